@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include "bench.h"
+#include "pic32cx1025sg61128.h"
+#include "clock_mgr.h"
+
+/*
+ * Micro-benchmark of single driver calls.
+ *
+ *   setup ── [ c0 = CYCCNT ── fn(ctx) ── c1 = CYCCNT ] ── teardown
+ *
+ * Each call is its own sample, so the spread of a call that waits on
+ * SYNCBUSY or a peripheral flag shows up in the percentiles instead
+ * of being averaged away. The cost of the two counter reads and the
+ * indirect call is measured once with an empty case and subtracted.
+ *
+ * The first call of a case is a warm-up and not recorded: it pays
+ * the flash wait states and cache misses the loop will not.
+ */
+
+/* ================= STATE ================= */
+static uint32_t bench_samples[BENCH_MAX_RUNS];
+static uint32_t bench_ovh;
+
+/* ================= LOCAL HELPERS ================= */
+static void bench_nop(void *ctx)
+{
+    (void)ctx;
+}
+
+static uint32_t bench_sample(bench_fn_t fn, void *ctx)
+{
+#if BENCH_MASK_IRQ
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+
+    uint32_t c0 = BENCH_CYCLES();
+    fn(ctx);
+    uint32_t cycles = BENCH_CYCLES() - c0;
+
+#if BENCH_MASK_IRQ
+    __set_PRIMASK(primask);
+#endif
+
+    return cycles;
+}
+
+/* Insertion sort: BENCH_MAX_RUNS is small and usually nearly sorted */
+static void bench_sort(uint32_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++)
+    {
+        uint32_t x = v[i];
+        uint32_t j = i;
+
+        while (j > 0u && v[j - 1u] > x)
+        {
+            v[j] = v[j - 1u];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+/* Nearest-rank percentile of sorted samples */
+static uint32_t bench_percentile(const uint32_t *v, uint32_t n, uint32_t pct)
+{
+    uint32_t rank = (n * pct + 99u) / 100u;
+
+    return v[rank ? rank - 1u : 0u];
+}
+
+/* ================= INITIALIZATION ================= */
+void bench_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Fastest empty call: anything above it belongs to the case */
+    bench_ovh = 0xFFFFFFFFu;
+    for (uint32_t i = 0; i < 64u; i++)
+    {
+        uint32_t cycles = bench_sample(bench_nop, NULL);
+
+        if (cycles < bench_ovh)
+            bench_ovh = cycles;
+    }
+}
+
+uint32_t bench_overhead(void)
+{
+    return bench_ovh;
+}
+
+/* ================= MEASUREMENT ================= */
+void bench_run(const bench_case_t *c, bench_result_t *result)
+{
+    uint32_t runs = c->runs ? c->runs : BENCH_RUNS;
+    uint64_t sum  = 0;
+
+    if (runs > BENCH_MAX_RUNS)
+        runs = BENCH_MAX_RUNS;
+
+    for (uint32_t i = 0; i <= runs; i++)
+    {
+        if (c->setup)
+            c->setup(c->ctx);
+
+        uint32_t cycles = bench_sample(c->fn, c->ctx);
+
+        if (c->teardown)
+            c->teardown(c->ctx);
+
+        /* Run 0 is the warm-up */
+        if (i == 0u)
+            continue;
+
+        cycles = cycles > bench_ovh ? cycles - bench_ovh : 0u;
+        bench_samples[i - 1u] = cycles;
+        sum += cycles;
+    }
+
+    bench_sort(bench_samples, runs);
+
+    result->runs = runs;
+    result->min  = bench_samples[0];
+    result->mean = (uint32_t)(sum / runs);
+    result->p50  = bench_percentile(bench_samples, runs, 50u);
+    result->p90  = bench_percentile(bench_samples, runs, 90u);
+    result->p99  = bench_percentile(bench_samples, runs, 99u);
+    result->max  = bench_samples[runs - 1u];
+}
+
+/* ================= SUITE ================= */
+void bench_run_suite(const bench_case_t *cases, uint32_t count,
+                     void (*write)(const char *str))
+{
+    char line[128];
+    bench_result_t r;
+
+    snprintf(line, sizeof line, "bench cpu_hz=%lu overhead=%lu cases=%lu\r\n",
+             (unsigned long)clock_cpu_hz(), (unsigned long)bench_ovh,
+             (unsigned long)count);
+    write(line);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bench_run(&cases[i], &r);
+
+        snprintf(line, sizeof line,
+                 "bench=%s runs=%lu min=%lu mean=%lu p50=%lu p90=%lu p99=%lu max=%lu\r\n",
+                 cases[i].name, (unsigned long)r.runs,
+                 (unsigned long)r.min, (unsigned long)r.mean,
+                 (unsigned long)r.p50, (unsigned long)r.p90,
+                 (unsigned long)r.p99, (unsigned long)r.max);
+        write(line);
+    }
+}
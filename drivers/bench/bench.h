@@ -0,0 +1,86 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+
+/* ================= BENCH CONFIG ================= */
+
+/* Samples kept per case: percentiles are taken over these */
+#ifndef BENCH_MAX_RUNS
+#define BENCH_MAX_RUNS          256u
+#endif
+
+/* Runs of a case that leaves runs at 0 */
+#ifndef BENCH_RUNS
+#define BENCH_RUNS              BENCH_MAX_RUNS
+#endif
+
+/*
+ * Cycle counter read around every call. The harness itself touches
+ * no other hardware, so any free-running 32-bit counter will do.
+ */
+#ifndef BENCH_CYCLES
+#define BENCH_CYCLES()          (DWT->CYCCNT)
+#endif
+
+/* 1: every call runs with PRIMASK set, so no ISR lands in a sample */
+#ifndef BENCH_MASK_IRQ
+#define BENCH_MASK_IRQ          1
+#endif
+
+/* ================= TYPES ================= */
+
+typedef void (*bench_fn_t)(void *ctx);
+
+/*
+ * One driver entry point. setup / teardown run around every call,
+ * outside the measured window (e.g. I²C start and stop around
+ * i2c_write()). Either may be NULL.
+ */
+typedef struct
+{
+    const char *name;
+    bench_fn_t  fn;
+    bench_fn_t  setup;
+    bench_fn_t  teardown;
+    void       *ctx;
+    uint32_t    runs;           /* 0 = BENCH_RUNS, at most BENCH_MAX_RUNS */
+} bench_case_t;
+
+/* CPU cycles per call, call overhead of the harness removed */
+typedef struct
+{
+    uint32_t runs;
+    uint32_t min;
+    uint32_t mean;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+} bench_result_t;
+
+/* ================= BENCH PUBLIC API ================= */
+
+/* Start the DWT cycle counter and measure the harness overhead */
+void bench_init(void);
+
+/* Cycles the harness adds to every sample (an empty case) */
+uint32_t bench_overhead(void);
+
+void bench_run(const bench_case_t *c, bench_result_t *result);
+
+/*
+ * Run every case and write the results through write() (e.g.
+ * SERCOM7_USART_WriteString), one key=value line each after a header:
+ *
+ *   bench cpu_hz=120000000 overhead=9 cases=12
+ *   bench=gpio_write_toggle runs=256 min=14 mean=14 p50=14 p90=14 p99=15 max=15
+ *
+ * All figures are CPU cycles.
+ */
+void bench_run_suite(const bench_case_t *cases, uint32_t count,
+                     void (*write)(const char *str));
+
+#endif /* BENCH_H */
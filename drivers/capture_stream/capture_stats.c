@@ -0,0 +1,128 @@
+#include "capture_stats.h"
+
+/*
+ * Capture window statistics.
+ *
+ * Two passes over the window: the first one gets min / max and the
+ * 64-bit sums, the second the squared deviations of the period from
+ * its mean for the RMS jitter. Deviations are taken from the mean in 1/256 tick so
+ * that sub-tick jitter of a steady signal is not rounded to zero.
+ */
+
+/* ================= LOCAL HELPERS ================= */
+
+static uint64_t capture_isqrt64(uint64_t v)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v)
+        bit >>= 2;
+
+    while (bit)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+static inline int capture_valid(uint32_t s)
+{
+    return CAPTURE_PERIOD(s) != 0u && CAPTURE_WIDTH(s) <= CAPTURE_PERIOD(s);
+}
+
+/* ================= CONVERSION ================= */
+uint32_t capture_ticks_to_ns(uint64_t ticks, uint32_t tick_hz)
+{
+    if (tick_hz == 0u)
+        return 0;
+
+    return (uint32_t)((ticks * 1000000000ULL + tick_hz / 2u) / tick_hz);
+}
+
+/* ================= STATISTICS ================= */
+void capture_stats_compute(const uint32_t *samples,
+                           uint32_t n,
+                           uint32_t tick_hz,
+                           capture_stats_t *stats)
+{
+    uint64_t sum_period = 0;
+    uint64_t sum_width = 0;
+
+    *stats = (capture_stats_t){0};
+    stats->period_min = UINT32_MAX;
+    stats->width_min  = UINT32_MAX;
+
+    /* Pass 1: extremes and sums */
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t s = samples[i];
+
+        if (!capture_valid(s))
+        {
+            stats->invalid++;
+            continue;
+        }
+
+        uint32_t period = CAPTURE_PERIOD(s);
+        uint32_t width  = CAPTURE_WIDTH(s);
+
+        if (period < stats->period_min) stats->period_min = period;
+        if (period > stats->period_max) stats->period_max = period;
+        if (width  < stats->width_min)  stats->width_min  = width;
+        if (width  > stats->width_max)  stats->width_max  = width;
+
+        sum_period += period;
+        sum_width  += width;
+        stats->count++;
+    }
+
+    if (stats->count == 0u)
+    {
+        stats->period_min = 0;
+        stats->width_min  = 0;
+        return;
+    }
+
+    uint32_t count = stats->count;
+
+    stats->period_mean = (uint32_t)((sum_period + count / 2u) / count);
+    stats->width_mean  = (uint32_t)((sum_width + count / 2u) / count);
+
+    stats->freq_mhz = (uint32_t)(((uint64_t)tick_hz * 1000u * count + sum_period / 2u) / sum_period);
+    stats->duty_ppm = (uint32_t)((sum_width * 1000000u + sum_period / 2u) / sum_period);
+
+    /* Pass 2: period variance around the mean, 1/256 tick fixed point */
+    uint64_t mean_q8 = (sum_period * 256u + count / 2u) / count;
+    uint64_t sum_sq = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (!capture_valid(samples[i]))
+            continue;
+
+        int64_t d = (int64_t)((uint64_t)CAPTURE_PERIOD(samples[i]) * 256u) - (int64_t)mean_q8;
+
+        /* |d| < 2^24: d² < 2^48, no overflow for windows < 65536 */
+        sum_sq += (uint64_t)(d * d);
+    }
+
+    /* RMS in 1/256 tick, then to ns */
+    uint64_t rms_q8 = capture_isqrt64(sum_sq / count);
+
+    if (tick_hz == 0u)
+        return;
+
+    stats->jitter_rms_ns = (uint32_t)((rms_q8 * 1000000000ULL / tick_hz + 128u) >> 8);
+    stats->jitter_pp_ns  = capture_ticks_to_ns(stats->period_max - stats->period_min, tick_hz);
+}
@@ -0,0 +1,52 @@
+#ifndef CAPTURE_STATS_H
+#define CAPTURE_STATS_H
+
+#include <stdint.h>
+
+/*
+ * One captured cycle as stored by the capture stream: the TC period
+ * capture (CC0) in the low half, the pulse width (CC1) in the high
+ * half, both in TC ticks.
+ */
+#define CAPTURE_PERIOD(s)   ((uint32_t)(s) & 0xFFFFu)
+#define CAPTURE_WIDTH(s)    ((uint32_t)(s) >> 16)
+#define CAPTURE_SAMPLE(period, width) \
+    (((uint32_t)(width) << 16) | ((uint32_t)(period) & 0xFFFFu))
+
+/* ================= TYPES ================= */
+typedef struct
+{
+    uint32_t count;             /* Valid cycles in the window              */
+    uint32_t invalid;           /* Skipped: period 0 or width > period     */
+
+    uint32_t period_min;        /* Ticks */
+    uint32_t period_max;
+    uint32_t period_mean;       /* Rounded */
+    uint32_t width_min;
+    uint32_t width_max;
+    uint32_t width_mean;
+
+    uint32_t freq_mhz;          /* Mean frequency, millihertz              */
+    uint32_t duty_ppm;          /* Σ width / Σ period, parts per million   */
+    uint32_t jitter_rms_ns;     /* Standard deviation of the period        */
+    uint32_t jitter_pp_ns;      /* Period max - min                        */
+} capture_stats_t;
+
+/* ================= STATISTICS ================= */
+
+/*
+ * Statistics over a window of capture samples, tick_hz = TC counter
+ * rate. Pure computation with no register access: it runs the same on
+ * the target and on a host, fed with synthetic streams.
+ * Windows up to 65535 samples; an empty one leaves every field 0.
+ * The ns fields stay 0 when tick_hz is 0.
+ */
+void capture_stats_compute(const uint32_t *samples,
+                           uint32_t n,
+                           uint32_t tick_hz,
+                           capture_stats_t *stats);
+
+/* Ticks → ns at tick_hz, rounded */
+uint32_t capture_ticks_to_ns(uint64_t ticks, uint32_t tick_hz);
+
+#endif /* CAPTURE_STATS_H */
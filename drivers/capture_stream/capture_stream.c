@@ -0,0 +1,213 @@
+#include "capture_stream.h"
+#include "timer_counter_drv.h"
+#include "dmac_drv.h"
+#include "evsys_drv.h"
+#include "eic_drv.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * DMA-streamed TC input capture.
+ *
+ *   pin ── EXTINT (level, event only) ── EVSYS async ──► TCn PPW
+ *                                                         │ MC1
+ *   ring[len] ◄── 1 word: CC1 << 16 | CC0 ── DMAC ◄───────┘
+ *
+ * PPW capture stores the period in CC0 at the rising edge and the
+ * pulse width in CC1 at the falling edge. CC0 and CC1 are adjacent
+ * 16-bit registers, so one word beat triggered by MC1 reads both: a
+ * complete cycle per beat. The descriptor loops on itself and raises
+ * one interrupt per pass, which only counts the pass.
+ *
+ * Written position = wraps * len + (len - remaining). The DMA can wrap
+ * before its interrupt is served (reader at higher priority or with
+ * interrupts masked); a total lower than the previous one is then one
+ * uncounted pass, hence the once-per-ring read requirement.
+ */
+
+/* ================= LOCAL HELPERS ================= */
+
+/* DMAC interrupt: the ring has been filled once more */
+static void capture_stream_dma_done(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    capture_stream_t *cs = (capture_stream_t *)ctx;
+    (void)ch;
+
+    if (status == DMAC_XFER_COMPLETE)
+        cs->wraps++;
+}
+
+/* Total samples written since start, free running */
+static uint32_t capture_stream_written(capture_stream_t *cs)
+{
+    uint32_t wraps, remaining;
+
+    do
+    {
+        wraps     = cs->wraps;
+        remaining = dmac_channel_remaining((uint8_t)cs->dma_ch);
+    } while (wraps != cs->wraps);
+
+    uint32_t total = wraps * cs->len + (cs->len - remaining);
+
+    /* Wrapped, interrupt not served yet */
+    if ((int32_t)(total - cs->written) < 0)
+        total += cs->len;
+
+    cs->written = total;
+    return total;
+}
+
+/* ================= INITIALIZATION ================= */
+bool capture_stream_init(capture_stream_t *cs,
+                         const capture_stream_config_t *cfg,
+                         uint32_t *buf,
+                         uint32_t len)
+{
+    if (len == 0u || len > CAPTURE_STREAM_MAX_LEN || (len & (len - 1u)))
+        return false;
+
+    cs->tc_index = cfg->tc_index;
+    cs->line     = cfg->line;
+    cs->buf      = buf;
+    cs->len      = len;
+    cs->ev_ch    = -1;
+    cs->overruns = 0;
+    cs->dma_ch   = dmac_channel_alloc();
+
+    if (cs->dma_ch < 0)
+        return false;
+
+    /* Smallest prescaler whose 16-bit range covers min_hz: best resolution */
+    cs->tick_hz = tc_init_for_rate(cs->tc_index, TC_MODE_16BIT, TC_WAVE_NFRQ, cfg->min_hz);
+    if (cs->tick_hz == 0u)
+    {
+        capture_stream_deinit(cs);
+        return false;
+    }
+
+    /* Event only: sense HIGH carries the pin level to the TC */
+    if (!eic_attach(cfg->port, cfg->pin, cfg->line, EIC_SENSE_HIGH, 0, 0, 0))
+    {
+        capture_stream_deinit(cs);
+        return false;
+    }
+    eic_disable_line(cfg->line);
+    eic_event_output_enable(cfg->line, true);
+
+    tc_capture_enable(cs->tc_index, 0, TC_CAPTURE_PPWP, cfg->invert);
+    tc_capture_enable(cs->tc_index, 1, TC_CAPTURE_PPWP, cfg->invert);
+
+    cs->ev_ch = evsys_route(EVSYS_GEN_EIC_EXTINT(cfg->line), EVSYS_USER_TC(cs->tc_index),
+                            EVSYS_PATH_ASYNC, EVSYS_EDGE_NONE);
+    if (cs->ev_ch < 0)
+    {
+        capture_stream_deinit(cs);
+        return false;
+    }
+
+    dmac_channel_setup((uint8_t)cs->dma_ch, DMAC_TRIG_TC_MC(cs->tc_index, 1),
+                       DMAC_TRIGACT_BURST, cfg->dma_priority);
+    dmac_channel_register_callback((uint8_t)cs->dma_ch, capture_stream_dma_done, cs);
+
+    return true;
+}
+
+void capture_stream_deinit(capture_stream_t *cs)
+{
+    if (cs->dma_ch < 0)
+        return;
+
+    capture_stream_stop(cs);
+
+    if (cs->ev_ch >= 0)
+    {
+        evsys_channel_free((uint8_t)cs->ev_ch);
+        eic_event_output_enable(cs->line, false);
+        eic_detach(cs->line);
+    }
+
+    dmac_channel_free((uint8_t)cs->dma_ch);
+    tc_deinit(cs->tc_index);
+
+    cs->ev_ch  = -1;
+    cs->dma_ch = -1;
+}
+
+/* ================= CONTROL ================= */
+void capture_stream_start(capture_stream_t *cs)
+{
+    dmac_desc_t *desc = dmac_channel_descriptor((uint8_t)cs->dma_ch);
+
+    /* Fixed source CC0..CC1, circular destination ring */
+    dmac_descriptor_fill(desc, tc_capture_register(cs->tc_index, 0), cs->buf,
+                         (uint16_t)cs->len, DMAC_BEAT_WORD,
+                         DMAC_DESC_DSTINC | DMAC_DESC_INT, desc);
+
+    cs->wraps   = 0;
+    cs->written = 0;
+    cs->tail    = 1;      /* First period runs from tc_start(), not an edge */
+
+    dmac_channel_enable((uint8_t)cs->dma_ch);
+    tc_start(cs->tc_index);
+}
+
+void capture_stream_stop(capture_stream_t *cs)
+{
+    if (cs->dma_ch < 0)
+        return;
+
+    tc_stop(cs->tc_index);
+    dmac_channel_disable((uint8_t)cs->dma_ch);
+}
+
+/* ================= READING ================= */
+uint32_t capture_stream_available(capture_stream_t *cs)
+{
+    uint32_t written = capture_stream_written(cs);
+
+    if ((int32_t)(written - cs->tail) <= 0)
+        return 0;
+
+    return written - cs->tail;
+}
+
+uint32_t capture_stream_read(capture_stream_t *cs, uint32_t *dst, uint32_t max)
+{
+    uint32_t avail = capture_stream_available(cs);
+    uint32_t mask  = cs->len - 1u;
+
+    /* Lapped: the slot at written % len is the next one overwritten */
+    if (avail > mask)
+    {
+        cs->overruns += avail - mask;
+        cs->tail     += avail - mask;
+        avail         = mask;
+    }
+
+    if (max > avail)
+        max = avail;
+
+    for (uint32_t i = 0; i < max; i++)
+        dst[i] = cs->buf[(cs->tail + i) & mask];
+
+    cs->tail += max;
+    return max;
+}
+
+void capture_stream_flush(capture_stream_t *cs)
+{
+    uint32_t written = capture_stream_written(cs);
+
+    if ((int32_t)(written - cs->tail) > 0)
+        cs->tail = written;
+}
+
+uint32_t capture_stream_overruns(const capture_stream_t *cs)
+{
+    return cs->overruns;
+}
+
+uint32_t capture_stream_tick_hz(const capture_stream_t *cs)
+{
+    return cs->tick_hz;
+}
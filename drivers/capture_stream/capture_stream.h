@@ -0,0 +1,82 @@
+#ifndef CAPTURE_STREAM_H
+#define CAPTURE_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_drv.h"
+#include "capture_stats.h"
+
+/* ================= CAPTURE STREAM CONFIG ================= */
+
+/* Ring length limit: one DMA block, power of two */
+#define CAPTURE_STREAM_MAX_LEN  32768u
+
+typedef struct
+{
+    uint8_t          tc_index;      /* Capture TC, 16-bit PPW            */
+    gpio_port_id_t   port;          /* Input pin, through the EIC        */
+    uint8_t          pin;
+    uint8_t          line;          /* EXTINT line of the pin            */
+    bool             invert;        /* Measure the low phase as width    */
+    uint32_t         min_hz;        /* Slowest input: picks the prescaler */
+    uint8_t          dma_priority;  /* 0..3, 3 = highest                 */
+} capture_stream_config_t;
+
+/*
+ * Stream state (caller allocated). Members are driver private.
+ */
+typedef struct
+{
+    uint8_t             tc_index;
+    uint8_t             line;
+    int8_t              dma_ch;
+    int8_t              ev_ch;
+    uint32_t           *buf;
+    uint32_t            len;
+    uint32_t            tick_hz;
+    volatile uint32_t   wraps;      /* Ring passes, DMAC interrupt */
+    uint32_t            written;    /* Last total seen by the reader */
+    uint32_t            tail;       /* Next sample to read, free running */
+    uint32_t            overruns;   /* Samples lost to a full ring */
+} capture_stream_t;
+
+/* ================= CAPTURE STREAM PUBLIC API ================= */
+
+/*
+ * Route pin → EXTINT → EVSYS → TC PPW capture → DMA → buf[len].
+ * Every input cycle becomes one CAPTURE_SAMPLE(period, width) word in
+ * the ring with no CPU involvement. len must be a power of two.
+ * Needs dmac_init() and evsys_init(); the EIC is initialized on demand.
+ */
+bool capture_stream_init(capture_stream_t *cs,
+                         const capture_stream_config_t *cfg,
+                         uint32_t *buf,
+                         uint32_t len);
+
+/* Release the TC, the DMA and event channels and the EXTINT line */
+void capture_stream_deinit(capture_stream_t *cs);
+
+void capture_stream_start(capture_stream_t *cs);
+void capture_stream_stop(capture_stream_t *cs);
+
+/*
+ * Samples waiting in the ring. Call at least once per len input
+ * cycles, or wraps of the ring are miscounted.
+ */
+uint32_t capture_stream_available(capture_stream_t *cs);
+
+/*
+ * Copy up to max samples out, oldest first. When the DMA lapped the
+ * reader, the oldest samples are skipped and counted as overruns.
+ */
+uint32_t capture_stream_read(capture_stream_t *cs, uint32_t *dst, uint32_t max);
+
+/* Drop everything captured so far */
+void capture_stream_flush(capture_stream_t *cs);
+
+uint32_t capture_stream_overruns(const capture_stream_t *cs);
+
+/* TC counter rate: the unit of period and width */
+uint32_t capture_stream_tick_hz(const capture_stream_t *cs);
+
+#endif /* CAPTURE_STREAM_H */
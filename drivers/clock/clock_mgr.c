@@ -0,0 +1,314 @@
+#include "clock_mgr.h"
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Clock tree owner.
+ *
+ * Drivers no longer write GCLK_PCHCTRL themselves: they enable their
+ * channel here, ask for its frequency and register a notifier if
+ * their timing depends on it. The generator table below is the only
+ * record of what each GCLK runs at.
+ */
+
+/* ================= MACROS ================= */
+#define CLOCK_PCH_FDPLL0    1u      /* OSCCTRL_GCLK_ID_FDPLL0 */
+
+/* ================= STATE ================= */
+static uint32_t gen_hz[CLOCK_GEN_MAX] = { CLOCK_DFLL_HZ };  /* GCLK0 = DFLL after reset */
+
+static uint8_t pch_refcount[CLOCK_PCH_MAX] = {0};
+static uint8_t pch_gen[CLOCK_PCH_MAX] = {0};
+
+static clock_notifier_t *notifiers = 0;
+static bool dpll_running = false;
+static bool clock_ready = false;
+
+/* ================= LOCAL HELPERS ================= */
+
+/* Drivers may come up before main() calls clock_init() */
+static void clock_ensure_init(void)
+{
+    if (!clock_ready)
+        clock_init();
+}
+
+static void clock_notify(uint8_t gen, clock_event_t event, uint32_t hz)
+{
+    for (clock_notifier_t *n = notifiers; n; n = n->next)
+    {
+        if (n->gen == gen && n->callback)
+            n->callback(gen, event, hz, n->ctx);
+    }
+}
+
+static void clock_gen_write(uint8_t gen, clock_src_t src, uint16_t div)
+{
+    GCLK_REGS->GCLK_GENCTRL[gen] =
+        GCLK_GENCTRL_SRC(src) |
+        GCLK_GENCTRL_DIV(div) |
+        GCLK_GENCTRL_IDC_Msk |
+        GCLK_GENCTRL_GENEN_Msk;
+
+    while (GCLK_REGS->GCLK_SYNCBUSY & (1u << (GCLK_SYNCBUSY_GENCTRL_Pos + gen)));
+}
+
+/*
+ * NVM read wait states for VDD > 2.7 V (datasheet NVM characteristics)
+ */
+static uint8_t clock_flash_ws(uint32_t hz)
+{
+    static const uint32_t ws_max_hz[] =
+    {
+        24000000UL, 51000000UL, 77000000UL, 101000000UL, 119000000UL
+    };
+    uint8_t ws = 0;
+
+    while (ws < sizeof ws_max_hz / sizeof ws_max_hz[0] && hz > ws_max_hz[ws])
+        ws++;
+
+    return ws;
+}
+
+static void clock_flash_set_ws(uint32_t hz)
+{
+    NVMCTRL_REGS->NVMCTRL_CTRLA =
+        (NVMCTRL_REGS->NVMCTRL_CTRLA & ~(NVMCTRL_CTRLA_RWS_Msk | NVMCTRL_CTRLA_AUTOWS_Msk)) |
+        NVMCTRL_CTRLA_RWS(clock_flash_ws(hz));
+}
+
+/*
+ * DPLL0 = 1 MHz reference × (LDR + 1 + LDRFRAC / 32)
+ *
+ * @return Frequency actually produced
+ */
+static uint32_t clock_dpll_start(uint32_t hz)
+{
+    uint32_t ldr     = hz / CLOCK_DPLL_REF_HZ - 1u;
+    uint32_t ldrfrac = ((hz % CLOCK_DPLL_REF_HZ) * 32u + CLOCK_DPLL_REF_HZ / 2u) / CLOCK_DPLL_REF_HZ;
+
+    if (ldrfrac == 32u)
+    {
+        ldr++;
+        ldrfrac = 0;
+    }
+
+    if (!dpll_running)
+        (void)clock_periph_enable(CLOCK_PCH_FDPLL0, CLOCK_GEN_DPLL_REF);
+
+    OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLCTRLA = 0;
+    while (OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLSYNCBUSY & OSCCTRL_DPLLSYNCBUSY_ENABLE_Msk);
+
+    OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLRATIO =
+        OSCCTRL_DPLLRATIO_LDR(ldr) | OSCCTRL_DPLLRATIO_LDRFRAC(ldrfrac);
+    while (OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLSYNCBUSY & OSCCTRL_DPLLSYNCBUSY_DPLLRATIO_Msk);
+
+    OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLCTRLB = OSCCTRL_DPLLCTRLB_REFCLK_GCLK;
+
+    OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLCTRLA = OSCCTRL_DPLLCTRLA_ENABLE_Msk;
+    while (OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLSYNCBUSY & OSCCTRL_DPLLSYNCBUSY_ENABLE_Msk);
+
+    while ((OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLSTATUS &
+            (OSCCTRL_DPLLSTATUS_LOCK_Msk | OSCCTRL_DPLLSTATUS_CLKRDY_Msk)) !=
+           (OSCCTRL_DPLLSTATUS_LOCK_Msk | OSCCTRL_DPLLSTATUS_CLKRDY_Msk));
+
+    dpll_running = true;
+
+    return CLOCK_DPLL_REF_HZ * (ldr + 1u) + (CLOCK_DPLL_REF_HZ * ldrfrac) / 32u;
+}
+
+static void clock_dpll_stop(void)
+{
+    if (!dpll_running)
+        return;
+
+    OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLCTRLA = 0;
+    while (OSCCTRL_REGS->DPLL[0].OSCCTRL_DPLLSYNCBUSY & OSCCTRL_DPLLSYNCBUSY_ENABLE_Msk);
+
+    clock_periph_disable(CLOCK_PCH_FDPLL0);
+    dpll_running = false;
+}
+
+/* ================= INITIALIZATION ================= */
+void clock_init(void)
+{
+    clock_ready = true;
+
+    /* GCLK1: peripheral cores, independent of CPU scaling */
+    clock_gen_write(CLOCK_GEN_PERIPH, CLOCK_SRC_DFLL, 1);
+    gen_hz[CLOCK_GEN_PERIPH] = CLOCK_DFLL_HZ;
+
+    /* GCLK2: 1 MHz DPLL reference */
+    clock_gen_write(CLOCK_GEN_DPLL_REF, CLOCK_SRC_DFLL, CLOCK_DFLL_HZ / CLOCK_DPLL_REF_HZ);
+    gen_hz[CLOCK_GEN_DPLL_REF] = CLOCK_DPLL_REF_HZ;
+
+    clock_flash_set_ws(gen_hz[CLOCK_GEN_CPU]);
+}
+
+/* ================= GENERATORS ================= */
+bool clock_gen_set(uint8_t gen, clock_src_t src, uint32_t src_hz, uint16_t div)
+{
+    if (gen >= CLOCK_GEN_MAX || div == 0u)
+        return false;
+    if (gen == CLOCK_GEN_CPU)
+        return false;       /* clock_set_cpu_hz() handles flash wait states */
+    if (gen != 1u && div > 0xFFu)
+        return false;       /* Only GCLK1 has a 16-bit divider */
+
+    clock_notify(gen, CLOCK_EVENT_PRE_CHANGE, gen_hz[gen]);
+
+    clock_gen_write(gen, src, div);
+    gen_hz[gen] = src_hz / div;
+
+    clock_notify(gen, CLOCK_EVENT_POST_CHANGE, gen_hz[gen]);
+    return true;
+}
+
+uint32_t clock_gen_hz(uint8_t gen)
+{
+    clock_ensure_init();
+    return (gen < CLOCK_GEN_MAX) ? gen_hz[gen] : 0u;
+}
+
+/* ================= CPU CLOCK ================= */
+bool clock_set_cpu_hz(uint32_t hz)
+{
+    uint32_t old_hz = gen_hz[CLOCK_GEN_CPU];
+    uint32_t new_hz;
+    uint32_t ws_hz;
+
+    if (hz == 0u || hz > CLOCK_CPU_MAX_HZ)
+        return false;
+
+    clock_notify(CLOCK_GEN_CPU, CLOCK_EVENT_PRE_CHANGE, old_hz);
+
+    /* Wait states for the fastest rate passed through on the way */
+    ws_hz = (old_hz > hz) ? old_hz : hz;
+    if (ws_hz < CLOCK_DFLL_HZ)
+        ws_hz = CLOCK_DFLL_HZ;
+    clock_flash_set_ws(ws_hz);
+
+    /* Run from the DFLL while the DPLL is touched */
+    clock_gen_write(CLOCK_GEN_CPU, CLOCK_SRC_DFLL, 1);
+
+    if (hz <= CLOCK_DFLL_HZ && (CLOCK_DFLL_HZ % hz) == 0u)
+    {
+        uint32_t div = CLOCK_DFLL_HZ / hz;
+
+        if (div > 1u)
+            clock_gen_write(CLOCK_GEN_CPU, CLOCK_SRC_DFLL, (uint16_t)div);
+
+        clock_dpll_stop();
+        new_hz = CLOCK_DFLL_HZ / div;
+    }
+    else
+    {
+        uint32_t div = (CLOCK_DPLL_MIN_HZ + hz - 1u) / hz;
+
+        if ((uint64_t)hz * div > CLOCK_DPLL_MAX_HZ || div > 0xFFu)
+            div = 1u;
+
+        new_hz = clock_dpll_start(hz * div) / div;
+        clock_gen_write(CLOCK_GEN_CPU, CLOCK_SRC_DPLL0, (uint16_t)div);
+    }
+
+    gen_hz[CLOCK_GEN_CPU] = new_hz;
+    clock_flash_set_ws(new_hz);
+
+    clock_notify(CLOCK_GEN_CPU, CLOCK_EVENT_POST_CHANGE, new_hz);
+    return true;
+}
+
+uint32_t clock_cpu_hz(void)
+{
+    return gen_hz[CLOCK_GEN_CPU];
+}
+
+/* ================= PERIPHERAL CHANNELS ================= */
+bool clock_periph_enable(uint8_t pch, uint8_t gen)
+{
+    bool ok = true;
+
+    if (pch >= CLOCK_PCH_MAX || gen >= CLOCK_GEN_MAX)
+        return false;
+
+    clock_ensure_init();
+
+    uint32_t basepri = irq_lock();
+
+    if (pch_refcount[pch] == 0u)
+    {
+        GCLK_REGS->GCLK_PCHCTRL[pch] = GCLK_PCHCTRL_GEN(gen) | GCLK_PCHCTRL_CHEN_Msk;
+        while (!(GCLK_REGS->GCLK_PCHCTRL[pch] & GCLK_PCHCTRL_CHEN_Msk));
+
+        pch_gen[pch] = gen;
+        pch_refcount[pch] = 1;
+    }
+    else if (pch_gen[pch] != gen || pch_refcount[pch] == 0xFFu)
+    {
+        ok = false;     /* Shared channel already runs from another generator */
+    }
+    else
+    {
+        pch_refcount[pch]++;
+    }
+
+    irq_unlock(basepri);
+    return ok;
+}
+
+void clock_periph_disable(uint8_t pch)
+{
+    if (pch >= CLOCK_PCH_MAX)
+        return;
+
+    uint32_t basepri = irq_lock();
+
+    if (pch_refcount[pch] && --pch_refcount[pch] == 0u)
+    {
+        GCLK_REGS->GCLK_PCHCTRL[pch] &= ~GCLK_PCHCTRL_CHEN_Msk;
+        while (GCLK_REGS->GCLK_PCHCTRL[pch] & GCLK_PCHCTRL_CHEN_Msk);
+    }
+
+    irq_unlock(basepri);
+}
+
+uint32_t clock_periph_hz(uint8_t pch)
+{
+    if (pch >= CLOCK_PCH_MAX || pch_refcount[pch] == 0u)
+        return 0u;
+
+    return gen_hz[pch_gen[pch]];
+}
+
+uint8_t clock_periph_refcount(uint8_t pch)
+{
+    return (pch < CLOCK_PCH_MAX) ? pch_refcount[pch] : 0u;
+}
+
+/* ================= CHANGE NOTIFICATION ================= */
+void clock_notifier_register(clock_notifier_t *notifier)
+{
+    uint32_t basepri = irq_lock();
+
+    notifier->next = notifiers;
+    notifiers = notifier;
+
+    irq_unlock(basepri);
+}
+
+void clock_notifier_unregister(clock_notifier_t *notifier)
+{
+    uint32_t basepri = irq_lock();
+
+    for (clock_notifier_t **p = &notifiers; *p; p = &(*p)->next)
+    {
+        if (*p == notifier)
+        {
+            *p = notifier->next;
+            break;
+        }
+    }
+
+    irq_unlock(basepri);
+}
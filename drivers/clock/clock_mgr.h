@@ -0,0 +1,96 @@
+#ifndef CLOCK_MGR_H
+#define CLOCK_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= CLOCK CONFIG ================= */
+#define CLOCK_GEN_MAX       12u     /* GCLK0 .. GCLK11 */
+#define CLOCK_PCH_MAX       48u     /* GCLK peripheral channels */
+
+/*
+ * Generator roles set up by clock_init():
+ *   GCLK0 : CPU / MCLK, scaled at runtime by clock_set_cpu_hz()
+ *   GCLK1 : peripheral cores (SERCOM, TC), DFLL48M, stays at 48 MHz
+ *   GCLK2 : 1 MHz DPLL0 reference (DFLL48M / 48)
+ */
+#define CLOCK_GEN_CPU       0u
+#define CLOCK_GEN_PERIPH    1u
+#define CLOCK_GEN_DPLL_REF  2u
+
+#define CLOCK_DFLL_HZ       48000000UL
+#define CLOCK_DPLL_REF_HZ   1000000UL
+#define CLOCK_CPU_MAX_HZ    120000000UL
+
+/* DPLL0 output range */
+#define CLOCK_DPLL_MIN_HZ   96000000UL
+#define CLOCK_DPLL_MAX_HZ   200000000UL
+
+/* ================= SOURCES ================= */
+/* GENCTRL.SRC values */
+typedef enum
+{
+    CLOCK_SRC_XOSC0   = 0,
+    CLOCK_SRC_XOSC1   = 1,
+    CLOCK_SRC_GCLKIN  = 2,
+    CLOCK_SRC_GCLKGEN1= 3,
+    CLOCK_SRC_OSCULP32K = 4,
+    CLOCK_SRC_XOSC32K = 5,
+    CLOCK_SRC_DFLL    = 6,
+    CLOCK_SRC_DPLL0   = 7,
+    CLOCK_SRC_DPLL1   = 8
+} clock_src_t;
+
+/* ================= CHANGE NOTIFICATION ================= */
+typedef enum
+{
+    CLOCK_EVENT_PRE_CHANGE = 0,     /* hz = current rate, generator still running it */
+    CLOCK_EVENT_POST_CHANGE         /* hz = new rate, already applied */
+} clock_event_t;
+
+typedef void (*clock_notify_t)(uint8_t gen, clock_event_t event, uint32_t hz, void *ctx);
+
+/*
+ * Caller-owned list node, one per interested driver instance.
+ * Callbacks run in the context of the code changing the clock.
+ */
+typedef struct clock_notifier
+{
+    uint8_t                 gen;
+    clock_notify_t          callback;
+    void                   *ctx;
+    struct clock_notifier  *next;
+} clock_notifier_t;
+
+/* ================= CLOCK PUBLIC API ================= */
+
+/* Take over the reset clock tree (DFLL48M open loop on GCLK0) */
+void clock_init(void);
+
+/* Generators */
+bool clock_gen_set(uint8_t gen, clock_src_t src, uint32_t src_hz, uint16_t div);
+uint32_t clock_gen_hz(uint8_t gen);
+
+/*
+ * CPU clock. Up to 48 MHz: DFLL48M divided. Above: DPLL0 from the
+ * 1 MHz reference, divided to keep the DPLL in its output range.
+ * Flash wait states are adjusted around the change.
+ */
+bool clock_set_cpu_hz(uint32_t hz);
+uint32_t clock_cpu_hz(void);
+
+/*
+ * Peripheral channels (PCHCTRL), reference counted.
+ * The first enable connects the channel to gen, the last disable
+ * gates it off. All users of a shared channel get the same generator.
+ */
+bool clock_periph_enable(uint8_t pch, uint8_t gen);
+void clock_periph_disable(uint8_t pch);
+uint32_t clock_periph_hz(uint8_t pch);
+uint8_t clock_periph_refcount(uint8_t pch);
+
+/* Change notification */
+void clock_notifier_register(clock_notifier_t *notifier);
+void clock_notifier_unregister(clock_notifier_t *notifier);
+
+#endif /* CLOCK_MGR_H */
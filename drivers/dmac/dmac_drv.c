@@ -0,0 +1,254 @@
+#include "pic32cx1025sg61128.h"
+#include "dmac_drv.h"
+#include "irq_mgr.h"
+#include "isr_prof.h"
+
+/* ================= DESCRIPTOR MEMORY ================= */
+/*
+ * The DMAC fetches the first descriptor of channel n from
+ * BASEADDR + 16*n and writes the channel state back to
+ * WRBADDR + 16*n whenever the channel is suspended or re-arbitrated.
+ */
+static dmac_desc_t dmac_desc[DMAC_CH_MAX];
+static dmac_desc_t dmac_wrb[DMAC_CH_MAX];
+
+/* ================= CHANNEL STATE ================= */
+static uint32_t dmac_alloc_mask = 0;
+
+static dmac_callback_t dmac_callbacks[DMAC_CH_MAX] = {0};
+static void *dmac_contexts[DMAC_CH_MAX] = {0};
+
+/* ================= INITIALIZATION ================= */
+void dmac_init(void)
+{
+    /* DMAC is an AHB master, no GCLK needed */
+    MCLK_REGS->MCLK_AHBMASK |= MCLK_AHBMASK_DMAC_Msk;
+
+    /* Disable and reset */
+    DMAC_REGS->DMAC_CTRL &= ~DMAC_CTRL_DMAENABLE_Msk;
+    DMAC_REGS->DMAC_CTRL = DMAC_CTRL_SWRST_Msk;
+    while (DMAC_REGS->DMAC_CTRL & DMAC_CTRL_SWRST_Msk);
+
+    DMAC_REGS->DMAC_BASEADDR = (uint32_t)dmac_desc;
+    DMAC_REGS->DMAC_WRBADDR  = (uint32_t)dmac_wrb;
+
+    /* Enable DMAC with all four priority levels */
+    DMAC_REGS->DMAC_CTRL =
+        DMAC_CTRL_DMAENABLE_Msk |
+        DMAC_CTRL_LVLEN0_Msk | DMAC_CTRL_LVLEN1_Msk |
+        DMAC_CTRL_LVLEN2_Msk | DMAC_CTRL_LVLEN3_Msk;
+
+    irq_enable(DMAC_0_IRQn, IRQ_PRIO_DMAC);
+    irq_enable(DMAC_1_IRQn, IRQ_PRIO_DMAC);
+    irq_enable(DMAC_2_IRQn, IRQ_PRIO_DMAC);
+    irq_enable(DMAC_3_IRQn, IRQ_PRIO_DMAC);
+    irq_enable(DMAC_4_IRQn, IRQ_PRIO_DMAC);
+}
+
+/* ================= CHANNEL ALLOCATION ================= */
+int8_t dmac_channel_alloc(void)
+{
+    int8_t ch = -1;
+
+    uint32_t basepri = irq_lock();
+    for (uint8_t i = 0; i < DMAC_CH_MAX; i++)
+    {
+        if (!(dmac_alloc_mask & (1u << i)))
+        {
+            dmac_alloc_mask |= (1u << i);
+            ch = (int8_t)i;
+            break;
+        }
+    }
+    irq_unlock(basepri);
+
+    return ch;
+}
+
+void dmac_channel_free(uint8_t ch)
+{
+    if (ch >= DMAC_CH_MAX)
+        return;
+
+    dmac_channel_disable(ch);
+    dmac_callbacks[ch] = 0;
+
+    uint32_t basepri = irq_lock();
+    dmac_alloc_mask &= ~(1u << ch);
+    irq_unlock(basepri);
+}
+
+/* ================= CHANNEL SETUP ================= */
+void dmac_channel_setup(uint8_t ch,
+                        uint8_t trigsrc,
+                        dmac_trigact_t trigact,
+                        uint8_t priority)
+{
+    if (ch >= DMAC_CH_MAX)
+        return;
+
+    dmac_channel_disable(ch);
+
+    DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA = DMAC_CHCTRLA_SWRST_Msk;
+    while (DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA & DMAC_CHCTRLA_SWRST_Msk);
+
+    DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA =
+        DMAC_CHCTRLA_TRIGSRC(trigsrc) |
+        DMAC_CHCTRLA_TRIGACT(trigact) |
+        DMAC_CHCTRLA_BURSTLEN_SINGLE;
+
+    DMAC_REGS->CHANNEL[ch].DMAC_CHPRILVL = priority & 0x3u;
+
+    /* Completion and error are always reported */
+    DMAC_REGS->CHANNEL[ch].DMAC_CHINTFLAG =
+        DMAC_CHINTFLAG_TCMPL_Msk | DMAC_CHINTFLAG_TERR_Msk | DMAC_CHINTFLAG_SUSP_Msk;
+    DMAC_REGS->CHANNEL[ch].DMAC_CHINTENSET =
+        DMAC_CHINTENSET_TCMPL_Msk | DMAC_CHINTENSET_TERR_Msk;
+}
+
+void dmac_channel_register_callback(uint8_t ch, dmac_callback_t callback, void *ctx)
+{
+    if (ch < DMAC_CH_MAX)
+    {
+        dmac_contexts[ch]  = ctx;
+        dmac_callbacks[ch] = callback;
+    }
+}
+
+bool dmac_channel_set_event_input(uint8_t ch, dmac_evact_t action)
+{
+    if (ch >= DMAC_EV_CH_MAX)
+        return false;
+
+    DMAC_REGS->CHANNEL[ch].DMAC_CHEVCTRL =
+        (action == DMAC_EVACT_NONE) ? 0u :
+        (uint8_t)(DMAC_CHEVCTRL_EVIE_Msk | DMAC_CHEVCTRL_EVACT(action));
+
+    return true;
+}
+
+/* ================= DESCRIPTORS ================= */
+dmac_desc_t *dmac_channel_descriptor(uint8_t ch)
+{
+    return &dmac_desc[ch];
+}
+
+/*
+ * Fill one transfer descriptor.
+ * src / dst are START addresses; the DMAC wants END addresses for
+ * incrementing pointers, that conversion is done here.
+ */
+void dmac_descriptor_fill(dmac_desc_t *desc,
+                          const volatile void *src,
+                          volatile void *dst,
+                          uint16_t beats,
+                          dmac_beat_t beat,
+                          uint8_t flags,
+                          const dmac_desc_t *next)
+{
+    uint32_t bytes = (uint32_t)beats << beat;
+    uint16_t btctrl = DMAC_BTCTRL_VALID_Msk | DMAC_BTCTRL_BEATSIZE(beat);
+
+    desc->srcaddr = (uint32_t)src;
+    desc->dstaddr = (uint32_t)dst;
+
+    if (flags & DMAC_DESC_SRCINC)
+    {
+        btctrl |= DMAC_BTCTRL_SRCINC_Msk;
+        desc->srcaddr += bytes;
+    }
+
+    if (flags & DMAC_DESC_DSTINC)
+    {
+        btctrl |= DMAC_BTCTRL_DSTINC_Msk;
+        desc->dstaddr += bytes;
+    }
+
+    if (flags & DMAC_DESC_INT)
+        btctrl |= DMAC_BTCTRL_BLOCKACT_INT;
+
+    desc->btcnt    = beats;
+    desc->descaddr = (uint32_t)next;
+    desc->btctrl   = btctrl;
+}
+
+/* ================= CONTROL ================= */
+void dmac_channel_enable(uint8_t ch)
+{
+    /* Seed write-back so remaining() is valid before the first beat */
+    dmac_wrb[ch].btcnt = dmac_desc[ch].btcnt;
+
+    __DSB();
+    DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA |= DMAC_CHCTRLA_ENABLE_Msk;
+}
+
+void dmac_channel_disable(uint8_t ch)
+{
+    DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA &= ~DMAC_CHCTRLA_ENABLE_Msk;
+    while (DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk);
+}
+
+void dmac_channel_trigger(uint8_t ch)
+{
+    DMAC_REGS->DMAC_SWTRIGCTRL = (1u << ch);
+}
+
+bool dmac_channel_busy(uint8_t ch)
+{
+    return (DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk) != 0u;
+}
+
+/*
+ * Beats left in the current block.
+ * The ACTIVE register holds the live count for the channel that owns
+ * the bus right now; every other channel is read from write-back.
+ */
+uint16_t dmac_channel_remaining(uint8_t ch)
+{
+    uint32_t active = DMAC_REGS->DMAC_ACTIVE;
+
+    if ((active & DMAC_ACTIVE_ABUSY_Msk) &&
+        ((active & DMAC_ACTIVE_ID_Msk) >> DMAC_ACTIVE_ID_Pos) == ch)
+    {
+        return (uint16_t)((active & DMAC_ACTIVE_BTCNT_Msk) >> DMAC_ACTIVE_BTCNT_Pos);
+    }
+
+    return dmac_wrb[ch].btcnt;
+}
+
+/* ================= COMMON ISR HANDLER ================= */
+static void DMACx_Handler(void)
+{
+    ISR_PROF_ENTER(prof);
+
+    uint32_t pending = DMAC_REGS->DMAC_INTSTATUS;
+
+    while (pending)
+    {
+        uint8_t ch = (uint8_t)__builtin_ctz(pending);
+        pending &= pending - 1u;
+
+        uint8_t flags = DMAC_REGS->CHANNEL[ch].DMAC_CHINTFLAG;
+        DMAC_REGS->CHANNEL[ch].DMAC_CHINTFLAG = flags;   /* clear */
+
+        if (!dmac_callbacks[ch])
+            continue;
+
+        if (flags & DMAC_CHINTFLAG_TERR_Msk)
+            dmac_callbacks[ch](ch, DMAC_XFER_ERROR, dmac_contexts[ch]);
+        else if (flags & DMAC_CHINTFLAG_TCMPL_Msk)
+            dmac_callbacks[ch](ch, DMAC_XFER_COMPLETE, dmac_contexts[ch]);
+        else if (flags & DMAC_CHINTFLAG_SUSP_Msk)
+            dmac_callbacks[ch](ch, DMAC_XFER_SUSPENDED, dmac_contexts[ch]);
+    }
+
+    ISR_PROF_EXIT(prof, ISR_PROF_ID_DMAC, ISR_PROF_NO_LATENCY);
+}
+
+/* ================= MAPPING ISR HANDLERS ================= */
+/* DMAC_0..3 serve channels 0..3, DMAC_4 serves channels 4..31 */
+void DMAC_0_Handler(void) { DMACx_Handler(); }
+void DMAC_1_Handler(void) { DMACx_Handler(); }
+void DMAC_2_Handler(void) { DMACx_Handler(); }
+void DMAC_3_Handler(void) { DMACx_Handler(); }
+void DMAC_4_Handler(void) { DMACx_Handler(); }
@@ -0,0 +1,120 @@
+#ifndef DMAC_DRV_H
+#define DMAC_DRV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= DMAC CONFIG ================= */
+#define DMAC_CH_MAX     32u     /* Channels implemented on PIC32CX SG */
+
+/*
+ * Trigger sources (DMAC CHCTRLA.TRIGSRC, datasheet trigger table)
+ * Only the ones used by drivers in this repo are listed.
+ */
+#define DMAC_TRIG_DISABLE       0x00u
+#define DMAC_TRIG_SERCOM_RX(n)  (0x04u + 2u * (n))   /* SERCOMn RX ready */
+#define DMAC_TRIG_SERCOM_TX(n)  (0x05u + 2u * (n))   /* SERCOMn TX empty */
+#define DMAC_TRIG_TC_OVF(n)     (0x2Cu + 3u * (n))   /* TCn overflow     */
+#define DMAC_TRIG_TC_MC(n, c)   (0x2Du + 3u * (n) + (c)) /* TCn match/capture c */
+
+/* ================= TRIGGER ACTION ================= */
+typedef enum
+{
+    DMAC_TRIGACT_BLOCK       = 0,   /* One block per trigger       */
+    DMAC_TRIGACT_BURST       = 2,   /* One burst per trigger       */
+    DMAC_TRIGACT_TRANSACTION = 3    /* Whole transaction per trigger */
+} dmac_trigact_t;
+
+/* ================= EVENT INPUT ACTION ================= */
+/* CHEVCTRL.EVACT: channels 0..7 only (EVSYS_USER_DMAC_CH) */
+typedef enum
+{
+    DMAC_EVACT_NONE    = 0,
+    DMAC_EVACT_TRIG    = 1,     /* Event acts as a transfer trigger  */
+    DMAC_EVACT_CTRIG   = 2,     /* Conditional trigger               */
+    DMAC_EVACT_CBLOCK  = 3,     /* Conditional block transfer        */
+    DMAC_EVACT_SUSPEND = 4,
+    DMAC_EVACT_RESUME  = 5,
+    DMAC_EVACT_SSKIP   = 6,     /* Skip the next block suspend       */
+    DMAC_EVACT_INCPRI  = 7      /* Raise the channel priority        */
+} dmac_evact_t;
+
+#define DMAC_EV_CH_MAX  8u      /* Channels with an event input */
+
+/* ================= BEAT SIZE ================= */
+typedef enum
+{
+    DMAC_BEAT_BYTE  = 0,
+    DMAC_BEAT_HWORD = 1,
+    DMAC_BEAT_WORD  = 2
+} dmac_beat_t;
+
+/* ================= DESCRIPTOR FLAGS ================= */
+#define DMAC_DESC_SRCINC    (1u << 0)   /* Increment source address      */
+#define DMAC_DESC_DSTINC    (1u << 1)   /* Increment destination address */
+#define DMAC_DESC_INT       (1u << 2)   /* Block-complete interrupt      */
+
+/* ================= TRANSFER STATUS ================= */
+typedef enum
+{
+    DMAC_XFER_COMPLETE = 0,     /* Block with DMAC_DESC_INT done          */
+    DMAC_XFER_ERROR,            /* Bus error / invalid descriptor         */
+    DMAC_XFER_SUSPENDED         /* Channel suspended                      */
+} dmac_xfer_status_t;
+
+typedef void (*dmac_callback_t)(uint8_t channel, dmac_xfer_status_t status, void *ctx);
+
+/* ================= TRANSFER DESCRIPTOR ================= */
+/*
+ * Same layout as the hardware descriptor. Descriptors must be 128-bit
+ * aligned and stay in SRAM for the whole transfer.
+ */
+typedef struct __attribute__((aligned(16)))
+{
+    volatile uint16_t btctrl;
+    volatile uint16_t btcnt;
+    volatile uint32_t srcaddr;      /* END address when SRCINC is set */
+    volatile uint32_t dstaddr;      /* END address when DSTINC is set */
+    volatile uint32_t descaddr;     /* Next descriptor, 0 = last      */
+} dmac_desc_t;
+
+/* ================= API ================= */
+void dmac_init(void);
+
+/* Channel allocation (returns -1 when none free) */
+int8_t dmac_channel_alloc(void);
+void dmac_channel_free(uint8_t ch);
+
+void dmac_channel_setup(uint8_t ch,
+                        uint8_t trigsrc,
+                        dmac_trigact_t trigact,
+                        uint8_t priority);
+
+void dmac_channel_register_callback(uint8_t ch, dmac_callback_t callback, void *ctx);
+
+/*
+ * Event input of a channel (after dmac_channel_setup(), which clears
+ * it). DMAC_EVACT_TRIG with DMAC_TRIG_DISABLE lets an EVSYS event
+ * trigger the channel like a peripheral would. false if the channel
+ * has no event input.
+ */
+bool dmac_channel_set_event_input(uint8_t ch, dmac_evact_t action);
+
+/* Descriptors */
+dmac_desc_t *dmac_channel_descriptor(uint8_t ch);  /* First descriptor of a channel */
+void dmac_descriptor_fill(dmac_desc_t *desc,
+                          const volatile void *src,
+                          volatile void *dst,
+                          uint16_t beats,
+                          dmac_beat_t beat,
+                          uint8_t flags,
+                          const dmac_desc_t *next);
+
+/* Control */
+void dmac_channel_enable(uint8_t ch);
+void dmac_channel_disable(uint8_t ch);
+void dmac_channel_trigger(uint8_t ch);      /* Software trigger */
+bool dmac_channel_busy(uint8_t ch);
+uint16_t dmac_channel_remaining(uint8_t ch);
+
+#endif /* DMAC_DRV_H */
@@ -0,0 +1,383 @@
+#include "eic_drv.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+#include "irq_mgr.h"
+#include "isr_prof.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * External interrupt controller.
+ *
+ * Each EXTINT line has its own vector. The handler clears the flag,
+ * reads the pin level, optionally pushes { timestamp, line, level }
+ * into the event queue and calls the line callback.
+ *
+ * Queue: the EXTINT vectors share one NVIC priority, so only one
+ * line handler runs at a time and it is the only writer of q_head;
+ * thread code is the only writer of q_tail. Both indices run freely
+ * and are masked on access, so neither side needs a lock.
+ */
+
+/* ================= MACROS ================= */
+#define EIC_GCLK_ID             4u
+#define EIC_PMUX_A              0u      /* Peripheral function A */
+
+#define EIC_CONFIG_SHIFT(line)  (((line) & 7u) * 4u)
+#define EIC_CONFIG_FILTEN       0x8u
+#define EIC_CONFIG_MASK         0xFu
+
+#define EIC_LINE_VALID(line)    ((line) < EIC_LINES)
+
+/* ================= STATE ================= */
+typedef struct
+{
+    gpio_port_id_t  port;
+    uint8_t         pin;
+    bool            attached;
+    bool            queued;
+    eic_callback_t  callback;
+    void           *ctx;
+} eic_line_t;
+
+static eic_line_t eic_lines[EIC_LINES] = {0};
+static bool eic_ready = false;
+
+static eic_event_t *q_buf = 0;
+static uint32_t q_mask = 0;
+static volatile uint32_t q_head = 0;    /* Written by the ISRs   */
+static volatile uint32_t q_tail = 0;    /* Written by the reader */
+static volatile uint32_t q_dropped = 0;
+static eic_notify_t q_notify = 0;
+static void *q_notify_ctx = 0;
+
+/* ================= LOCAL HELPERS ================= */
+
+static void eic_set_enabled(bool enable)
+{
+    if (enable)
+        EIC_REGS->EIC_CTRLA |= EIC_CTRLA_ENABLE_Msk;
+    else
+        EIC_REGS->EIC_CTRLA &= ~EIC_CTRLA_ENABLE_Msk;
+
+    while (EIC_REGS->EIC_SYNCBUSY & EIC_SYNCBUSY_ENABLE_Msk);
+}
+
+static void eic_pin_mux(gpio_port_id_t port, uint8_t pin, uint32_t flags)
+{
+    port_group_registers_t *group = &PORT_REGS->GROUP[port];
+    uint8_t cfg = PORT_PINCFG_PMUXEN_Msk | PORT_PINCFG_INEN_Msk;
+
+    group->PORT_DIRCLR = (1u << pin);
+
+    if (flags & (EIC_FLAG_PULLUP | EIC_FLAG_PULLDOWN))
+    {
+        cfg |= PORT_PINCFG_PULLEN_Msk;
+
+        if (flags & EIC_FLAG_PULLUP)
+            group->PORT_OUTSET = (1u << pin);
+        else
+            group->PORT_OUTCLR = (1u << pin);
+    }
+
+    if (pin & 1u)
+        group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0x0Fu) |
+                                     (uint8_t)(EIC_PMUX_A << 4);
+    else
+        group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0xF0u) |
+                                     (uint8_t)EIC_PMUX_A;
+
+    group->PORT_PINCFG[pin] = cfg;
+}
+
+static inline bool eic_pin_level(const eic_line_t *l, uint8_t line)
+{
+    if (EIC_REGS->EIC_DEBOUNCEN & (1u << line))
+        return (EIC_REGS->EIC_PINSTATE >> line) & 1u;
+
+    return (PORT_REGS->GROUP[l->port].PORT_IN >> l->pin) & 1u;
+}
+
+static void eic_queue_push(uint8_t line, bool level)
+{
+    uint32_t head = q_head;
+
+    if (head - q_tail > q_mask)
+    {
+        q_dropped++;
+        return;
+    }
+
+    eic_event_t *ev = &q_buf[head & q_mask];
+    ev->timestamp = timebase_now();
+    ev->line      = line;
+    ev->level     = level;
+
+    __DMB();
+    q_head = head + 1u;
+
+    /* First event of a burst wakes the consumer */
+    if (head == q_tail && q_notify)
+        q_notify(q_notify_ctx);
+}
+
+/* ================= INITIALIZATION ================= */
+void eic_init(void)
+{
+    MCLK_REGS->MCLK_APBAMASK |= MCLK_APBAMASK_EIC_Msk;
+    (void)clock_periph_enable(EIC_GCLK_ID, EIC_GCLK_GEN);
+
+    EIC_REGS->EIC_CTRLA = EIC_CTRLA_SWRST_Msk;
+    while (EIC_REGS->EIC_SYNCBUSY & EIC_SYNCBUSY_SWRST_Msk);
+
+    /* CKSEL = 0: edge detection on GCLK_EIC */
+    EIC_REGS->EIC_INTENCLR = 0xFFFFu;
+    EIC_REGS->EIC_INTFLAG  = 0xFFFFu;
+
+    for (uint8_t line = 0; line < EIC_LINES; line++)
+    {
+        IRQn_Type irq = (IRQn_Type)(EIC_EXTINT_0_IRQn + line);
+
+        eic_lines[line].attached = false;
+        NVIC_ClearPendingIRQ(irq);
+        irq_enable(irq, EIC_IRQ_PRIORITY);
+    }
+
+    eic_set_debounce_us(5000);
+    eic_set_enabled(true);
+    eic_ready = true;
+}
+
+/* ================= LINE CONFIGURATION ================= */
+bool eic_attach(gpio_port_id_t port,
+                uint8_t pin,
+                uint8_t line,
+                eic_sense_t sense,
+                uint32_t flags,
+                eic_callback_t callback,
+                void *ctx)
+{
+    if (!EIC_LINE_VALID(line) || pin >= 32u)
+        return false;
+
+    if (!eic_ready)
+        eic_init();
+
+    eic_disable_line(line);
+
+    eic_line_t *l = &eic_lines[line];
+    l->port     = port;
+    l->pin      = pin;
+    l->queued   = (flags & EIC_FLAG_QUEUE) != 0u;
+    l->callback = callback;
+    l->ctx      = ctx;
+    l->attached = true;
+
+    uint32_t cfg = (uint32_t)sense;
+    if (flags & EIC_FLAG_FILTER)
+        cfg |= EIC_CONFIG_FILTEN;
+
+    /* CONFIG, DEBOUNCEN and ASYNCH are enable-protected */
+    uint32_t basepri = irq_lock();
+
+    eic_set_enabled(false);
+
+    uint32_t shift = EIC_CONFIG_SHIFT(line);
+    EIC_REGS->EIC_CONFIG[line >> 3] = (EIC_REGS->EIC_CONFIG[line >> 3] &
+                                       ~(EIC_CONFIG_MASK << shift)) | (cfg << shift);
+
+    if (flags & EIC_FLAG_DEBOUNCE)
+        EIC_REGS->EIC_DEBOUNCEN |= (1u << line);
+    else
+        EIC_REGS->EIC_DEBOUNCEN &= ~(1u << line);
+
+    EIC_REGS->EIC_ASYNCH &= ~(1u << line);
+
+    eic_set_enabled(true);
+
+    irq_unlock(basepri);
+
+    eic_pin_mux(port, pin, flags);
+
+    EIC_REGS->EIC_INTFLAG = (1u << line);
+    eic_enable_line(line);
+
+    return true;
+}
+
+void eic_detach(uint8_t line)
+{
+    if (!EIC_LINE_VALID(line) || !eic_lines[line].attached)
+        return;
+
+    eic_line_t *l = &eic_lines[line];
+
+    eic_disable_line(line);
+
+    uint32_t basepri = irq_lock();
+
+    eic_set_enabled(false);
+    EIC_REGS->EIC_CONFIG[line >> 3] &= ~(EIC_CONFIG_MASK << EIC_CONFIG_SHIFT(line));
+    EIC_REGS->EIC_DEBOUNCEN &= ~(1u << line);
+    EIC_REGS->EIC_EVCTRL &= ~(1u << line);
+    eic_set_enabled(true);
+
+    irq_unlock(basepri);
+
+    /* Plain GPIO input again */
+    PORT_REGS->GROUP[l->port].PORT_PINCFG[l->pin] = PORT_PINCFG_INEN_Msk;
+
+    l->attached = false;
+    l->callback = 0;
+}
+
+void eic_enable_line(uint8_t line)
+{
+    if (EIC_LINE_VALID(line))
+        EIC_REGS->EIC_INTENSET = (1u << line);
+}
+
+void eic_disable_line(uint8_t line)
+{
+    if (EIC_LINE_VALID(line))
+        EIC_REGS->EIC_INTENCLR = (1u << line);
+}
+
+void eic_event_output_enable(uint8_t line, bool enable)
+{
+    if (!EIC_LINE_VALID(line))
+        return;
+
+    /* EVCTRL is enable-protected */
+    uint32_t basepri = irq_lock();
+
+    eic_set_enabled(false);
+
+    if (enable)
+        EIC_REGS->EIC_EVCTRL |= (1u << line);
+    else
+        EIC_REGS->EIC_EVCTRL &= ~(1u << line);
+
+    eic_set_enabled(true);
+
+    irq_unlock(basepri);
+}
+
+bool eic_read_line(uint8_t line)
+{
+    if (!EIC_LINE_VALID(line) || !eic_lines[line].attached)
+        return false;
+
+    return eic_pin_level(&eic_lines[line], line);
+}
+
+/* ================= DEBOUNCE ================= */
+void eic_set_debounce_us(uint32_t us)
+{
+    uint32_t n = 0;
+
+    /* 7 samples × 2^(n+1) / 32768 Hz */
+    while (n < 7u && (7ULL * (2UL << n) * 1000000ULL) / 32768u < us)
+        n++;
+
+    uint32_t basepri = irq_lock();
+
+    bool was_enabled = (EIC_REGS->EIC_CTRLA & EIC_CTRLA_ENABLE_Msk) != 0u;
+    if (was_enabled)
+        eic_set_enabled(false);
+
+    EIC_REGS->EIC_DPRESCALER = EIC_DPRESCALER_TICKON_Msk |
+                               EIC_DPRESCALER_PRESCALER0(n) | EIC_DPRESCALER_STATES0_Msk |
+                               EIC_DPRESCALER_PRESCALER1(n) | EIC_DPRESCALER_STATES1_Msk;
+
+    if (was_enabled)
+        eic_set_enabled(true);
+
+    irq_unlock(basepri);
+}
+
+/* ================= EVENT QUEUE ================= */
+bool eic_queue_init(eic_event_t *buf, uint32_t len, eic_notify_t notify, void *ctx)
+{
+    if (!buf || len == 0u || (len & (len - 1u)))
+        return false;
+
+    uint32_t basepri = irq_lock();
+
+    q_buf        = buf;
+    q_mask       = len - 1u;
+    q_head       = 0;
+    q_tail       = 0;
+    q_dropped    = 0;
+    q_notify     = notify;
+    q_notify_ctx = ctx;
+
+    irq_unlock(basepri);
+    return true;
+}
+
+uint32_t eic_queue_read(eic_event_t *events, uint32_t max)
+{
+    uint32_t tail = q_tail;
+    uint32_t n = q_head - tail;
+
+    if (n > max)
+        n = max;
+
+    __DMB();
+
+    for (uint32_t i = 0; i < n; i++)
+        events[i] = q_buf[(tail + i) & q_mask];
+
+    __DMB();
+    q_tail = tail + n;
+
+    return n;
+}
+
+uint32_t eic_queue_count(void)
+{
+    return q_head - q_tail;
+}
+
+uint32_t eic_queue_dropped(void)
+{
+    return q_dropped;
+}
+
+/* ================= COMMON ISR HANDLER ================= */
+static void eic_line_handler(uint8_t line)
+{
+    ISR_PROF_ENTER(prof);
+
+    eic_line_t *l = &eic_lines[line];
+
+    EIC_REGS->EIC_INTFLAG = (1u << line);
+
+    bool level = eic_pin_level(l, line);
+
+    if (l->queued && q_buf)
+        eic_queue_push(line, level);
+
+    if (l->callback)
+        l->callback(line, level, l->ctx);
+
+    ISR_PROF_EXIT(prof, ISR_PROF_ID_EIC, ISR_PROF_NO_LATENCY);
+}
+
+/* ================= MAPPING ISR HANDLERS ================= */
+void EIC_EXTINT_0_Handler(void)  { eic_line_handler(0); }
+void EIC_EXTINT_1_Handler(void)  { eic_line_handler(1); }
+void EIC_EXTINT_2_Handler(void)  { eic_line_handler(2); }
+void EIC_EXTINT_3_Handler(void)  { eic_line_handler(3); }
+void EIC_EXTINT_4_Handler(void)  { eic_line_handler(4); }
+void EIC_EXTINT_5_Handler(void)  { eic_line_handler(5); }
+void EIC_EXTINT_6_Handler(void)  { eic_line_handler(6); }
+void EIC_EXTINT_7_Handler(void)  { eic_line_handler(7); }
+void EIC_EXTINT_8_Handler(void)  { eic_line_handler(8); }
+void EIC_EXTINT_9_Handler(void)  { eic_line_handler(9); }
+void EIC_EXTINT_10_Handler(void) { eic_line_handler(10); }
+void EIC_EXTINT_11_Handler(void) { eic_line_handler(11); }
+void EIC_EXTINT_12_Handler(void) { eic_line_handler(12); }
+void EIC_EXTINT_13_Handler(void) { eic_line_handler(13); }
+void EIC_EXTINT_14_Handler(void) { eic_line_handler(14); }
+void EIC_EXTINT_15_Handler(void) { eic_line_handler(15); }
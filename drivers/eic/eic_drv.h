@@ -0,0 +1,123 @@
+#ifndef EIC_DRV_H
+#define EIC_DRV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_drv.h"
+#include "irq_mgr.h"
+
+/* ================= EIC CONFIG ================= */
+#define EIC_LINES               16u
+
+/*
+ * EXTINT line of a pin: EXTINT[pin % 16] for most pins. Check the
+ * pinout table for the exceptions (e.g. PA08 is NMI) and pass the
+ * line explicitly where it differs.
+ */
+#define EIC_LINE_FOR_PIN(pin)   ((uint8_t)((pin) & 15u))
+
+/* Generator clocking edge detection (48 MHz: pulses down to ~40 ns) */
+#ifndef EIC_GCLK_GEN
+#define EIC_GCLK_GEN            1u
+#endif
+
+/*
+ * NVIC priority of all 16 EXTINT vectors. They must stay equal: the
+ * event queue has a single producer because line handlers never
+ * preempt each other.
+ */
+#ifndef EIC_IRQ_PRIORITY
+#define EIC_IRQ_PRIORITY        IRQ_PRIO_EIC
+#endif
+
+/* ================= TYPES ================= */
+typedef enum
+{
+    EIC_SENSE_NONE = 0,
+    EIC_SENSE_RISE = 1,
+    EIC_SENSE_FALL = 2,
+    EIC_SENSE_BOTH = 3,
+    EIC_SENSE_HIGH = 4,     /* Level: disable the line in the callback */
+    EIC_SENSE_LOW  = 5
+} eic_sense_t;
+
+/* eic_attach() flags */
+#define EIC_FLAG_FILTER         (1u << 0)   /* 3-sample majority filter      */
+#define EIC_FLAG_DEBOUNCE       (1u << 1)   /* Debouncer, eic_set_debounce_us */
+#define EIC_FLAG_QUEUE          (1u << 2)   /* Push timestamped edge events  */
+#define EIC_FLAG_PULLUP         (1u << 3)
+#define EIC_FLAG_PULLDOWN       (1u << 4)
+
+/* Runs in the EXTINT interrupt; level = pin state after the edge */
+typedef void (*eic_callback_t)(uint8_t line, bool level, void *ctx);
+
+typedef struct
+{
+    uint64_t timestamp;     /* timebase_now() ticks */
+    uint8_t  line;
+    uint8_t  level;
+} eic_event_t;
+
+/* Called from the ISR when the queue goes from empty to non-empty */
+typedef void (*eic_notify_t)(void *ctx);
+
+/* ================= EIC PUBLIC API ================= */
+
+/* Clock the EIC and enable it with all lines off */
+void eic_init(void);
+
+/*
+ * Route port/pin to EXTINT line, set its sense and flags and enable
+ * its interrupt. callback may be 0 when only the queue is used.
+ *
+ * The EIC is briefly disabled to rewrite its enable-protected
+ * configuration: edges on other lines during that window are missed.
+ */
+bool eic_attach(gpio_port_id_t port,
+                uint8_t pin,
+                uint8_t line,
+                eic_sense_t sense,
+                uint32_t flags,
+                eic_callback_t callback,
+                void *ctx);
+
+/* Stop the line and give the pin back to GPIO */
+void eic_detach(uint8_t line);
+
+void eic_enable_line(uint8_t line);
+void eic_disable_line(uint8_t line);
+
+/*
+ * Also emit the line's edges as an EVSYS event (EVSYS_GEN_EIC_EXTINT).
+ * The event follows the sense, filter and debounce settings; call
+ * eic_disable_line() when only the event is wanted, not the interrupt.
+ */
+void eic_event_output_enable(uint8_t line, bool enable);
+
+/* Current pin state (debounced for debounced lines) */
+bool eic_read_line(uint8_t line);
+
+/*
+ * Debounce time for EIC_FLAG_DEBOUNCE lines: 7 stable samples of the
+ * 32 kHz low-power clock, prescaled to cover at least us
+ * (0.43 ms .. 55 ms). Applies to all lines.
+ */
+void eic_set_debounce_us(uint32_t us);
+
+/* ================= EVENT QUEUE ================= */
+
+/*
+ * Lock-free single-producer (EXTINT ISRs) / single-consumer queue.
+ * len must be a power of two. Requires timebase_init().
+ */
+bool eic_queue_init(eic_event_t *buf, uint32_t len, eic_notify_t notify, void *ctx);
+
+/* Copy up to max events out, oldest first; returns the count */
+uint32_t eic_queue_read(eic_event_t *events, uint32_t max);
+
+uint32_t eic_queue_count(void);
+
+/* Events lost because the queue was full */
+uint32_t eic_queue_dropped(void);
+
+#endif /* EIC_DRV_H */
@@ -0,0 +1,186 @@
+#include "evsys_drv.h"
+#include "clock_mgr.h"
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Event system.
+ *
+ *   generator ──EVGEN──► CHANNEL[n] ──USER[m] = n + 1──► user
+ *
+ * A channel carries one generator to any number of users without the
+ * CPU: a TC capture started by an EIC edge, a DMA beat triggered by a
+ * TC match, an ADC conversion started by the RTC. Channels 0..11 have
+ * a GCLK and support the synchronous / resynchronized paths (edge
+ * detection, software events, busy status); the GCLK channel is only
+ * requested while such a channel is connected. The asynchronous path
+ * works on every channel and adds no latency, but passes the
+ * generator level through unchanged.
+ */
+
+/* ================= MACROS ================= */
+#define EVSYS_GCLK_ID(ch)       (11u + (ch))
+#define EVSYS_CH_VALID(ch)      ((ch) < EVSYS_CH_MAX)
+
+/* ================= STATE ================= */
+static uint32_t evsys_alloc_mask = 0;
+static uint32_t evsys_clocked = 0;      /* Channels holding their GCLK */
+
+/* ================= LOCAL HELPERS ================= */
+
+static void evsys_channel_clock(uint8_t ch, bool enable)
+{
+    uint32_t bit = 1u << ch;
+
+    if (enable && !(evsys_clocked & bit))
+    {
+        (void)clock_periph_enable(EVSYS_GCLK_ID(ch), EVSYS_GCLK_GEN);
+        evsys_clocked |= bit;
+    }
+    else if (!enable && (evsys_clocked & bit))
+    {
+        clock_periph_disable(EVSYS_GCLK_ID(ch));
+        evsys_clocked &= ~bit;
+    }
+}
+
+/* ================= INITIALIZATION ================= */
+void evsys_init(void)
+{
+    /* EVSYS runs on the APB clock, channel GCLKs are requested per channel */
+    MCLK_REGS->MCLK_APBBMASK |= MCLK_APBBMASK_EVSYS_Msk;
+
+    EVSYS_REGS->EVSYS_CTRLA = EVSYS_CTRLA_SWRST_Msk;
+    while (EVSYS_REGS->EVSYS_CTRLA & EVSYS_CTRLA_SWRST_Msk);
+
+    for (uint8_t ch = 0; ch < EVSYS_SYNC_CH_MAX; ch++)
+        evsys_channel_clock(ch, false);
+
+    evsys_alloc_mask = 0;
+}
+
+/* ================= CHANNEL ALLOCATION ================= */
+int8_t evsys_channel_alloc(bool sync)
+{
+    uint8_t first = sync ? 0u : EVSYS_SYNC_CH_MAX;
+    int8_t ch = -1;
+
+    uint32_t basepri = irq_lock();
+
+    /* Asynchronous requests take the clockless channels first */
+    for (uint8_t n = 0; n < EVSYS_CH_MAX; n++)
+    {
+        uint8_t i = (uint8_t)((first + n) % EVSYS_CH_MAX);
+
+        if (sync && i >= EVSYS_SYNC_CH_MAX)
+            break;
+
+        if (!(evsys_alloc_mask & (1u << i)))
+        {
+            evsys_alloc_mask |= (1u << i);
+            ch = (int8_t)i;
+            break;
+        }
+    }
+
+    irq_unlock(basepri);
+
+    return ch;
+}
+
+void evsys_channel_free(uint8_t ch)
+{
+    if (!EVSYS_CH_VALID(ch))
+        return;
+
+    /* Users still pointing at the channel see no more events */
+    for (uint8_t user = 0; user < EVSYS_USER_MAX; user++)
+    {
+        if (EVSYS_REGS->EVSYS_USER[user] == (uint32_t)(ch + 1u))
+            EVSYS_REGS->EVSYS_USER[user] = 0;
+    }
+
+    EVSYS_REGS->CHANNEL[ch].EVSYS_CHANNEL = EVSYS_CHANNEL_ONDEMAND_Msk;
+    EVSYS_REGS->CHANNEL[ch].EVSYS_CHINTENCLR = EVSYS_CHINTENCLR_Msk;
+    evsys_channel_clock(ch, false);
+
+    uint32_t basepri = irq_lock();
+    evsys_alloc_mask &= ~(1u << ch);
+    irq_unlock(basepri);
+}
+
+/* ================= ROUTING ================= */
+bool evsys_channel_connect(uint8_t ch, uint8_t generator, evsys_path_t path, evsys_edge_t edge)
+{
+    if (!EVSYS_CH_VALID(ch))
+        return false;
+
+    /* Only channels 0..11 have a clock; async passes levels, no edges */
+    if (path != EVSYS_PATH_ASYNC && ch >= EVSYS_SYNC_CH_MAX)
+        return false;
+    if (path == EVSYS_PATH_ASYNC && edge != EVSYS_EDGE_NONE)
+        return false;
+
+    /* Clock first: the channel must not see a generator edge unclocked */
+    if (path != EVSYS_PATH_ASYNC)
+        evsys_channel_clock(ch, true);
+
+    EVSYS_REGS->CHANNEL[ch].EVSYS_CHANNEL =
+        EVSYS_CHANNEL_EVGEN(generator) |
+        EVSYS_CHANNEL_PATH(path) |
+        EVSYS_CHANNEL_EDGSEL(edge) |
+        EVSYS_CHANNEL_ONDEMAND_Msk;
+
+    if (path == EVSYS_PATH_ASYNC)
+        evsys_channel_clock(ch, false);
+
+    return true;
+}
+
+bool evsys_user_attach(uint8_t user, uint8_t ch)
+{
+    if (user >= EVSYS_USER_MAX || !EVSYS_CH_VALID(ch))
+        return false;
+
+    EVSYS_REGS->EVSYS_USER[user] = EVSYS_USER_CHANNEL(ch + 1u);
+    return true;
+}
+
+void evsys_user_detach(uint8_t user)
+{
+    if (user < EVSYS_USER_MAX)
+        EVSYS_REGS->EVSYS_USER[user] = 0;
+}
+
+int8_t evsys_route(uint8_t generator, uint8_t user, evsys_path_t path, evsys_edge_t edge)
+{
+    int8_t ch = evsys_channel_alloc(path != EVSYS_PATH_ASYNC);
+    if (ch < 0)
+        return -1;
+
+    if (!evsys_channel_connect((uint8_t)ch, generator, path, edge) ||
+        !evsys_user_attach(user, (uint8_t)ch))
+    {
+        evsys_channel_free((uint8_t)ch);
+        return -1;
+    }
+
+    return ch;
+}
+
+/* ================= CONTROL ================= */
+void evsys_software_event(uint8_t ch)
+{
+    if (ch < EVSYS_SYNC_CH_MAX)
+        EVSYS_REGS->EVSYS_SWEVT = (1u << ch);
+}
+
+bool evsys_channel_ready(uint8_t ch)
+{
+    if (ch >= EVSYS_SYNC_CH_MAX)
+        return true;    /* Async: no handshake, always ready */
+
+    uint8_t status = EVSYS_REGS->CHANNEL[ch].EVSYS_CHSTATUS;
+
+    return (status & EVSYS_CHSTATUS_RDYUSR_Msk) && !(status & EVSYS_CHSTATUS_BUSYCH_Msk);
+}
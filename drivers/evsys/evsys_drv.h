@@ -0,0 +1,95 @@
+#ifndef EVSYS_DRV_H
+#define EVSYS_DRV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= EVSYS CONFIG ================= */
+#define EVSYS_CH_MAX            32u
+#define EVSYS_SYNC_CH_MAX       12u     /* Channels 0..11 have a GCLK: sync / resync paths */
+
+/* Generator clock for synchronous / resynchronized channels */
+#ifndef EVSYS_GCLK_GEN
+#define EVSYS_GCLK_GEN          1u
+#endif
+
+/*
+ * Generators (CHANNEL.EVGEN, datasheet generator table).
+ * Only the ones with drivers in this repo are listed.
+ */
+#define EVSYS_GEN_NONE              0x00u
+#define EVSYS_GEN_RTC_PER(n)        (0x04u + (n))       /* n = 0..7: 1024 Hz / 2^(7-n) ... */
+#define EVSYS_GEN_RTC_CMP(n)        (0x0Cu + (n))
+#define EVSYS_GEN_RTC_OVF           0x11u
+#define EVSYS_GEN_EIC_EXTINT(n)     (0x12u + (n))       /* n = 0..15 */
+#define EVSYS_GEN_DMAC_CH(n)        (0x22u + (n))       /* n = 0..3  */
+#define EVSYS_GEN_TC_OVF(n)         (0x49u + 3u * (n))
+#define EVSYS_GEN_TC_MC(n, c)       (0x4Au + 3u * (n) + (c))
+#define EVSYS_GEN_PDEC_OVF          0x61u
+#define EVSYS_GEN_PDEC_ERR          0x62u
+#define EVSYS_GEN_PDEC_DIR          0x63u
+#define EVSYS_GEN_PDEC_VLC          0x64u
+#define EVSYS_GEN_PDEC_MC(c)        (0x65u + (c))
+#define EVSYS_GEN_ADC_RESRDY(n)     (0x67u + 2u * (n))  /* ADC0 / ADC1   */
+#define EVSYS_GEN_ADC_WINMON(n)     (0x68u + 2u * (n))
+
+/*
+ * Users (USER[] index, datasheet user table). 13 is TAL BRK, 14..16
+ * CM4 trace, 17..43 the TCC EV / MC inputs.
+ */
+#define EVSYS_USER_RTC_TAMPER       0u
+#define EVSYS_USER_PORT_EV(n)       (1u + (n))          /* n = 0..3  */
+#define EVSYS_USER_DMAC_CH(n)       (5u + (n))          /* n = 0..7  */
+#define EVSYS_USER_TC(n)            (44u + (n))         /* TCn EVU   */
+#define EVSYS_USER_PDEC_EVU(n)      (52u + (n))         /* n = 0..2  */
+#define EVSYS_USER_ADC_START(n)     (55u + 2u * (n))
+#define EVSYS_USER_ADC_SYNC(n)      (56u + 2u * (n))
+#define EVSYS_USER_MAX              67u
+
+/* ================= PATH / EDGE ================= */
+typedef enum
+{
+    EVSYS_PATH_SYNC    = 0,     /* Generator on the channel GCLK           */
+    EVSYS_PATH_RESYNC  = 1,     /* Resynchronized to the channel GCLK      */
+    EVSYS_PATH_ASYNC   = 2      /* No clock, no latency, no edge detection */
+} evsys_path_t;
+
+typedef enum
+{
+    EVSYS_EDGE_NONE    = 0,     /* Required for the asynchronous path */
+    EVSYS_EDGE_RISING  = 1,
+    EVSYS_EDGE_FALLING = 2,
+    EVSYS_EDGE_BOTH    = 3
+} evsys_edge_t;
+
+/* ================= API ================= */
+void evsys_init(void);
+
+/*
+ * Channel allocation. sync = true asks for one of channels 0..11
+ * (needed for the sync / resync paths and software events).
+ * Returns -1 when none is free.
+ */
+int8_t evsys_channel_alloc(bool sync);
+void evsys_channel_free(uint8_t ch);
+
+/* Select the generator feeding a channel */
+bool evsys_channel_connect(uint8_t ch, uint8_t generator, evsys_path_t path, evsys_edge_t edge);
+
+/* Attach / detach a user to a channel (one channel per user) */
+bool evsys_user_attach(uint8_t user, uint8_t ch);
+void evsys_user_detach(uint8_t user);
+
+/*
+ * Allocate a channel and wire generator → user in one call.
+ * Returns the channel or -1.
+ */
+int8_t evsys_route(uint8_t generator, uint8_t user, evsys_path_t path, evsys_edge_t edge);
+
+/* Software event on a channel (sync / resync channels only) */
+void evsys_software_event(uint8_t ch);
+
+/* All users of a sync / resync channel ready for the next event */
+bool evsys_channel_ready(uint8_t ch);
+
+#endif /* EVSYS_DRV_H */
@@ -35,7 +35,7 @@ void gpio_write_high(gpio_port_id_t port, uint8_t pin)
     if (!GPIO_PIN_VALID(pin))
         return;
 
-    PORT_REGS->GROUP[port].PORT_OUTSET = (1u << pin);
+    GPIO_FAST_REGS->GROUP[port].PORT_OUTSET = (1u << pin);
 }
 
 /* ---------------------------------------------------------
@@ -46,7 +46,7 @@ void gpio_write_low(gpio_port_id_t port, uint8_t pin)
     if (!GPIO_PIN_VALID(pin))
         return;
 
-    PORT_REGS->GROUP[port].PORT_OUTCLR = (1u << pin);
+    GPIO_FAST_REGS->GROUP[port].PORT_OUTCLR = (1u << pin);
 }
 
 /* ---------------------------------------------------------
@@ -57,7 +57,7 @@ void gpio_write_toggle(gpio_port_id_t port, uint8_t pin)
     if (!GPIO_PIN_VALID(pin))
         return;
 
-    PORT_REGS->GROUP[port].PORT_OUTTGL = (1u << pin);
+    GPIO_FAST_REGS->GROUP[port].PORT_OUTTGL = (1u << pin);
 }
 
 /* ---------------------------------------------------------
@@ -70,3 +70,82 @@ bool gpio_read_pin(gpio_port_id_t port, uint8_t pin)
 
     return ((PORT_REGS->GROUP[port].PORT_IN >> pin) & 0x1u) != 0u;
 }
+
+/* ---------------------------------------------------------
+ * Configure all pins in mask
+ * --------------------------------------------------------- */
+void gpio_port_configure(gpio_port_id_t port,
+                         uint32_t mask,
+                         gpio_direction_t direction)
+{
+    port_group_registers_t *group = &PORT_REGS->GROUP[port];
+
+    if (direction == GPIO_DIR_OUTPUT)
+    {
+        group->PORT_DIRSET = mask;
+        return;
+    }
+
+    group->PORT_DIRCLR = mask;
+
+    /*
+     * WRCONFIG writes PINCFG of up to 16 pins at once: low half, then
+     * HWSEL for pins 16..31. PMUXEN/PULLEN/DRVSTR are written as 0.
+     */
+    if (mask & 0x0000FFFFu)
+    {
+        group->PORT_WRCONFIG = PORT_WRCONFIG_WRPINCFG_Msk |
+                               PORT_WRCONFIG_INEN_Msk |
+                               PORT_WRCONFIG_PINMASK(mask & 0xFFFFu);
+    }
+
+    if (mask & 0xFFFF0000u)
+    {
+        group->PORT_WRCONFIG = PORT_WRCONFIG_HWSEL_Msk |
+                               PORT_WRCONFIG_WRPINCFG_Msk |
+                               PORT_WRCONFIG_INEN_Msk |
+                               PORT_WRCONFIG_PINMASK(mask >> 16);
+    }
+}
+
+/* ---------------------------------------------------------
+ * Input sampling mode (PORT CTRL.SAMPLING)
+ * --------------------------------------------------------- */
+void gpio_port_set_sampling(gpio_port_id_t port, uint32_t mask, bool continuous)
+{
+    if (continuous)
+        PORT_REGS->GROUP[port].PORT_CTRL |= mask;
+    else
+        PORT_REGS->GROUP[port].PORT_CTRL &= ~mask;
+}
+
+/* ---------------------------------------------------------
+ * Parallel bus of adjacent pins
+ * --------------------------------------------------------- */
+void gpio_bus_init(gpio_bus_t *bus,
+                   gpio_port_id_t port,
+                   uint8_t first_pin,
+                   uint8_t width,
+                   gpio_direction_t direction)
+{
+    if (width == 0u || !GPIO_PIN_VALID(first_pin) || (first_pin + width) > 32u)
+    {
+        bus->mask = 0;
+        return;
+    }
+
+    bus->port  = port;
+    bus->shift = first_pin;
+    bus->mask  = (width == 32u) ? 0xFFFFFFFFu : (((1UL << width) - 1u) << first_pin);
+
+    gpio_bus_set_direction(bus, direction);
+}
+
+void gpio_bus_set_direction(const gpio_bus_t *bus, gpio_direction_t direction)
+{
+    gpio_port_configure(bus->port, bus->mask, direction);
+
+    /* gpio_bus_read() may go through IOBUS: keep the bus pins sampled */
+    if (direction == GPIO_DIR_INPUT)
+        gpio_port_set_sampling(bus->port, bus->mask, true);
+}
@@ -3,6 +3,31 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <xc.h>
+
+/* ================= GPIO CONFIG ================= */
+
+/*
+ * Port-wide fast path through the Cortex-M4 IOBUS alias of PORT:
+ * single-cycle loads/stores instead of an AHB-APB bridge access.
+ * Set to 0 to go through the APB PORT_REGS instead (e.g. when
+ * comparing, or if the alias is not mapped on a derivative).
+ */
+#ifndef GPIO_USE_IOBUS
+#define GPIO_USE_IOBUS      1
+#endif
+
+#ifndef GPIO_IOBUS_BASE
+#define GPIO_IOBUS_BASE     0x60000000UL
+#endif
+
+#if GPIO_USE_IOBUS
+#define GPIO_FAST_REGS      ((port_registers_t *)GPIO_IOBUS_BASE)
+#else
+#define GPIO_FAST_REGS      PORT_REGS
+#endif
+
+#define GPIO_PIN_MASK(pin)  (1UL << (pin))
 
 /*
  * GPIO Port Index
@@ -16,6 +41,12 @@ typedef enum
     GPIO_PORT3
 } gpio_port_id_t;
 
+/* Datasheet names: PAxx = GPIO_PORT_A, ... */
+#define GPIO_PORT_A     GPIO_PORT0
+#define GPIO_PORT_B     GPIO_PORT1
+#define GPIO_PORT_C     GPIO_PORT2
+#define GPIO_PORT_D     GPIO_PORT3
+
 /*
  * GPIO Pin Direction
  */
@@ -48,4 +79,101 @@ void gpio_write_toggle(gpio_port_id_t port, uint8_t pin);
 /* Read current logic level on a pin */
 bool gpio_read_pin(gpio_port_id_t port, uint8_t pin);
 
+/* ---------------- Port-Wide (Masked) APIs ---------------- */
+
+/*
+ * Configure every pin in mask at once. Inputs also get their input
+ * buffer enabled (PINCFG.INEN) through one WRCONFIG write per half
+ * port, so gpio_port_read() sees them.
+ */
+void gpio_port_configure(gpio_port_id_t port,
+                         uint32_t mask,
+                         gpio_direction_t direction);
+
+/*
+ * Continuous input sampling for the pins in mask: required for
+ * gpio_port_read() through IOBUS to return the current level
+ * (on-demand sampling only works for APB reads). Costs power.
+ */
+void gpio_port_set_sampling(gpio_port_id_t port, uint32_t mask, bool continuous);
+
+/*
+ * The functions below compile to one load and/or one store on the
+ * port group. No pin validation: mask bits outside the port are
+ * ignored by hardware.
+ */
+
+/* Drive the pins in mask high / low / inverted */
+static inline void gpio_port_set(gpio_port_id_t port, uint32_t mask)
+{
+    GPIO_FAST_REGS->GROUP[port].PORT_OUTSET = mask;
+}
+
+static inline void gpio_port_clear(gpio_port_id_t port, uint32_t mask)
+{
+    GPIO_FAST_REGS->GROUP[port].PORT_OUTCLR = mask;
+}
+
+static inline void gpio_port_toggle(gpio_port_id_t port, uint32_t mask)
+{
+    GPIO_FAST_REGS->GROUP[port].PORT_OUTTGL = mask;
+}
+
+/*
+ * Pins in mask take the matching bits of value: set and clear happen
+ * in the same OUTTGL write, so a parallel bus changes on one edge.
+ * Pins outside mask are never written, so interrupts driving other
+ * pins of the port need no lock; the masked pins must be owned by
+ * the caller.
+ */
+static inline void gpio_port_write(gpio_port_id_t port, uint32_t mask, uint32_t value)
+{
+    port_group_registers_t *group = &GPIO_FAST_REGS->GROUP[port];
+
+    group->PORT_OUTTGL = (group->PORT_OUT ^ value) & mask;
+}
+
+/* Input level of the pins in mask */
+static inline uint32_t gpio_port_read(gpio_port_id_t port, uint32_t mask)
+{
+    return GPIO_FAST_REGS->GROUP[port].PORT_IN & mask;
+}
+
+/* Current output latch of the whole port */
+static inline uint32_t gpio_port_read_output(gpio_port_id_t port)
+{
+    return GPIO_FAST_REGS->GROUP[port].PORT_OUT;
+}
+
+/* ---------------- Parallel Bus APIs ---------------- */
+
+/*
+ * width adjacent pins starting at first_pin, e.g. D0..D7 of a
+ * parallel LCD on PB08..PB15.
+ */
+typedef struct
+{
+    gpio_port_id_t  port;
+    uint8_t         shift;      /* first_pin */
+    uint32_t        mask;       /* Pins of the bus in the port */
+} gpio_bus_t;
+
+void gpio_bus_init(gpio_bus_t *bus,
+                   gpio_port_id_t port,
+                   uint8_t first_pin,
+                   uint8_t width,
+                   gpio_direction_t direction);
+
+void gpio_bus_set_direction(const gpio_bus_t *bus, gpio_direction_t direction);
+
+static inline void gpio_bus_write(const gpio_bus_t *bus, uint32_t value)
+{
+    gpio_port_write(bus->port, bus->mask, value << bus->shift);
+}
+
+static inline uint32_t gpio_bus_read(const gpio_bus_t *bus)
+{
+    return gpio_port_read(bus->port, bus->mask) >> bus->shift;
+}
+
 #endif /* GPIO_DRV_H */
@@ -0,0 +1,173 @@
+#include "gpio_wave.h"
+#include "timer_counter_drv.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * DMA GPIO waveform engine.
+ *
+ *   TCn (MFRQ, period = 1 sample) ── OVF trigger ──► DMAC channel
+ *                                                       │ 1 beat
+ *   samples[] ──────────────────────────────────────────┴──► PORT OUT/OUTTGL/...
+ *
+ * Each TC overflow moves one sample into the PORT register, so the
+ * output timing is set by the TC alone: CPU load and interrupts do not
+ * move the edges (only other DMA channels of higher priority competing
+ * for the bus can add a few cycles of delay). The DMAC cannot reach
+ * the IOBUS alias; it writes PORT through the APB bridge.
+ */
+
+/* ================= LOCAL HELPERS ================= */
+
+static volatile void *gpio_wave_dst(const gpio_wave_config_t *cfg)
+{
+    port_group_registers_t *group = &PORT_REGS->GROUP[cfg->port];
+    volatile uint32_t *reg;
+
+    switch (cfg->dst)
+    {
+        case GPIO_WAVE_DST_OUTTGL: reg = &group->PORT_OUTTGL; break;
+        case GPIO_WAVE_DST_OUTSET: reg = &group->PORT_OUTSET; break;
+        case GPIO_WAVE_DST_OUTCLR: reg = &group->PORT_OUTCLR; break;
+        default:                   reg = &group->PORT_OUT;    break;
+    }
+
+    /* Narrow beats hit one lane of the register: other pins untouched */
+    return (volatile uint8_t *)reg + cfg->lane;
+}
+
+/* DMAC interrupt: one-shot stream finished (or bus error) */
+static void gpio_wave_dma_done(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    gpio_wave_t *wave = (gpio_wave_t *)ctx;
+    (void)ch;
+
+    if (status == DMAC_XFER_SUSPENDED)
+        return;
+
+    tc_stop(wave->tc_index);
+    wave->busy = false;
+
+    if (wave->callback)
+        wave->callback(wave, wave->ctx);
+}
+
+/* ================= INITIALIZATION ================= */
+bool gpio_wave_init(gpio_wave_t *wave, const gpio_wave_config_t *cfg)
+{
+    uint32_t lane_bytes = 4u - cfg->lane;
+
+    if (cfg->lane > 3u || (1u << cfg->beat) > lane_bytes || (cfg->lane & ((1u << cfg->beat) - 1u)))
+        return false;
+
+    int8_t ch = dmac_channel_alloc();
+    if (ch < 0)
+        return false;
+
+    wave->tc_index = cfg->tc_index;
+    wave->dma_ch   = ch;
+    wave->beat     = cfg->beat;
+    wave->dst_reg  = gpio_wave_dst(cfg);
+    wave->busy     = false;
+    wave->callback = 0;
+    wave->ctx      = 0;
+
+    gpio_port_configure(cfg->port, cfg->pin_mask, GPIO_DIR_OUTPUT);
+
+    dmac_channel_setup((uint8_t)ch, DMAC_TRIG_TC_OVF(cfg->tc_index),
+                       DMAC_TRIGACT_BURST, cfg->dma_priority);
+    dmac_channel_register_callback((uint8_t)ch, gpio_wave_dma_done, wave);
+
+    if (gpio_wave_set_rate(wave, cfg->sample_hz) == 0u)
+    {
+        gpio_wave_deinit(wave);
+        return false;
+    }
+
+    return true;
+}
+
+void gpio_wave_deinit(gpio_wave_t *wave)
+{
+    if (wave->dma_ch < 0)
+        return;
+
+    gpio_wave_stop(wave);
+    dmac_channel_free((uint8_t)wave->dma_ch);
+    tc_deinit(wave->tc_index);
+
+    wave->dma_ch = -1;
+}
+
+/* ================= RATE ================= */
+uint32_t gpio_wave_set_rate(gpio_wave_t *wave, uint32_t sample_hz)
+{
+    if (wave->busy || sample_hz == 0u)
+        return 0;
+
+    /* Smallest prescaler that fits the period: best resolution */
+    uint32_t in    = tc_init_for_rate(wave->tc_index, TC_MODE_16BIT, TC_WAVE_MFRQ, sample_hz);
+    uint32_t ticks = (in + sample_hz / 2u) / sample_hz;
+
+    if (ticks == 0u)
+        return 0;       /* Faster than the TC clock */
+
+    tc_set_compare(wave->tc_index, ticks - 1u);
+    wave->sample_hz = in / ticks;
+    return wave->sample_hz;
+}
+
+void gpio_wave_set_callback(gpio_wave_t *wave, gpio_wave_callback_t callback, void *ctx)
+{
+    wave->ctx      = ctx;
+    wave->callback = callback;
+}
+
+/* ================= STREAMING ================= */
+bool gpio_wave_start(gpio_wave_t *wave, const void *samples, uint16_t count, bool loop)
+{
+    if (wave->busy || wave->dma_ch < 0 || count == 0u)
+        return false;
+
+    dmac_desc_t *desc = dmac_channel_descriptor((uint8_t)wave->dma_ch);
+
+    /* Circular: the descriptor links back to itself, no interrupt */
+    dmac_descriptor_fill(desc, samples, wave->dst_reg, count, wave->beat,
+                         loop ? DMAC_DESC_SRCINC : (DMAC_DESC_SRCINC | DMAC_DESC_INT),
+                         loop ? desc : 0);
+
+    wave->busy = true;
+
+    dmac_channel_enable((uint8_t)wave->dma_ch);
+    tc_start(wave->tc_index);
+
+    return true;
+}
+
+void gpio_wave_stop(gpio_wave_t *wave)
+{
+    if (wave->dma_ch < 0)
+        return;
+
+    tc_stop(wave->tc_index);
+    dmac_channel_disable((uint8_t)wave->dma_ch);
+    wave->busy = false;
+}
+
+bool gpio_wave_busy(const gpio_wave_t *wave)
+{
+    return wave->busy;
+}
+
+/* ================= ENCODING HELPERS ================= */
+void gpio_wave_encode_toggle(uint32_t *levels, uint32_t count, uint32_t start, uint32_t mask)
+{
+    uint32_t prev = start;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t level = levels[i];
+
+        levels[i] = (level ^ prev) & mask;
+        prev = level;
+    }
+}
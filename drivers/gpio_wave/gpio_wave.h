@@ -0,0 +1,101 @@
+#ifndef GPIO_WAVE_H
+#define GPIO_WAVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_drv.h"
+#include "dmac_drv.h"
+
+/* ================= GPIO WAVE CONFIG ================= */
+
+/* Max samples per gpio_wave_start() (one DMA block) */
+#define GPIO_WAVE_MAX_SAMPLES   65535u
+
+/* ================= DESTINATION ================= */
+/*
+ * PORT register the samples are written to:
+ *   OUT    : samples are the new pin levels. With byte / half-word
+ *            beats only the pins of that lane are written.
+ *   OUTTGL : samples are XOR masks, pins outside them are untouched
+ *            (see gpio_wave_encode_toggle()).
+ *   OUTSET / OUTCLR : samples set / clear pins.
+ */
+typedef enum
+{
+    GPIO_WAVE_DST_OUT = 0,
+    GPIO_WAVE_DST_OUTTGL,
+    GPIO_WAVE_DST_OUTSET,
+    GPIO_WAVE_DST_OUTCLR
+} gpio_wave_dst_t;
+
+struct gpio_wave;
+
+/* Runs in DMAC interrupt context when a one-shot stream has ended */
+typedef void (*gpio_wave_callback_t)(struct gpio_wave *wave, void *ctx);
+
+typedef struct
+{
+    uint8_t          tc_index;      /* Pacing TC, 16-bit MFRQ             */
+    gpio_port_id_t   port;
+    gpio_wave_dst_t  dst;
+    dmac_beat_t      beat;          /* Sample size                        */
+    uint8_t          lane;          /* Byte offset in the register (0..3) */
+    uint32_t         pin_mask;      /* Pins driven: set to output         */
+    uint32_t         sample_hz;
+    uint8_t          dma_priority;  /* 0..3, 3 = highest                  */
+} gpio_wave_config_t;
+
+/*
+ * Engine state (caller allocated). Members are driver private.
+ */
+typedef struct gpio_wave
+{
+    uint8_t                 tc_index;
+    int8_t                  dma_ch;
+    dmac_beat_t             beat;
+    volatile void          *dst_reg;
+    uint32_t                sample_hz;      /* Achieved rate */
+    volatile bool           busy;
+    gpio_wave_callback_t    callback;
+    void                   *ctx;
+} gpio_wave_t;
+
+/* ================= GPIO WAVE PUBLIC API ================= */
+
+/*
+ * Configure pins, the pacing TC and a DMA channel (dmac_init() first).
+ * The TC is claimed for the engine: its OVF triggers one DMA beat.
+ */
+bool gpio_wave_init(gpio_wave_t *wave, const gpio_wave_config_t *cfg);
+
+/* Release the DMA channel and the TC */
+void gpio_wave_deinit(gpio_wave_t *wave);
+
+/*
+ * Change the sample rate (engine idle). Returns the rate achieved:
+ * TC clock / prescaler / whole ticks.
+ */
+uint32_t gpio_wave_set_rate(gpio_wave_t *wave, uint32_t sample_hz);
+
+void gpio_wave_set_callback(gpio_wave_t *wave, gpio_wave_callback_t callback, void *ctx);
+
+/*
+ * Stream count samples of the configured beat size, one per period.
+ * loop = true repeats the buffer until gpio_wave_stop(). samples must
+ * stay valid while the engine runs; the pins keep the last value.
+ */
+bool gpio_wave_start(gpio_wave_t *wave, const void *samples, uint16_t count, bool loop);
+
+void gpio_wave_stop(gpio_wave_t *wave);
+bool gpio_wave_busy(const gpio_wave_t *wave);
+
+/* ================= ENCODING HELPERS ================= */
+
+/*
+ * Turn absolute 32-bit port levels into OUTTGL masks (in place):
+ * toggles[i] = levels[i] ^ levels[i-1], with start = current levels
+ * before the first sample. Only pins in mask are kept.
+ */
+void gpio_wave_encode_toggle(uint32_t *levels, uint32_t count, uint32_t start, uint32_t mask);
+
+#endif /* GPIO_WAVE_H */
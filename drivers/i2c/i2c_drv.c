@@ -1,58 +1,129 @@
-#include "i2c.h"
+#include "i2c_drv.h"
+#include "dmac_drv.h"
+#include "sercom_core.h"
+#include "clock_mgr.h"
+#include "irq_mgr.h"
 #include "pic32cx1025sg61128.h"
 
+/* CTRLB.CMD values */
+#define I2C_CMD_REPEAT_START   0x1u
+#define I2C_CMD_READ_BYTE      0x2u
+#define I2C_CMD_STOP           0x3u
 
-static void i2c_clock_init(void)
+/* ================= ASYNC ENGINE STATE ================= */
+
+typedef enum
+{
+    I2C_PHASE_IDLE = 0,
+    I2C_PHASE_WRITE,        /* Address + write bytes  */
+    I2C_PHASE_READ          /* Address + read bytes   */
+} i2c_phase_t;
+
+static i2c_xfer_t *volatile xfer_head = 0;   /* Active transaction */
+static i2c_xfer_t *xfer_tail = 0;
+
+static volatile i2c_phase_t xfer_phase = I2C_PHASE_IDLE;
+static uint16_t xfer_index = 0;
+static volatile uint16_t xfer_ticks = 0;
+
+/* ================= DMA STATE ================= */
+static int8_t dma_tx_ch = -1;
+static int8_t dma_rx_ch = -1;
+static volatile bool xfer_dma_active = false;
+static uint16_t dma_last_remaining = 0;     /* Watchdog: channel progress at the last tick */
+
+/* ================= CLOCK STATE ================= */
+static uint32_t i2c_scl_hz = I2C_SPEED_STANDARD;
+static clock_notifier_t i2c_clock_nb;
+static volatile uint32_t i2c_retune_hz = 0;     /* New core clock, waiting for the bus to go idle */
+
+static void i2c_xfer_abort(i2c_status_t status);
+static bool i2c_apply_speed(uint32_t scl_hz, uint32_t gclk_hz);
+
+/*
+ * SCL timing (BAUDLOW = 0):  fSCL = fGCLK / (10 + 2*BAUD + fGCLK*Trise)
+ * with BAUDLOW:               fSCL = fGCLK / (10 + BAUD + BAUDLOW + fGCLK*Trise)
+ *
+ * Fast / Fast-plus need tLOW about twice tHIGH, so the period is
+ * split 2:1 between BAUDLOW and BAUD. Returns 0 if out of range.
+ */
+static uint32_t i2c_calc_baud(uint32_t gclk_hz, uint32_t scl_hz)
 {
-    MCLK_REGS->MCLK_APBAMASK |= MCLK_APBDMASK_SERCOM6_Msk;
+    if (scl_hz == 0)
+        return 0;
+
+    uint32_t rise   = (uint32_t)(((uint64_t)gclk_hz * I2C_TRISE_NS + 999999999u) / 1000000000u);
+    uint32_t period = (gclk_hz + scl_hz / 2u) / scl_hz;
+
+    if (period <= 10u + rise + 2u)
+        return 0;
 
-    GCLK_REGS->GCLK_PCHCTRL[SERCOM6_GCLK_ID_CORE] =
-    GCLK_PCHCTRL_GEN_GCLK0 | GCLK_PCHCTRL_CHEN_Msk;
+    uint32_t total = period - 10u - rise;
+
+    if (scl_hz <= I2C_SPEED_STANDARD)
+    {
+        uint32_t baud = total / 2u;
+        return (baud > 0xFFu) ? 0 : SERCOM_I2CM_BAUD_BAUD(baud);
+    }
 
-    while (!(GCLK_REGS->GCLK_PCHCTRL[SERCOM6_GCLK_ID_CORE] =
-             GCLK_PCHCTRL_CHEN_Msk));
+    uint32_t low  = (total * 2u + 1u) / 3u;
+    uint32_t high = total - low;
+
+    if (low > 0xFFu || high > 0xFFu)
+        return 0;
+
+    return SERCOM_I2CM_BAUD_BAUD(high) | SERCOM_I2CM_BAUD_BAUDLOW(low);
 }
 
+/*
+ * PD08 (even) → SCL → SERCOM6 PAD1
+ * PD09 (odd)  → SDA → SERCOM6 PAD0
+ * Peripheral Function: D, pull-ups on (OK for test, external recommended)
+ */
+static const sercom_pin_t i2c_pins[] =
+{
+    { I2C_PORT, I2C_SCL_PIN, SERCOM_MUX_D, true },
+    { I2C_PORT, I2C_SDA_PIN, SERCOM_MUX_D, true }
+};
+
+static void i2c_isr(void *ctx)
+{
+    (void)ctx;
+    i2c_interrupt_handler();
+}
 
-static void i2c_pins_init(void)
+/*
+ * SERCOM6 generator changed: keep the same SCL. With a transaction
+ * on the bus the new BAUD is applied by i2c_xfer_finish(), before
+ * the next transaction starts.
+ */
+static void i2c_clock_changed(uint8_t gen, clock_event_t event, uint32_t hz, void *ctx)
 {
-    /* Enable PMUX */
-    PORT_REGS->GROUP[I2C_PORT].PORT_PINCFG[I2C_SDA_PIN] |= PORT_PINCFG_PMUXEN_Msk;
-    PORT_REGS->GROUP[I2C_PORT].PORT_PINCFG[I2C_SCL_PIN] |= PORT_PINCFG_PMUXEN_Msk;
+    (void)gen;
+    (void)ctx;
 
-    /* PD09 (odd) → SDA → SERCOM6 PAD0 */
-    PORT_REGS->GROUP[I2C_PORT].PORT_PMUX[I2C_SDA_PIN >> 1] =
-        (PORT_REGS->GROUP[I2C_PORT].PORT_PMUX[I2C_SDA_PIN >> 1] & 0x0F) |
-        (MUX_PD09D_SERCOM6_PAD0 << 4);
+    if (event != CLOCK_EVENT_POST_CHANGE)
+        return;
 
-    /* PD08 (even) → SCL → SERCOM6 PAD1 */
-    PORT_REGS->GROUP[I2C_PORT].PORT_PMUX[I2C_SCL_PIN >> 1] =
-        (PORT_REGS->GROUP[I2C_PORT].PORT_PMUX[I2C_SCL_PIN >> 1] & 0xF0) |
-        MUX_PD08D_SERCOM6_PAD1;
+    uint32_t basepri = irq_lock();
 
-    /* Pull-ups (OK for test, external recommended) */
-    PORT_REGS->GROUP[I2C_PORT].PORT_PINCFG[I2C_SDA_PIN] |= PORT_PINCFG_PULLEN_Msk;
-    PORT_REGS->GROUP[I2C_PORT].PORT_PINCFG[I2C_SCL_PIN] |= PORT_PINCFG_PULLEN_Msk;
+    if (i2c_busy())
+        i2c_retune_hz = hz;
+    else
+        (void)i2c_apply_speed(i2c_scl_hz, hz);
 
-    PORT_REGS->GROUP[I2C_PORT].PORT_OUTSET =
-        (1 << I2C_SDA_PIN) | (1 << I2C_SCL_PIN);
+    irq_unlock(basepri);
 }
 
 
-void i2c_init(void)
+bool i2c_init(void)
 {
-    i2c_clock_init();
-    i2c_pins_init();
-
-    /* -------- SERCOM RESET (CORRECT WAY) -------- */
+    /* -------- CLOCK, PINS, SERCOM RESET -------- */
+    if (!sercom_core_claim(I2C_SERCOM_INDEX))
+        return false;
 
-    /* Make sure SERCOM is disabled */
-    I2C_SERCOM->I2CM.SERCOM_CTRLA &= ~SERCOM_I2CM_CTRLA_ENABLE_Msk;
-    while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_ENABLE_Msk);
-
-    /* Software reset */
-    I2C_SERCOM->I2CM.SERCOM_CTRLA |= SERCOM_I2CM_CTRLA_SWRST_Msk;
-    while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_SWRST_Msk);
+    sercom_core_init(I2C_SERCOM_INDEX, i2c_pins, 2);
+    sercom_core_register_isr(I2C_SERCOM_INDEX, i2c_isr, 0);
 
     /* -------- CONFIGURATION -------- */
 
@@ -60,7 +131,8 @@ void i2c_init(void)
     I2C_SERCOM->I2CM.SERCOM_CTRLA =
           SERCOM_I2CM_CTRLA_MODE_I2C_MASTER
         | SERCOM_I2CM_CTRLA_PINOUT(0)   /* REQUIRED for PD08/PD09 */
-        | SERCOM_I2CM_CTRLA_SDAHOLD(3);
+        | SERCOM_I2CM_CTRLA_SDAHOLD(3)
+        | SERCOM_I2CM_CTRLA_LOWTOUTEN_Msk;  /* SCL stuck low → ERROR */
 
     /* CTRLB: Smart mode */
     I2C_SERCOM->I2CM.SERCOM_CTRLB =
@@ -68,7 +140,10 @@ void i2c_init(void)
     while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_SYSOP_Msk);
 
     /* -------- BAUD RATE -------- */
-    I2C_SERCOM->I2CM.SERCOM_BAUD = 232;  /* OK for now */
+    /* 100 kHz from the SERCOM6 core clock (BAUD = 232 at 48 MHz) */
+    i2c_scl_hz = I2C_SPEED_STANDARD;
+    I2C_SERCOM->I2CM.SERCOM_BAUD =
+        i2c_calc_baud(sercom_core_clock_hz(I2C_SERCOM_INDEX), i2c_scl_hz);
 
     /* -------- ENABLE -------- */
     I2C_SERCOM->I2CM.SERCOM_CTRLA |= SERCOM_I2CM_CTRLA_ENABLE_Msk;
@@ -80,6 +155,14 @@ void i2c_init(void)
         SERCOM_I2CM_STATUS_BUSSTATE(1);
 
     while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_SYSOP_Msk);
+
+    /* -------- FOLLOW CLOCK CHANGES -------- */
+    clock_notifier_unregister(&i2c_clock_nb);
+    i2c_clock_nb.gen      = SERCOM_GCLK_GEN;
+    i2c_clock_nb.callback = i2c_clock_changed;
+    clock_notifier_register(&i2c_clock_nb);
+
+    return true;
 }
 
 bool i2c_start(uint8_t addr, bool read)
@@ -197,3 +280,483 @@ void i2c_stop(void)
         }
     }
 }
+
+
+/* ================= BUS SPEED ================= */
+
+/*
+ * Reprogram SCL frequency from the actual SERCOM6 core clock.
+ * Above 400 kHz CTRLA.SPEED selects Fast-mode Plus drive timing.
+ * SPEED is enable-protected, so the SERCOM is briefly disabled.
+ */
+bool i2c_set_speed(uint32_t scl_hz, uint32_t gclk_hz)
+{
+    if (i2c_busy())
+        return false;
+
+    return i2c_apply_speed(scl_hz, gclk_hz);
+}
+
+/* Bus idle: no transaction queued, or between two of them */
+static bool i2c_apply_speed(uint32_t scl_hz, uint32_t gclk_hz)
+{
+    if (gclk_hz == 0u)
+        gclk_hz = sercom_core_clock_hz(I2C_SERCOM_INDEX);
+
+    uint32_t baud = i2c_calc_baud(gclk_hz, scl_hz);
+
+    if (baud == 0 || scl_hz > I2C_SPEED_FAST_PLUS)
+        return false;
+
+    I2C_SERCOM->I2CM.SERCOM_CTRLA &= ~SERCOM_I2CM_CTRLA_ENABLE_Msk;
+    while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_ENABLE_Msk);
+
+    I2C_SERCOM->I2CM.SERCOM_CTRLA =
+        (I2C_SERCOM->I2CM.SERCOM_CTRLA & ~SERCOM_I2CM_CTRLA_SPEED_Msk) |
+        SERCOM_I2CM_CTRLA_SPEED((scl_hz > I2C_SPEED_FAST) ? 1u : 0u);
+
+    I2C_SERCOM->I2CM.SERCOM_BAUD = baud;
+
+    I2C_SERCOM->I2CM.SERCOM_CTRLA |= SERCOM_I2CM_CTRLA_ENABLE_Msk;
+    while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_ENABLE_Msk);
+
+    /* Force bus idle again */
+    I2C_SERCOM->I2CM.SERCOM_STATUS = SERCOM_I2CM_STATUS_BUSSTATE(1);
+    while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_SYSOP_Msk);
+
+    i2c_scl_hz = scl_hz;
+    return true;
+}
+
+/* ================= ASYNC TRANSACTION ENGINE ================= */
+
+static void i2c_sync_sysop(void)
+{
+    while (I2C_SERCOM->I2CM.SERCOM_SYNCBUSY & SERCOM_I2CM_SYNCBUSY_SYSOP_Msk);
+}
+
+static void i2c_send_cmd(uint32_t cmd, bool nack)
+{
+    uint32_t ctrlb = I2C_SERCOM->I2CM.SERCOM_CTRLB & ~SERCOM_I2CM_CTRLB_CMD_Msk;
+
+    if (nack)
+        ctrlb |= SERCOM_I2CM_CTRLB_ACKACT_Msk;
+    else
+        ctrlb &= ~SERCOM_I2CM_CTRLB_ACKACT_Msk;
+
+    I2C_SERCOM->I2CM.SERCOM_CTRLB = ctrlb | SERCOM_I2CM_CTRLB_CMD(cmd);
+    i2c_sync_sysop();
+}
+
+/*
+ * DMA phases
+ * Write: the DMAC feeds every data byte on MB, with the MB interrupt
+ *        off so the CPU is not entered per byte. The completion
+ *        turns MB back on: the MB after the last byte is handled as
+ *        usual (NACK, repeated START / STOP). A NACK or lost
+ *        arbitration before that stalls the channel and is picked up
+ *        by i2c_timeout_tick().
+ * Read:  the DMAC takes the first rd_len-1 bytes on SB (smart mode ACKs
+ *        each one); the last byte comes back to the ISR to NACK + STOP.
+ */
+static void i2c_dma_done(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    (void)ctx;
+
+    xfer_dma_active = false;
+    xfer_ticks = 0;
+
+    if (status != DMAC_XFER_COMPLETE)
+    {
+        i2c_xfer_abort(I2C_STATUS_BUS_ERROR);
+        return;
+    }
+
+    if (ch == (uint8_t)dma_rx_ch)
+        I2C_SERCOM->I2CM.SERCOM_INTENSET = SERCOM_I2CM_INTENSET_SB_Msk;
+    else
+        I2C_SERCOM->I2CM.SERCOM_INTENSET = SERCOM_I2CM_INTENSET_MB_Msk;
+}
+
+/* DMA write stalled on a NACK or lost arbitration: abort at that byte */
+static bool i2c_dma_write_failed(i2c_xfer_t *xfer)
+{
+    uint16_t status = I2C_SERCOM->I2CM.SERCOM_STATUS;
+
+    if (status & SERCOM_I2CM_STATUS_ARBLOST_Msk)
+    {
+        i2c_xfer_abort((status & SERCOM_I2CM_STATUS_BUSERR_Msk) ?
+                       I2C_STATUS_BUS_ERROR : I2C_STATUS_ARB_LOST);
+        return true;
+    }
+
+    if (!(status & SERCOM_I2CM_STATUS_RXNACK_Msk))
+        return false;
+
+    /* The address was ACKed once the channel moved a byte */
+    bool data = dmac_channel_remaining((uint8_t)dma_tx_ch) < xfer->wr_len;
+
+    i2c_xfer_abort(data ? I2C_STATUS_NACK_DATA : I2C_STATUS_NACK_ADDR);
+    return true;
+}
+
+static void i2c_start_write(i2c_xfer_t *xfer)
+{
+    xfer_phase = I2C_PHASE_WRITE;
+    xfer_index = 0;
+
+    if (dma_tx_ch >= 0 && xfer->wr_len >= I2C_DMA_MIN_LEN)
+    {
+        dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)dma_tx_ch),
+                             xfer->wr_buf, &I2C_SERCOM->I2CM.SERCOM_DATA,
+                             xfer->wr_len, DMAC_BEAT_BYTE,
+                             DMAC_DESC_SRCINC | DMAC_DESC_INT, 0);
+        xfer_index = xfer->wr_len;
+        xfer_dma_active = true;
+        dma_last_remaining = xfer->wr_len;
+        I2C_SERCOM->I2CM.SERCOM_INTENCLR = SERCOM_I2CM_INTENCLR_MB_Msk;
+        dmac_channel_enable((uint8_t)dma_tx_ch);
+    }
+
+    I2C_SERCOM->I2CM.SERCOM_ADDR = (uint32_t)xfer->addr << 1;
+    i2c_sync_sysop();
+}
+
+static void i2c_start_read(i2c_xfer_t *xfer)
+{
+    xfer_phase = I2C_PHASE_READ;
+    xfer_index = 0;
+
+    if (dma_rx_ch >= 0 && xfer->rd_len > I2C_DMA_MIN_LEN)
+    {
+        dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)dma_rx_ch),
+                             &I2C_SERCOM->I2CM.SERCOM_DATA, xfer->rd_buf,
+                             (uint16_t)(xfer->rd_len - 1u), DMAC_BEAT_BYTE,
+                             DMAC_DESC_DSTINC | DMAC_DESC_INT, 0);
+        xfer_index = (uint16_t)(xfer->rd_len - 1u);
+        xfer_dma_active = true;
+        dma_last_remaining = xfer_index;
+        I2C_SERCOM->I2CM.SERCOM_INTENCLR = SERCOM_I2CM_INTENCLR_SB_Msk;
+        dmac_channel_enable((uint8_t)dma_rx_ch);
+    }
+
+    I2C_SERCOM->I2CM.SERCOM_ADDR = ((uint32_t)xfer->addr << 1) | 1u;
+    i2c_sync_sysop();
+}
+
+/* Put the address of the active transaction on the bus */
+static void i2c_xfer_begin(i2c_xfer_t *xfer)
+{
+    xfer_ticks = 0;
+
+    /* ACK received bytes until the last one */
+    I2C_SERCOM->I2CM.SERCOM_CTRLB &= ~SERCOM_I2CM_CTRLB_ACKACT_Msk;
+    i2c_sync_sysop();
+
+    I2C_SERCOM->I2CM.SERCOM_INTENSET =
+        SERCOM_I2CM_INTENSET_MB_Msk |
+        SERCOM_I2CM_INTENSET_SB_Msk |
+        SERCOM_I2CM_INTENSET_ERROR_Msk;
+
+    if (xfer->wr_len)
+        i2c_start_write(xfer);
+    else
+        i2c_start_read(xfer);
+}
+
+/*
+ * Finish the active transaction and start the next one.
+ * Called from the ISR or from the timeout tick with SERCOM6 IRQs masked.
+ */
+static void i2c_xfer_finish(i2c_status_t status)
+{
+    i2c_xfer_t *done = xfer_head;
+
+    xfer_head = done->next;
+    if (!xfer_head)
+        xfer_tail = 0;
+
+    done->next   = 0;
+    done->status = status;
+
+    /* Clock changed during the transaction: re-tune while the bus is free */
+    if (i2c_retune_hz && !(done->flags & I2C_XFER_NO_STOP))
+    {
+        (void)i2c_apply_speed(i2c_scl_hz, i2c_retune_hz);
+        i2c_retune_hz = 0;
+    }
+
+    if (xfer_head)
+    {
+        i2c_xfer_begin(xfer_head);
+    }
+    else
+    {
+        xfer_phase = I2C_PHASE_IDLE;
+        I2C_SERCOM->I2CM.SERCOM_INTENCLR =
+            SERCOM_I2CM_INTENCLR_MB_Msk |
+            SERCOM_I2CM_INTENCLR_SB_Msk |
+            SERCOM_I2CM_INTENCLR_ERROR_Msk;
+    }
+
+    if (done->callback)
+        done->callback(done, status);
+}
+
+/* Release the bus after a failure (no STOP possible after ARBLOST) */
+static void i2c_xfer_abort(i2c_status_t status)
+{
+    if (xfer_dma_active)
+    {
+        dmac_channel_disable((uint8_t)((xfer_phase == I2C_PHASE_WRITE) ? dma_tx_ch : dma_rx_ch));
+        xfer_dma_active = false;
+    }
+
+    if (status != I2C_STATUS_ARB_LOST)
+        i2c_send_cmd(I2C_CMD_STOP, true);
+
+    /* Force IDLE so the next START is not blocked */
+    I2C_SERCOM->I2CM.SERCOM_STATUS =
+        SERCOM_I2CM_STATUS_BUSSTATE(1) |
+        SERCOM_I2CM_STATUS_ARBLOST_Msk |
+        SERCOM_I2CM_STATUS_BUSERR_Msk |
+        SERCOM_I2CM_STATUS_LOWTOUT_Msk;
+    i2c_sync_sysop();
+
+    i2c_xfer_finish(status);
+}
+
+bool i2c_submit(i2c_xfer_t *xfer)
+{
+    if (!xfer || (xfer->wr_len == 0 && xfer->rd_len == 0))
+        return false;
+    if (xfer->status == I2C_STATUS_PENDING)
+        return false;
+
+    xfer->status = I2C_STATUS_PENDING;
+    xfer->next   = 0;
+
+    uint32_t basepri = irq_lock();
+
+    if (xfer_tail)
+    {
+        xfer_tail->next = xfer;
+        xfer_tail = xfer;
+    }
+    else
+    {
+        xfer_head = xfer_tail = xfer;
+
+        I2C_SERCOM->I2CM.SERCOM_INTFLAG = SERCOM_I2CM_INTFLAG_ERROR_Msk;
+
+        sercom_core_irq_enable(I2C_SERCOM_INDEX);   /* MB, SB, ERROR */
+
+        i2c_xfer_begin(xfer);
+    }
+
+    irq_unlock(basepri);
+    return true;
+}
+
+bool i2c_busy(void)
+{
+    return xfer_head != 0;
+}
+
+/*
+ * A DMA phase has no per-byte interrupt to reset the watchdog: the
+ * channel's progress since the last tick does it instead, and a
+ * stalled DMA write is checked for a NACK before it counts as a
+ * timeout.
+ */
+void i2c_timeout_tick(void)
+{
+    if (xfer_phase == I2C_PHASE_IDLE)
+        return;
+
+    uint32_t basepri = irq_lock();
+
+    if (xfer_dma_active)
+    {
+        bool     write = (xfer_phase == I2C_PHASE_WRITE);
+        uint16_t remaining = dmac_channel_remaining((uint8_t)(write ? dma_tx_ch : dma_rx_ch));
+
+        if (remaining != dma_last_remaining)
+        {
+            dma_last_remaining = remaining;
+            xfer_ticks = 0;
+        }
+        else if (write && i2c_dma_write_failed(xfer_head))
+        {
+            irq_unlock(basepri);
+            return;
+        }
+    }
+
+    /* Re-check under the lock: the ISR may have completed it meanwhile */
+    if (xfer_phase != I2C_PHASE_IDLE && ++xfer_ticks >= I2C_XFER_TIMEOUT_TICKS)
+        i2c_xfer_abort(I2C_STATUS_TIMEOUT);
+
+    irq_unlock(basepri);
+}
+
+/*
+ * MB: address or data byte sent in write direction (or bus error)
+ * SB: data byte received in read direction
+ * ERROR: SCL low timeout / bus error
+ */
+void i2c_interrupt_handler(void)
+{
+    i2c_xfer_t *xfer = xfer_head;
+    uint8_t  flags  = I2C_SERCOM->I2CM.SERCOM_INTFLAG;
+    uint16_t status = I2C_SERCOM->I2CM.SERCOM_STATUS;
+
+    if (!xfer)
+    {
+        I2C_SERCOM->I2CM.SERCOM_INTENCLR = flags;
+        return;
+    }
+
+    /* SB may be owned by a DMA phase right now */
+    flags &= I2C_SERCOM->I2CM.SERCOM_INTENSET;
+
+    /* Any activity resets the software watchdog */
+    xfer_ticks = 0;
+
+    if (flags & SERCOM_I2CM_INTFLAG_ERROR_Msk)
+    {
+        I2C_SERCOM->I2CM.SERCOM_INTFLAG = SERCOM_I2CM_INTFLAG_ERROR_Msk;
+
+        if (status & SERCOM_I2CM_STATUS_LOWTOUT_Msk)
+        {
+            i2c_xfer_abort(I2C_STATUS_TIMEOUT);
+            return;
+        }
+        if (status & SERCOM_I2CM_STATUS_BUSERR_Msk)
+        {
+            i2c_xfer_abort(I2C_STATUS_BUS_ERROR);
+            return;
+        }
+    }
+
+    if (flags & SERCOM_I2CM_INTFLAG_MB_Msk)
+    {
+        if (status & SERCOM_I2CM_STATUS_ARBLOST_Msk)
+        {
+            i2c_xfer_abort((status & SERCOM_I2CM_STATUS_BUSERR_Msk) ?
+                           I2C_STATUS_BUS_ERROR : I2C_STATUS_ARB_LOST);
+            return;
+        }
+
+        if (status & SERCOM_I2CM_STATUS_RXNACK_Msk)
+        {
+            /* NACK on address (index 0 / read phase) or on a data byte */
+            i2c_xfer_abort((xfer_phase == I2C_PHASE_WRITE && xfer_index > 0) ?
+                           I2C_STATUS_NACK_DATA : I2C_STATUS_NACK_ADDR);
+            return;
+        }
+
+        if (xfer_phase == I2C_PHASE_WRITE)
+        {
+            if (xfer_index < xfer->wr_len)
+            {
+                /* Writing DATA clears MB */
+                I2C_SERCOM->I2CM.SERCOM_DATA = xfer->wr_buf[xfer_index++];
+                i2c_sync_sysop();
+            }
+            else if (xfer->rd_len)
+            {
+                /* Repeated START into the read phase */
+                i2c_start_read(xfer);
+            }
+            else
+            {
+                if (xfer->flags & I2C_XFER_NO_STOP)
+                    I2C_SERCOM->I2CM.SERCOM_INTFLAG = SERCOM_I2CM_INTFLAG_MB_Msk;
+                else
+                    i2c_send_cmd(I2C_CMD_STOP, false);
+
+                i2c_xfer_finish(I2C_STATUS_OK);
+            }
+        }
+        return;
+    }
+
+    if (flags & SERCOM_I2CM_INTFLAG_SB_Msk)
+    {
+        bool last = (xfer_index + 1u >= xfer->rd_len);
+
+        if (last)
+        {
+            /* NACK the last byte and STOP before DATA is read */
+            if (xfer->flags & I2C_XFER_NO_STOP)
+                I2C_SERCOM->I2CM.SERCOM_CTRLB |= SERCOM_I2CM_CTRLB_ACKACT_Msk;
+            else
+                i2c_send_cmd(I2C_CMD_STOP, true);
+            i2c_sync_sysop();
+        }
+
+        /* Smart mode: reading DATA sends the ACK/NACK */
+        xfer->rd_buf[xfer_index++] = (uint8_t)I2C_SERCOM->I2CM.SERCOM_DATA;
+
+        if (last)
+            i2c_xfer_finish(I2C_STATUS_OK);
+    }
+}
+
+/* ================= DMA / WRITE-READ ================= */
+
+/*
+ * Let the transaction engine move data phases through the DMAC.
+ * dmac_init() must have been called. Phases shorter than
+ * I2C_DMA_MIN_LEN stay on the interrupt path.
+ */
+bool i2c_dma_init(void)
+{
+    if (dma_tx_ch < 0)
+        dma_tx_ch = dmac_channel_alloc();
+    if (dma_rx_ch < 0)
+        dma_rx_ch = dmac_channel_alloc();
+
+    if (dma_tx_ch < 0 || dma_rx_ch < 0)
+    {
+        if (dma_tx_ch >= 0)
+            dmac_channel_free((uint8_t)dma_tx_ch);
+        if (dma_rx_ch >= 0)
+            dmac_channel_free((uint8_t)dma_rx_ch);
+        dma_tx_ch = dma_rx_ch = -1;
+        return false;
+    }
+
+    dmac_channel_setup((uint8_t)dma_tx_ch, DMAC_TRIG_SERCOM_TX(6), DMAC_TRIGACT_BURST, 1);
+    dmac_channel_setup((uint8_t)dma_rx_ch, DMAC_TRIG_SERCOM_RX(6), DMAC_TRIGACT_BURST, 1);
+    dmac_channel_register_callback((uint8_t)dma_tx_ch, i2c_dma_done, 0);
+    dmac_channel_register_callback((uint8_t)dma_rx_ch, i2c_dma_done, 0);
+
+    return true;
+}
+
+/*
+ * Register-style read: START + write wr_buf, repeated START, read
+ * rd_len bytes, STOP. Fills xfer and queues it.
+ */
+bool i2c_write_read(i2c_xfer_t *xfer,
+                    uint8_t addr,
+                    const uint8_t *wr_buf, uint16_t wr_len,
+                    uint8_t *rd_buf, uint16_t rd_len,
+                    i2c_callback_t callback, void *ctx)
+{
+    if (!xfer || xfer->status == I2C_STATUS_PENDING)
+        return false;
+
+    xfer->addr     = addr;
+    xfer->wr_buf   = wr_buf;
+    xfer->wr_len   = wr_len;
+    xfer->rd_buf   = rd_buf;
+    xfer->rd_len   = rd_len;
+    xfer->flags    = 0;
+    xfer->callback = callback;
+    xfer->ctx      = ctx;
+
+    return i2c_submit(xfer);
+}
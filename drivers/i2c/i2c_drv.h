@@ -8,6 +8,7 @@
 
 
 /* -------- I2C SERCOM selection -------- */
+#define I2C_SERCOM_INDEX 6       // Must match I2C_SERCOM
 #define I2C_SERCOM       SERCOM6_REGS
 
 /* -------- I2C pin configuration -------- */
@@ -16,12 +17,27 @@
 #define I2C_SCL_PIN    8       // PD08  ✅ SCL
 #define I2C_SDA_PIN    9       // PD09  ✅ SDA
 
+/* -------- I2C clock / timing -------- */
+/* SERCOM6 core clock comes from the clock manager (sercom_core_clock_hz) */
+
+#ifndef I2C_TRISE_NS
+#define I2C_TRISE_NS         100u         /* SCL rise time, board dependent */
+#endif
+
+#define I2C_SPEED_STANDARD   100000UL
+#define I2C_SPEED_FAST       400000UL
+#define I2C_SPEED_FAST_PLUS  1000000UL
+
+/* Data phases at least this long are moved by DMA (after i2c_dma_init) */
+#ifndef I2C_DMA_MIN_LEN
+#define I2C_DMA_MIN_LEN      4u
+#endif
 
 
 /* ================= I2C PUBLIC API ================= */
 
-/* Initialize I2C peripheral */
-void i2c_init(void);
+/* Initialize I2C peripheral (false if SERCOM6 is already owned) */
+bool i2c_init(void);
 
 /* Start condition
  * addr = 7-bit slave address
@@ -41,4 +57,80 @@ uint8_t i2c_read(bool ack);
 /* Stop condition */
 void i2c_stop(void);
 
+/* Change SCL frequency (100k / 400k / 1M); gclk_hz 0 = current SERCOM core clock.
+ * The chosen SCL is reapplied when the core clock generator changes, after
+ * the running transaction if there is one. */
+bool i2c_set_speed(uint32_t scl_hz, uint32_t gclk_hz);
+
+
+/* ================= ASYNC TRANSACTION ENGINE ================= */
+
+/* Software timeout per transaction, in i2c_timeout_tick() calls */
+#ifndef I2C_XFER_TIMEOUT_TICKS
+#define I2C_XFER_TIMEOUT_TICKS   10u
+#endif
+
+/* Transaction result */
+typedef enum
+{
+    I2C_STATUS_OK = 0,
+    I2C_STATUS_PENDING,       /* Queued or on the bus          */
+    I2C_STATUS_NACK_ADDR,     /* Address not acknowledged      */
+    I2C_STATUS_NACK_DATA,     /* Data byte not acknowledged    */
+    I2C_STATUS_ARB_LOST,      /* Another master won the bus    */
+    I2C_STATUS_BUS_ERROR,     /* Illegal START/STOP seen       */
+    I2C_STATUS_TIMEOUT        /* SCL low timeout or no progress */
+} i2c_status_t;
+
+/* Transaction flags */
+#define I2C_XFER_NO_STOP   (1u << 0)   /* Keep the bus: next transaction starts with repeated START */
+
+struct i2c_xfer;
+typedef void (*i2c_callback_t)(struct i2c_xfer *xfer, i2c_status_t status);
+
+/*
+ * Transaction descriptor
+ * Write phase (if wr_len) then read phase (if rd_len) with a repeated
+ * START in between, then STOP. Owned by the driver from i2c_submit()
+ * until the callback runs; buffers must stay valid until then.
+ */
+typedef struct i2c_xfer
+{
+    uint8_t         addr;       /* 7-bit slave address */
+    const uint8_t  *wr_buf;
+    uint16_t        wr_len;
+    uint8_t        *rd_buf;
+    uint16_t        rd_len;
+    uint8_t         flags;
+    i2c_callback_t  callback;   /* Runs in interrupt context */
+    void           *ctx;
+
+    /* Driver owned */
+    volatile i2c_status_t status;
+    struct i2c_xfer *next;
+} i2c_xfer_t;
+
+/* Queue a transaction (returns false if invalid or already queued) */
+bool i2c_submit(i2c_xfer_t *xfer);
+
+/* True while transactions are queued or running */
+bool i2c_busy(void);
+
+/* Software watchdog, call from a periodic tick (e.g. 1 ms).
+ * Also reports a NACK during a DMA write, one tick after it happens. */
+void i2c_timeout_tick(void);
+
+/* Move data phases through DMAC (needs dmac_init()) */
+bool i2c_dma_init(void);
+
+/* START, write, repeated START, read, STOP in one queued transaction */
+bool i2c_write_read(i2c_xfer_t *xfer,
+                    uint8_t addr,
+                    const uint8_t *wr_buf, uint16_t wr_len,
+                    uint8_t *rd_buf, uint16_t rd_len,
+                    i2c_callback_t callback, void *ctx);
+
+/* SERCOM6 interrupt service routine (all SERCOM6 vectors) */
+void i2c_interrupt_handler(void);
+
 #endif /* I2C_H */
@@ -0,0 +1,263 @@
+#include "i2c_target.h"
+#include "pic32cx1025sg61128.h"
+#include "sercom_core.h"
+
+/* CTRLB.CMD: release the bus and wait for the next START */
+#define I2C_TARGET_CMD_WAIT_START   0x2u
+
+/* ================= STATE ================= */
+static uint8_t *map_regs = 0;
+static uint16_t map_size = 0;
+static const uint8_t *map_wr_mask = 0;
+
+/* ISR private */
+static uint16_t reg_ptr = 0;
+static bool     ptr_pending = false;    /* next written byte is the register pointer */
+static bool     read_first = true;      /* next read DRDY starts a read phase */
+static uint16_t xfer_lo = 0;
+static uint16_t xfer_hi = 0;
+static bool     xfer_dirty = false;
+
+/* ISR → poll */
+static volatile bool     notify_pending = false;
+static volatile uint16_t notify_lo = 0;
+static volatile uint16_t notify_hi = 0;
+
+static i2c_target_callback_t notify_callback = 0;
+static void *notify_context = 0;
+
+/* ================= LOCAL HELPERS ================= */
+
+/*
+ * PB16 (even) → SDA → SERCOM5 PAD0
+ * PB17 (odd)  → SCL → SERCOM5 PAD1
+ * Peripheral Function: C
+ */
+static const sercom_pin_t i2c_target_pins[] =
+{
+    { I2C_TARGET_PORT, I2C_TARGET_SDA_PIN, SERCOM_MUX_C, false },
+    { I2C_TARGET_PORT, I2C_TARGET_SCL_PIN, SERCOM_MUX_C, false }
+};
+
+static void i2c_target_isr(void *ctx)
+{
+    (void)ctx;
+    i2c_target_interrupt_handler();
+}
+
+static bool i2c_target_writable(uint16_t reg)
+{
+    return !map_wr_mask || (map_wr_mask[reg >> 3] & (1u << (reg & 7u)));
+}
+
+/* ================= INITIALIZATION ================= */
+bool i2c_target_init(uint8_t addr,
+                     uint8_t *regs,
+                     uint16_t size,
+                     const uint8_t *wr_mask,
+                     bool fast_plus)
+{
+    /* The pointer byte addresses 256 registers at most */
+    if (!regs || size == 0u || size > 256u)
+        return false;
+
+    if (!sercom_core_claim(I2C_TARGET_SERCOM_INDEX))
+        return false;
+
+    map_regs    = regs;
+    map_size    = size;
+    map_wr_mask = wr_mask;
+    reg_ptr     = 0;
+    ptr_pending = true;
+    read_first  = true;
+    notify_pending = false;
+
+    /* Clock, pins, disable and reset */
+    sercom_core_irq_disable(I2C_TARGET_SERCOM_INDEX);
+    sercom_core_init(I2C_TARGET_SERCOM_INDEX, i2c_target_pins, 2);
+    sercom_core_register_isr(I2C_TARGET_SERCOM_INDEX, i2c_target_isr, 0);
+
+    /* CTRLA: I2C slave, PAD0=SDA, PAD1=SCL */
+    I2C_TARGET_SERCOM->I2CS.SERCOM_CTRLA =
+          SERCOM_I2CS_CTRLA_MODE_I2C_SLAVE
+        | SERCOM_I2CS_CTRLA_SDAHOLD(fast_plus ? 1u : 3u)
+        | SERCOM_I2CS_CTRLA_SPEED(fast_plus ? 1u : 0u);
+
+    /*
+     * CTRLB: Smart mode, reading/writing DATA sends the ACK itself,
+     * so each data byte costs one DATA access in the ISR.
+     * AACKEN: address is ACKed by hardware, no AMATCH round-trip
+     * and no clock stretch on the address byte.
+     */
+    I2C_TARGET_SERCOM->I2CS.SERCOM_CTRLB =
+          SERCOM_I2CS_CTRLB_SMEN_Msk
+        | SERCOM_I2CS_CTRLB_AACKEN_Msk;
+
+    I2C_TARGET_SERCOM->I2CS.SERCOM_ADDR = SERCOM_I2CS_ADDR_ADDR(addr);
+
+    I2C_TARGET_SERCOM->I2CS.SERCOM_INTFLAG =
+        SERCOM_I2CS_INTFLAG_PREC_Msk | SERCOM_I2CS_INTFLAG_ERROR_Msk;
+    I2C_TARGET_SERCOM->I2CS.SERCOM_INTENSET =
+        SERCOM_I2CS_INTENSET_PREC_Msk |
+        SERCOM_I2CS_INTENSET_DRDY_Msk |
+        SERCOM_I2CS_INTENSET_ERROR_Msk;
+
+    I2C_TARGET_SERCOM->I2CS.SERCOM_CTRLA |= SERCOM_I2CS_CTRLA_ENABLE_Msk;
+    while (I2C_TARGET_SERCOM->I2CS.SERCOM_SYNCBUSY & SERCOM_I2CS_SYNCBUSY_ENABLE_Msk);
+
+    sercom_core_irq_enable(I2C_TARGET_SERCOM_INDEX);   /* PREC, DRDY, ERROR */
+
+    return true;
+}
+
+void i2c_target_set_callback(i2c_target_callback_t callback, void *ctx)
+{
+    notify_context  = ctx;
+    notify_callback = callback;
+}
+
+/* ================= THREAD CONTEXT ================= */
+
+/*
+ * Pending ranges from several STOPs are merged into one, so a burst of
+ * host writes is reported once.
+ */
+void i2c_target_poll(void)
+{
+    if (!notify_pending)
+        return;
+
+    sercom_core_irq_disable(I2C_TARGET_SERCOM_INDEX);
+    uint16_t lo = notify_lo;
+    uint16_t hi = notify_hi;
+    notify_pending = false;
+    sercom_core_irq_enable(I2C_TARGET_SERCOM_INDEX);
+
+    if (notify_callback)
+        notify_callback(lo, (uint16_t)(hi - lo + 1u), notify_context);
+}
+
+void i2c_target_update(uint16_t first, const uint8_t *data, uint16_t len)
+{
+    if (first >= map_size || len > map_size - first)
+        return;
+
+    sercom_core_irq_disable(I2C_TARGET_SERCOM_INDEX);
+    for (uint16_t i = 0; i < len; i++)
+    {
+        map_regs[first + i] = data[i];
+    }
+    sercom_core_irq_enable(I2C_TARGET_SERCOM_INDEX);
+}
+
+/* ================= ISR ================= */
+
+/*
+ * DRDY : host read  → next shadow byte into DATA, or end of the
+ *                     read phase when the host NACKed the last one
+ *        host write → pointer byte or shadow write
+ * PREC : STOP, hand the dirty range to thread context
+ *
+ * Addresses are ACKed by hardware (AACKEN), so a new write
+ * transaction is recognised by "first byte after STOP or after a
+ * read phase" and that byte is taken as the register pointer.
+ * Likewise a read phase starts after a STOP, a written byte or the
+ * end of the previous read; its first DRDY always loads DATA, since
+ * STATUS.RXNACK still holds the NACK that ended the previous read.
+ */
+void i2c_target_interrupt_handler(void)
+{
+    sercom_i2cs_registers_t *i2cs = &I2C_TARGET_SERCOM->I2CS;
+    uint8_t flags = i2cs->SERCOM_INTFLAG;
+
+    if (flags & SERCOM_I2CS_INTFLAG_DRDY_Msk)
+    {
+        if (i2cs->SERCOM_STATUS & SERCOM_I2CS_STATUS_DIR_Msk)
+        {
+            ptr_pending = true;
+
+            /*
+             * NACK on the previous byte of this phase: the host is
+             * done. Preloading DATA here would send one byte too many
+             * and move the pointer past the next read's start.
+             */
+            if (!read_first && (i2cs->SERCOM_STATUS & SERCOM_I2CS_STATUS_RXNACK_Msk))
+            {
+                read_first = true;
+                i2cs->SERCOM_CTRLB = (i2cs->SERCOM_CTRLB & ~SERCOM_I2CS_CTRLB_CMD_Msk)
+                                   | SERCOM_I2CS_CTRLB_CMD(I2C_TARGET_CMD_WAIT_START);
+            }
+            else
+            {
+                /* Host read: served from RAM, no callback */
+                read_first = false;
+                i2cs->SERCOM_DATA = map_regs[reg_ptr];
+                if (++reg_ptr >= map_size)
+                    reg_ptr = 0;
+            }
+        }
+        else
+        {
+            uint8_t data = (uint8_t)i2cs->SERCOM_DATA;
+
+            read_first = true;
+
+            if (ptr_pending)
+            {
+                ptr_pending = false;
+                reg_ptr = (data < map_size) ? data : 0u;
+            }
+            else
+            {
+                if (i2c_target_writable(reg_ptr))
+                {
+                    map_regs[reg_ptr] = data;
+
+                    if (!xfer_dirty)
+                    {
+                        xfer_lo = xfer_hi = reg_ptr;
+                        xfer_dirty = true;
+                    }
+                    else if (reg_ptr < xfer_lo)
+                        xfer_lo = reg_ptr;
+                    else if (reg_ptr > xfer_hi)
+                        xfer_hi = reg_ptr;
+                }
+
+                if (++reg_ptr >= map_size)
+                    reg_ptr = 0;
+            }
+        }
+    }
+
+    if (flags & SERCOM_I2CS_INTFLAG_PREC_Msk)
+    {
+        i2cs->SERCOM_INTFLAG = SERCOM_I2CS_INTFLAG_PREC_Msk;
+
+        ptr_pending = true;
+        read_first  = true;
+
+        if (xfer_dirty)
+        {
+            xfer_dirty = false;
+
+            if (!notify_pending)
+            {
+                notify_lo = xfer_lo;
+                notify_hi = xfer_hi;
+                notify_pending = true;
+            }
+            else
+            {
+                if (xfer_lo < notify_lo) notify_lo = xfer_lo;
+                if (xfer_hi > notify_hi) notify_hi = xfer_hi;
+            }
+        }
+    }
+
+    if (flags & SERCOM_I2CS_INTFLAG_ERROR_Msk)
+    {
+        i2cs->SERCOM_STATUS  = i2cs->SERCOM_STATUS;
+        i2cs->SERCOM_INTFLAG = SERCOM_I2CS_INTFLAG_ERROR_Msk;
+    }
+}
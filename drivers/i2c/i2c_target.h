@@ -0,0 +1,64 @@
+#ifndef I2C_TARGET_H
+#define I2C_TARGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* -------- I2C target SERCOM selection -------- */
+#define I2C_TARGET_SERCOM_INDEX 5      // Must match I2C_TARGET_SERCOM
+#define I2C_TARGET_SERCOM      SERCOM5_REGS
+
+/* -------- I2C target pin configuration -------- */
+/* PORT index: 0=PORTA, 1=PORTB, 2=PORTC, 3=PORTD */
+#define I2C_TARGET_PORT        1       // PORTB
+#define I2C_TARGET_SDA_PIN     16      // PB16 → SERCOM5 PAD0
+#define I2C_TARGET_SCL_PIN     17      // PB17 → SERCOM5 PAD1
+
+
+/* ================= I2C TARGET (SLAVE) API ================= */
+
+/*
+ * Register map emulation
+ *
+ * The host sees a byte-addressed register file:
+ *   write: [addr+W] [reg] [data0] [data1] ...   → regs[reg], regs[reg+1], ...
+ *   read:  [addr+W] [reg] [Sr] [addr+R] ...     → regs[reg], regs[reg+1], ...
+ * The register pointer auto-increments and wraps at the map size.
+ *
+ * Reads are served straight from the RAM shadow inside the ISR.
+ * Host writes land in the shadow and are reported once per STOP as a
+ * dirty range, delivered from i2c_target_poll() (thread context).
+ */
+
+/* Change notification: registers [first, first + len) were written */
+typedef void (*i2c_target_callback_t)(uint16_t first, uint16_t len, void *ctx);
+
+/* Initialize SERCOM5 as I2C target
+ * addr     = 7-bit address
+ * regs     = RAM shadow (must stay valid)
+ * size     = number of registers (1..256)
+ * wr_mask  = bitmap, bit n set → register n writable by host
+ *            (NULL = all writable)
+ * fast_plus= true → 1 MHz drive timing (CTRLA.SPEED)
+ * Returns false if size is out of range or SERCOM5 is already owned
+ * by another driver.
+ */
+bool i2c_target_init(uint8_t addr,
+                     uint8_t *regs,
+                     uint16_t size,
+                     const uint8_t *wr_mask,
+                     bool fast_plus);
+
+/* Register the change notification callback */
+void i2c_target_set_callback(i2c_target_callback_t callback, void *ctx);
+
+/* Deliver pending change notifications (call from main loop) */
+void i2c_target_poll(void);
+
+/* Update shadow registers atomically w.r.t. host reads */
+void i2c_target_update(uint16_t first, const uint8_t *data, uint16_t len);
+
+/* SERCOM5 interrupt service routine (all SERCOM5 vectors) */
+void i2c_target_interrupt_handler(void);
+
+#endif /* I2C_TARGET_H */
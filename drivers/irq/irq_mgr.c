@@ -0,0 +1,117 @@
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Interrupt priorities and BASEPRI critical sections.
+ *
+ * PRIMASK (cpsid i) holds off every interrupt for as long as any
+ * driver updates a list or a counter, so a UART driver adds its
+ * worst section to the latency of a motor control loop. BASEPRI only
+ * holds off priorities at and below a ceiling: with the drivers at
+ * IRQ_LOCK_CEILING and below, priority 0 is never delayed by them.
+ *
+ * The outermost section of a nest is timed with DWT->CYCCNT. Inner
+ * sections, and sections taken by unmasked ISRs while one is open,
+ * find BASEPRI already set and are part of the outer window.
+ */
+
+/* ================= MACROS ================= */
+#define IRQ_BASEPRI(prio)       ((uint32_t)(prio) << (8u - __NVIC_PRIO_BITS))
+
+/* ================= STATE ================= */
+static uint32_t irq_mask_start;
+static uint32_t irq_mask_site;
+static irq_mask_stats_t irq_stats;
+
+/* ================= INITIALIZATION ================= */
+void irq_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    irq_reset_mask_stats();
+}
+
+void irq_enable(IRQn_Type irq, uint8_t priority)
+{
+    if (priority > IRQ_PRIO_LOWEST)
+        priority = IRQ_PRIO_LOWEST;
+
+    NVIC_SetPriority(irq, priority);
+    NVIC_EnableIRQ(irq);
+}
+
+void irq_disable(IRQn_Type irq)
+{
+    NVIC_DisableIRQ(irq);
+}
+
+/* ================= CRITICAL SECTIONS ================= */
+
+/* site: caller of the public entry, recorded for the worst case */
+static inline uint32_t irq_raise(uint8_t ceiling, uint32_t site)
+{
+    uint32_t state = __get_BASEPRI();
+
+    if (ceiling == 0u)
+        ceiling = 1u;
+
+    /* Only ever raises the mask: nested sections cannot lower it */
+    __set_BASEPRI_MAX(IRQ_BASEPRI(ceiling));
+
+    if (state == 0u)
+    {
+        irq_mask_start = DWT->CYCCNT;
+        irq_mask_site  = site;
+    }
+
+    return state;
+}
+
+uint32_t irq_lock(void)
+{
+    return irq_raise(IRQ_LOCK_CEILING, (uint32_t)__builtin_return_address(0));
+}
+
+uint32_t irq_lock_to(uint8_t ceiling)
+{
+    return irq_raise(ceiling, (uint32_t)__builtin_return_address(0));
+}
+
+void irq_unlock(uint32_t state)
+{
+    if (state == 0u)
+    {
+        uint32_t cycles = DWT->CYCCNT - irq_mask_start;
+
+        irq_stats.count++;
+        irq_stats.last_cycles = cycles;
+
+        if (cycles > irq_stats.max_cycles)
+        {
+            irq_stats.max_cycles = cycles;
+            irq_stats.max_site   = irq_mask_site;
+        }
+    }
+
+    __set_BASEPRI(state);
+}
+
+/* ================= MASKED WINDOW ================= */
+
+/* PRIMASK: an ISR above the ceiling may close a window of its own */
+void irq_get_mask_stats(irq_mask_stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = irq_stats;
+    __set_PRIMASK(primask);
+}
+
+void irq_reset_mask_stats(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    irq_stats = (irq_mask_stats_t){0};
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,106 @@
+#ifndef IRQ_MGR_H
+#define IRQ_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+
+/* ================= PRIORITY PLAN ================= */
+/*
+ * NVIC priorities, 0 = most urgent (__NVIC_PRIO_BITS = 3: 0 .. 7).
+ * Every driver enables its vectors through irq_enable() with its
+ * entry below; override any of them before including the drivers.
+ *
+ *   0  application control loops   never masked by irq_lock()
+ *   1  timebase, TC                time stamps, PWM edges, capture
+ *   2  DMAC                        stream wraps and completion
+ *   3  EIC                         pin edges, event queue
+ *   4  RTC                         timer wheel, wake-ups
+ *   6  SERCOM                      comms and logging
+ *
+ * Equal priorities never preempt each other: drivers sharing one
+ * level may share data without locking against each other.
+ */
+#ifndef IRQ_PRIO_CONTROL
+#define IRQ_PRIO_CONTROL        0u
+#endif
+#ifndef IRQ_PRIO_TIMEBASE
+#define IRQ_PRIO_TIMEBASE       1u
+#endif
+#ifndef IRQ_PRIO_TC
+#define IRQ_PRIO_TC             1u
+#endif
+#ifndef IRQ_PRIO_DMAC
+#define IRQ_PRIO_DMAC           2u
+#endif
+#ifndef IRQ_PRIO_EIC
+#define IRQ_PRIO_EIC            3u
+#endif
+#ifndef IRQ_PRIO_RTC
+#define IRQ_PRIO_RTC            4u
+#endif
+#ifndef IRQ_PRIO_SERCOM
+#define IRQ_PRIO_SERCOM         6u
+#endif
+
+#define IRQ_PRIO_LOWEST         ((1u << __NVIC_PRIO_BITS) - 1u)
+
+/*
+ * Ceiling of irq_lock(): priorities from this one down are held off.
+ * Driver critical sections use it, so it must cover every driver
+ * vector above; the levels more urgent than it keep running.
+ */
+#ifndef IRQ_LOCK_CEILING
+#define IRQ_LOCK_CEILING        1u
+#endif
+
+/* ================= TYPES ================= */
+
+/* Longest irq_lock() .. irq_unlock() window, DWT cycles */
+typedef struct
+{
+    uint32_t count;         /* Outermost sections since reset          */
+    uint32_t last_cycles;   /* Length of the last one                  */
+    uint32_t max_cycles;    /* Worst case                              */
+    uint32_t max_site;      /* Return address of its irq_lock() caller */
+} irq_mask_stats_t;
+
+/* ================= IRQ PUBLIC API ================= */
+
+/* Start the DWT cycle counter the window statistics need */
+void irq_init(void);
+
+/* Set the vector's priority, then enable it */
+void irq_enable(IRQn_Type irq, uint8_t priority);
+void irq_disable(IRQn_Type irq);
+
+/* ================= CRITICAL SECTIONS ================= */
+/*
+ * BASEPRI critical sections: hold off interrupts of priority ceiling
+ * and below (numerically >=); more urgent ones still run. Sections
+ * nest; pass the returned state back to irq_unlock().
+ *
+ *     uint32_t basepri = irq_lock();
+ *     ...
+ *     irq_unlock(basepri);
+ *
+ * BASEPRI cannot mask priority 0, so a ceiling of 0 is taken as 1.
+ * ISRs above IRQ_LOCK_CEILING are not kept out of driver sections:
+ * from there, call only lock-free APIs (timebase_now(), GPIO,
+ * tc_counter64_read()).
+ */
+uint32_t irq_lock(void);
+uint32_t irq_lock_to(uint8_t ceiling);
+void irq_unlock(uint32_t state);
+
+/* ================= MASKED WINDOW ================= */
+
+/*
+ * Worst time interrupts at the ceiling stayed masked, measured from
+ * the outermost irq_lock() to its irq_unlock(). PRIMASK sections
+ * (scheduler sleep, timebase_init()) are not included.
+ */
+void irq_get_mask_stats(irq_mask_stats_t *stats);
+void irq_reset_mask_stats(void);
+
+#endif /* IRQ_MGR_H */
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include "isr_prof.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * ISR execution time and latency.
+ *
+ *   handler entry ── isr_prof_enter(): busy0, t0 = CYCCNT
+ *        ...
+ *   handler exit ─── isr_prof_exit():  total = CYCCNT - t0
+ *                                      self  = total - (busy - busy0)
+ *                                      busy += self
+ *
+ * busy sums the self time of every profiled handler, so the time a
+ * nested handler spent inside this one is exactly busy - busy0 and
+ * each cycle is charged to one handler only. The few instructions
+ * updating busy run with PRIMASK set so a nesting handler cannot
+ * split the read-modify-write.
+ *
+ * The statistics of an id are written only by its own handler. All
+ * vectors sharing an id (SERCOM 0..3, DMAC 0..4, EXTINT 0..15) have
+ * one priority, so they never preempt each other.
+ */
+
+/* ================= STATE ================= */
+volatile uint32_t isr_prof_busy;
+
+static isr_prof_stats_t isr_prof_stats[ISR_PROF_IDS];
+
+static const char *const isr_prof_names[ISR_PROF_ID_USER(0)] =
+{
+    "TC0", "TC1", "TC2", "TC3", "TC4", "TC5", "TC6", "TC7",
+    "SERCOM0", "SERCOM1", "SERCOM2", "SERCOM3",
+    "SERCOM4", "SERCOM5", "SERCOM6", "SERCOM7",
+    "DMAC", "EIC", "RTC"
+};
+
+/* ================= LOCAL HELPERS ================= */
+
+/* Bin 0 for 0 cycles, bin k for 2^(k-1) .. 2^k - 1 */
+static inline uint32_t isr_prof_bin(uint32_t cycles)
+{
+    uint32_t bin = 32u - __CLZ(cycles);
+
+    return bin < ISR_PROF_HIST_BINS ? bin : ISR_PROF_HIST_BINS - 1u;
+}
+
+static void isr_prof_clear(isr_prof_stats_t *s)
+{
+    *s = (isr_prof_stats_t){0};
+    s->exec_min = 0xFFFFFFFFu;
+    s->lat_min  = 0xFFFFFFFFu;
+}
+
+/* ================= HOOKS ================= */
+void isr_prof_exit(const isr_prof_ctx_t *ctx, uint8_t id, uint32_t latency)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t busy = isr_prof_busy;
+    uint32_t self = (DWT->CYCCNT - ctx->t0) - (busy - ctx->busy0);
+    isr_prof_busy = busy + self;
+
+    __set_PRIMASK(primask);
+
+    if (id >= ISR_PROF_IDS)
+        return;
+
+    isr_prof_stats_t *s = &isr_prof_stats[id];
+
+    s->count++;
+    s->exec_sum += self;
+    if (self < s->exec_min)
+        s->exec_min = self;
+    if (self > s->exec_max)
+        s->exec_max = self;
+
+    if (latency == ISR_PROF_NO_LATENCY)
+        return;
+
+    s->lat_count++;
+    s->lat_sum += latency;
+    if (latency < s->lat_min)
+        s->lat_min = latency;
+    if (latency > s->lat_max)
+        s->lat_max = latency;
+    s->lat_hist[isr_prof_bin(latency)]++;
+}
+
+/* ================= INITIALIZATION ================= */
+void isr_prof_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    isr_prof_reset();
+}
+
+/* ================= STATISTICS ================= */
+void isr_prof_get(uint8_t id, isr_prof_stats_t *stats)
+{
+    if (id >= ISR_PROF_IDS)
+        return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = isr_prof_stats[id];
+    __set_PRIMASK(primask);
+}
+
+void isr_prof_reset(void)
+{
+    for (uint8_t id = 0; id < ISR_PROF_IDS; id++)
+    {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        isr_prof_clear(&isr_prof_stats[id]);
+        __set_PRIMASK(primask);
+    }
+}
+
+const char *isr_prof_name(uint8_t id)
+{
+    static char user[8];
+
+    if (id < sizeof isr_prof_names / sizeof isr_prof_names[0])
+        return isr_prof_names[id];
+
+    snprintf(user, sizeof user, "USER%u", (unsigned)(id - ISR_PROF_ID_USER(0)));
+    return user;
+}
+
+/* ================= DUMP ================= */
+void isr_prof_dump(void (*write)(const char *str))
+{
+    char line[128];
+    isr_prof_stats_t s;
+
+    for (uint8_t id = 0; id < ISR_PROF_IDS; id++)
+    {
+        isr_prof_get(id, &s);
+
+        if (s.count == 0u)
+            continue;
+
+        int n = snprintf(line, sizeof line, "isr=%s n=%lu exec=%lu/%lu/%lu",
+                         isr_prof_name(id), (unsigned long)s.count,
+                         (unsigned long)s.exec_min,
+                         (unsigned long)(s.exec_sum / s.count),
+                         (unsigned long)s.exec_max);
+
+        if (s.lat_count)
+        {
+            n += snprintf(line + n, sizeof line - (size_t)n, " lat=%lu/%lu/%lu hist=",
+                          (unsigned long)s.lat_min,
+                          (unsigned long)(s.lat_sum / s.lat_count),
+                          (unsigned long)s.lat_max);
+        }
+        write(line);
+
+        /* Histogram in pieces: line stays short at any bin count */
+        for (uint32_t b = 0; s.lat_count && b < ISR_PROF_HIST_BINS; b++)
+        {
+            snprintf(line, sizeof line, b ? ",%lu" : "%lu", (unsigned long)s.lat_hist[b]);
+            write(line);
+        }
+
+        write("\r\n");
+    }
+}
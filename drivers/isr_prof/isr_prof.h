@@ -0,0 +1,110 @@
+#ifndef ISR_PROF_H
+#define ISR_PROF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+
+/* ================= ISR PROFILER CONFIG ================= */
+
+/*
+ * Entry / exit stamps in every driver handler. About 40 cycles per
+ * interrupt: meant to stay on. 0 compiles the hooks away.
+ */
+#ifndef ISR_PROF_ENABLE
+#define ISR_PROF_ENABLE         1
+#endif
+
+/* Latency histogram: bin 0 = 0 cycles, bin k = 2^(k-1) .. 2^k - 1, last = rest */
+#ifndef ISR_PROF_HIST_BINS
+#define ISR_PROF_HIST_BINS      12u
+#endif
+
+/* Slots for application vectors (ISR_PROF_ID_USER) */
+#ifndef ISR_PROF_USER_IDS
+#define ISR_PROF_USER_IDS       4u
+#endif
+
+/* ================= VECTOR IDS ================= */
+/* One id per driver handler; vectors sharing a handler share an id */
+#define ISR_PROF_ID_TC(n)       (0u + (n))      /* TC0 .. TC7              */
+#define ISR_PROF_ID_SERCOM(n)   (8u + (n))      /* SERCOMn, all 4 vectors  */
+#define ISR_PROF_ID_DMAC        16u             /* DMAC_0 .. DMAC_4        */
+#define ISR_PROF_ID_EIC         17u             /* EXTINT 0 .. 15          */
+#define ISR_PROF_ID_RTC         18u
+#define ISR_PROF_ID_USER(n)     (19u + (n))
+#define ISR_PROF_IDS            (19u + ISR_PROF_USER_IDS)
+
+#define ISR_PROF_NO_LATENCY     0xFFFFFFFFu
+
+/* ================= TYPES ================= */
+
+/* Per id, CPU cycles. Execution time excludes nested profiled ISRs. */
+typedef struct
+{
+    uint32_t count;
+    uint32_t exec_min;
+    uint32_t exec_max;
+    uint64_t exec_sum;
+    uint32_t lat_count;         /* Entries with a known event time */
+    uint32_t lat_min;
+    uint32_t lat_max;
+    uint64_t lat_sum;
+    uint32_t lat_hist[ISR_PROF_HIST_BINS];
+} isr_prof_stats_t;
+
+typedef struct
+{
+    uint32_t t0;                /* CYCCNT at entry                      */
+    uint32_t busy0;             /* Nested ISR time already accounted    */
+} isr_prof_ctx_t;
+
+/* ================= HOOKS ================= */
+
+/* Self time of all profiled ISRs so far: nested time is subtracted */
+extern volatile uint32_t isr_prof_busy;
+
+static inline isr_prof_ctx_t isr_prof_enter(void)
+{
+    isr_prof_ctx_t ctx;
+
+    /* busy first: an ISR nesting in between is outside both stamps */
+    ctx.busy0 = isr_prof_busy;
+    ctx.t0    = DWT->CYCCNT;
+    return ctx;
+}
+
+/* latency: cycles from the hardware event to entry, or ISR_PROF_NO_LATENCY */
+void isr_prof_exit(const isr_prof_ctx_t *ctx, uint8_t id, uint32_t latency);
+
+#if ISR_PROF_ENABLE
+#define ISR_PROF_ENTER(ctx)                 isr_prof_ctx_t ctx = isr_prof_enter()
+#define ISR_PROF_EXIT(ctx, id, latency)     isr_prof_exit(&(ctx), (id), (latency))
+#else
+#define ISR_PROF_ENTER(ctx)                 ((void)0)
+#define ISR_PROF_EXIT(ctx, id, latency)     ((void)0)
+#endif
+
+/* ================= ISR PROFILER PUBLIC API ================= */
+
+/* Start the DWT cycle counter and clear all statistics */
+void isr_prof_init(void);
+
+void isr_prof_get(uint8_t id, isr_prof_stats_t *stats);
+void isr_prof_reset(void);
+
+/* Short name of an id ("TC3", "SERCOM7", "USER0", ...) */
+const char *isr_prof_name(uint8_t id);
+
+/*
+ * One line per id that ran since the last reset, through write()
+ * (e.g. SERCOM7_USART_WriteString), as key=value pairs:
+ *
+ *   isr=TC2 n=10000 exec=112/118/240 lat=41/55/302 hist=0,0,0,...
+ *
+ * exec and lat are min/mean/max CPU cycles; lat is omitted when the
+ * handler has no event time. Runs in thread context.
+ */
+void isr_prof_dump(void (*write)(const char *str));
+
+#endif /* ISR_PROF_H */
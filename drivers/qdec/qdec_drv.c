@@ -0,0 +1,416 @@
+#include "qdec_drv.h"
+#include "timer_counter_drv.h"
+#include "evsys_drv.h"
+#include "eic_drv.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Quadrature decoder.
+ *
+ *   PDEC backend:  A ─► QDI0 ┐
+ *                  B ─► QDI1 ┴► PDEC QDEC X4 ─► 16-bit COUNT (±)
+ *
+ *   TC backend:    A ─► EXTINT (event only) ─► EVSYS async ─► TCn COUNT
+ *                                                  │ (+)
+ *   period TC:     A rising edge ──────────────────┴─► TCm PPW ─► CC0
+ *
+ * Neither backend interrupts per count. qdec_update() reads the 16-bit
+ * hardware count and folds its signed difference into a 32-bit
+ * position, so it must run before the counter moves by half its range.
+ * The index pulse is an EXTINT interrupt that latches the position.
+ */
+
+/* ================= MACROS ================= */
+#define QDEC_PDEC_GCLK_ID       31u     /* PDEC_GCLK_ID */
+#define QDEC_PMUX_G             6u      /* Peripheral function G: PDEC QDIx */
+
+/* ================= LOCAL HELPERS ================= */
+
+static void qdec_pin_mux(gpio_port_id_t port, uint8_t pin, uint8_t func)
+{
+    port_group_registers_t *group = &PORT_REGS->GROUP[port];
+
+    if (pin & 1u)
+        group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0x0Fu) | (uint8_t)(func << 4);
+    else
+        group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0xF0u) | (uint8_t)func;
+
+    group->PORT_PINCFG[pin] = PORT_PINCFG_PMUXEN_Msk | PORT_PINCFG_INEN_Msk;
+}
+
+static uint16_t qdec_pdec_read(void)
+{
+    PDEC_REGS->PDEC_CTRLBSET = PDEC_CTRLBSET_CMD_READSYNC;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_CTRLB_Msk);
+
+    return (uint16_t)PDEC_REGS->PDEC_COUNT;
+}
+
+static uint16_t qdec_read_raw(const qdec_t *q)
+{
+    if (q->backend == QDEC_BACKEND_PDEC)
+        return qdec_pdec_read();
+
+    return tc16_get_count(q->count_tc);
+}
+
+/* Signed counts from last to raw: PDEC counts both ways, TC only up */
+static int32_t qdec_delta(const qdec_t *q, uint16_t raw)
+{
+    uint16_t diff = (uint16_t)(raw - q->last_raw);
+
+    if (q->backend == QDEC_BACKEND_PDEC)
+        return (int16_t)diff;
+
+    return q->dir * (int32_t)diff;
+}
+
+/* Fold the hardware count into position / travel. irq_lock() held. */
+static void qdec_accumulate(qdec_t *q)
+{
+    uint16_t raw   = qdec_read_raw(q);
+    int32_t  delta = qdec_delta(q, raw);
+
+    q->last_raw  = raw;
+    q->position += delta;
+    q->travel   += delta;
+}
+
+/* EXTINT interrupt: index pulse. Cannot preempt qdec_accumulate(). */
+static void qdec_index_isr(uint8_t line, bool level, void *ctx)
+{
+    qdec_t *q = (qdec_t *)ctx;
+    (void)line;
+    (void)level;
+
+    int32_t pos = q->position + qdec_delta(q, qdec_read_raw(q));
+
+    if (q->home_pending)
+    {
+        q->position    -= pos;
+        pos             = 0;
+        q->home_pending = false;
+    }
+
+    q->index_position = pos;
+    q->index_count++;
+}
+
+/* ================= PDEC BACKEND ================= */
+static void qdec_pdec_init(const qdec_config_t *cfg)
+{
+    MCLK_REGS->MCLK_APBCMASK |= MCLK_APBCMASK_PDEC_Msk;
+    (void)clock_periph_enable(QDEC_PDEC_GCLK_ID, QDEC_PDEC_GCLK_GEN);
+
+    PDEC_REGS->PDEC_CTRLA = PDEC_CTRLA_SWRST_Msk;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_SWRST_Msk);
+
+    qdec_pin_mux(cfg->port, cfg->pin_a, QDEC_PMUX_G);
+    qdec_pin_mux(cfg->port, cfg->pin_b, QDEC_PMUX_G);
+
+    /* X4, 16-bit angular count wrapping at CC0, no revolution field */
+    PDEC_REGS->PDEC_CTRLA = PDEC_CTRLA_MODE_QDEC |
+                            PDEC_CTRLA_CONF_X4 |
+                            PDEC_CTRLA_ANGULAR(7) |
+                            PDEC_CTRLA_PINEN0_Msk |
+                            PDEC_CTRLA_PINEN1_Msk |
+                            (cfg->swap ? PDEC_CTRLA_SWAP_Msk : 0u);
+
+    PDEC_REGS->PDEC_FILTER = cfg->filter;
+
+    PDEC_REGS->PDEC_CC[0] = 0xFFFFu;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_CC0_Msk);
+
+    PDEC_REGS->PDEC_CTRLA |= PDEC_CTRLA_ENABLE_Msk;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_ENABLE_Msk);
+
+    PDEC_REGS->PDEC_CTRLBSET = PDEC_CTRLBSET_CMD_START;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_CTRLB_Msk);
+}
+
+static void qdec_pdec_deinit(void)
+{
+    PDEC_REGS->PDEC_CTRLA &= ~PDEC_CTRLA_ENABLE_Msk;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_ENABLE_Msk);
+
+    PDEC_REGS->PDEC_CTRLA = PDEC_CTRLA_SWRST_Msk;
+    while (PDEC_REGS->PDEC_SYNCBUSY & PDEC_SYNCBUSY_SWRST_Msk);
+
+    clock_periph_disable(QDEC_PDEC_GCLK_ID);
+    MCLK_REGS->MCLK_APBCMASK &= ~MCLK_APBCMASK_PDEC_Msk;
+}
+
+/* ================= TC BACKEND ================= */
+static bool qdec_tc_init(qdec_t *q, const qdec_config_t *cfg)
+{
+    tc_init(q->count_tc, TC_MODE_16BIT, TC_PRESCALER_DIV1, TC_WAVE_NFRQ, 0);
+    tc_set_event_action(q->count_tc, TC_EVACT_COUNT, false);
+
+    /* Event only: sense HIGH carries the level of A to the TC */
+    if (!eic_attach(cfg->port, cfg->pin_a, q->line_a, EIC_SENSE_HIGH, 0, 0, 0))
+        return false;
+    eic_disable_line(q->line_a);
+    eic_event_output_enable(q->line_a, true);
+
+    q->ev_ch = evsys_route(EVSYS_GEN_EIC_EXTINT(q->line_a), EVSYS_USER_TC(q->count_tc),
+                           EVSYS_PATH_ASYNC, EVSYS_EDGE_NONE);
+    if (q->ev_ch < 0)
+        return false;
+
+    tc_start(q->count_tc);
+    return true;
+}
+
+/* ================= PERIOD CAPTURE ================= */
+
+static bool qdec_period_init(qdec_t *q, const qdec_config_t *cfg)
+{
+    uint32_t tick_hz = tc_init_for_rate(q->period_tc, TC_MODE_16BIT, TC_WAVE_NFRQ, cfg->min_edge_hz);
+
+    if (tick_hz == 0u)
+        return false;
+
+    tc_capture_enable(q->period_tc, 0, TC_CAPTURE_PPWP, false);
+
+    if (q->backend == QDEC_BACKEND_TC)
+    {
+        /* Second user of the A event channel */
+        if (!evsys_user_attach(EVSYS_USER_TC(q->period_tc), (uint8_t)q->ev_ch))
+            return false;
+    }
+    else
+    {
+        if (!eic_attach(cfg->period_port, cfg->period_pin, q->period_line, EIC_SENSE_HIGH, 0, 0, 0))
+            return false;
+        eic_disable_line(q->period_line);
+        eic_event_output_enable(q->period_line, true);
+
+        q->ev_ch = evsys_route(EVSYS_GEN_EIC_EXTINT(q->period_line), EVSYS_USER_TC(q->period_tc),
+                               EVSYS_PATH_ASYNC, EVSYS_EDGE_NONE);
+        if (q->ev_ch < 0)
+            return false;
+    }
+
+    /* X4 counts 4 edges per A cycle, the TC backend only the rising one */
+    qdec_velocity_init(&q->vel, q->backend == QDEC_BACKEND_PDEC ? 4u : 1u,
+                       tick_hz, QDEC_MIN_COUNTS);
+
+    tc_start(q->period_tc);
+    return true;
+}
+
+/* ================= INITIALIZATION ================= */
+bool qdec_init(qdec_t *q, const qdec_config_t *cfg)
+{
+    *q = (qdec_t){0};
+
+    q->backend        = cfg->backend;
+    q->count_tc       = cfg->count_tc;
+    q->line_a         = cfg->line_a;
+    q->period_tc      = QDEC_NO_TC;
+    q->period_line    = cfg->period_line;
+    q->index_line     = QDEC_NO_LINE;
+    q->ev_ch          = -1;
+    q->dir            = 1;
+    q->counts_per_rev = cfg->counts_per_rev;
+
+    qdec_velocity_init(&q->vel, 1u, 0u, QDEC_MIN_COUNTS);
+
+    if (q->backend == QDEC_BACKEND_PDEC)
+    {
+        qdec_pdec_init(cfg);
+    }
+    else if (!qdec_tc_init(q, cfg))
+    {
+        qdec_deinit(q);
+        return false;
+    }
+
+    if (cfg->period_tc != QDEC_NO_TC)
+    {
+        q->period_tc = cfg->period_tc;
+
+        if (!qdec_period_init(q, cfg))
+        {
+            qdec_deinit(q);
+            return false;
+        }
+    }
+
+    if (cfg->index_line != QDEC_NO_LINE)
+    {
+        if (!eic_attach(cfg->index_port, cfg->index_pin, cfg->index_line,
+                        EIC_SENSE_RISE, EIC_FLAG_FILTER, qdec_index_isr, q))
+        {
+            qdec_deinit(q);
+            return false;
+        }
+        q->index_line = cfg->index_line;
+    }
+
+    q->last_raw    = qdec_read_raw(q);
+    q->last_update = timebase_now();
+
+    return true;
+}
+
+void qdec_deinit(qdec_t *q)
+{
+    if (q->index_line != QDEC_NO_LINE)
+        eic_detach(q->index_line);
+
+    if (q->ev_ch >= 0)
+        evsys_channel_free((uint8_t)q->ev_ch);
+
+    if (q->period_tc != QDEC_NO_TC)
+    {
+        tc_deinit(q->period_tc);
+
+        if (q->backend == QDEC_BACKEND_PDEC)
+        {
+            eic_event_output_enable(q->period_line, false);
+            eic_detach(q->period_line);
+        }
+    }
+
+    if (q->backend == QDEC_BACKEND_PDEC)
+    {
+        qdec_pdec_deinit();
+    }
+    else
+    {
+        eic_event_output_enable(q->line_a, false);
+        eic_detach(q->line_a);
+        tc_deinit(q->count_tc);
+    }
+
+    q->index_line = QDEC_NO_LINE;
+    q->period_tc  = QDEC_NO_TC;
+    q->ev_ch      = -1;
+}
+
+/* ================= POSITION ================= */
+int64_t qdec_update(qdec_t *q)
+{
+    uint64_t now    = timebase_now();
+    uint32_t dt_us  = (uint32_t)timebase_ticks_to_us(now - q->last_update);
+    uint32_t period = 0;
+
+    q->last_update = now;
+
+    uint32_t basepri = irq_lock();
+    qdec_accumulate(q);
+    irq_unlock(basepri);
+
+    int32_t counts = q->travel - q->vel_travel;
+    q->vel_travel  = q->travel;
+
+    if (q->period_tc != QDEC_NO_TC)
+    {
+        /* OVF first: a wrap before the capture is then always seen with it */
+        bool ovf = tc_overflow(q->period_tc);
+
+        if (tc_compare_match(q->period_tc))
+        {
+            period = tc16_get_capture(q->period_tc, 0);
+
+            /*
+             * PPW restarts the counter on every edge, so an overflow
+             * since the previous capture means this period is longer
+             * than the counter. Both flags in one update can only be
+             * wrap-then-edge unless the update took a whole wrap.
+             */
+            if (q->period_wrapped || ovf)
+                period = QDEC_VEL_WRAPPED;
+            q->period_wrapped = ovf && dt_us >= q->vel.wrap_us;
+
+            /* The first period runs from tc_start(), not from an edge */
+            if (!q->period_seen)
+            {
+                q->period_seen = true;
+                period         = 0;
+            }
+        }
+        else if (ovf)
+        {
+            q->period_wrapped = true;
+        }
+    }
+
+    return qdec_velocity_update(&q->vel, counts, dt_us, period);
+}
+
+int32_t qdec_position(qdec_t *q)
+{
+    uint32_t basepri = irq_lock();
+    qdec_accumulate(q);
+    int32_t position = q->position;
+    irq_unlock(basepri);
+
+    return position;
+}
+
+void qdec_set_position(qdec_t *q, int32_t position)
+{
+    uint32_t basepri = irq_lock();
+    qdec_accumulate(q);
+    q->position = position;
+    irq_unlock(basepri);
+}
+
+int64_t qdec_velocity_mcps(const qdec_t *q)
+{
+    return q->vel.mcps;
+}
+
+qdec_vel_method_t qdec_velocity_method(const qdec_t *q)
+{
+    return q->vel.method;
+}
+
+int32_t qdec_rpm_x10(const qdec_t *q)
+{
+    return qdec_velocity_rpm_x10(q->vel.mcps, q->counts_per_rev);
+}
+
+void qdec_set_direction(qdec_t *q, int8_t dir)
+{
+    /* Counts so far keep the old sign */
+    uint32_t basepri = irq_lock();
+    qdec_accumulate(q);
+    q->dir = dir < 0 ? -1 : 1;
+    irq_unlock(basepri);
+}
+
+/* ================= INDEX ================= */
+uint32_t qdec_index_count(const qdec_t *q)
+{
+    return q->index_count;
+}
+
+int32_t qdec_index_position(const qdec_t *q)
+{
+    return q->index_position;
+}
+
+void qdec_home_on_index(qdec_t *q)
+{
+    q->home_pending = true;
+}
+
+bool qdec_error(qdec_t *q)
+{
+    if (q->backend != QDEC_BACKEND_PDEC)
+        return false;
+
+    if (PDEC_REGS->PDEC_STATUS & PDEC_STATUS_QERR_Msk)
+    {
+        PDEC_REGS->PDEC_STATUS = PDEC_STATUS_QERR_Msk;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,148 @@
+#ifndef QDEC_DRV_H
+#define QDEC_DRV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_drv.h"
+#include "qdec_velocity.h"
+
+/* ================= QDEC CONFIG ================= */
+
+/* Generator clocking the PDEC counter and its input filter */
+#ifndef QDEC_PDEC_GCLK_GEN
+#define QDEC_PDEC_GCLK_GEN      1u
+#endif
+
+/* |counts| per qdec_update() from which M replaces T (see qdec_velocity.h) */
+#ifndef QDEC_MIN_COUNTS
+#define QDEC_MIN_COUNTS         16u
+#endif
+
+#define QDEC_NO_TC              0xFFu   /* period_tc: no period capture */
+#define QDEC_NO_LINE            0xFFu   /* index_line: no index input   */
+
+/* ================= BACKEND ================= */
+/*
+ * PDEC : the position decoder in QDEC X4 mode. Both channels decoded
+ *        in hardware: 4 counts per cycle, direction and phase errors.
+ *        Pins on peripheral function G (QDI0 = A, QDI1 = B).
+ * TC   : fallback when the PDEC pins are taken. A counts through
+ *        EXTINT → EVSYS → TC (count event action): 1 count per cycle,
+ *        no direction sense. B is not read; the direction is given by
+ *        the application (qdec_set_direction()), e.g. from the motor
+ *        drive command.
+ */
+typedef enum
+{
+    QDEC_BACKEND_PDEC = 0,
+    QDEC_BACKEND_TC
+} qdec_backend_t;
+
+typedef struct
+{
+    qdec_backend_t   backend;
+
+    gpio_port_id_t   port;          /* A and B, same port                */
+    uint8_t          pin_a;
+    uint8_t          pin_b;         /* PDEC only                         */
+    bool             swap;          /* PDEC: count the other way round   */
+    uint8_t          filter;        /* PDEC: input filter, GCLK periods  */
+
+    uint8_t          count_tc;      /* TC backend: 16-bit event counter  */
+    uint8_t          line_a;        /* TC backend: EXTINT line of pin_a  */
+
+    /*
+     * Optional period capture of A rising edges (T method). The TC
+     * backend shares the A event; the PDEC backend needs A wired to
+     * one more pin with its own EXTINT line (PDEC owns pin_a).
+     */
+    uint8_t          period_tc;     /* QDEC_NO_TC: M method only         */
+    gpio_port_id_t   period_port;   /* PDEC backend                      */
+    uint8_t          period_pin;
+    uint8_t          period_line;
+    uint32_t         min_edge_hz;   /* Slowest A rate timed: prescaler   */
+
+    /* Optional index (Z) pulse, once per revolution */
+    gpio_port_id_t   index_port;
+    uint8_t          index_pin;
+    uint8_t          index_line;    /* QDEC_NO_LINE: none                */
+
+    uint32_t         counts_per_rev;    /* For qdec_rpm_x10()            */
+} qdec_config_t;
+
+/*
+ * Decoder state (caller allocated). Members are driver private.
+ */
+typedef struct
+{
+    qdec_backend_t      backend;
+    uint8_t             count_tc;
+    uint8_t             line_a;
+    uint8_t             period_tc;
+    uint8_t             period_line;
+    uint8_t             index_line;
+    int8_t              ev_ch;
+    int8_t              dir;            /* TC backend: +1 / -1              */
+    uint16_t            last_raw;       /* Hardware count at the last read  */
+    volatile int32_t    position;       /* Counts, index homing applied     */
+    int32_t             travel;         /* Counts, never re-zeroed          */
+    int32_t             vel_travel;     /* travel at the last update        */
+    uint64_t            last_update;    /* timebase_now() ticks             */
+    uint32_t            counts_per_rev;
+    volatile uint32_t   index_count;
+    volatile int32_t    index_position;
+    volatile bool       home_pending;
+    bool                period_seen;    /* First capture dropped            */
+    bool                period_wrapped; /* OVF since the last capture      */
+    qdec_velocity_t     vel;
+} qdec_t;
+
+/* ================= QDEC PUBLIC API ================= */
+
+/*
+ * Claim the backend's hardware and start counting from position 0.
+ * The TC backend and the period capture need evsys_init(); the EIC is
+ * initialized on demand. qdec_update() needs timebase_init().
+ */
+bool qdec_init(qdec_t *q, const qdec_config_t *cfg);
+
+/* Release the PDEC / TCs, event channel and EXTINT lines */
+void qdec_deinit(qdec_t *q);
+
+/*
+ * Fold the hardware count into the 32-bit position and run one
+ * velocity step. Call periodically (1 kHz is typical), at least once
+ * per 32767 counts: the hardware counter is 16 bits wide.
+ * Returns the velocity in millicounts per second.
+ */
+int64_t qdec_update(qdec_t *q);
+
+/* Current position (reads the hardware count) */
+int32_t qdec_position(qdec_t *q);
+void qdec_set_position(qdec_t *q, int32_t position);
+
+/* Result of the last qdec_update() */
+int64_t qdec_velocity_mcps(const qdec_t *q);
+qdec_vel_method_t qdec_velocity_method(const qdec_t *q);
+int32_t qdec_rpm_x10(const qdec_t *q);
+
+/* TC backend: sign of the counts from now on (+1 / -1) */
+void qdec_set_direction(qdec_t *q, int8_t dir);
+
+/* ================= INDEX ================= */
+
+/* Index pulses seen, and the position at the last one */
+uint32_t qdec_index_count(const qdec_t *q);
+int32_t qdec_index_position(const qdec_t *q);
+
+/* Make the position 0 at the next index pulse */
+void qdec_home_on_index(qdec_t *q);
+
+/*
+ * PDEC: a quadrature error (both channels changed at once, or a
+ * missing edge) was seen since the last call. Clears the flag.
+ * Always false for the TC backend.
+ */
+bool qdec_error(qdec_t *q);
+
+#endif /* QDEC_DRV_H */
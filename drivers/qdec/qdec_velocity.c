@@ -0,0 +1,101 @@
+#include "qdec_velocity.h"
+
+/*
+ * M / T velocity estimator.
+ *
+ * M is used as soon as an update period holds min_counts counts: its
+ * relative error (one count) is then at most 1 / min_counts. Below
+ * that the last captured period gives the speed; its resolution is
+ * one capture tick, far finer than a count per update at low speed.
+ *
+ * A shaft that slows down or stops produces no new capture, so the
+ * last period would be held forever. No count for t means the speed
+ * is below 1 count / t: the T estimate is clamped to that bound and
+ * decays towards zero while the shaft stays still. A capture the TC
+ * overflowed before (QDEC_VEL_WRAPPED, from its OVF flag) is truncated
+ * and dropped; M takes over until captures are valid again. The time
+ * between the updates that saw two captures cannot tell: it is the
+ * edge spacing give or take one update period.
+ */
+
+/* ================= MACROS ================= */
+#define QDEC_MCPS_PER_CPUS      1000000000LL    /* 1 count / µs in millicounts / s */
+
+/* ================= INITIALIZATION ================= */
+void qdec_velocity_init(qdec_velocity_t *v,
+                        uint32_t counts_per_period,
+                        uint32_t tick_hz,
+                        uint32_t min_counts)
+{
+    *v = (qdec_velocity_t){0};
+
+    v->counts_per_period = counts_per_period ? counts_per_period : 1u;
+    v->tick_hz           = tick_hz;
+    v->min_counts        = min_counts ? min_counts : 1u;
+    v->wrap_us           = tick_hz ? (uint32_t)(65536ULL * 1000000u / tick_hz) : 0u;
+}
+
+/* ================= ESTIMATOR ================= */
+int64_t qdec_velocity_update(qdec_velocity_t *v, int32_t counts, uint32_t dt_us, uint32_t period)
+{
+    uint32_t mag = (uint32_t)(counts < 0 ? -(int64_t)counts : counts);
+
+    if (period == QDEC_VEL_WRAPPED)
+        v->period = 0;
+    else if (period)
+        v->period = period;
+
+    if (counts)
+    {
+        v->dir = counts > 0 ? 1 : -1;
+        v->since_edge_us = 0;
+    }
+    else
+    {
+        v->since_edge_us += dt_us;
+    }
+
+    if (dt_us == 0u)
+        return v->mcps;
+
+    /* M: enough counts, or nothing better */
+    if (mag >= v->min_counts || v->tick_hz == 0u || v->period == 0u)
+    {
+        if (mag == 0u && v->dir == 0)
+            v->method = QDEC_VEL_NONE;
+        else
+            v->method = QDEC_VEL_M;
+
+        v->mcps = (int64_t)counts * QDEC_MCPS_PER_CPUS / dt_us;
+        return v->mcps;
+    }
+
+    /* T: counts_per_period counts in period ticks */
+    int64_t t_mcps = (int64_t)v->counts_per_period * v->tick_hz * 1000 / v->period;
+
+    v->method = QDEC_VEL_T;
+
+    if (v->since_edge_us)
+    {
+        int64_t bound = QDEC_MCPS_PER_CPUS / (int64_t)v->since_edge_us;
+
+        if (t_mcps > bound)
+        {
+            t_mcps    = bound;
+            v->method = QDEC_VEL_STALL;
+        }
+    }
+
+    v->mcps = v->dir * t_mcps;
+    return v->mcps;
+}
+
+/* ================= CONVERSION ================= */
+int32_t qdec_velocity_rpm_x10(int64_t mcps, uint32_t counts_per_rev)
+{
+    if (counts_per_rev == 0u)
+        return 0;
+
+    /* rpm × 10 = cps × 600 / cpr = mcps × 3 / (5 × cpr) */
+    return (int32_t)(mcps * 3 / (5 * (int64_t)counts_per_rev));
+}
@@ -0,0 +1,68 @@
+#ifndef QDEC_VELOCITY_H
+#define QDEC_VELOCITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Encoder velocity from two measurements, picked per update:
+ *
+ *   M method: counts in the last update period / its length.
+ *             Accurate when many counts arrive per update.
+ *   T method: time between two edges of one channel, captured by a TC.
+ *             Accurate when edges are slow, where M sees 0 or 1 count.
+ *
+ * Pure integer computation with no register access (like capture_stats):
+ * the same code runs on a host against synthetic edge streams.
+ */
+
+/* ================= TYPES ================= */
+typedef enum
+{
+    QDEC_VEL_NONE = 0,      /* No edge seen yet              */
+    QDEC_VEL_M,             /* Count difference              */
+    QDEC_VEL_T,             /* Captured period               */
+    QDEC_VEL_STALL          /* T, bounded by time since edge */
+} qdec_vel_method_t;
+
+typedef struct
+{
+    /* Configuration */
+    uint32_t counts_per_period; /* Counts between two captured edges (X4: 4) */
+    uint32_t tick_hz;           /* Capture TC rate, 0 = M method only        */
+    uint32_t min_counts;        /* |counts| from which M is used             */
+    uint32_t wrap_us;           /* Capture TC range                          */
+
+    /* State */
+    int8_t            dir;
+    uint32_t          period;           /* Last valid capture, ticks */
+    uint64_t          since_edge_us;    /* Time without a count      */
+    int64_t           mcps;             /* Millicounts per second    */
+    qdec_vel_method_t method;
+} qdec_velocity_t;
+
+/* period argument: a capture came, but the TC wrapped before it */
+#define QDEC_VEL_WRAPPED        0xFFFFFFFFu
+
+/* ================= API ================= */
+
+/* tick_hz = 0: no period capture. min_counts 0 is taken as 1. */
+void qdec_velocity_init(qdec_velocity_t *v,
+                        uint32_t counts_per_period,
+                        uint32_t tick_hz,
+                        uint32_t min_counts);
+
+/*
+ * One estimator step.
+ *   counts : signed count change since the previous step
+ *   dt_us  : time since the previous step
+ *   period : new capture since the previous step (ticks), 0 = none,
+ *            QDEC_VEL_WRAPPED = a capture the TC overflowed before
+ * Returns the velocity in millicounts per second.
+ */
+int64_t qdec_velocity_update(qdec_velocity_t *v, int32_t counts, uint32_t dt_us, uint32_t period);
+
+/* Millicounts per second → rpm × 10 */
+int32_t qdec_velocity_rpm_x10(int64_t mcps, uint32_t counts_per_rev);
+
+#endif /* QDEC_VELOCITY_H */
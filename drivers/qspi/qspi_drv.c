@@ -0,0 +1,386 @@
+#include "qspi_drv.h"
+#include "clock_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * QSPI in serial-memory mode.
+ *
+ * Every access is an instruction frame (INSTRCTRL + INSTRFRAME); data
+ * moves through the AHB window at QSPI_MEM_BASE. A command-mode frame
+ * ends with CTRLA.LASTXFER, which releases CS. Memory-mapped mode keeps
+ * a READMEMORY frame loaded, so any AHB read in the window turns into
+ * a quad read without software.
+ */
+
+/* ================= MACROS ================= */
+#define QSPI_PORTA          0
+#define QSPI_PORTB          1
+#define QSPI_PMUX_H         7u      /* Peripheral function H */
+
+#define QSPI_MEM            ((volatile uint8_t *)QSPI_MEM_BASE)
+
+/* ================= STATE ================= */
+static bool xip_active = false;
+
+static uint32_t qspi_sck_max = 0;     /* Requested SCK ceiling */
+static clock_notifier_t qspi_clock_nb;
+
+/* ================= LOCAL HELPERS ================= */
+
+/*
+ * PA08..PA11 → DATA0..3, PB10 → SCK, PB11 → CS (function H)
+ */
+static void qspi_pins_init(void)
+{
+    static const uint8_t pins[][2] =
+    {
+        { QSPI_PORTA, 8 }, { QSPI_PORTA, 9 }, { QSPI_PORTA, 10 }, { QSPI_PORTA, 11 },
+        { QSPI_PORTB, 10 }, { QSPI_PORTB, 11 }
+    };
+
+    for (uint8_t i = 0; i < sizeof pins / sizeof pins[0]; i++)
+    {
+        uint8_t port = pins[i][0];
+        uint8_t pin  = pins[i][1];
+
+        if (pin & 1u)
+            PORT_REGS->GROUP[port].PORT_PMUX[pin >> 1] =
+                (PORT_REGS->GROUP[port].PORT_PMUX[pin >> 1] & 0x0Fu) | (QSPI_PMUX_H << 4);
+        else
+            PORT_REGS->GROUP[port].PORT_PMUX[pin >> 1] =
+                (PORT_REGS->GROUP[port].PORT_PMUX[pin >> 1] & 0xF0u) | QSPI_PMUX_H;
+
+        PORT_REGS->GROUP[port].PORT_PINCFG[pin] |= PORT_PINCFG_PMUXEN_Msk;
+    }
+}
+
+/* Load a frame; reading it back makes sure it is applied before data access */
+static void qspi_frame(uint32_t frame)
+{
+    QSPI_REGS->QSPI_INSTRFRAME = frame;
+    (void)QSPI_REGS->QSPI_INSTRFRAME;
+}
+
+/* Close the current frame: CS goes high once the last byte is out */
+static void qspi_frame_end(void)
+{
+    __DSB();
+    __ISB();
+
+    QSPI_REGS->QSPI_CTRLA = QSPI_CTRLA_ENABLE_Msk | QSPI_CTRLA_LASTXFER_Msk;
+
+    while (!(QSPI_REGS->QSPI_INTFLAG & QSPI_INTFLAG_INSTREND_Msk));
+    QSPI_REGS->QSPI_INTFLAG = QSPI_INTFLAG_INSTREND_Msk;
+}
+
+/* 1-4-4 fast read frame, used by qspi_flash_read() and XIP */
+static void qspi_read_frame(void)
+{
+    QSPI_REGS->QSPI_INSTRCTRL =
+        QSPI_INSTRCTRL_INSTR(QSPI_CMD_QUAD_IO_READ) |
+        QSPI_INSTRCTRL_OPTCODE(0xFFu);              /* Mode byte: no continuous read */
+
+    qspi_frame(QSPI_INSTRFRAME_WIDTH(QSPI_WIDTH_1_4_4) |
+               QSPI_INSTRFRAME_INSTREN_Msk |
+               QSPI_INSTRFRAME_ADDREN_Msk |
+               QSPI_INSTRFRAME_OPTCODEEN_Msk |
+               QSPI_INSTRFRAME_OPTCODELEN_8BITS |
+               QSPI_INSTRFRAME_DATAEN_Msk |
+               QSPI_INSTRFRAME_ADDRLEN_24BITS |
+               QSPI_INSTRFRAME_DUMMYLEN(QSPI_QUAD_READ_DUMMY) |
+               QSPI_INSTRFRAME_TFRTYPE_READMEMORY);
+}
+
+/* Commands need the bus: take it from XIP for the duration */
+static bool qspi_xip_pause(void)
+{
+    bool was_active = xip_active;
+
+    if (was_active)
+        qspi_xip_disable();
+
+    return was_active;
+}
+
+static void qspi_xip_resume(bool was_active)
+{
+    if (was_active)
+    {
+        /* Flash content may have changed under the cache */
+        if (CMCC_REGS->CMCC_SR & CMCC_SR_CSTS_Msk)
+            CMCC_REGS->CMCC_MAINT0 = CMCC_MAINT0_INVALL_Msk;
+
+        qspi_xip_enable();
+    }
+}
+
+/*
+ * SCK = CPU clock / (BAUD + 1), never above the requested rate
+ */
+static uint32_t qspi_baud_for(uint32_t clk_hz, uint32_t sck_hz)
+{
+    uint32_t div = (clk_hz + sck_hz - 1u) / sck_hz;
+
+    if (div == 0u)
+        div = 1u;
+    if (div > 256u)
+        div = 256u;
+
+    return QSPI_BAUD_BAUD(div - 1u);
+}
+
+/*
+ * CPU clock changed: CLK_QSPI_AHB changed with it, rescale SCK.
+ */
+static void qspi_clock_changed(uint8_t gen, clock_event_t event, uint32_t hz, void *ctx)
+{
+    (void)gen;
+    (void)ctx;
+
+    if (event == CLOCK_EVENT_POST_CHANGE)
+        QSPI_REGS->QSPI_BAUD = qspi_baud_for(hz, qspi_sck_max);
+}
+
+/* ================= INITIALIZATION ================= */
+void qspi_init(uint32_t sck_hz)
+{
+    qspi_sck_max = sck_hz;
+
+    /* QSPI has no GCLK: AHB, 2x AHB and APB clocks only */
+    MCLK_REGS->MCLK_AHBMASK  |= MCLK_AHBMASK_QSPI_Msk | MCLK_AHBMASK_QSPI_2X_Msk;
+    MCLK_REGS->MCLK_APBCMASK |= MCLK_APBCMASK_QSPI_Msk;
+
+    qspi_pins_init();
+
+    QSPI_REGS->QSPI_CTRLA = QSPI_CTRLA_SWRST_Msk;
+    while (QSPI_REGS->QSPI_CTRLA & QSPI_CTRLA_SWRST_Msk);
+
+    /* Serial memory mode, CS released by LASTXFER, 8-bit data */
+    QSPI_REGS->QSPI_CTRLB =
+        QSPI_CTRLB_MODE_MEMORY |
+        QSPI_CTRLB_CSMODE_LASTXFER |
+        QSPI_CTRLB_DATALEN_8BITS;
+
+    /* SPI mode 0, SCK = CPU clock / (BAUD + 1) */
+    QSPI_REGS->QSPI_BAUD = qspi_baud_for(clock_cpu_hz(), sck_hz);
+
+    QSPI_REGS->QSPI_CTRLA = QSPI_CTRLA_ENABLE_Msk;
+    while (!(QSPI_REGS->QSPI_STATUS & QSPI_STATUS_ENABLE_Msk));
+
+    xip_active = false;
+
+    clock_notifier_unregister(&qspi_clock_nb);
+    qspi_clock_nb.gen      = CLOCK_GEN_CPU;
+    qspi_clock_nb.callback = qspi_clock_changed;
+    clock_notifier_register(&qspi_clock_nb);
+}
+
+/* ================= COMMAND MODE ================= */
+void qspi_command(uint8_t instr)
+{
+    bool xip = qspi_xip_pause();
+
+    QSPI_REGS->QSPI_INSTRCTRL = QSPI_INSTRCTRL_INSTR(instr);
+    qspi_frame(QSPI_INSTRFRAME_WIDTH(QSPI_WIDTH_1_1_1) |
+               QSPI_INSTRFRAME_INSTREN_Msk |
+               QSPI_INSTRFRAME_TFRTYPE_READ);
+    qspi_frame_end();
+
+    qspi_xip_resume(xip);
+}
+
+void qspi_command_read(uint8_t instr, uint8_t *buf, size_t len)
+{
+    bool xip = qspi_xip_pause();
+
+    QSPI_REGS->QSPI_INSTRCTRL = QSPI_INSTRCTRL_INSTR(instr);
+    qspi_frame(QSPI_INSTRFRAME_WIDTH(QSPI_WIDTH_1_1_1) |
+               QSPI_INSTRFRAME_INSTREN_Msk |
+               QSPI_INSTRFRAME_DATAEN_Msk |
+               QSPI_INSTRFRAME_TFRTYPE_READ);
+
+    for (size_t i = 0; i < len; i++)
+        buf[i] = QSPI_MEM[i];
+
+    qspi_frame_end();
+
+    qspi_xip_resume(xip);
+}
+
+void qspi_command_write(uint8_t instr, const uint8_t *buf, size_t len)
+{
+    bool xip = qspi_xip_pause();
+
+    QSPI_REGS->QSPI_INSTRCTRL = QSPI_INSTRCTRL_INSTR(instr);
+    qspi_frame(QSPI_INSTRFRAME_WIDTH(QSPI_WIDTH_1_1_1) |
+               QSPI_INSTRFRAME_INSTREN_Msk |
+               QSPI_INSTRFRAME_DATAEN_Msk |
+               QSPI_INSTRFRAME_TFRTYPE_WRITE);
+
+    for (size_t i = 0; i < len; i++)
+        QSPI_MEM[i] = buf[i];
+
+    qspi_frame_end();
+
+    qspi_xip_resume(xip);
+}
+
+void qspi_command_addr(uint8_t instr, uint32_t addr)
+{
+    bool xip = qspi_xip_pause();
+
+    QSPI_REGS->QSPI_INSTRADDR = addr;
+    QSPI_REGS->QSPI_INSTRCTRL = QSPI_INSTRCTRL_INSTR(instr);
+    qspi_frame(QSPI_INSTRFRAME_WIDTH(QSPI_WIDTH_1_1_1) |
+               QSPI_INSTRFRAME_INSTREN_Msk |
+               QSPI_INSTRFRAME_ADDREN_Msk |
+               QSPI_INSTRFRAME_ADDRLEN_24BITS |
+               QSPI_INSTRFRAME_TFRTYPE_WRITE);
+    qspi_frame_end();
+
+    qspi_xip_resume(xip);
+}
+
+/* ================= NOR FLASH HELPERS ================= */
+uint32_t qspi_flash_read_id(void)
+{
+    uint8_t id[3];
+
+    qspi_command_read(QSPI_CMD_READ_ID, id, sizeof id);
+
+    return ((uint32_t)id[0] << 16) | ((uint32_t)id[1] << 8) | id[2];
+}
+
+uint8_t qspi_flash_read_status(void)
+{
+    uint8_t status;
+
+    qspi_command_read(QSPI_CMD_READ_STATUS, &status, 1);
+    return status;
+}
+
+void qspi_flash_wait_ready(void)
+{
+    while (qspi_flash_read_status() & QSPI_STATUS_WIP);
+}
+
+static void qspi_flash_erase(uint8_t instr, uint32_t addr)
+{
+    bool xip = qspi_xip_pause();
+
+    qspi_command(QSPI_CMD_WRITE_ENABLE);
+    qspi_command_addr(instr, addr);
+    qspi_flash_wait_ready();
+
+    qspi_xip_resume(xip);
+}
+
+void qspi_flash_erase_sector(uint32_t addr)
+{
+    qspi_flash_erase(QSPI_CMD_SECTOR_ERASE, addr);
+}
+
+void qspi_flash_erase_block(uint32_t addr)
+{
+    qspi_flash_erase(QSPI_CMD_BLOCK_ERASE, addr);
+}
+
+void qspi_flash_erase_chip(void)
+{
+    bool xip = qspi_xip_pause();
+
+    qspi_command(QSPI_CMD_WRITE_ENABLE);
+    qspi_command(QSPI_CMD_CHIP_ERASE);
+    qspi_flash_wait_ready();
+
+    qspi_xip_resume(xip);
+}
+
+/*
+ * Page program, 1-1-4. The address phase comes from the AHB address
+ * of the first write into the window (WRITEMEMORY).
+ */
+void qspi_flash_program(uint32_t addr, const uint8_t *data, size_t len)
+{
+    bool xip = qspi_xip_pause();
+
+    while (len)
+    {
+        size_t room  = QSPI_FLASH_PAGE_SIZE - (addr % QSPI_FLASH_PAGE_SIZE);
+        size_t chunk = (len < room) ? len : room;
+
+        qspi_command(QSPI_CMD_WRITE_ENABLE);
+
+        QSPI_REGS->QSPI_INSTRCTRL = QSPI_INSTRCTRL_INSTR(QSPI_CMD_QUAD_PROGRAM);
+        qspi_frame(QSPI_INSTRFRAME_WIDTH(QSPI_WIDTH_1_1_4) |
+                   QSPI_INSTRFRAME_INSTREN_Msk |
+                   QSPI_INSTRFRAME_ADDREN_Msk |
+                   QSPI_INSTRFRAME_ADDRLEN_24BITS |
+                   QSPI_INSTRFRAME_DATAEN_Msk |
+                   QSPI_INSTRFRAME_TFRTYPE_WRITEMEMORY);
+
+        for (size_t i = 0; i < chunk; i++)
+            QSPI_MEM[addr + i] = data[i];
+
+        qspi_frame_end();
+        qspi_flash_wait_ready();
+
+        addr += chunk;
+        data += chunk;
+        len  -= chunk;
+    }
+
+    qspi_xip_resume(xip);
+}
+
+/*
+ * One frame per call, word reads while source and destination are
+ * aligned. The benchmark example compares this against XIP reads.
+ */
+void qspi_flash_read(uint32_t addr, uint8_t *buf, size_t len)
+{
+    bool xip = qspi_xip_pause();
+    size_t i = 0;
+
+    qspi_read_frame();
+
+    if (((addr | (uint32_t)buf) & 3u) == 0u)
+    {
+        const volatile uint32_t *src = (const volatile uint32_t *)(QSPI_MEM_BASE + addr);
+        uint32_t *dst = (uint32_t *)buf;
+
+        for (; i + 4u <= len; i += 4u)
+            *dst++ = *src++;
+    }
+
+    for (; i < len; i++)
+        buf[i] = QSPI_MEM[addr + i];
+
+    qspi_frame_end();
+
+    qspi_xip_resume(xip);
+}
+
+/* ================= MEMORY-MAPPED (XIP) ================= */
+void qspi_xip_enable(void)
+{
+    if (xip_active)
+        return;
+
+    qspi_read_frame();
+    xip_active = true;
+}
+
+void qspi_xip_disable(void)
+{
+    if (!xip_active)
+        return;
+
+    qspi_frame_end();
+    xip_active = false;
+}
+
+bool qspi_xip_enabled(void)
+{
+    return xip_active;
+}
@@ -0,0 +1,116 @@
+#ifndef QSPI_DRV_H
+#define QSPI_DRV_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* ================= QSPI CONFIG ================= */
+
+/* AHB window the external flash is mapped to */
+#define QSPI_MEM_BASE           0x04000000UL
+#define QSPI_MEM_SIZE           0x01000000UL    /* 16 MB, 24-bit addressing */
+
+#ifndef QSPI_FLASH_PAGE_SIZE
+#define QSPI_FLASH_PAGE_SIZE    256u
+#endif
+
+#ifndef QSPI_FLASH_SECTOR_SIZE
+#define QSPI_FLASH_SECTOR_SIZE  4096u
+#endif
+
+/*
+ * Serial NOR opcodes (JEDEC common set).
+ * Override to match the fitted part if it differs.
+ */
+#ifndef QSPI_CMD_WRITE_ENABLE
+#define QSPI_CMD_WRITE_ENABLE   0x06u
+#endif
+#ifndef QSPI_CMD_READ_STATUS
+#define QSPI_CMD_READ_STATUS    0x05u
+#endif
+#ifndef QSPI_CMD_READ_ID
+#define QSPI_CMD_READ_ID        0x9Fu
+#endif
+#ifndef QSPI_CMD_SECTOR_ERASE
+#define QSPI_CMD_SECTOR_ERASE   0x20u   /* 4 KB  */
+#endif
+#ifndef QSPI_CMD_BLOCK_ERASE
+#define QSPI_CMD_BLOCK_ERASE    0xD8u   /* 64 KB */
+#endif
+#ifndef QSPI_CMD_CHIP_ERASE
+#define QSPI_CMD_CHIP_ERASE     0xC7u
+#endif
+#ifndef QSPI_CMD_QUAD_PROGRAM
+#define QSPI_CMD_QUAD_PROGRAM   0x32u   /* 1-1-4 page program   */
+#endif
+#ifndef QSPI_CMD_QUAD_IO_READ
+#define QSPI_CMD_QUAD_IO_READ   0xEBu   /* 1-4-4 fast read      */
+#endif
+#ifndef QSPI_QUAD_READ_DUMMY
+#define QSPI_QUAD_READ_DUMMY    4u      /* Dummy cycles after the mode byte */
+#endif
+
+#define QSPI_STATUS_WIP         (1u << 0)
+
+/* ================= BUS WIDTH ================= */
+/* INSTRFRAME.WIDTH: instruction - address - data */
+typedef enum
+{
+    QSPI_WIDTH_1_1_1 = 0,
+    QSPI_WIDTH_1_1_2 = 1,
+    QSPI_WIDTH_1_1_4 = 2,
+    QSPI_WIDTH_1_2_2 = 3,
+    QSPI_WIDTH_1_4_4 = 4,
+    QSPI_WIDTH_2_2_2 = 5,
+    QSPI_WIDTH_4_4_4 = 6
+} qspi_width_t;
+
+/* ================= QSPI PUBLIC API ================= */
+
+/*
+ * Clocks, pins (PA08..PA11, PB10 SCK, PB11 CS), memory mode, SCK <= sck_hz.
+ * SCK derives from the CPU clock (CLK_QSPI_AHB) and is rescaled when
+ * clock_set_cpu_hz() changes it.
+ */
+void qspi_init(uint32_t sck_hz);
+
+/*
+ * Command mode: one instruction frame per call, CS released at the end.
+ * Memory-mapped reads are suspended meanwhile and restored afterwards.
+ */
+void qspi_command(uint8_t instr);
+void qspi_command_read(uint8_t instr, uint8_t *buf, size_t len);
+void qspi_command_write(uint8_t instr, const uint8_t *buf, size_t len);
+void qspi_command_addr(uint8_t instr, uint32_t addr);
+
+/* ================= NOR FLASH HELPERS ================= */
+uint32_t qspi_flash_read_id(void);
+uint8_t qspi_flash_read_status(void);
+void qspi_flash_wait_ready(void);
+
+void qspi_flash_erase_sector(uint32_t addr);
+void qspi_flash_erase_block(uint32_t addr);
+void qspi_flash_erase_chip(void);
+
+/* Quad program, split at page boundaries; waits for completion */
+void qspi_flash_program(uint32_t addr, const uint8_t *data, size_t len);
+
+/* Quad I/O read through one instruction frame per call */
+void qspi_flash_read(uint32_t addr, uint8_t *buf, size_t len);
+
+/* ================= MEMORY-MAPPED (XIP) ================= */
+
+/*
+ * After qspi_xip_enable() the flash reads through plain pointers:
+ *     const uint16_t *lut = (const uint16_t *)QSPI_XIP_PTR(0x10000);
+ * Every AHB read in the window becomes a 1-4-4 fast read with no
+ * driver code involved. Erase / program calls pause XIP and resume it.
+ */
+#define QSPI_XIP_PTR(addr)      ((const volatile void *)(QSPI_MEM_BASE + (addr)))
+
+void qspi_xip_enable(void);
+void qspi_xip_disable(void);
+bool qspi_xip_enabled(void);
+
+#endif /* QSPI_DRV_H */
@@ -1,9 +1,20 @@
 #include "rtc_timer.h"
+#include "irq_mgr.h"
+#include "isr_prof.h"
 #include <pic32cx1025sg61128.h>
 
 static volatile bool rtcExpired = false;
 static volatile uint32_t app_tick_ms = 0;  
 
+static rtc_timer_callback_t rtc_callback = 0;
+static void *rtc_callback_ctx = 0;
+static volatile bool rtc_cmp0_soft = false;     /* CMP0 pended by software */
+
+static rtc_timer_callback_t rtc_wrap_callback = 0;
+static void *rtc_wrap_ctx = 0;
+
+static bool rtc_free_running = false;
+
 void RTC_Timer_Init(uint32_t compare)
 {
     /* Enable RTC clock */
@@ -67,3 +78,172 @@ uint32_t APP_GetTick(void)
 {
     return app_tick_ms;
 }
+
+/* ================= FREE-RUNNING MODE ================= */
+/*
+ * Several services (timer wheel, timebase) share the counter: only
+ * the first call resets it.
+ */
+void RTC_Timer_InitFreeRunning(void)
+{
+    if (rtc_free_running)
+        return;
+    rtc_free_running = true;
+
+    /* Enable RTC clock, 32 kHz from the always-on ULP oscillator */
+    MCLK_REGS->MCLK_APBAMASK |= MCLK_APBAMASK_RTC_Msk;
+    OSC32KCTRL_REGS->OSC32KCTRL_RTCCTRL = OSC32KCTRL_RTCCTRL_RTCSEL_ULP32K;
+
+    /* Reset RTC */
+    RTC_REGS->MODE0.RTC_CTRLA |= RTC_MODE0_CTRLA_SWRST_Msk;
+    while (RTC_REGS->MODE0.RTC_SYNCBUSY);
+
+    /* 32-bit counter at 1024 Hz, COUNT readable (COUNTSYNC) */
+    RTC_REGS->MODE0.RTC_CTRLA =
+        RTC_MODE0_CTRLA_MODE_COUNT32 |
+        RTC_MODE0_CTRLA_PRESCALER_DIV32 |
+        RTC_MODE0_CTRLA_COUNTSYNC_Msk;
+    while (RTC_REGS->MODE0.RTC_SYNCBUSY);
+
+    RTC_REGS->MODE0.RTC_INTENCLR = RTC_MODE0_INTENCLR_CMP0_Msk;
+    RTC_REGS->MODE0.RTC_INTFLAG  = RTC_MODE0_INTFLAG_CMP0_Msk;
+
+    RTC_REGS->MODE0.RTC_CTRLA |= RTC_MODE0_CTRLA_ENABLE_Msk;
+    while (RTC_REGS->MODE0.RTC_SYNCBUSY);
+}
+
+uint32_t RTC_Timer_GetCount(void)
+{
+    while (RTC_REGS->MODE0.RTC_SYNCBUSY & RTC_MODE0_SYNCBUSY_COUNT_Msk);
+    return RTC_REGS->MODE0.RTC_COUNT;
+}
+
+/*
+ * Move COMP0 without touching COUNT. A deadline that has already
+ * passed (or passes while COMP0 synchronizes) pends the interrupt
+ * by software so it is never missed.
+ */
+void RTC_Timer_ArmCompare(uint32_t value)
+{
+    RTC_REGS->MODE0.RTC_COMP[0] = value;
+    while (RTC_REGS->MODE0.RTC_SYNCBUSY & RTC_MODE0_SYNCBUSY_COMP0_Msk);
+
+    RTC_REGS->MODE0.RTC_INTFLAG  = RTC_MODE0_INTFLAG_CMP0_Msk;
+    RTC_REGS->MODE0.RTC_INTENSET = RTC_MODE0_INTENSET_CMP0_Msk;
+
+    if ((int32_t)(RTC_Timer_GetCount() - value) >= 0)
+    {
+        rtc_cmp0_soft = true;
+        NVIC_SetPendingIRQ(RTC_IRQn);
+    }
+}
+
+void RTC_Timer_DisarmCompare(void)
+{
+    RTC_REGS->MODE0.RTC_INTENCLR = RTC_MODE0_INTENCLR_CMP0_Msk;
+    RTC_REGS->MODE0.RTC_INTFLAG  = RTC_MODE0_INTFLAG_CMP0_Msk;
+}
+
+/* ================= EVENTS ================= */
+void RTC_Timer_SetEventOutput(uint32_t outputs)
+{
+    bool running = (RTC_REGS->MODE0.RTC_CTRLA & RTC_MODE0_CTRLA_ENABLE_Msk) != 0u;
+
+    if (running)
+    {
+        RTC_REGS->MODE0.RTC_CTRLA &= ~RTC_MODE0_CTRLA_ENABLE_Msk;
+        while (RTC_REGS->MODE0.RTC_SYNCBUSY & RTC_MODE0_SYNCBUSY_ENABLE_Msk);
+    }
+
+    /* PEREO0..7, CMPEO0..1, OVFEO */
+    RTC_REGS->MODE0.RTC_EVCTRL = outputs & 0x83FFUL;
+
+    if (running)
+    {
+        RTC_REGS->MODE0.RTC_CTRLA |= RTC_MODE0_CTRLA_ENABLE_Msk;
+        while (RTC_REGS->MODE0.RTC_SYNCBUSY & RTC_MODE0_SYNCBUSY_ENABLE_Msk);
+    }
+}
+
+/* ================= INTERRUPT ================= */
+static void rtc_irq_update(void)
+{
+    if (rtc_callback || rtc_wrap_callback)
+        irq_enable(RTC_IRQn, IRQ_PRIO_RTC);
+    else
+        NVIC_DisableIRQ(RTC_IRQn);
+}
+
+void RTC_Timer_RegisterCallback(rtc_timer_callback_t callback, void *ctx)
+{
+    NVIC_DisableIRQ(RTC_IRQn);
+
+    rtc_callback     = callback;
+    rtc_callback_ctx = ctx;
+
+    rtc_irq_update();
+}
+
+/*
+ * Half-period events: CMP1 at 0x80000000 and OVF at 0x00000000.
+ * Lets a reader tell which half of the 32-bit range COUNT is in
+ * without racing the interrupt (see timebase).
+ *
+ * @return COUNT sampled after the flags were cleared; no event for
+ *         that half is pending. Call with interrupts disabled to
+ *         seed the caller's state before the first event.
+ */
+uint32_t RTC_Timer_EnableWrapEvents(rtc_timer_callback_t callback, void *ctx)
+{
+    uint32_t before, count;
+
+    NVIC_DisableIRQ(RTC_IRQn);
+
+    rtc_wrap_callback = callback;
+    rtc_wrap_ctx      = ctx;
+
+    RTC_REGS->MODE0.RTC_COMP[1] = 0x80000000UL;
+    while (RTC_REGS->MODE0.RTC_SYNCBUSY & RTC_MODE0_SYNCBUSY_COMP1_Msk);
+
+    /* Retry if COUNT changed half while the flags were cleared */
+    do
+    {
+        before = RTC_Timer_GetCount();
+        RTC_REGS->MODE0.RTC_INTFLAG = RTC_MODE0_INTFLAG_CMP1_Msk | RTC_MODE0_INTFLAG_OVF_Msk;
+        count = RTC_Timer_GetCount();
+    } while ((before ^ count) & 0x80000000UL);
+
+    RTC_REGS->MODE0.RTC_INTENSET = RTC_MODE0_INTENSET_CMP1_Msk | RTC_MODE0_INTENSET_OVF_Msk;
+
+    rtc_irq_update();
+
+    return count;
+}
+
+void RTC_Handler(void)
+{
+    ISR_PROF_ENTER(prof);
+
+    uint16_t flags = RTC_REGS->MODE0.RTC_INTFLAG;
+
+    RTC_REGS->MODE0.RTC_INTFLAG = flags;
+
+    /* One call per half-period event */
+    if (rtc_wrap_callback)
+    {
+        if (flags & RTC_MODE0_INTFLAG_CMP1_Msk)
+            rtc_wrap_callback(rtc_wrap_ctx);
+        if (flags & RTC_MODE0_INTFLAG_OVF_Msk)
+            rtc_wrap_callback(rtc_wrap_ctx);
+    }
+
+    if ((flags & RTC_MODE0_INTFLAG_CMP0_Msk) || rtc_cmp0_soft)
+    {
+        rtc_cmp0_soft = false;
+
+        if (rtc_callback)
+            rtc_callback(rtc_callback_ctx);
+    }
+
+    ISR_PROF_EXIT(prof, ISR_PROF_ID_RTC, ISR_PROF_NO_LATENCY);
+}
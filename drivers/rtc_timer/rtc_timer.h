@@ -4,10 +4,40 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* Free-running mode: OSCULP32K / 32 */
+#define RTC_TIMER_FREE_HZ   1024u
+
+typedef void (*rtc_timer_callback_t)(void *ctx);
+
 void RTC_Timer_Init(uint32_t compare);
 void RTC_Timer_Start(void);
-void RTC_Timer_SetCompare(uint32_t value);
+void RTC_Timer_SetCompare(uint32_t value);     /* Restarts COUNT from 0 */
 bool RTC_Timer_Expired(void);
 uint32_t APP_GetTick(void);
 
+/*
+ * Free-running counter for software timers: COUNT is never reset,
+ * COMP0 is moved to the next deadline instead.
+ */
+void RTC_Timer_InitFreeRunning(void);
+uint32_t RTC_Timer_GetCount(void);
+void RTC_Timer_ArmCompare(uint32_t value);     /* Absolute COUNT value */
+void RTC_Timer_DisarmCompare(void);
+
+/* CMP0 interrupt → callback(ctx), interrupt context */
+void RTC_Timer_RegisterCallback(rtc_timer_callback_t callback, void *ctx);
+
+/* COUNT crossing 0x80000000 (CMP1) and 0 (OVF) → callback(ctx), once per event.
+ * Returns COUNT at the moment the events were armed. */
+uint32_t RTC_Timer_EnableWrapEvents(rtc_timer_callback_t callback, void *ctx);
+
+/* RTC_Timer_SetEventOutput() outputs (EVCTRL bit positions) */
+#define RTC_TIMER_EV_PER(n)     (1UL << (n))        /* Prescaler tap n */
+#define RTC_TIMER_EV_CMP(n)     (1UL << (8u + (n)))
+#define RTC_TIMER_EV_OVF        (1UL << 15)
+
+/* Events routed through EVSYS (EVSYS_GEN_RTC_*). EVCTRL is
+ * enable-protected: a running RTC is stopped for the rewrite. */
+void RTC_Timer_SetEventOutput(uint32_t outputs);
+
 #endif
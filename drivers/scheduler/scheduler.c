@@ -0,0 +1,342 @@
+#include "scheduler.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Cooperative run-to-completion scheduler.
+ *
+ * Each task owns an event queue and a unique priority. Posting an
+ * event enqueues it and sets the task's bit in sched_ready; the loop
+ * picks the highest set bit (CLZ), hands one event to that task's
+ * handler and comes back. Handlers never block, so a long one only
+ * delays tasks below it, never an interrupt.
+ *
+ * Interrupts only ever enqueue: the producer side of every queue and
+ * the ready mask are updated with LDREX/STREX, so posting needs no
+ * critical section and nested ISRs of any priority can post to the
+ * same task.
+ */
+
+/* ================= STATE ================= */
+static sched_task_t *sched_tasks[SCHED_PRIO_MAX] = {0};
+static volatile uint32_t sched_ready = 0;
+static sched_stats_t sched_stats = {0};
+
+static sched_task_t sched_defer_task;
+static sched_slot_t sched_defer_slots[SCHED_DEFER_QUEUE_LEN];
+
+/* ================= ATOMICS ================= */
+
+static bool sched_cas(volatile uint32_t *addr, uint32_t expected, uint32_t desired)
+{
+    do
+    {
+        if (__LDREXW(addr) != expected)
+        {
+            __CLREX();
+            return false;
+        }
+    } while (__STREXW(desired, addr));
+
+    return true;
+}
+
+static void sched_ready_set(uint32_t mask)
+{
+    uint32_t v;
+
+    do
+    {
+        v = __LDREXW(&sched_ready);
+    } while (__STREXW(v | mask, &sched_ready));
+}
+
+static void sched_ready_clear(uint32_t mask)
+{
+    uint32_t v;
+
+    do
+    {
+        v = __LDREXW(&sched_ready);
+    } while (__STREXW(v & ~mask, &sched_ready));
+}
+
+/* Statistics written by posting ISRs of any priority */
+static void sched_stat_inc(volatile uint32_t *addr)
+{
+    uint32_t v;
+
+    do
+    {
+        v = __LDREXW(addr);
+    } while (__STREXW(v + 1u, addr));
+}
+
+static void sched_stat_max(volatile uint32_t *addr, uint32_t value)
+{
+    uint32_t v;
+
+    do
+    {
+        v = __LDREXW(addr);
+        if (value <= v)
+        {
+            __CLREX();
+            return;
+        }
+    } while (__STREXW(value, addr));
+}
+
+/* ================= QUEUE ================= */
+
+/*
+ * Bounded MPMC ring (D. Vyukov): slot.seq == pos means free for the
+ * producer at pos, pos + 1 means filled for the consumer at pos.
+ */
+static void sched_queue_init(sched_queue_t *q, sched_slot_t *slots, uint32_t len)
+{
+    q->slots = slots;
+    q->mask  = len - 1u;
+    q->head  = 0;
+    q->tail  = 0;
+
+    for (uint32_t i = 0; i < len; i++)
+        slots[i].seq = i;
+}
+
+static bool sched_queue_push(sched_queue_t *q, const sched_event_t *event)
+{
+    uint32_t pos = q->head;
+    sched_slot_t *slot;
+
+    for (;;)
+    {
+        slot = &q->slots[pos & q->mask];
+        int32_t diff = (int32_t)(slot->seq - pos);
+
+        if (diff == 0)
+        {
+            if (sched_cas(&q->head, pos, pos + 1u))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;   /* Full */
+        }
+
+        pos = q->head;
+    }
+
+    slot->event = *event;
+    __DMB();
+    slot->seq = pos + 1u;
+
+    return true;
+}
+
+static bool sched_queue_pop(sched_queue_t *q, sched_event_t *event)
+{
+    uint32_t pos = q->tail;
+    sched_slot_t *slot = &q->slots[pos & q->mask];
+
+    if ((int32_t)(slot->seq - (pos + 1u)) < 0)
+        return false;       /* Empty */
+
+    *event = slot->event;
+    __DMB();
+    slot->seq = pos + q->mask + 1u;
+    q->tail   = pos + 1u;
+
+    return true;
+}
+
+static bool sched_queue_empty(const sched_queue_t *q)
+{
+    return q->head == q->tail;
+}
+
+/* ================= CYCLE COUNTER ================= */
+
+static inline uint32_t sched_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/* ================= DEFERRED WORK ================= */
+
+static void sched_defer_handler(const sched_event_t *event, void *ctx)
+{
+    (void)ctx;
+
+    event->fn(event->data);
+}
+
+/* ================= INITIALIZATION ================= */
+void sched_init(void)
+{
+    for (uint32_t i = 0; i < SCHED_PRIO_MAX; i++)
+        sched_tasks[i] = 0;
+
+    sched_ready = 0;
+    sched_stats.cycles_busy = 0;
+    sched_stats.cycles_idle = 0;
+
+    /* Handler run times come from the DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    (void)sched_task_create(&sched_defer_task, "defer", SCHED_DEFER_PRIORITY,
+                            sched_defer_handler, 0,
+                            sched_defer_slots, SCHED_DEFER_QUEUE_LEN);
+}
+
+bool sched_task_create(sched_task_t *task,
+                       const char *name,
+                       uint8_t priority,
+                       sched_handler_t handler,
+                       void *ctx,
+                       sched_slot_t *queue_buf,
+                       uint32_t queue_len)
+{
+    if (priority >= SCHED_PRIO_MAX || sched_tasks[priority] || !handler)
+        return false;
+    if (queue_len == 0u || (queue_len & (queue_len - 1u)))
+        return false;
+
+    task->name     = name;
+    task->handler  = handler;
+    task->ctx      = ctx;
+    task->priority = priority;
+    sched_queue_init(&task->queue, queue_buf, queue_len);
+    sched_task_reset_stats(task);
+
+    sched_tasks[priority] = task;
+    return true;
+}
+
+/* ================= POSTING ================= */
+static bool sched_post_event(sched_task_t *task, const sched_event_t *event)
+{
+    if (!sched_queue_push(&task->queue, event))
+    {
+        sched_stat_inc(&task->stats.dropped);
+        return false;
+    }
+
+    sched_stat_max(&task->stats.queue_high_water, task->queue.head - task->queue.tail);
+
+    sched_ready_set(1u << task->priority);
+    return true;
+}
+
+bool sched_post(sched_task_t *task, uint32_t id, void *data)
+{
+    sched_event_t event = { .id = id, .data = data };
+
+    return sched_post_event(task, &event);
+}
+
+bool sched_defer(void (*fn)(void *arg), void *arg)
+{
+    sched_event_t event = { .fn = fn, .data = arg };
+
+    return sched_post_event(&sched_defer_task, &event);
+}
+
+/* ================= DISPATCH ================= */
+bool sched_run_once(void)
+{
+    uint32_t ready = sched_ready;
+    sched_event_t event;
+
+    if (!ready)
+        return false;
+
+    uint32_t prio = 31u - __CLZ(ready);
+    sched_task_t *task = sched_tasks[prio];
+
+    /* Clear before popping: a post racing the pop sets it again */
+    sched_ready_clear(1u << prio);
+
+    if (!sched_queue_pop(&task->queue, &event))
+        return true;
+
+    if (!sched_queue_empty(&task->queue))
+        sched_ready_set(1u << prio);
+
+    uint32_t start = sched_cycles();
+    task->handler(&event, task->ctx);
+    uint32_t cycles = sched_cycles() - start;
+
+    task->stats.runs++;
+    task->stats.cycles_total += cycles;
+    task->stats.cycles_last   = cycles;
+    if (cycles > task->stats.cycles_max)
+        task->stats.cycles_max = cycles;
+
+    sched_stats.cycles_busy += cycles;
+    return true;
+}
+
+void sched_run(void)
+{
+    while (1)
+    {
+        if (sched_run_once())
+            continue;
+
+        /* Sleep unless an ISR posted since the check; WFI wakes with PRIMASK set */
+        __disable_irq();
+        if (!sched_ready)
+        {
+            uint32_t start = sched_cycles();
+            __WFI();
+            sched_stats.cycles_idle += sched_cycles() - start;
+        }
+        __enable_irq();
+    }
+}
+
+/* ================= STATISTICS ================= */
+void sched_task_get_stats(sched_task_t *task, sched_task_stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = task->stats;
+    __set_PRIMASK(primask);
+}
+
+void sched_task_reset_stats(sched_task_t *task)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    task->stats.runs             = 0;
+    task->stats.cycles_total     = 0;
+    task->stats.cycles_max       = 0;
+    task->stats.cycles_last      = 0;
+    task->stats.queue_high_water = 0;
+    task->stats.dropped          = 0;
+
+    __set_PRIMASK(primask);
+}
+
+void sched_get_stats(sched_stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = sched_stats;
+    __set_PRIMASK(primask);
+}
+
+sched_task_t *sched_task_next(sched_task_t *prev)
+{
+    int32_t prio = prev ? (int32_t)prev->priority - 1 : (int32_t)SCHED_PRIO_MAX - 1;
+
+    for (; prio >= 0; prio--)
+    {
+        if (sched_tasks[prio])
+            return sched_tasks[prio];
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= SCHEDULER CONFIG ================= */
+
+/* One task per priority, 0 (lowest) .. 31 (highest) */
+#define SCHED_PRIO_MAX          32u
+
+/* Built-in task running sched_defer() work */
+#ifndef SCHED_DEFER_PRIORITY
+#define SCHED_DEFER_PRIORITY    31u
+#endif
+
+#ifndef SCHED_DEFER_QUEUE_LEN
+#define SCHED_DEFER_QUEUE_LEN   32u     /* Power of two */
+#endif
+
+/* ================= TYPES ================= */
+
+typedef struct
+{
+    union
+    {
+        uint32_t  id;
+        void    (*fn)(void *arg);       /* Deferred work (sched_defer) */
+    };
+    void     *data;
+} sched_event_t;
+
+/* Queue storage, caller allocated: sched_slot_t buf[N], N a power of two */
+typedef struct
+{
+    volatile uint32_t  seq;
+    sched_event_t      event;
+} sched_slot_t;
+
+/*
+ * Bounded multi-producer / single-consumer queue.
+ * Producers (any ISR or task) reserve a slot with LDREX/STREX and
+ * publish it through its sequence number; the scheduler consumes.
+ */
+typedef struct
+{
+    sched_slot_t       *slots;
+    uint32_t            mask;
+    volatile uint32_t   head;           /* Next slot to reserve */
+    uint32_t            tail;           /* Next slot to consume */
+} sched_queue_t;
+
+typedef void (*sched_handler_t)(const sched_event_t *event, void *ctx);
+
+/*
+ * Execution statistics, DWT cycles. dropped and queue_high_water are
+ * updated by posting ISRs with LDREX/STREX, like the queue itself.
+ */
+typedef struct
+{
+    uint32_t runs;              /* Events handled                  */
+    uint64_t cycles_total;      /* Sum of handler run times        */
+    uint32_t cycles_max;        /* Longest single handler run      */
+    uint32_t cycles_last;
+    uint32_t queue_high_water;  /* Peak queued events              */
+    uint32_t dropped;           /* Posts refused, queue full       */
+} sched_task_stats_t;
+
+typedef struct
+{
+    const char         *name;
+    sched_handler_t     handler;
+    void               *ctx;
+    uint8_t             priority;
+    sched_queue_t       queue;
+    sched_task_stats_t  stats;
+} sched_task_t;
+
+typedef struct
+{
+    uint64_t cycles_busy;       /* In task handlers  */
+    uint64_t cycles_idle;       /* Sleeping in WFI   */
+} sched_stats_t;
+
+/* ================= SCHEDULER PUBLIC API ================= */
+
+/* Reset the task table and start the deferred-work task */
+void sched_init(void);
+
+/*
+ * Register a run-to-completion task. Each priority holds one task.
+ * queue_len must be a power of two.
+ */
+bool sched_task_create(sched_task_t *task,
+                       const char *name,
+                       uint8_t priority,
+                       sched_handler_t handler,
+                       void *ctx,
+                       sched_slot_t *queue_buf,
+                       uint32_t queue_len);
+
+/* Queue an event for a task. Lock-free, callable from any ISR */
+bool sched_post(sched_task_t *task, uint32_t id, void *data);
+
+/* Run fn(arg) later from the deferred-work task. Lock-free, ISR safe */
+bool sched_defer(void (*fn)(void *arg), void *arg);
+
+/*
+ * Run the highest-priority ready task for one event.
+ * @return false if nothing was ready
+ */
+bool sched_run_once(void);
+
+/* Dispatch forever, WFI when no task is ready */
+void sched_run(void);
+
+/* ================= STATISTICS ================= */
+void sched_task_get_stats(sched_task_t *task, sched_task_stats_t *stats);
+void sched_task_reset_stats(sched_task_t *task);
+void sched_get_stats(sched_stats_t *stats);
+
+/* Iterate the registered tasks, highest priority first (0 at the end) */
+sched_task_t *sched_task_next(sched_task_t *prev);
+
+#endif /* SCHEDULER_H */
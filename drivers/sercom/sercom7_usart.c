@@ -1,154 +1,199 @@
 #include "sercom7_usart.h"
 #include <pic32cx1025sg61128.h>
 
-/* ===================== Macros ===================== */
-#define PORTC_INDEX        2
-#define SERCOM7_GCLK_ID    37
-#define SERCOM_SLOW_GCLK   3
-#define SERCOM_REF_FREQ    48000000UL   // 48 MHz reference clock
-
-/* ===================== Local Helpers ===================== */
-
-/**
- * @brief Enable clocks required for SERCOM7 USART operation
+/*
+ * SERCOM7 USART on PC12 (TX) / PC13 (RX), optional PC14 (RTS) / PC15 (CTS).
  *
- * - Enables APBD bus clock for SERCOM7
- * - Connects GCLK0 to SERCOM7 core clock
- * - Enables shared SERCOM slow clock
+ * Thin wrapper over the generic instance driver in sercom_usart.c; all
+ * ring, DMA and baud logic lives there.
  */
-static void SERCOM7_USART_ClockInit(void)
-{
-    /* Enable APBD clock for SERCOM7 peripheral */
-    MCLK_REGS->MCLK_APBDMASK |= MCLK_APBDMASK_SERCOM7_Msk;
 
-    /* Route GCLK0 to SERCOM7 core */
-    GCLK_REGS->GCLK_PCHCTRL[SERCOM7_GCLK_ID] =
-        GCLK_PCHCTRL_GEN_GCLK0 |
-        GCLK_PCHCTRL_CHEN_Msk;
-    while (!(GCLK_REGS->GCLK_PCHCTRL[SERCOM7_GCLK_ID] & GCLK_PCHCTRL_CHEN_Msk));
+/* ===================== Macros ===================== */
+#define SERCOM7_INDEX      7u
 
-    /* Enable SERCOM slow clock (shared among SERCOMs) */
-    GCLK_REGS->GCLK_PCHCTRL[SERCOM_SLOW_GCLK] =
-        GCLK_PCHCTRL_GEN_GCLK0 |
-        GCLK_PCHCTRL_CHEN_Msk;
-    while (!(GCLK_REGS->GCLK_PCHCTRL[SERCOM_SLOW_GCLK] & GCLK_PCHCTRL_CHEN_Msk));
-}
+/* ===================== Instance ===================== */
+static sercom_usart_t sercom7_usart;
 
-/**
- * @brief Configure PC12 and PC13 for SERCOM7 USART
- *
- * PC12 → SERCOM7 PAD0 → TX  
- * PC13 → SERCOM7 PAD1 → RX  
+static uint8_t tx_buf[SERCOM7_USART_TX_BUF_SIZE];
+static uint8_t rx_buf[SERCOM7_USART_RX_BUF_SIZE];
+
+/*
+ * PC12 → SERCOM7 PAD0 → TX
+ * PC13 → SERCOM7 PAD1 → RX
+ * PC14 → SERCOM7 PAD2 → RTS (flow control only)
+ * PC15 → SERCOM7 PAD3 → CTS (flow control only)
  * Peripheral Function: C
  */
-static void SERCOM7_USART_PinMuxInit(void)
+static const sercom_pin_t sercom7_usart_pins[] =
 {
-    /* Enable peripheral multiplexing */
-    PORT_REGS->GROUP[PORTC_INDEX].PORT_PINCFG[12] |= PORT_PINCFG_PMUXEN_Msk;
-    PORT_REGS->GROUP[PORTC_INDEX].PORT_PINCFG[13] |= PORT_PINCFG_PMUXEN_Msk;
+    { SERCOM_PORTC, 12, SERCOM_MUX_C, false },
+    { SERCOM_PORTC, 13, SERCOM_MUX_C, false },
+    { SERCOM_PORTC, 14, SERCOM_MUX_C, false },
+    { SERCOM_PORTC, 15, SERCOM_MUX_C, false }
+};
 
-    /* Configure PMUX for PC12 & PC13 */
-    PORT_REGS->GROUP[PORTC_INDEX].PORT_PMUX[12 >> 1] =
-        PORT_PMUX_PMUXE(PORT_PMUX_PMUXE_C) |   // PC12
-        PORT_PMUX_PMUXO(PORT_PMUX_PMUXO_C);    // PC13
-}
+/* ===================== Public APIs ===================== */
 
-/**
- * @brief Perform software reset of SERCOM7 USART
- *
- * Ensures peripheral starts from a known state
- */
-static void SERCOM7_USART_SoftwareReset(void)
+bool SERCOM7_USART_ComputeBaud(uint32_t ref_freq,
+                               uint32_t baudrate,
+                               sercom7_usart_sampr_t sampr,
+                               sercom7_usart_baud_t *out)
 {
-    SERCOM7_REGS->USART_INT.SERCOM_CTRLA |= SERCOM_USART_INT_CTRLA_SWRST_Msk;
-    while (SERCOM7_REGS->USART_INT.SERCOM_CTRLA & SERCOM_USART_INT_CTRLA_SWRST_Msk);
+    return sercom_usart_compute_baud(ref_freq, baudrate, sampr, out);
 }
 
 /**
- * @brief Calculate BAUD register value (Async Arithmetic Mode)
+ * @brief Initialize SERCOM7 as USART (8N1, async) from a config
  *
- * Formula:
- * BAUD = 65536 × (1 − (16 × Baudrate / fref))
- *
- * @param baudrate Desired baud rate (e.g., 115200)
- * @return Calculated BAUD register value
+ * @param cfg    Baud rate, reference clock, oversampling, flow control
+ * @param result Optional: BAUD value, achieved rate and error in ppm
+ * @return false if the baud rate cannot be generated (USART untouched)
  */
-static uint16_t SERCOM7_USART_CalcBaud(uint32_t baudrate)
+bool SERCOM7_USART_InitEx(const sercom7_usart_config_t *cfg,
+                          sercom7_usart_baud_t *result)
 {
-    return (uint16_t)(
-        65536.0f *
-        (1.0f - ((16.0f * baudrate) / (float)SERCOM_REF_FREQ))
-    );
+    sercom_usart_config_t usart_cfg =
+    {
+        .sercom       = SERCOM7_INDEX,
+        .pins         = sercom7_usart_pins,
+        .pin_count    = cfg->flow_control ? 4u : 2u,
+        .rxpo         = 1,                      /* RX on PAD1 */
+        .txpo         = 0,                      /* TX on PAD0 */
+        .baudrate     = cfg->baudrate,
+        .ref_freq     = cfg->ref_freq ? cfg->ref_freq : SERCOM7_USART_REF_FREQ,
+        .sampr        = cfg->sampr,
+        .flow_control = cfg->flow_control,
+        .tx_buf       = tx_buf,
+        .tx_size      = SERCOM7_USART_TX_BUF_SIZE,
+        .rx_buf       = rx_buf,
+        .rx_size      = SERCOM7_USART_RX_BUF_SIZE
+    };
+
+    return sercom_usart_init(&sercom7_usart, &usart_cfg, result);
 }
 
-/* ===================== Public APIs ===================== */
-
 /**
  * @brief Initialize SERCOM7 as USART (8N1, async)
  *
+ * 16x arithmetic mode from SERCOM7_USART_REF_FREQ, no flow control.
+ *
  * @param baudrate Desired baud rate
  */
 void SERCOM7_USART_Init(uint32_t baudrate)
 {
-    SERCOM7_USART_ClockInit();
-    SERCOM7_USART_PinMuxInit();
-    SERCOM7_USART_SoftwareReset();
+    sercom7_usart_config_t cfg =
+    {
+        .baudrate     = baudrate,
+        .ref_freq     = SERCOM7_USART_REF_FREQ,
+        .sampr        = SERCOM7_USART_SAMPR_16X_ARITH,
+        .flow_control = false
+    };
 
-    /* Configure USART mode */
-    SERCOM7_REGS->USART_INT.SERCOM_CTRLA =
-        SERCOM_USART_INT_CTRLA_MODE_USART_INT_CLK | // Internal clock
-        SERCOM_USART_INT_CTRLA_RXPO_PAD1 |           // RX on PAD1
-        SERCOM_USART_INT_CTRLA_TXPO_PAD0 |           // TX on PAD0
-        SERCOM_USART_INT_CTRLA_DORD_LSB;              // LSB first
+    (void)SERCOM7_USART_InitEx(&cfg, 0);
+}
 
-    /* Enable TX & RX, 8-bit data */
-    SERCOM7_REGS->USART_INT.SERCOM_CTRLB =
-        SERCOM_USART_INT_CTRLB_RXEN_Msk |
-        SERCOM_USART_INT_CTRLB_TXEN_Msk |
-        SERCOM_USART_INT_CTRLB_CHSIZE(0);
+void SERCOM7_USART_WriteByte(uint8_t data)
+{
+    sercom_usart_write_byte(&sercom7_usart, data);
+}
 
-    while (SERCOM7_REGS->USART_INT.SERCOM_SYNCBUSY &
-           SERCOM_USART_INT_SYNCBUSY_CTRLB_Msk);
+uint8_t SERCOM7_USART_ReadByte(void)
+{
+    return sercom_usart_read_byte(&sercom7_usart);
+}
 
-    /* Set baud rate */
-    SERCOM7_REGS->USART_INT.SERCOM_BAUD =
-        SERCOM_USART_INT_BAUD_BAUD(SERCOM7_USART_CalcBaud(baudrate));
+void SERCOM7_USART_WriteString(const char *str)
+{
+    sercom_usart_write_string(&sercom7_usart, str);
+}
+
+/* ===================== Interrupt Mode ===================== */
 
-    /* Enable USART */
-    SERCOM7_REGS->USART_INT.SERCOM_CTRLA |= SERCOM_USART_INT_CTRLA_ENABLE_Msk;
-    while (SERCOM7_REGS->USART_INT.SERCOM_SYNCBUSY &
-           SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk);
+void SERCOM7_USART_SetMode(sercom7_usart_mode_t mode)
+{
+    (void)sercom_usart_set_mode(&sercom7_usart, mode);
 }
 
-/**
- * @brief Transmit one byte (blocking)
- */
-void SERCOM7_USART_WriteByte(uint8_t data)
+size_t SERCOM7_USART_Write(const uint8_t *buf, size_t len)
 {
-    while (!(SERCOM7_REGS->USART_INT.SERCOM_INTFLAG &
-             SERCOM_USART_INT_INTFLAG_DRE_Msk));
+    return sercom_usart_write(&sercom7_usart, buf, len);
+}
 
-    SERCOM7_REGS->USART_INT.SERCOM_DATA = data;
+size_t SERCOM7_USART_Read(uint8_t *buf, size_t len)
+{
+    return sercom_usart_read(&sercom7_usart, buf, len);
 }
 
-/**
- * @brief Receive one byte (blocking)
- */
-uint8_t SERCOM7_USART_ReadByte(void)
+size_t SERCOM7_USART_RxAvailable(void)
+{
+    return sercom_usart_rx_available(&sercom7_usart);
+}
+
+size_t SERCOM7_USART_TxFree(void)
 {
-    while (!(SERCOM7_REGS->USART_INT.SERCOM_INTFLAG &
-             SERCOM_USART_INT_INTFLAG_RXC_Msk));
+    return sercom_usart_tx_free(&sercom7_usart);
+}
 
-    return (uint8_t)(SERCOM7_REGS->USART_INT.SERCOM_DATA & 0xFF);
+void SERCOM7_USART_GetStats(sercom7_usart_stats_t *stats)
+{
+    sercom_usart_get_stats(&sercom7_usart, stats);
 }
 
-/**
- * @brief Transmit a null-terminated string
+void SERCOM7_USART_ResetStats(void)
+{
+    sercom_usart_reset_stats(&sercom7_usart);
+}
+
+/* ===================== DMA Mode ===================== */
+
+bool SERCOM7_USART_DmaInit(uint8_t *rx_buf, uint16_t rx_size)
+{
+    return sercom_usart_dma_init(&sercom7_usart, rx_buf, rx_size);
+}
+
+bool SERCOM7_USART_DmaWriteList(const sercom7_usart_dma_buf_t *list,
+                                uint8_t count,
+                                sercom7_usart_dma_callback_t callback,
+                                void *ctx)
+{
+    return sercom_usart_dma_write_list(&sercom7_usart, list, count, callback, ctx);
+}
+
+bool SERCOM7_USART_DmaWrite(const uint8_t *buf,
+                            uint16_t len,
+                            sercom7_usart_dma_callback_t callback,
+                            void *ctx)
+{
+    return sercom_usart_dma_write(&sercom7_usart, buf, len, callback, ctx);
+}
+
+bool SERCOM7_USART_DmaTxBusy(void)
+{
+    return sercom_usart_dma_tx_busy(&sercom7_usart);
+}
+
+void SERCOM7_USART_DmaSetIdleCallback(sercom7_usart_dma_callback_t callback, void *ctx)
+{
+    sercom_usart_dma_set_idle_callback(&sercom7_usart, callback, ctx);
+}
+
+void SERCOM7_USART_DmaRxPoll(void)
+{
+    sercom_usart_dma_rx_poll(&sercom7_usart);
+}
+
+/* ===================== ISR ===================== */
+
+/*
+ * The SERCOM7_x vectors are defined in sercom_core.c and reach
+ * sercom_usart_isr() through the handler registered at init.
  */
-void SERCOM7_USART_WriteString(const char *str)
+void SERCOM7_USART_InterruptHandler(void)
 {
-    while (*str)
-    {
-        SERCOM7_USART_WriteByte((uint8_t)*str++);
-    }
+    sercom_usart_isr(&sercom7_usart);
+}
+
+sercom_usart_t *SERCOM7_USART_Instance(void)
+{
+    return &sercom7_usart;
 }
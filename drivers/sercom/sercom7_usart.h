@@ -2,6 +2,67 @@
 #define SERCOM7_USART_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sercom_usart.h"
+
+/* ===================== Configuration ===================== */
+
+/*
+ * Default SERCOM7 core clock when the config leaves ref_freq 0.
+ * 0 = ask the clock manager and follow its generator changes.
+ */
+#ifndef SERCOM7_USART_REF_FREQ
+#define SERCOM7_USART_REF_FREQ      0UL
+#endif
+
+/* Ring buffer sizes for interrupt mode (must be powers of two) */
+#ifndef SERCOM7_USART_TX_BUF_SIZE
+#define SERCOM7_USART_TX_BUF_SIZE   256u
+#endif
+
+#ifndef SERCOM7_USART_RX_BUF_SIZE
+#define SERCOM7_USART_RX_BUF_SIZE   256u
+#endif
+
+/* ===================== Types ===================== */
+
+/*
+ * SERCOM7 is one instance of the generic driver (sercom_usart.h);
+ * the SERCOM7_USART_* names below are kept for existing code.
+ */
+#define SERCOM7_USART_DMA_SG_MAX        SERCOM_USART_DMA_SG_MAX
+#define SERCOM7_USART_DMA_IDLE_POLLS    SERCOM_USART_DMA_IDLE_POLLS
+
+typedef sercom_usart_sampr_t        sercom7_usart_sampr_t;
+typedef sercom_usart_baud_t         sercom7_usart_baud_t;
+typedef sercom_usart_mode_t         sercom7_usart_mode_t;
+typedef sercom_usart_dma_buf_t      sercom7_usart_dma_buf_t;
+typedef sercom_usart_dma_callback_t sercom7_usart_dma_callback_t;
+typedef sercom_usart_stats_t        sercom7_usart_stats_t;
+
+#define SERCOM7_USART_SAMPR_16X_ARITH   SERCOM_USART_SAMPR_16X_ARITH
+#define SERCOM7_USART_SAMPR_16X_FRAC    SERCOM_USART_SAMPR_16X_FRAC
+#define SERCOM7_USART_SAMPR_8X_ARITH    SERCOM_USART_SAMPR_8X_ARITH
+#define SERCOM7_USART_SAMPR_8X_FRAC     SERCOM_USART_SAMPR_8X_FRAC
+#define SERCOM7_USART_SAMPR_3X_ARITH    SERCOM_USART_SAMPR_3X_ARITH
+
+#define SERCOM7_USART_MODE_BLOCKING     SERCOM_USART_MODE_BLOCKING
+#define SERCOM7_USART_MODE_INTERRUPT    SERCOM_USART_MODE_INTERRUPT
+#define SERCOM7_USART_MODE_DMA          SERCOM_USART_MODE_DMA
+
+#define SERCOM7_USART_BAUD_ARITH        SERCOM_USART_BAUD_ARITH
+
+/**
+ * @brief USART configuration for SERCOM7_USART_InitEx()
+ */
+typedef struct
+{
+    uint32_t              baudrate;
+    uint32_t              ref_freq;       /* SERCOM7 core clock, 0 = SERCOM7_USART_REF_FREQ */
+    sercom7_usart_sampr_t sampr;
+    bool                  flow_control;   /* RTS on PC14, CTS on PC15 */
+} sercom7_usart_config_t;
 
 /**
  * @brief Initialize SERCOM7 USART peripheral
@@ -10,6 +71,22 @@
  */
 void SERCOM7_USART_Init(uint32_t baudrate);
 
+/**
+ * @brief Initialize SERCOM7 USART with oversampling / flow control options
+ *
+ * @return false if the baud rate is not reachable
+ */
+bool SERCOM7_USART_InitEx(const sercom7_usart_config_t *cfg,
+                          sercom7_usart_baud_t *result);
+
+/**
+ * @brief Integer BAUD computation, reports achieved rate and error
+ */
+bool SERCOM7_USART_ComputeBaud(uint32_t ref_freq,
+                               uint32_t baudrate,
+                               sercom7_usart_sampr_t sampr,
+                               sercom7_usart_baud_t *out);
+
 /**
  * @brief Send one byte over USART
  */
@@ -25,4 +102,82 @@ uint8_t SERCOM7_USART_ReadByte(void);
  */
 void SERCOM7_USART_WriteString(const char *str);
 
+/* ===================== Interrupt Mode ===================== */
+
+/**
+ * @brief Select blocking or interrupt-driven operation
+ */
+void SERCOM7_USART_SetMode(sercom7_usart_mode_t mode);
+
+/**
+ * @brief Queue up to len bytes for transmission (non-blocking)
+ *
+ * @return Number of bytes accepted into the TX ring
+ */
+size_t SERCOM7_USART_Write(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Copy up to len received bytes out of the RX ring (non-blocking)
+ *
+ * @return Number of bytes copied
+ */
+size_t SERCOM7_USART_Read(uint8_t *buf, size_t len);
+
+/**
+ * @brief Bytes waiting in the RX ring
+ */
+size_t SERCOM7_USART_RxAvailable(void);
+
+/**
+ * @brief Free space in the TX ring
+ */
+size_t SERCOM7_USART_TxFree(void);
+
+/**
+ * @brief Read / clear overrun and high-water counters
+ */
+void SERCOM7_USART_GetStats(sercom7_usart_stats_t *stats);
+void SERCOM7_USART_ResetStats(void);
+
+/* ===================== DMA Mode ===================== */
+
+/**
+ * @brief Enter DMA mode with circular reception into rx_buf
+ *
+ * Requires dmac_init(). RX data is read with SERCOM7_USART_Read().
+ */
+bool SERCOM7_USART_DmaInit(uint8_t *rx_buf, uint16_t rx_size);
+
+/**
+ * @brief Zero-copy transmit of one buffer / a scatter-gather list
+ *
+ * @return false if busy or the request is invalid
+ */
+bool SERCOM7_USART_DmaWrite(const uint8_t *buf,
+                            uint16_t len,
+                            sercom7_usart_dma_callback_t callback,
+                            void *ctx);
+bool SERCOM7_USART_DmaWriteList(const sercom7_usart_dma_buf_t *list,
+                                uint8_t count,
+                                sercom7_usart_dma_callback_t callback,
+                                void *ctx);
+
+bool SERCOM7_USART_DmaTxBusy(void);
+
+/**
+ * @brief RX idle-line detection (call DmaRxPoll from a periodic tick)
+ */
+void SERCOM7_USART_DmaSetIdleCallback(sercom7_usart_dma_callback_t callback, void *ctx);
+void SERCOM7_USART_DmaRxPoll(void);
+
+/**
+ * @brief SERCOM7 interrupt service routine (all four SERCOM7 vectors)
+ */
+void SERCOM7_USART_InterruptHandler(void);
+
+/**
+ * @brief Underlying generic instance, for the sercom_usart_* API
+ */
+sercom_usart_t *SERCOM7_USART_Instance(void);
+
 #endif /* SERCOM7_USART_H */
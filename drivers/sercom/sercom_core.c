@@ -0,0 +1,249 @@
+#include "sercom_core.h"
+#include "clock_mgr.h"
+#include "irq_mgr.h"
+#include "isr_prof.h"
+
+/* ===================== Macros ===================== */
+#define SERCOM_SLOW_GCLK        3           /* Shared slow clock channel */
+
+/* ===================== Descriptor Table ===================== */
+
+/**
+ * @brief Per-instance hardware description (datasheet accurate)
+ *
+ * SERCOM0/1 → APBA, SERCOM2/3 → APBB, SERCOM4..7 → APBD.
+ * The four IRQ lines of an instance are consecutive.
+ */
+typedef struct
+{
+    sercom_registers_t *regs;
+    volatile uint32_t  *apb_mask_reg;
+    uint32_t            apb_mask_bit;
+    uint8_t             gclk_id;
+    IRQn_Type           irq0;
+} sercom_desc_t;
+
+static const sercom_desc_t sercom_table[SERCOM_MAX] =
+{
+    { SERCOM0_REGS, &MCLK_REGS->MCLK_APBAMASK, MCLK_APBAMASK_SERCOM0_Msk, 7,  SERCOM0_0_IRQn },
+    { SERCOM1_REGS, &MCLK_REGS->MCLK_APBAMASK, MCLK_APBAMASK_SERCOM1_Msk, 8,  SERCOM1_0_IRQn },
+    { SERCOM2_REGS, &MCLK_REGS->MCLK_APBBMASK, MCLK_APBBMASK_SERCOM2_Msk, 23, SERCOM2_0_IRQn },
+    { SERCOM3_REGS, &MCLK_REGS->MCLK_APBBMASK, MCLK_APBBMASK_SERCOM3_Msk, 24, SERCOM3_0_IRQn },
+    { SERCOM4_REGS, &MCLK_REGS->MCLK_APBDMASK, MCLK_APBDMASK_SERCOM4_Msk, 34, SERCOM4_0_IRQn },
+    { SERCOM5_REGS, &MCLK_REGS->MCLK_APBDMASK, MCLK_APBDMASK_SERCOM5_Msk, 35, SERCOM5_0_IRQn },
+    { SERCOM6_REGS, &MCLK_REGS->MCLK_APBDMASK, MCLK_APBDMASK_SERCOM6_Msk, 36, SERCOM6_0_IRQn },
+    { SERCOM7_REGS, &MCLK_REGS->MCLK_APBDMASK, MCLK_APBDMASK_SERCOM7_Msk, 37, SERCOM7_0_IRQn }
+};
+
+/* ===================== Instance State ===================== */
+static uint8_t sercom_claimed = 0;
+static uint8_t sercom_clocked = 0;
+
+static sercom_isr_t sercom_handlers[SERCOM_MAX] = {0};
+static void *sercom_contexts[SERCOM_MAX] = {0};
+
+/* ===================== Ownership ===================== */
+sercom_registers_t *sercom_core_regs(uint8_t index)
+{
+    return (index < SERCOM_MAX) ? sercom_table[index].regs : 0;
+}
+
+bool sercom_core_claim(uint8_t index)
+{
+    bool ok = false;
+
+    if (index >= SERCOM_MAX)
+        return false;
+
+    uint32_t basepri = irq_lock();
+    if (!(sercom_claimed & (1u << index)))
+    {
+        sercom_claimed |= (uint8_t)(1u << index);
+        ok = true;
+    }
+    irq_unlock(basepri);
+
+    return ok;
+}
+
+void sercom_core_release(uint8_t index)
+{
+    if (index >= SERCOM_MAX)
+        return;
+
+    sercom_core_irq_disable(index);
+    sercom_handlers[index] = 0;
+
+    /* Gate the core and (last user) slow clock channels */
+    if (sercom_clocked & (1u << index))
+    {
+        sercom_core_reset(index);
+        clock_periph_disable(sercom_table[index].gclk_id);
+        clock_periph_disable(SERCOM_SLOW_GCLK);
+        sercom_clocked &= (uint8_t)~(1u << index);
+    }
+
+    uint32_t basepri = irq_lock();
+    sercom_claimed &= (uint8_t)~(1u << index);
+    irq_unlock(basepri);
+}
+
+/* ===================== Bring-up ===================== */
+
+/**
+ * @brief Enable bus clock, core GCLK and shared slow GCLK
+ *
+ * Channels are reference counted by the clock manager; each SERCOM
+ * takes its references once, sercom_core_release() returns them.
+ */
+void sercom_core_clock_enable(uint8_t index)
+{
+    const sercom_desc_t *d = &sercom_table[index];
+
+    /* APB clock for this SERCOM */
+    *d->apb_mask_reg |= d->apb_mask_bit;
+
+    if (sercom_clocked & (1u << index))
+        return;
+
+    (void)clock_periph_enable(d->gclk_id, SERCOM_GCLK_GEN);
+    (void)clock_periph_enable(SERCOM_SLOW_GCLK, SERCOM_GCLK_GEN);
+    sercom_clocked |= (uint8_t)(1u << index);
+}
+
+/**
+ * @brief Hand pins to the SERCOM (read-modify-write of the PMUX nibble)
+ */
+void sercom_core_pinmux(const sercom_pin_t *pins, uint8_t pin_count)
+{
+    for (uint8_t i = 0; i < pin_count; i++)
+    {
+        port_group_registers_t *group = &PORT_REGS->GROUP[pins[i].port];
+        uint8_t pin = pins[i].pin;
+
+        if (pin & 1u)
+            group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0x0Fu) |
+                                         (uint8_t)(pins[i].mux << 4);
+        else
+            group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0xF0u) |
+                                         (uint8_t)(pins[i].mux & 0x0Fu);
+
+        if (pins[i].pullup)
+        {
+            group->PORT_PINCFG[pin] |= PORT_PINCFG_PULLEN_Msk;
+            group->PORT_OUTSET = (1u << pin);
+        }
+
+        group->PORT_PINCFG[pin] |= PORT_PINCFG_PMUXEN_Msk;
+    }
+}
+
+/**
+ * @brief Disable and software-reset SERCOMn
+ *
+ * CTRLA.ENABLE / SWRST and SYNCBUSY sit at the same place in every
+ * mode, so the USART view is used for all of them.
+ */
+void sercom_core_reset(uint8_t index)
+{
+    sercom_usart_int_registers_t *r = &sercom_table[index].regs->USART_INT;
+
+    r->SERCOM_CTRLA &= ~SERCOM_USART_INT_CTRLA_ENABLE_Msk;
+    while (r->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk);
+
+    r->SERCOM_CTRLA = SERCOM_USART_INT_CTRLA_SWRST_Msk;
+    while (r->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_SWRST_Msk);
+}
+
+void sercom_core_init(uint8_t index, const sercom_pin_t *pins, uint8_t pin_count)
+{
+    if (index >= SERCOM_MAX)
+        return;
+
+    sercom_core_clock_enable(index);
+    sercom_core_pinmux(pins, pin_count);
+    sercom_core_reset(index);
+}
+
+uint32_t sercom_core_clock_hz(uint8_t index)
+{
+    if (index >= SERCOM_MAX)
+        return 0u;
+
+    /* Not clocked yet: the rate it will get from sercom_core_init() */
+    if (!(sercom_clocked & (1u << index)))
+        return clock_gen_hz(SERCOM_GCLK_GEN);
+
+    return clock_periph_hz(sercom_table[index].gclk_id);
+}
+
+/* ===================== Interrupts ===================== */
+void sercom_core_register_isr(uint8_t index, sercom_isr_t handler, void *ctx)
+{
+    if (index < SERCOM_MAX)
+    {
+        sercom_contexts[index] = ctx;
+        sercom_handlers[index] = handler;
+    }
+}
+
+void sercom_core_irq_enable(uint8_t index)
+{
+    for (uint8_t i = 0; i < SERCOM_IRQ_LINES; i++)
+    {
+        irq_enable((IRQn_Type)(sercom_table[index].irq0 + i), IRQ_PRIO_SERCOM);
+    }
+}
+
+void sercom_core_irq_disable(uint8_t index)
+{
+    for (uint8_t i = 0; i < SERCOM_IRQ_LINES; i++)
+    {
+        irq_disable((IRQn_Type)(sercom_table[index].irq0 + i));
+    }
+}
+
+/* ================= COMMON ISR HANDLER ================= */
+static void SERCOMx_Handler(uint8_t index)
+{
+    ISR_PROF_ENTER(prof);
+
+    if (sercom_handlers[index])
+        sercom_handlers[index](sercom_contexts[index]);
+
+    ISR_PROF_EXIT(prof, ISR_PROF_ID_SERCOM(index), ISR_PROF_NO_LATENCY);
+}
+
+/* ================= MAPPING ISR HANDLERS ================= */
+void SERCOM0_0_Handler(void) { SERCOMx_Handler(0); }
+void SERCOM0_1_Handler(void) { SERCOMx_Handler(0); }
+void SERCOM0_2_Handler(void) { SERCOMx_Handler(0); }
+void SERCOM0_3_Handler(void) { SERCOMx_Handler(0); }
+void SERCOM1_0_Handler(void) { SERCOMx_Handler(1); }
+void SERCOM1_1_Handler(void) { SERCOMx_Handler(1); }
+void SERCOM1_2_Handler(void) { SERCOMx_Handler(1); }
+void SERCOM1_3_Handler(void) { SERCOMx_Handler(1); }
+void SERCOM2_0_Handler(void) { SERCOMx_Handler(2); }
+void SERCOM2_1_Handler(void) { SERCOMx_Handler(2); }
+void SERCOM2_2_Handler(void) { SERCOMx_Handler(2); }
+void SERCOM2_3_Handler(void) { SERCOMx_Handler(2); }
+void SERCOM3_0_Handler(void) { SERCOMx_Handler(3); }
+void SERCOM3_1_Handler(void) { SERCOMx_Handler(3); }
+void SERCOM3_2_Handler(void) { SERCOMx_Handler(3); }
+void SERCOM3_3_Handler(void) { SERCOMx_Handler(3); }
+void SERCOM4_0_Handler(void) { SERCOMx_Handler(4); }
+void SERCOM4_1_Handler(void) { SERCOMx_Handler(4); }
+void SERCOM4_2_Handler(void) { SERCOMx_Handler(4); }
+void SERCOM4_3_Handler(void) { SERCOMx_Handler(4); }
+void SERCOM5_0_Handler(void) { SERCOMx_Handler(5); }
+void SERCOM5_1_Handler(void) { SERCOMx_Handler(5); }
+void SERCOM5_2_Handler(void) { SERCOMx_Handler(5); }
+void SERCOM5_3_Handler(void) { SERCOMx_Handler(5); }
+void SERCOM6_0_Handler(void) { SERCOMx_Handler(6); }
+void SERCOM6_1_Handler(void) { SERCOMx_Handler(6); }
+void SERCOM6_2_Handler(void) { SERCOMx_Handler(6); }
+void SERCOM6_3_Handler(void) { SERCOMx_Handler(6); }
+void SERCOM7_0_Handler(void) { SERCOMx_Handler(7); }
+void SERCOM7_1_Handler(void) { SERCOMx_Handler(7); }
+void SERCOM7_2_Handler(void) { SERCOMx_Handler(7); }
+void SERCOM7_3_Handler(void) { SERCOMx_Handler(7); }
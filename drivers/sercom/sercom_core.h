@@ -0,0 +1,95 @@
+#ifndef SERCOM_CORE_H
+#define SERCOM_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pic32cx1025sg61128.h>
+
+/* ===================== Configuration ===================== */
+#define SERCOM_MAX          8u      /* SERCOM0 .. SERCOM7 */
+#define SERCOM_IRQ_LINES    4u      /* SERCOMn_0 .. SERCOMn_3 */
+
+/* Generator feeding the SERCOM cores (see clock_mgr.h) */
+#ifndef SERCOM_GCLK_GEN
+#define SERCOM_GCLK_GEN     1u      /* CLOCK_GEN_PERIPH */
+#endif
+
+/* PORT index: 0=PORTA, 1=PORTB, 2=PORTC, 3=PORTD */
+#define SERCOM_PORTA        0u
+#define SERCOM_PORTB        1u
+#define SERCOM_PORTC        2u
+#define SERCOM_PORTD        3u
+
+/* Peripheral function (PMUX value) */
+#define SERCOM_MUX_C        2u
+#define SERCOM_MUX_D        3u
+
+/* ===================== Types ===================== */
+
+/**
+ * @brief One SERCOM pad pin
+ */
+typedef struct
+{
+    uint8_t port;       /* SERCOM_PORTx             */
+    uint8_t pin;        /* 0..31                    */
+    uint8_t mux;        /* SERCOM_MUX_C / _D        */
+    bool    pullup;     /* Internal pull-up (I2C)   */
+} sercom_pin_t;
+
+/**
+ * @brief Interrupt handler registered per SERCOM instance
+ *
+ * Called for all four vectors of the instance.
+ */
+typedef void (*sercom_isr_t)(void *ctx);
+
+/* ===================== API ===================== */
+
+/**
+ * @brief Register block of SERCOMn (NULL if out of range)
+ */
+sercom_registers_t *sercom_core_regs(uint8_t index);
+
+/**
+ * @brief Reserve a SERCOM for one driver
+ *
+ * @return false if the instance is already owned
+ */
+bool sercom_core_claim(uint8_t index);
+void sercom_core_release(uint8_t index);
+
+/**
+ * @brief Bring up SERCOMn: bus clock, core + slow GCLK, pin mux, SWRST
+ *
+ * Leaves the SERCOM disabled and in reset state.
+ */
+void sercom_core_init(uint8_t index, const sercom_pin_t *pins, uint8_t pin_count);
+
+/**
+ * @brief Individual steps of sercom_core_init()
+ */
+void sercom_core_clock_enable(uint8_t index);
+void sercom_core_pinmux(const sercom_pin_t *pins, uint8_t pin_count);
+void sercom_core_reset(uint8_t index);
+
+/**
+ * @brief Core clock frequency feeding SERCOMn
+ *
+ * Drivers that derive BAUD from it register a clock_notifier_t on
+ * SERCOM_GCLK_GEN to follow frequency changes.
+ */
+uint32_t sercom_core_clock_hz(uint8_t index);
+
+/**
+ * @brief Route all vectors of SERCOMn to handler(ctx)
+ */
+void sercom_core_register_isr(uint8_t index, sercom_isr_t handler, void *ctx);
+
+/**
+ * @brief Enable / disable the four NVIC lines of SERCOMn
+ */
+void sercom_core_irq_enable(uint8_t index);
+void sercom_core_irq_disable(uint8_t index);
+
+#endif /* SERCOM_CORE_H */
@@ -0,0 +1,809 @@
+#include "sercom_usart.h"
+
+/*
+ * Generic SERCOMx USART driver.
+ *
+ * Every function takes the instance, so several USARTs run side by
+ * side, each with its own rings, DMA channels and ISR context.
+ * Clocking, pin mux, reset and vector dispatch come from sercom_core.
+ */
+
+/* ===================== Local Helpers ===================== */
+
+static bool sercom_usart_is_pow2(uint32_t v)
+{
+    return v && !(v & (v - 1u));
+}
+
+static size_t sercom_usart_dma_available(sercom_usart_t *u);
+static size_t sercom_usart_dma_read(sercom_usart_t *u, uint8_t *buf, size_t len);
+
+/* ===================== Setup ===================== */
+
+/**
+ * @brief Compute the BAUD register value with integer math
+ *
+ * Arithmetic modes (SAMPR 0, 2, 4):
+ *   BAUD   = 65536 × (1 − S × Baudrate / fref)
+ *   actual = fref × (65536 − BAUD) / (65536 × S)
+ *
+ * Fractional modes (SAMPR 1, 3), BAUD[12:0] + FP[15:13]:
+ *   BAUD + FP/8 = fref / (S × Baudrate)
+ *   actual      = 8 × fref / (S × (8 × BAUD + FP))
+ *
+ * S = 16, 8 or 3 samples per bit. All terms are rounded to nearest.
+ *
+ * @return false if the rate is not reachable with this fref / SAMPR
+ */
+bool sercom_usart_compute_baud(uint32_t ref_freq,
+                               uint32_t baudrate,
+                               sercom_usart_sampr_t sampr,
+                               sercom_usart_baud_t *out)
+{
+    uint32_t samples;
+    uint32_t actual;
+    uint16_t reg;
+
+    if (baudrate == 0 || ref_freq == 0)
+        return false;
+
+    switch (sampr)
+    {
+        case SERCOM_USART_SAMPR_16X_ARITH:
+        case SERCOM_USART_SAMPR_16X_FRAC:  samples = 16; break;
+        case SERCOM_USART_SAMPR_8X_ARITH:
+        case SERCOM_USART_SAMPR_8X_FRAC:   samples = 8;  break;
+        case SERCOM_USART_SAMPR_3X_ARITH:  samples = 3;  break;
+        default: return false;
+    }
+
+    uint64_t bit_clk = (uint64_t)samples * baudrate;
+
+    if (bit_clk > ref_freq)
+        return false;
+
+    if (sampr == SERCOM_USART_SAMPR_16X_FRAC ||
+        sampr == SERCOM_USART_SAMPR_8X_FRAC)
+    {
+        /* Period in 1/8 steps */
+        uint64_t eighths = ((uint64_t)ref_freq * 8u + bit_clk / 2u) / bit_clk;
+
+        if (eighths < 8u || (eighths >> 3) > 0x1FFFu)
+            return false;
+
+        reg    = (uint16_t)(((eighths & 0x7u) << 13) | (eighths >> 3));
+        actual = (uint32_t)(((uint64_t)ref_freq * 8u + (samples * eighths) / 2u) /
+                            (samples * eighths));
+    }
+    else
+    {
+        uint64_t step = (bit_clk * 65536u + ref_freq / 2u) / ref_freq;
+
+        reg    = (uint16_t)(65536u - step);
+        actual = (uint32_t)(((uint64_t)ref_freq * step + (65536u * samples) / 2u) /
+                            (65536u * samples));
+    }
+
+    out->baud_reg  = reg;
+    out->actual    = actual;
+    out->error_ppm = (int32_t)(((int64_t)actual - (int64_t)baudrate) * 1000000 /
+                               (int64_t)baudrate);
+    return true;
+}
+
+/**
+ * @brief Leave the current interrupt / DMA mode
+ *
+ * Waits for queued TX data to drain, then disables the SERCOM
+ * interrupts and returns the DMA channels to the pool (DMA mode
+ * allocates them again). Unread RX bytes are discarded.
+ */
+static void sercom_usart_stop_mode(sercom_usart_t *u)
+{
+    if (u->mode == SERCOM_USART_MODE_INTERRUPT)
+    {
+        /* Let the ISR finish sending what is already queued */
+        while (u->tx_head != u->tx_tail);
+    }
+    else if (u->mode == SERCOM_USART_MODE_DMA)
+    {
+        while (u->dma_tx_busy);
+    }
+
+    if (u->dma_tx_ch >= 0)
+        dmac_channel_free((uint8_t)u->dma_tx_ch);
+    if (u->dma_rx_ch >= 0)
+        dmac_channel_free((uint8_t)u->dma_rx_ch);
+    u->dma_tx_ch = -1;
+    u->dma_rx_ch = -1;
+
+    u->regs->SERCOM_INTENCLR =
+        SERCOM_USART_INT_INTENCLR_DRE_Msk |
+        SERCOM_USART_INT_INTENCLR_RXC_Msk |
+        SERCOM_USART_INT_INTENCLR_ERROR_Msk;
+
+    sercom_core_irq_disable(u->sercom);
+
+    u->mode = SERCOM_USART_MODE_BLOCKING;
+}
+
+/**
+ * @brief Generator feeding the SERCOM changed: re-derive BAUD
+ *
+ * BAUD is enable-protected, so the USART is switched off for the
+ * write. A character on the wire at that moment is lost.
+ */
+static void sercom_usart_clock_changed(uint8_t gen, clock_event_t event, uint32_t hz, void *ctx)
+{
+    sercom_usart_t *u = ctx;
+    sercom_usart_baud_t baud;
+    (void)gen;
+
+    if (event != CLOCK_EVENT_POST_CHANGE)
+        return;
+    if (!sercom_usart_compute_baud(hz, u->baudrate, u->sampr, &baud))
+        return;
+
+    u->regs->SERCOM_CTRLA &= ~SERCOM_USART_INT_CTRLA_ENABLE_Msk;
+    while (u->regs->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk);
+
+    u->regs->SERCOM_BAUD = baud.baud_reg;
+
+    u->regs->SERCOM_CTRLA |= SERCOM_USART_INT_CTRLA_ENABLE_Msk;
+    while (u->regs->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk);
+}
+
+/**
+ * @brief Initialize a SERCOM as USART (8N1, async)
+ *
+ * The instance must be zeroed before its first init. Re-initializing
+ * it is allowed, also on another SERCOM: the old one is released and
+ * DMA channels of the previous mode are freed.
+ * With cfg->ref_freq == 0 the baud rate follows later changes of the
+ * generator feeding the SERCOM (clock manager notification).
+ */
+bool sercom_usart_init(sercom_usart_t *u,
+                       const sercom_usart_config_t *cfg,
+                       sercom_usart_baud_t *result)
+{
+    sercom_usart_baud_t baud;
+    sercom_registers_t *regs = sercom_core_regs(cfg->sercom);
+    uint32_t ref_freq = cfg->ref_freq ? cfg->ref_freq : sercom_core_clock_hz(cfg->sercom);
+
+    if (!regs)
+        return false;
+    if ((cfg->tx_buf && !sercom_usart_is_pow2(cfg->tx_size)) ||
+        (cfg->rx_buf && !sercom_usart_is_pow2(cfg->rx_size)))
+        return false;
+    if (!sercom_usart_compute_baud(ref_freq, cfg->baudrate, cfg->sampr, &baud))
+        return false;
+
+    bool moving = (u->regs != &regs->USART_INT);
+
+    if (moving && !sercom_core_claim(cfg->sercom))
+        return false;
+
+    /* Previously initialized: leave its mode, drop the old SERCOM */
+    if (u->regs)
+    {
+        sercom_usart_stop_mode(u);
+        clock_notifier_unregister(&u->clock_nb);
+
+        if (moving)
+            sercom_core_release(u->sercom);
+    }
+
+    if (result)
+        *result = baud;
+
+    u->sercom       = cfg->sercom;
+    u->regs         = &regs->USART_INT;
+    u->mode         = SERCOM_USART_MODE_BLOCKING;
+    u->flow_control = cfg->flow_control;
+    u->baudrate     = cfg->baudrate;
+    u->sampr        = cfg->sampr;
+    u->tx_buf       = cfg->tx_buf;
+    u->rx_buf       = cfg->rx_buf;
+    u->tx_size      = cfg->tx_buf ? cfg->tx_size : 0u;
+    u->rx_size      = cfg->rx_buf ? cfg->rx_size : 0u;
+    u->tx_head = u->tx_tail = 0;
+    u->rx_head = u->rx_tail = 0;
+    u->dma_tx_ch    = -1;
+    u->dma_rx_ch    = -1;
+    u->dma_tx_busy  = false;
+    sercom_usart_reset_stats(u);
+
+    sercom_core_init(cfg->sercom, cfg->pins, cfg->pin_count);
+    sercom_core_register_isr(cfg->sercom, sercom_usart_isr, u);
+
+    /* Configure USART mode */
+    u->regs->SERCOM_CTRLA =
+        SERCOM_USART_INT_CTRLA_MODE_USART_INT_CLK |   // Internal clock
+        SERCOM_USART_INT_CTRLA_SAMPR(cfg->sampr) |    // Oversampling / BAUD format
+        SERCOM_USART_INT_CTRLA_RXPO(cfg->rxpo) |      // RX pad
+        SERCOM_USART_INT_CTRLA_TXPO(cfg->flow_control ?
+                                    SERCOM_USART_TXPO_PAD0_FLOW : cfg->txpo) |
+        SERCOM_USART_INT_CTRLA_DORD_LSB;              // LSB first
+
+    /* Enable TX & RX, 8-bit data */
+    u->regs->SERCOM_CTRLB =
+        SERCOM_USART_INT_CTRLB_RXEN_Msk |
+        SERCOM_USART_INT_CTRLB_TXEN_Msk |
+        SERCOM_USART_INT_CTRLB_CHSIZE(0);
+
+    while (u->regs->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_CTRLB_Msk);
+
+    /* Set baud rate (arithmetic or fractional layout, see compute_baud) */
+    u->regs->SERCOM_BAUD = baud.baud_reg;
+
+    /* Enable USART */
+    u->regs->SERCOM_CTRLA |= SERCOM_USART_INT_CTRLA_ENABLE_Msk;
+    while (u->regs->SERCOM_SYNCBUSY & SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk);
+
+    if (!cfg->ref_freq)
+    {
+        u->clock_nb.gen      = SERCOM_GCLK_GEN;
+        u->clock_nb.callback = sercom_usart_clock_changed;
+        u->clock_nb.ctx      = u;
+        clock_notifier_register(&u->clock_nb);
+    }
+
+    return true;
+}
+
+/* ===================== Blocking ===================== */
+
+/**
+ * @brief Transmit one byte (blocking)
+ *
+ * In interrupt mode the byte is queued through the TX ring and the
+ * call only waits while the ring is full.
+ */
+void sercom_usart_write_byte(sercom_usart_t *u, uint8_t data)
+{
+    if (u->mode == SERCOM_USART_MODE_INTERRUPT)
+    {
+        while (sercom_usart_write(u, &data, 1) == 0);
+        return;
+    }
+
+    /* DMA mode: wait until no DMA transfer owns DATA */
+    while (u->dma_tx_busy);
+
+    while (!(u->regs->SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_DRE_Msk));
+
+    u->regs->SERCOM_DATA = data;
+}
+
+/**
+ * @brief Receive one byte (blocking)
+ *
+ * In interrupt / DMA mode the byte is taken from the RX ring.
+ */
+uint8_t sercom_usart_read_byte(sercom_usart_t *u)
+{
+    if (u->mode != SERCOM_USART_MODE_BLOCKING)
+    {
+        uint8_t data;
+        while (sercom_usart_read(u, &data, 1) == 0);
+        return data;
+    }
+
+    while (!(u->regs->SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_RXC_Msk));
+
+    return (uint8_t)(u->regs->SERCOM_DATA & 0xFF);
+}
+
+/**
+ * @brief Transmit a null-terminated string
+ */
+void sercom_usart_write_string(sercom_usart_t *u, const char *str)
+{
+    while (*str)
+    {
+        sercom_usart_write_byte(u, (uint8_t)*str++);
+    }
+}
+
+/* ===================== Interrupt Mode ===================== */
+
+/**
+ * @brief Select blocking or interrupt-driven operation
+ *
+ * Switching to interrupt mode empties both rings, enables the RXC and
+ * ERROR interrupts and the SERCOM NVIC lines. DRE is only enabled
+ * while the TX ring holds data.
+ *
+ * DMA mode is entered through sercom_usart_dma_init() only.
+ *
+ * @return false for DMA mode or if the instance has no rings
+ */
+bool sercom_usart_set_mode(sercom_usart_t *u, sercom_usart_mode_t mode)
+{
+    if (mode == u->mode)
+        return true;
+    if (mode == SERCOM_USART_MODE_DMA)
+        return false;
+    if (mode == SERCOM_USART_MODE_INTERRUPT && (!u->tx_buf || !u->rx_buf))
+        return false;
+
+    sercom_usart_stop_mode(u);
+
+    if (mode == SERCOM_USART_MODE_INTERRUPT)
+    {
+        u->tx_head = u->tx_tail = 0;
+        u->rx_head = u->rx_tail = 0;
+
+        u->mode = SERCOM_USART_MODE_INTERRUPT;
+
+        u->regs->SERCOM_INTFLAG = SERCOM_USART_INT_INTFLAG_ERROR_Msk;
+        u->regs->SERCOM_INTENSET =
+            SERCOM_USART_INT_INTENSET_RXC_Msk |
+            SERCOM_USART_INT_INTENSET_ERROR_Msk;
+
+        sercom_core_irq_enable(u->sercom);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Queue bytes for transmission (non-blocking)
+ *
+ * @return Number of bytes accepted (may be less than len when the
+ *         TX ring is full, 0 outside interrupt mode)
+ */
+size_t sercom_usart_write(sercom_usart_t *u, const uint8_t *buf, size_t len)
+{
+    if (u->mode != SERCOM_USART_MODE_INTERRUPT)
+        return 0;
+
+    uint32_t head  = u->tx_head;
+    uint32_t space = u->tx_size - (head - u->tx_tail);
+    uint32_t mask  = u->tx_size - 1u;
+    size_t   n     = (len < space) ? len : space;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        u->tx_buf[(head + i) & mask] = buf[i];
+    }
+
+    /* Publish data before moving head */
+    __DMB();
+    u->tx_head = head + n;
+
+    if (n)
+    {
+        uint32_t used = u->tx_head - u->tx_tail;
+        if (used > u->stats.tx_high_water)
+            u->stats.tx_high_water = (uint16_t)used;
+
+        /* DRE ISR drains the ring and disables itself when empty */
+        u->regs->SERCOM_INTENSET = SERCOM_USART_INT_INTENSET_DRE_Msk;
+    }
+
+    return n;
+}
+
+/**
+ * @brief Take received bytes from the RX ring (non-blocking)
+ *
+ * @return Number of bytes copied into buf (0 if nothing is pending)
+ */
+size_t sercom_usart_read(sercom_usart_t *u, uint8_t *buf, size_t len)
+{
+    if (u->mode == SERCOM_USART_MODE_DMA)
+        return sercom_usart_dma_read(u, buf, len);
+
+    if (u->mode != SERCOM_USART_MODE_INTERRUPT)
+        return 0;
+
+    uint32_t tail  = u->rx_tail;
+    uint32_t avail = u->rx_head - tail;
+    uint32_t mask  = u->rx_size - 1u;
+    size_t   n     = (len < avail) ? len : avail;
+
+    /* Read data only after head has been observed */
+    __DMB();
+
+    for (size_t i = 0; i < n; i++)
+    {
+        buf[i] = u->rx_buf[(tail + i) & mask];
+    }
+
+    u->rx_tail = tail + n;
+
+    /* Resume reception paused by RTS flow control */
+    if (n && u->flow_control)
+        u->regs->SERCOM_INTENSET = SERCOM_USART_INT_INTENSET_RXC_Msk;
+
+    return n;
+}
+
+/**
+ * @brief Number of received bytes waiting
+ */
+size_t sercom_usart_rx_available(sercom_usart_t *u)
+{
+    if (u->mode == SERCOM_USART_MODE_DMA)
+        return sercom_usart_dma_available(u);
+
+    return u->rx_head - u->rx_tail;
+}
+
+/**
+ * @brief Free space in the TX ring
+ */
+size_t sercom_usart_tx_free(sercom_usart_t *u)
+{
+    return u->tx_size - (u->tx_head - u->tx_tail);
+}
+
+/**
+ * @brief Snapshot the overrun / high-water counters
+ */
+void sercom_usart_get_stats(sercom_usart_t *u, sercom_usart_stats_t *stats)
+{
+    stats->rx_overrun     = u->stats.rx_overrun;
+    stats->rx_hw_overrun  = u->stats.rx_hw_overrun;
+    stats->rx_frame_error = u->stats.rx_frame_error;
+    stats->rx_high_water  = u->stats.rx_high_water;
+    stats->tx_high_water  = u->stats.tx_high_water;
+}
+
+/**
+ * @brief Clear the overrun / high-water counters
+ */
+void sercom_usart_reset_stats(sercom_usart_t *u)
+{
+    u->stats.rx_overrun     = 0;
+    u->stats.rx_hw_overrun  = 0;
+    u->stats.rx_frame_error = 0;
+    u->stats.rx_high_water  = 0;
+    u->stats.tx_high_water  = 0;
+}
+
+/* ===================== DMA Mode ===================== */
+
+/**
+ * @brief Total bytes the RX DMA channel has written since dma_init
+ *
+ * Wrap count and remaining beats are re-read until no wrap interrupt
+ * slipped in between. Right after a wrap, before the ISR has run, the
+ * result can lag by one buffer; callers treat that as "no new data".
+ */
+static uint32_t sercom_usart_dma_rx_written(sercom_usart_t *u)
+{
+    uint32_t wraps;
+    uint16_t remaining;
+
+    do
+    {
+        wraps     = u->dma_rx_wraps;
+        remaining = dmac_channel_remaining((uint8_t)u->dma_rx_ch);
+    } while (wraps != u->dma_rx_wraps);
+
+    return wraps * u->dma_rx_size + (u->dma_rx_size - remaining);
+}
+
+/**
+ * @brief Unread bytes in the circular RX buffer
+ *
+ * If the DMAC lapped the reader, the oldest data is gone: the loss is
+ * counted as rx_overrun and the reader skips to the oldest valid byte.
+ */
+static size_t sercom_usart_dma_available(sercom_usart_t *u)
+{
+    uint32_t written = sercom_usart_dma_rx_written(u);
+
+    if ((int32_t)(written - u->dma_rx_read) <= 0)
+        return 0;
+
+    uint32_t avail = written - u->dma_rx_read;
+
+    if (avail > u->dma_rx_size)
+    {
+        u->stats.rx_overrun += avail - u->dma_rx_size;
+        u->dma_rx_read = written - u->dma_rx_size;
+        avail = u->dma_rx_size;
+    }
+
+    if (avail > u->stats.rx_high_water)
+        u->stats.rx_high_water = (uint16_t)avail;
+
+    return avail;
+}
+
+static size_t sercom_usart_dma_read(sercom_usart_t *u, uint8_t *buf, size_t len)
+{
+    size_t   avail = sercom_usart_dma_available(u);
+    size_t   n     = (len < avail) ? len : avail;
+    uint32_t pos   = u->dma_rx_read % u->dma_rx_size;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        buf[i] = u->dma_rx_buf[pos];
+        if (++pos == u->dma_rx_size)
+            pos = 0;
+    }
+
+    u->dma_rx_read += n;
+    return n;
+}
+
+static void sercom_usart_dma_tx_done(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    sercom_usart_t *u = ctx;
+    (void)ch;
+
+    u->dma_tx_busy = false;
+
+    if (u->dma_tx_callback)
+        u->dma_tx_callback(status == DMAC_XFER_COMPLETE, u->dma_tx_context);
+}
+
+static void sercom_usart_dma_rx_wrap(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    sercom_usart_t *u = ctx;
+    (void)ch;
+
+    if (status == DMAC_XFER_COMPLETE)
+        u->dma_rx_wraps++;
+}
+
+/**
+ * @brief Switch the instance to DMA mode
+ *
+ * dmac_init() must have been called. Allocates one TX and one RX
+ * channel (freed again when the mode changes) and starts circular
+ * reception into rx_buf, which must stay valid until then.
+ *
+ * @return false if no DMA channel was available
+ */
+bool sercom_usart_dma_init(sercom_usart_t *u, uint8_t *rx_buf, uint16_t rx_size)
+{
+    if (!rx_buf || rx_size == 0)
+        return false;
+
+    sercom_usart_stop_mode(u);
+
+    u->dma_tx_ch = dmac_channel_alloc();
+    u->dma_rx_ch = dmac_channel_alloc();
+    if (u->dma_tx_ch < 0 || u->dma_rx_ch < 0)
+    {
+        sercom_usart_stop_mode(u);      /* Frees the one that was granted */
+        return false;
+    }
+
+    /* TX: one byte per DRE trigger */
+    dmac_channel_setup((uint8_t)u->dma_tx_ch, DMAC_TRIG_SERCOM_TX(u->sercom), DMAC_TRIGACT_BURST, 1);
+    dmac_channel_register_callback((uint8_t)u->dma_tx_ch, sercom_usart_dma_tx_done, u);
+    u->dma_tx_busy = false;
+
+    /* RX: one byte per RXC trigger, descriptor linked to itself */
+    u->dma_rx_buf   = rx_buf;
+    u->dma_rx_size  = rx_size;
+    u->dma_rx_wraps = 0;
+    u->dma_rx_read  = 0;
+    u->dma_rx_last  = 0;
+    u->dma_rx_idle_polls = 0;
+
+    dmac_desc_t *rx_desc = dmac_channel_descriptor((uint8_t)u->dma_rx_ch);
+    dmac_channel_setup((uint8_t)u->dma_rx_ch, DMAC_TRIG_SERCOM_RX(u->sercom), DMAC_TRIGACT_BURST, 2);
+    dmac_channel_register_callback((uint8_t)u->dma_rx_ch, sercom_usart_dma_rx_wrap, u);
+    dmac_descriptor_fill(rx_desc,
+                         &u->regs->SERCOM_DATA,
+                         rx_buf,
+                         rx_size,
+                         DMAC_BEAT_BYTE,
+                         DMAC_DESC_DSTINC | DMAC_DESC_INT,
+                         rx_desc);
+
+    u->mode = SERCOM_USART_MODE_DMA;
+
+    /* Only line errors are still handled by the CPU */
+    u->regs->SERCOM_INTFLAG = SERCOM_USART_INT_INTFLAG_ERROR_Msk;
+    u->regs->SERCOM_INTENSET = SERCOM_USART_INT_INTENSET_ERROR_Msk;
+    sercom_core_irq_enable(u->sercom);
+
+    dmac_channel_enable((uint8_t)u->dma_rx_ch);
+    return true;
+}
+
+/**
+ * @brief Transmit a scatter-gather list without copying (DMA mode)
+ *
+ * Each entry becomes one chained descriptor; only the last one raises
+ * an interrupt. The buffers are read directly by the DMAC and must
+ * stay untouched until the callback runs.
+ *
+ * The callback runs in DMAC interrupt context once the last byte has
+ * been handed to the USART (it may still be shifting out).
+ *
+ * @return false if DMA mode is not active, a transfer is in progress,
+ *         or the list is empty / too long / has an empty entry
+ */
+bool sercom_usart_dma_write_list(sercom_usart_t *u,
+                                 const sercom_usart_dma_buf_t *list,
+                                 uint8_t count,
+                                 sercom_usart_dma_callback_t callback,
+                                 void *ctx)
+{
+    if (u->mode != SERCOM_USART_MODE_DMA || u->dma_tx_busy)
+        return false;
+    if (count == 0 || count > SERCOM_USART_DMA_SG_MAX)
+        return false;
+
+    dmac_desc_t *desc = dmac_channel_descriptor((uint8_t)u->dma_tx_ch);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (list[i].len == 0)
+            return false;
+
+        bool         last = (i == count - 1u);
+        dmac_desc_t *next = last ? 0 : &u->dma_tx_chain[i];
+
+        dmac_descriptor_fill(desc,
+                             list[i].data,
+                             &u->regs->SERCOM_DATA,
+                             list[i].len,
+                             DMAC_BEAT_BYTE,
+                             DMAC_DESC_SRCINC | (last ? DMAC_DESC_INT : 0u),
+                             next);
+        desc = next;
+    }
+
+    u->dma_tx_callback = callback;
+    u->dma_tx_context  = ctx;
+    u->dma_tx_busy     = true;
+
+    dmac_channel_enable((uint8_t)u->dma_tx_ch);
+    return true;
+}
+
+/**
+ * @brief Transmit one caller-owned buffer without copying (DMA mode)
+ */
+bool sercom_usart_dma_write(sercom_usart_t *u,
+                            const uint8_t *buf,
+                            uint16_t len,
+                            sercom_usart_dma_callback_t callback,
+                            void *ctx)
+{
+    sercom_usart_dma_buf_t entry = { buf, len };
+    return sercom_usart_dma_write_list(u, &entry, 1, callback, ctx);
+}
+
+/**
+ * @brief True while a DMA transmit is in progress
+ */
+bool sercom_usart_dma_tx_busy(sercom_usart_t *u)
+{
+    return u->dma_tx_busy;
+}
+
+/**
+ * @brief Register the RX idle-line callback (DMA mode)
+ */
+void sercom_usart_dma_set_idle_callback(sercom_usart_t *u,
+                                        sercom_usart_dma_callback_t callback,
+                                        void *ctx)
+{
+    u->dma_rx_idle_context  = ctx;
+    u->dma_rx_idle_callback = callback;
+}
+
+/**
+ * @brief RX idle-line detection, call from a periodic tick
+ *
+ * The USART has no idle-line interrupt, so idle is detected by
+ * sampling the DMA write position. When it has not moved for
+ * SERCOM_USART_DMA_IDLE_POLLS consecutive calls and unread data is
+ * pending, the idle callback runs once (argument true).
+ *
+ * Idle timeout = SERCOM_USART_DMA_IDLE_POLLS x tick period.
+ */
+void sercom_usart_dma_rx_poll(sercom_usart_t *u)
+{
+    if (u->mode != SERCOM_USART_MODE_DMA)
+        return;
+
+    uint32_t written = sercom_usart_dma_rx_written(u);
+
+    if (written != u->dma_rx_last)
+    {
+        u->dma_rx_last = written;
+        u->dma_rx_idle_polls = 0;
+        return;
+    }
+
+    if (u->dma_rx_idle_polls < SERCOM_USART_DMA_IDLE_POLLS)
+    {
+        u->dma_rx_idle_polls++;
+
+        if (u->dma_rx_idle_polls == SERCOM_USART_DMA_IDLE_POLLS &&
+            written != u->dma_rx_read &&
+            u->dma_rx_idle_callback)
+        {
+            u->dma_rx_idle_callback(true, u->dma_rx_idle_context);
+        }
+    }
+}
+
+/* ===================== ISR ===================== */
+
+/**
+ * @brief Instance interrupt handler
+ *
+ * - RXC   : move DATA into the RX ring (counted as overrun if full)
+ * - DRE   : feed the next TX ring byte, disable DRE when empty
+ * - ERROR : count BUFOVF / FERR and clear STATUS
+ */
+void sercom_usart_isr(void *ctx)
+{
+    sercom_usart_t *u = ctx;
+    sercom_usart_int_registers_t *usart = u->regs;
+    uint8_t flags = usart->SERCOM_INTFLAG & usart->SERCOM_INTENSET;
+
+    if (flags & SERCOM_USART_INT_INTFLAG_ERROR_Msk)
+    {
+        uint16_t status = usart->SERCOM_STATUS;
+
+        if (status & SERCOM_USART_INT_STATUS_BUFOVF_Msk)
+            u->stats.rx_hw_overrun++;
+        if (status & SERCOM_USART_INT_STATUS_FERR_Msk)
+            u->stats.rx_frame_error++;
+
+        usart->SERCOM_STATUS  = status;
+        usart->SERCOM_INTFLAG = SERCOM_USART_INT_INTFLAG_ERROR_Msk;
+    }
+
+    if (flags & SERCOM_USART_INT_INTFLAG_RXC_Msk)
+    {
+        uint32_t head = u->rx_head;
+        uint32_t used = head - u->rx_tail;
+
+        if (used >= u->rx_size && u->flow_control)
+        {
+            /*
+             * Ring full: leave the byte in the hardware buffer and stop
+             * taking RXC. Once the buffer fills, RTS deasserts and the
+             * sender pauses. sercom_usart_read() re-enables RXC.
+             */
+            usart->SERCOM_INTENCLR = SERCOM_USART_INT_INTENCLR_RXC_Msk;
+        }
+        else if (used < u->rx_size)
+        {
+            /* Reading DATA clears RXC */
+            uint8_t data = (uint8_t)(usart->SERCOM_DATA & 0xFF);
+
+            u->rx_buf[head & (u->rx_size - 1u)] = data;
+            __DMB();
+            u->rx_head = head + 1;
+
+            if (used + 1 > u->stats.rx_high_water)
+                u->stats.rx_high_water = (uint16_t)(used + 1);
+        }
+        else
+        {
+            (void)usart->SERCOM_DATA;
+            u->stats.rx_overrun++;
+        }
+    }
+
+    if (flags & SERCOM_USART_INT_INTFLAG_DRE_Msk)
+    {
+        uint32_t tail = u->tx_tail;
+
+        if (tail != u->tx_head)
+        {
+            usart->SERCOM_DATA = u->tx_buf[tail & (u->tx_size - 1u)];
+            u->tx_tail = tail + 1;
+        }
+        else
+        {
+            usart->SERCOM_INTENCLR = SERCOM_USART_INT_INTENCLR_DRE_Msk;
+        }
+    }
+}
@@ -0,0 +1,233 @@
+#ifndef SERCOM_USART_H
+#define SERCOM_USART_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sercom_core.h"
+#include "dmac_drv.h"
+#include "clock_mgr.h"
+
+/* ===================== Configuration ===================== */
+
+/* Max buffers in one DMA scatter-gather transmit */
+#ifndef SERCOM_USART_DMA_SG_MAX
+#define SERCOM_USART_DMA_SG_MAX     8u
+#endif
+
+/* Unchanged dma_rx_poll() calls before the RX line counts as idle */
+#ifndef SERCOM_USART_DMA_IDLE_POLLS
+#define SERCOM_USART_DMA_IDLE_POLLS 2u
+#endif
+
+/* CTRLA.TXPO: TX on PAD0, RTS on PAD2, CTS on PAD3 */
+#define SERCOM_USART_TXPO_PAD0_FLOW 2u
+
+/* ===================== Types ===================== */
+
+/**
+ * @brief Sample rate / BAUD register format (CTRLA.SAMPR)
+ *
+ * Max baud rate = fref / samples, e.g. 48 MHz: 3 Mbps (16x), 6 Mbps (8x).
+ * Fractional modes give finer steps at high rates.
+ */
+typedef enum
+{
+    SERCOM_USART_SAMPR_16X_ARITH = 0,
+    SERCOM_USART_SAMPR_16X_FRAC  = 1,
+    SERCOM_USART_SAMPR_8X_ARITH  = 2,
+    SERCOM_USART_SAMPR_8X_FRAC   = 3,
+    SERCOM_USART_SAMPR_3X_ARITH  = 4
+} sercom_usart_sampr_t;
+
+/**
+ * @brief Driver operating mode
+ *
+ * BLOCKING  : every byte busy-waits on DRE / RXC (default after init)
+ * INTERRUPT : bytes move through TX/RX ring buffers serviced by the ISR
+ * DMA       : zero-copy DMAC transmit, circular DMAC receive
+ */
+typedef enum
+{
+    SERCOM_USART_MODE_BLOCKING = 0,
+    SERCOM_USART_MODE_INTERRUPT,
+    SERCOM_USART_MODE_DMA
+} sercom_usart_mode_t;
+
+/**
+ * @brief Result of the baud rate computation
+ */
+typedef struct
+{
+    uint16_t baud_reg;      /* Value written to BAUD                 */
+    uint32_t actual;        /* Achieved baud rate                    */
+    int32_t  error_ppm;     /* (actual - requested) / requested, ppm */
+} sercom_usart_baud_t;
+
+/**
+ * @brief Interrupt / DMA mode diagnostics
+ */
+typedef struct
+{
+    uint32_t rx_overrun;        /* Bytes dropped because the RX ring was full */
+    uint32_t rx_hw_overrun;     /* BUFOVF: bytes lost before the ISR ran      */
+    uint32_t rx_frame_error;    /* FERR: framing errors                        */
+    uint16_t rx_high_water;     /* Peak RX ring fill level                     */
+    uint16_t tx_high_water;     /* Peak TX ring fill level                     */
+} sercom_usart_stats_t;
+
+/**
+ * @brief One entry of a DMA scatter-gather transmit list
+ */
+typedef struct
+{
+    const uint8_t *data;
+    uint16_t       len;
+} sercom_usart_dma_buf_t;
+
+/**
+ * @brief DMA completion / RX idle callback (runs in interrupt context
+ *        for TX, in the dma_rx_poll() caller's context for RX idle)
+ */
+typedef void (*sercom_usart_dma_callback_t)(bool ok, void *ctx);
+
+/**
+ * @brief Instance configuration
+ *
+ * tx_buf / rx_buf are the interrupt-mode rings (power-of-two sizes,
+ * may be NULL if interrupt mode is never used).
+ */
+typedef struct
+{
+    uint8_t               sercom;         /* 0..7                              */
+    const sercom_pin_t   *pins;
+    uint8_t               pin_count;
+    uint8_t               rxpo;           /* CTRLA.RXPO: RX pad                */
+    uint8_t               txpo;           /* CTRLA.TXPO (ignored with flow ctl) */
+    uint32_t              baudrate;
+    uint32_t              ref_freq;       /* 0 = sercom_core_clock_hz(), tracked */
+    sercom_usart_sampr_t  sampr;
+    bool                  flow_control;   /* RTS PAD2 / CTS PAD3, TX on PAD0   */
+    uint8_t              *tx_buf;
+    uint16_t              tx_size;
+    uint8_t              *rx_buf;
+    uint16_t              rx_size;
+} sercom_usart_config_t;
+
+/**
+ * @brief USART instance (caller allocated, one per SERCOM)
+ *
+ * All members are driver private.
+ */
+typedef struct
+{
+    uint8_t                        sercom;
+    sercom_usart_int_registers_t  *regs;
+    volatile sercom_usart_mode_t   mode;
+    bool                           flow_control;
+    volatile sercom_usart_stats_t  stats;
+
+    /* Baud rate kept across generator changes (ref_freq == 0 only) */
+    uint32_t                       baudrate;
+    sercom_usart_sampr_t           sampr;
+    clock_notifier_t               clock_nb;
+
+    /* Interrupt mode: SPSC rings, free-running head / tail */
+    uint8_t                       *tx_buf;
+    uint8_t                       *rx_buf;
+    uint32_t                       tx_size;
+    uint32_t                       rx_size;
+    volatile uint32_t              tx_head;
+    volatile uint32_t              tx_tail;
+    volatile uint32_t              rx_head;
+    volatile uint32_t              rx_tail;
+
+    /* DMA mode */
+    int8_t                         dma_tx_ch;
+    int8_t                         dma_rx_ch;
+    dmac_desc_t                    dma_tx_chain[SERCOM_USART_DMA_SG_MAX - 1];
+    volatile bool                  dma_tx_busy;
+    sercom_usart_dma_callback_t    dma_tx_callback;
+    void                          *dma_tx_context;
+    uint8_t                       *dma_rx_buf;
+    uint16_t                       dma_rx_size;
+    volatile uint32_t              dma_rx_wraps;
+    uint32_t                       dma_rx_read;
+    uint32_t                       dma_rx_last;
+    uint16_t                       dma_rx_idle_polls;
+    sercom_usart_dma_callback_t    dma_rx_idle_callback;
+    void                          *dma_rx_idle_context;
+} sercom_usart_t;
+
+/**
+ * @brief Compile-time BAUD for arithmetic modes
+ *
+ * e.g. static const uint16_t b = SERCOM_USART_BAUD_ARITH(48000000UL, 115200UL, 16);
+ */
+#define SERCOM_USART_BAUD_ARITH(fref, baud, samples) \
+    ((uint16_t)(65536ULL - ((65536ULL * (samples) * (baud) + (fref) / 2u) / (fref))))
+
+/* ===================== Setup ===================== */
+
+/**
+ * @brief Integer BAUD computation, reports achieved rate and error
+ */
+bool sercom_usart_compute_baud(uint32_t ref_freq,
+                               uint32_t baudrate,
+                               sercom_usart_sampr_t sampr,
+                               sercom_usart_baud_t *out);
+
+/**
+ * @brief Claim cfg->sercom and initialize it as USART (8N1, async)
+ *
+ * usart must be zeroed before the first call (static or = {0}).
+ * Calling it again re-initializes the instance, releasing the
+ * previous SERCOM and DMA channels.
+ *
+ * @return false if the SERCOM is owned by another driver, the baud rate
+ *         is unreachable or a ring size is not a power of two
+ */
+bool sercom_usart_init(sercom_usart_t *usart,
+                       const sercom_usart_config_t *cfg,
+                       sercom_usart_baud_t *result);
+
+/* ===================== Blocking ===================== */
+void sercom_usart_write_byte(sercom_usart_t *usart, uint8_t data);
+uint8_t sercom_usart_read_byte(sercom_usart_t *usart);
+void sercom_usart_write_string(sercom_usart_t *usart, const char *str);
+
+/* ===================== Interrupt Mode ===================== */
+bool sercom_usart_set_mode(sercom_usart_t *usart, sercom_usart_mode_t mode);
+size_t sercom_usart_write(sercom_usart_t *usart, const uint8_t *buf, size_t len);
+size_t sercom_usart_read(sercom_usart_t *usart, uint8_t *buf, size_t len);
+size_t sercom_usart_rx_available(sercom_usart_t *usart);
+size_t sercom_usart_tx_free(sercom_usart_t *usart);
+void sercom_usart_get_stats(sercom_usart_t *usart, sercom_usart_stats_t *stats);
+void sercom_usart_reset_stats(sercom_usart_t *usart);
+
+/* ===================== DMA Mode ===================== */
+bool sercom_usart_dma_init(sercom_usart_t *usart, uint8_t *rx_buf, uint16_t rx_size);
+bool sercom_usart_dma_write(sercom_usart_t *usart,
+                            const uint8_t *buf,
+                            uint16_t len,
+                            sercom_usart_dma_callback_t callback,
+                            void *ctx);
+bool sercom_usart_dma_write_list(sercom_usart_t *usart,
+                                 const sercom_usart_dma_buf_t *list,
+                                 uint8_t count,
+                                 sercom_usart_dma_callback_t callback,
+                                 void *ctx);
+bool sercom_usart_dma_tx_busy(sercom_usart_t *usart);
+void sercom_usart_dma_set_idle_callback(sercom_usart_t *usart,
+                                        sercom_usart_dma_callback_t callback,
+                                        void *ctx);
+void sercom_usart_dma_rx_poll(sercom_usart_t *usart);
+
+/* ===================== ISR ===================== */
+
+/**
+ * @brief Instance interrupt handler (registered with sercom_core)
+ */
+void sercom_usart_isr(void *ctx);
+
+#endif /* SERCOM_USART_H */
@@ -0,0 +1,386 @@
+#include "soft_pwm.h"
+#include "timer_counter_drv.h"
+#include "clock_mgr.h"
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Software PWM on ordinary GPIO.
+ *
+ * A period is described by an edge table sorted by time:
+ *
+ *   start  : set[port]  → all channels with duty > 0 go high
+ *   edge 0 : at t0, clr[port] → channels whose duty ends at t0 go low
+ *   edge 1 : at t1, ...
+ *   last   : at period → boundary, next period starts
+ *
+ * Channels ending at the same time share one entry, so every
+ * interrupt is one OUTCLR store per port that has edges, whatever the
+ * channel count. The TC runs free (16-bit NFRQ); each interrupt moves
+ * CC0 to the next entry, so there is one interrupt per distinct edge
+ * time plus one per period.
+ *
+ * Two tables: the ISR plays tables[active]; soft_pwm_update() builds
+ * the other one and raises update_ready. The ISR swaps only at the
+ * boundary, so all duties change together and a period is never
+ * built from two tables.
+ */
+
+/* ================= TYPES ================= */
+typedef struct
+{
+    uint16_t at;                        /* Ticks from period start */
+    uint32_t clr[SOFT_PWM_PORTS];
+} soft_pwm_edge_t;
+
+typedef struct
+{
+    uint32_t        set[SOFT_PWM_PORTS];
+    uint16_t        count;              /* Edges incl. the boundary */
+    soft_pwm_edge_t edges[SOFT_PWM_MAX_CHANNELS + 1u];
+} soft_pwm_table_t;
+
+typedef struct
+{
+    gpio_port_id_t port;
+    uint8_t        pin;
+    uint16_t       duty;                /* Staged */
+} soft_pwm_channel_t;
+
+/* ================= STATE ================= */
+static soft_pwm_channel_t pwm_ch[SOFT_PWM_MAX_CHANNELS];
+static uint8_t pwm_ch_count = 0;
+static uint32_t pwm_pins[SOFT_PWM_PORTS] = {0};
+
+static soft_pwm_table_t pwm_tables[2];
+static volatile uint8_t pwm_active = 0;
+static volatile bool pwm_update_ready = false;
+
+static uint8_t  pwm_tc = 0;
+static uint16_t pwm_steps = 0;
+static uint32_t pwm_ticks_per_step = 0;
+static uint32_t pwm_period = 0;         /* Ticks */
+static uint32_t pwm_min_gap = 1;        /* Ticks */
+static uint32_t pwm_hz = 0;
+static bool     pwm_running = false;
+
+/* ISR position */
+static uint16_t pwm_base = 0;           /* COUNT at period start */
+static uint16_t pwm_next = 0;           /* Edge index being waited for */
+
+/* Statistics */
+static soft_pwm_stats_t pwm_stats = {0};
+static uint32_t pwm_acc_cycles = 0;
+static uint32_t pwm_acc_count = 0;
+
+/* ================= LOCAL HELPERS ================= */
+
+/* Period start: one masked write per port, duty 0 channels forced low */
+static inline void soft_pwm_period_start(const soft_pwm_table_t *t)
+{
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+    {
+        if (pwm_pins[p])
+            gpio_port_write((gpio_port_id_t)p, pwm_pins[p], t->set[p]);
+    }
+}
+
+static inline void soft_pwm_schedule(const soft_pwm_table_t *t)
+{
+    tc_set_compare(pwm_tc, (uint16_t)(pwm_base + t->edges[pwm_next].at));
+}
+
+/* Empty table: all channels low, only the boundary */
+static void soft_pwm_table_clear(soft_pwm_table_t *t)
+{
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+        t->set[p] = 0;
+
+    t->count = 1;
+    t->edges[0].at = (uint16_t)pwm_period;
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+        t->edges[0].clr[p] = 0;
+}
+
+/* ================= ISR ================= */
+static void soft_pwm_isr(void)
+{
+    uint32_t c0 = DWT->CYCCNT;
+    const soft_pwm_table_t *t = &pwm_tables[pwm_active];
+    const soft_pwm_edge_t *e = &t->edges[pwm_next];
+    bool boundary = false;
+
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+    {
+        if (e->clr[p])
+            GPIO_FAST_REGS->GROUP[p].PORT_OUTCLR = e->clr[p];
+    }
+
+    if (++pwm_next >= t->count)
+    {
+        boundary  = true;
+        pwm_next  = 0;
+        pwm_base  = (uint16_t)(pwm_base + pwm_period);
+
+        if (pwm_update_ready)
+        {
+            pwm_active ^= 1u;
+            pwm_update_ready = false;
+            pwm_stats.updates++;
+            t = &pwm_tables[pwm_active];
+        }
+
+        soft_pwm_period_start(t);
+    }
+
+    soft_pwm_schedule(t);
+
+    pwm_acc_cycles += DWT->CYCCNT - c0;
+    pwm_acc_count++;
+
+    if (boundary)
+    {
+        pwm_stats.isr_cycles_last = pwm_acc_cycles;
+        pwm_stats.isr_count_last  = pwm_acc_count;
+        if (pwm_acc_cycles > pwm_stats.isr_cycles_max)
+            pwm_stats.isr_cycles_max = pwm_acc_cycles;
+        pwm_stats.periods++;
+
+        pwm_acc_cycles = 0;
+        pwm_acc_count  = 0;
+    }
+}
+
+/* ================= INITIALIZATION ================= */
+bool soft_pwm_init(uint8_t tc_index, uint32_t freq_hz, uint16_t steps)
+{
+    if (freq_hz == 0u || steps == 0u)
+        return false;
+
+    pwm_tc = tc_index;
+
+    /* Smallest prescaler whose period fits 16 bits: finest steps */
+    uint32_t in  = tc_init_for_rate(tc_index, TC_MODE_16BIT, TC_WAVE_NFRQ, freq_hz);
+    uint32_t tps = in / freq_hz / steps;
+
+    if (tps == 0u)
+        return false;   /* Steps shorter than one tick */
+
+    pwm_ticks_per_step = tps;
+    pwm_period  = tps * steps;
+    pwm_hz      = in / pwm_period;
+    pwm_min_gap = (uint32_t)(((uint64_t)SOFT_PWM_MIN_GAP_NS * in + 999999999ULL) / 1000000000ULL);
+
+    if (pwm_period < 4u * pwm_min_gap)
+        return false;
+
+    pwm_steps     = steps;
+    pwm_ch_count  = 0;
+    pwm_running   = false;
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+        pwm_pins[p] = 0;
+
+    soft_pwm_table_clear(&pwm_tables[0]);
+    soft_pwm_table_clear(&pwm_tables[1]);
+    pwm_active = 0;
+    pwm_update_ready = false;
+
+    /* ISR cost is measured with the DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    tc_register_callback(tc_index, TC_INT_MC0, soft_pwm_isr);
+    tc_disable_interrupt(tc_index, 1u << TC_INT_MC0);
+
+    soft_pwm_reset_stats();
+    return true;
+}
+
+int8_t soft_pwm_add_channel(gpio_port_id_t port, uint8_t pin)
+{
+    if (pwm_ch_count >= SOFT_PWM_MAX_CHANNELS || pin >= 32u || (uint32_t)port >= SOFT_PWM_PORTS)
+        return -1;
+
+    uint8_t ch = pwm_ch_count++;
+
+    pwm_ch[ch].port = port;
+    pwm_ch[ch].pin  = pin;
+    pwm_ch[ch].duty = 0;
+
+    gpio_port_clear(port, GPIO_PIN_MASK(pin));
+    gpio_port_configure(port, GPIO_PIN_MASK(pin), GPIO_DIR_OUTPUT);
+
+    /* Read by the ISR: channel joins with duty 0 (forced low) */
+    uint32_t basepri = irq_lock();
+    pwm_pins[port] |= GPIO_PIN_MASK(pin);
+    irq_unlock(basepri);
+
+    return (int8_t)ch;
+}
+
+/* ================= DUTY ================= */
+void soft_pwm_set_duty(uint8_t channel, uint16_t duty)
+{
+    if (channel < pwm_ch_count)
+        pwm_ch[channel].duty = (duty > pwm_steps) ? pwm_steps : duty;
+}
+
+void soft_pwm_update(void)
+{
+    uint8_t order[SOFT_PWM_MAX_CHANNELS];
+    uint16_t at[SOFT_PWM_MAX_CHANNELS];
+    uint8_t n = 0;
+
+    /* Withdraw an unplayed table: the ISR cannot swap until it is rebuilt */
+    pwm_update_ready = false;
+    __DMB();
+
+    soft_pwm_table_t *t = &pwm_tables[pwm_active ^ 1u];
+
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+        t->set[p] = 0;
+
+    /*
+     * Edge time per channel. Edges within the minimum gap of the period
+     * start are pushed to the gap; within the gap of the end, the
+     * channel stays on for the whole period.
+     */
+    for (uint8_t ch = 0; ch < pwm_ch_count; ch++)
+    {
+        uint32_t duty = pwm_ch[ch].duty;
+
+        if (duty == 0u)
+            continue;
+
+        t->set[pwm_ch[ch].port] |= GPIO_PIN_MASK(pwm_ch[ch].pin);
+
+        uint32_t ticks = duty * pwm_ticks_per_step;
+        if (duty >= pwm_steps || ticks + pwm_min_gap > pwm_period)
+            continue;
+        if (ticks < pwm_min_gap)
+            ticks = pwm_min_gap;
+
+        /* Insertion sort: N is small and mostly sorted between updates */
+        uint8_t i = n++;
+        while (i > 0u && at[i - 1u] > ticks)
+        {
+            at[i]    = at[i - 1u];
+            order[i] = order[i - 1u];
+            i--;
+        }
+        at[i]    = (uint16_t)ticks;
+        order[i] = ch;
+    }
+
+    /* Merge coincident / too-close edges into one entry */
+    uint16_t count = 0;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        soft_pwm_edge_t *e;
+
+        if (count > 0u && (uint32_t)(at[i] - t->edges[count - 1u].at) < pwm_min_gap)
+        {
+            e = &t->edges[count - 1u];
+        }
+        else
+        {
+            e = &t->edges[count++];
+            e->at = at[i];
+            for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+                e->clr[p] = 0;
+        }
+
+        e->clr[pwm_ch[order[i]].port] |= GPIO_PIN_MASK(pwm_ch[order[i]].pin);
+    }
+
+    /* Boundary */
+    t->edges[count].at = (uint16_t)pwm_period;
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+        t->edges[count].clr[p] = 0;
+    t->count = count + 1u;
+
+    __DMB();
+    pwm_update_ready = true;
+
+    /* Stopped: nothing plays, take the table now */
+    if (!pwm_running)
+    {
+        pwm_active ^= 1u;
+        pwm_update_ready = false;
+    }
+}
+
+bool soft_pwm_update_pending(void)
+{
+    return pwm_update_ready;
+}
+
+/* ================= CONTROL ================= */
+void soft_pwm_start(void)
+{
+    if (pwm_running || pwm_period == 0u)
+        return;
+
+    uint32_t basepri = irq_lock();
+
+    /* Counter stopped: period starts at the current COUNT */
+    pwm_base = (uint16_t)tc_get_count(pwm_tc);
+    pwm_next = 0;
+    soft_pwm_period_start(&pwm_tables[pwm_active]);
+    soft_pwm_schedule(&pwm_tables[pwm_active]);
+
+    tc_clear_interrupt(pwm_tc, 1u << TC_INT_MC0);
+    tc_enable_interrupt(pwm_tc, 1u << TC_INT_MC0);
+    pwm_running = true;
+    tc_start(pwm_tc);
+
+    irq_unlock(basepri);
+}
+
+void soft_pwm_stop(void)
+{
+    tc_disable_interrupt(pwm_tc, 1u << TC_INT_MC0);
+    tc_stop(pwm_tc);
+    pwm_running = false;
+
+    for (uint8_t p = 0; p < SOFT_PWM_PORTS; p++)
+    {
+        if (pwm_pins[p])
+            gpio_port_clear((gpio_port_id_t)p, pwm_pins[p]);
+    }
+
+    /* A table still waiting for a boundary is taken now */
+    if (pwm_update_ready)
+    {
+        pwm_active ^= 1u;
+        pwm_update_ready = false;
+    }
+}
+
+uint32_t soft_pwm_get_freq_hz(void)
+{
+    return pwm_hz;
+}
+
+/* ================= STATISTICS ================= */
+void soft_pwm_get_stats(soft_pwm_stats_t *stats)
+{
+    uint32_t basepri = irq_lock();
+    *stats = pwm_stats;
+    irq_unlock(basepri);
+
+    stats->period_cycles = pwm_hz ? clock_cpu_hz() / pwm_hz : 0u;
+}
+
+void soft_pwm_reset_stats(void)
+{
+    uint32_t basepri = irq_lock();
+
+    pwm_stats.periods         = 0;
+    pwm_stats.isr_cycles_last = 0;
+    pwm_stats.isr_cycles_max  = 0;
+    pwm_stats.isr_count_last  = 0;
+    pwm_stats.updates         = 0;
+
+    irq_unlock(basepri);
+}
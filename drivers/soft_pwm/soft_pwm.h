@@ -0,0 +1,71 @@
+#ifndef SOFT_PWM_H
+#define SOFT_PWM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio_drv.h"
+
+/* ================= SOFT PWM CONFIG ================= */
+#ifndef SOFT_PWM_MAX_CHANNELS
+#define SOFT_PWM_MAX_CHANNELS   32u
+#endif
+
+/*
+ * Edges closer than this are applied by the same interrupt. It bounds
+ * the interrupt rate and must exceed the ISR entry + exit time, or a
+ * compare can be set behind the counter and a whole 16-bit wrap lost.
+ */
+#ifndef SOFT_PWM_MIN_GAP_NS
+#define SOFT_PWM_MIN_GAP_NS     2000u
+#endif
+
+#define SOFT_PWM_PORTS          4u      /* GPIO_PORT0 .. GPIO_PORT3 */
+
+/* ================= TYPES ================= */
+
+/* Per-period interrupt cost, DWT cycles */
+typedef struct
+{
+    uint32_t periods;           /* Periods completed                     */
+    uint32_t isr_cycles_last;   /* ISR cycles spent in the last period   */
+    uint32_t isr_cycles_max;    /* Worst period since reset              */
+    uint32_t isr_count_last;    /* Interrupts taken in the last period   */
+    uint32_t period_cycles;     /* CPU cycles per PWM period             */
+    uint32_t updates;           /* Duty tables taken at a boundary       */
+} soft_pwm_stats_t;
+
+/* ================= SOFT PWM PUBLIC API ================= */
+
+/*
+ * Claim tc_index as the PWM time base: freq_hz period, duty from 0 to
+ * steps. Fails if a period of steps whole ticks does not fit 16 bits
+ * at any prescaler.
+ */
+bool soft_pwm_init(uint8_t tc_index, uint32_t freq_hz, uint16_t steps);
+
+/* Add an output, driven low until its duty is set. Returns -1 if full */
+int8_t soft_pwm_add_channel(gpio_port_id_t port, uint8_t pin);
+
+/* Stage a duty (0 .. steps); nothing changes until soft_pwm_update() */
+void soft_pwm_set_duty(uint8_t channel, uint16_t duty);
+
+/*
+ * Build the edge table for the staged duties and hand it to the ISR,
+ * which switches to it at the next period boundary: every channel
+ * changes in the same period. Thread context only.
+ */
+void soft_pwm_update(void);
+
+/* True while an updated table waits for the period boundary */
+bool soft_pwm_update_pending(void);
+
+void soft_pwm_start(void);
+void soft_pwm_stop(void);       /* All channels low */
+
+/* Achieved PWM frequency (whole ticks per step) */
+uint32_t soft_pwm_get_freq_hz(void);
+
+void soft_pwm_get_stats(soft_pwm_stats_t *stats);
+void soft_pwm_reset_stats(void);
+
+#endif /* SOFT_PWM_H */
@@ -0,0 +1,279 @@
+#include "spi_drv.h"
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+/*
+ * SERCOM SPI host with DMA full-duplex transfers.
+ *
+ * Every transaction uses two DMAC channels: TX is paced by DRE, RX by
+ * RXC. RX always runs (into a dummy byte if rx_buf is NULL), so its
+ * completion interrupt marks the moment the last bit has been clocked
+ * in. That interrupt releases CS, reprograms the SERCOM if the next
+ * transaction targets another device, asserts the next CS and restarts
+ * both channels; queued transactions follow each other without the
+ * application being involved.
+ */
+
+/* ================= LOCAL HELPERS ================= */
+
+static void spi_enable(sercom_spim_registers_t *regs, bool enable)
+{
+    if (enable)
+        regs->SERCOM_CTRLA |= SERCOM_SPIM_CTRLA_ENABLE_Msk;
+    else
+        regs->SERCOM_CTRLA &= ~SERCOM_SPIM_CTRLA_ENABLE_Msk;
+
+    while (regs->SERCOM_SYNCBUSY & SERCOM_SPIM_SYNCBUSY_ENABLE_Msk);
+}
+
+/*
+ * CTRLA mode bits and BAUD are enable-protected, so the SERCOM is
+ * switched off for the update. Skipped while the same device talks.
+ */
+static void spi_select_device(spi_master_t *spi, const spi_device_t *dev)
+{
+    if (spi->active_dev == dev)
+        return;
+
+    spi_enable(spi->regs, false);
+    spi->regs->SERCOM_CTRLA = spi->ctrla_base | dev->ctrla;
+    spi->regs->SERCOM_BAUD  = dev->baud;
+    spi_enable(spi->regs, true);
+
+    spi->active_dev = dev;
+}
+
+static void spi_xfer_start(spi_master_t *spi, spi_xfer_t *xfer)
+{
+    volatile void *data = &spi->regs->SERCOM_DATA;
+
+    spi_select_device(spi, xfer->dev);
+
+    /* RX first: it must be armed before the first byte comes back */
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)spi->dma_rx_ch),
+                         data,
+                         xfer->rx_buf ? xfer->rx_buf : &spi->dummy_rx,
+                         xfer->len,
+                         DMAC_BEAT_BYTE,
+                         (xfer->rx_buf ? DMAC_DESC_DSTINC : 0u) | DMAC_DESC_INT,
+                         0);
+
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)spi->dma_tx_ch),
+                         xfer->tx_buf ? xfer->tx_buf : &spi->dummy_tx,
+                         data,
+                         xfer->len,
+                         DMAC_BEAT_BYTE,
+                         xfer->tx_buf ? DMAC_DESC_SRCINC : 0u,
+                         0);
+
+    gpio_write_low(xfer->dev->cs_port, xfer->dev->cs_pin);
+
+    dmac_channel_enable((uint8_t)spi->dma_rx_ch);
+    dmac_channel_enable((uint8_t)spi->dma_tx_ch);     /* DRE is set: starts now */
+}
+
+/*
+ * End of the head transaction: CS, status, callback, next one. An
+ * error on either channel stops the other; the transaction ends with
+ * SPI_STATUS_DMA_ERROR and the queue moves on.
+ */
+static void spi_xfer_complete(spi_master_t *spi, dmac_xfer_status_t status)
+{
+    spi_xfer_t *xfer = spi->head;
+
+    if (!xfer)
+        return;
+
+    spi->head = xfer->next;
+    if (!spi->head)
+        spi->tail = 0;
+
+    /* Keep CS low only if the continuation targets the same device */
+    if (status != DMAC_XFER_COMPLETE ||
+        !(xfer->flags & SPI_XFER_KEEP_CS) ||
+        !spi->head || spi->head->dev != xfer->dev)
+    {
+        gpio_write_high(xfer->dev->cs_port, xfer->dev->cs_pin);
+    }
+
+    xfer->status = (status == DMAC_XFER_COMPLETE) ? SPI_STATUS_OK : SPI_STATUS_DMA_ERROR;
+
+    if (xfer->callback)
+        xfer->callback(xfer, xfer->ctx);
+
+    if (spi->head)
+        spi_xfer_start(spi, spi->head);
+}
+
+/*
+ * RX channel done: the transaction is complete on the wire.
+ */
+static void spi_dma_rx_done(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    spi_master_t *spi = ctx;
+    (void)ch;
+
+    if (status == DMAC_XFER_ERROR)
+        dmac_channel_disable((uint8_t)spi->dma_tx_ch);
+
+    spi_xfer_complete(spi, status);
+}
+
+/*
+ * TX channel: only its errors matter. RX would wait forever for bytes
+ * that are never clocked, so it is stopped and the transaction ends.
+ */
+static void spi_dma_tx_done(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    spi_master_t *spi = ctx;
+    (void)ch;
+
+    if (status != DMAC_XFER_ERROR)
+        return;
+
+    dmac_channel_disable((uint8_t)spi->dma_rx_ch);
+    spi_xfer_complete(spi, status);
+}
+
+/* ================= INITIALIZATION ================= */
+bool spi_master_init(spi_master_t *spi, const spi_config_t *cfg)
+{
+    sercom_registers_t *regs = sercom_core_regs(cfg->sercom);
+
+    if (!regs || !sercom_core_claim(cfg->sercom))
+        return false;
+
+    spi->dma_tx_ch = dmac_channel_alloc();
+    spi->dma_rx_ch = dmac_channel_alloc();
+    if (spi->dma_tx_ch < 0 || spi->dma_rx_ch < 0)
+    {
+        if (spi->dma_tx_ch >= 0)
+            dmac_channel_free((uint8_t)spi->dma_tx_ch);
+        if (spi->dma_rx_ch >= 0)
+            dmac_channel_free((uint8_t)spi->dma_rx_ch);
+        sercom_core_release(cfg->sercom);
+        return false;
+    }
+
+    spi->sercom     = cfg->sercom;
+    spi->regs       = &regs->SPIM;
+    spi->active_dev = 0;
+    spi->head       = 0;
+    spi->tail       = 0;
+    spi->dummy_tx   = SPI_DUMMY_BYTE;
+
+    sercom_core_init(cfg->sercom, cfg->pins, cfg->pin_count);
+    spi->clock_hz = sercom_core_clock_hz(cfg->sercom);
+
+    /* Host, GPIO chip select (MSSEN off), pads from the config */
+    spi->ctrla_base =
+          SERCOM_SPIM_CTRLA_MODE_SPI_MASTER
+        | SERCOM_SPIM_CTRLA_DOPO(cfg->dopo)
+        | SERCOM_SPIM_CTRLA_DIPO(cfg->dipo);
+
+    spi->regs->SERCOM_CTRLA = spi->ctrla_base;
+
+    /* 8-bit characters, receiver on */
+    spi->regs->SERCOM_CTRLB =
+          SERCOM_SPIM_CTRLB_RXEN_Msk
+        | SERCOM_SPIM_CTRLB_CHSIZE(0);
+    while (spi->regs->SERCOM_SYNCBUSY & SERCOM_SPIM_SYNCBUSY_CTRLB_Msk);
+
+    /* RX above TX so received bytes are always drained first */
+    dmac_channel_setup((uint8_t)spi->dma_rx_ch, DMAC_TRIG_SERCOM_RX(cfg->sercom), DMAC_TRIGACT_BURST, 3);
+    dmac_channel_setup((uint8_t)spi->dma_tx_ch, DMAC_TRIG_SERCOM_TX(cfg->sercom), DMAC_TRIGACT_BURST, 2);
+    dmac_channel_register_callback((uint8_t)spi->dma_rx_ch, spi_dma_rx_done, spi);
+    dmac_channel_register_callback((uint8_t)spi->dma_tx_ch, spi_dma_tx_done, spi);
+
+    return true;
+}
+
+/*
+ * SCK = fref / (2 * (BAUD + 1)), rounded so SCK never exceeds max_sck_hz.
+ * Highest rate: BAUD = 0, fref / 2.
+ */
+void spi_device_init(spi_master_t *spi,
+                     spi_device_t *dev,
+                     gpio_port_id_t cs_port,
+                     uint8_t cs_pin,
+                     uint32_t max_sck_hz,
+                     uint8_t mode,
+                     bool lsb_first)
+{
+    uint32_t div = 1u;
+
+    if (max_sck_hz)
+        div = (spi->clock_hz + 2u * max_sck_hz - 1u) / (2u * max_sck_hz);
+    if (div == 0u)
+        div = 1u;
+    if (div > 256u)
+        div = 256u;
+
+    dev->cs_port = cs_port;
+    dev->cs_pin  = cs_pin;
+    dev->baud    = (uint8_t)(div - 1u);
+    dev->sck_hz  = spi->clock_hz / (2u * div);
+    dev->ctrla   = ((mode & 2u) ? SERCOM_SPIM_CTRLA_CPOL_Msk : 0u) |
+                   ((mode & 1u) ? SERCOM_SPIM_CTRLA_CPHA_Msk : 0u) |
+                   (lsb_first ? SERCOM_SPIM_CTRLA_DORD_Msk : 0u);
+
+    /* CS idle high */
+    gpio_write_high(cs_port, cs_pin);
+    gpio_configure_pin(cs_port, cs_pin, GPIO_DIR_OUTPUT);
+}
+
+/* ================= TRANSACTION QUEUE ================= */
+bool spi_submit(spi_master_t *spi, spi_xfer_t *xfer)
+{
+    if (!xfer || !xfer->dev || xfer->len == 0)
+        return false;
+    if (xfer->status == SPI_STATUS_PENDING)
+        return false;
+
+    xfer->status = SPI_STATUS_PENDING;
+    xfer->next   = 0;
+
+    uint32_t basepri = irq_lock();
+
+    if (spi->tail)
+    {
+        spi->tail->next = xfer;
+        spi->tail = xfer;
+    }
+    else
+    {
+        spi->head = spi->tail = xfer;
+        spi_xfer_start(spi, xfer);
+    }
+
+    irq_unlock(basepri);
+    return true;
+}
+
+bool spi_busy(spi_master_t *spi)
+{
+    return spi->head != 0;
+}
+
+spi_status_t spi_transfer(spi_master_t *spi,
+                          const spi_device_t *dev,
+                          const uint8_t *tx_buf,
+                          uint8_t *rx_buf,
+                          uint16_t len)
+{
+    spi_xfer_t xfer =
+    {
+        .dev    = dev,
+        .tx_buf = tx_buf,
+        .rx_buf = rx_buf,
+        .len    = len,
+        .status = SPI_STATUS_OK
+    };
+
+    if (!spi_submit(spi, &xfer))
+        return SPI_STATUS_INVALID;
+
+    while (xfer.status == SPI_STATUS_PENDING);
+
+    return xfer.status;
+}
@@ -0,0 +1,130 @@
+#ifndef SPI_DRV_H
+#define SPI_DRV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sercom_core.h"
+#include "gpio_drv.h"
+#include "dmac_drv.h"
+
+/* ================= SPI CONFIG ================= */
+
+/* Byte clocked out when a transaction has no tx_buf */
+#ifndef SPI_DUMMY_BYTE
+#define SPI_DUMMY_BYTE      0xFFu
+#endif
+
+/* SPI modes: CPOL = bit 1, CPHA = bit 0 */
+#define SPI_MODE0           0u
+#define SPI_MODE1           1u
+#define SPI_MODE2           2u
+#define SPI_MODE3           3u
+
+/* ================= TRANSFER STATUS ================= */
+typedef enum
+{
+    SPI_STATUS_OK = 0,
+    SPI_STATUS_PENDING,         /* Queued or on the bus         */
+    SPI_STATUS_DMA_ERROR,       /* DMAC bus error, CS released  */
+    SPI_STATUS_INVALID          /* Rejected by spi_submit()     */
+} spi_status_t;
+
+/* ================= DEVICE ================= */
+/*
+ * One chip on the bus. Filled by spi_device_init(); CTRLA / BAUD are
+ * precomputed so switching devices between transactions only costs a
+ * disable / write / enable of the SERCOM.
+ */
+typedef struct
+{
+    gpio_port_id_t cs_port;
+    uint8_t        cs_pin;
+    uint32_t       sck_hz;      /* Achieved SCK                 */
+    uint32_t       ctrla;       /* Mode bits (CPOL/CPHA/DORD)   */
+    uint8_t        baud;
+} spi_device_t;
+
+/* ================= TRANSACTION ================= */
+#define SPI_XFER_KEEP_CS    (1u << 0)   /* Leave CS asserted if the next queued transaction is for the same device */
+
+struct spi_xfer;
+
+typedef void (*spi_callback_t)(struct spi_xfer *xfer, void *ctx);
+
+/*
+ * Full-duplex transaction. tx_buf == NULL clocks out SPI_DUMMY_BYTE,
+ * rx_buf == NULL discards received data. Buffers and the descriptor
+ * are caller-owned and must stay valid until status leaves PENDING.
+ */
+typedef struct spi_xfer
+{
+    const spi_device_t      *dev;
+    const uint8_t           *tx_buf;
+    uint8_t                 *rx_buf;
+    uint16_t                 len;
+    uint8_t                  flags;
+    spi_callback_t           callback;  /* Runs in DMAC interrupt context */
+    void                    *ctx;
+
+    /* Driver-owned */
+    volatile spi_status_t    status;
+    struct spi_xfer         *next;
+} spi_xfer_t;
+
+/* ================= BUS INSTANCE ================= */
+typedef struct
+{
+    uint8_t     sercom;         /* 0..7                         */
+    const sercom_pin_t *pins;   /* MOSI / SCK / MISO            */
+    uint8_t     pin_count;
+    uint8_t     dopo;           /* CTRLA.DOPO: 0 = DO PAD0, SCK PAD1 */
+    uint8_t     dipo;           /* CTRLA.DIPO: MISO pad         */
+} spi_config_t;
+
+/*
+ * Bus state (caller allocated, one per SERCOM).
+ * All members are driver private.
+ */
+typedef struct
+{
+    uint8_t                 sercom;
+    sercom_spim_registers_t *regs;
+    uint32_t                clock_hz;
+    uint32_t                ctrla_base;
+    int8_t                  dma_tx_ch;
+    int8_t                  dma_rx_ch;
+    const spi_device_t     *active_dev;
+    spi_xfer_t             *head;
+    spi_xfer_t             *tail;
+    uint8_t                 dummy_tx;
+    uint8_t                 dummy_rx;
+} spi_master_t;
+
+/* ================= SPI PUBLIC API ================= */
+
+/* Claim the SERCOM, set up pins + two DMA channels (dmac_init() first) */
+bool spi_master_init(spi_master_t *spi, const spi_config_t *cfg);
+
+/* Describe a device: CS pin (driven high here), max SCK, SPI mode, bit order */
+void spi_device_init(spi_master_t *spi,
+                     spi_device_t *dev,
+                     gpio_port_id_t cs_port,
+                     uint8_t cs_pin,
+                     uint32_t max_sck_hz,
+                     uint8_t mode,
+                     bool lsb_first);
+
+/* Queue a transaction (non-blocking); false if invalid or already queued */
+bool spi_submit(spi_master_t *spi, spi_xfer_t *xfer);
+
+/* True while any transaction is queued or on the bus */
+bool spi_busy(spi_master_t *spi);
+
+/* Queue one transaction and wait for it */
+spi_status_t spi_transfer(spi_master_t *spi,
+                          const spi_device_t *dev,
+                          const uint8_t *tx_buf,
+                          uint8_t *rx_buf,
+                          uint16_t len);
+
+#endif /* SPI_DRV_H */
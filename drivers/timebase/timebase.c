@@ -0,0 +1,177 @@
+#include "timebase.h"
+#include "clock_mgr.h"
+#include "irq_mgr.h"
+#include "pic32cx1025sg61128.h"
+
+#if TIMEBASE_SOURCE == TIMEBASE_SOURCE_TC
+#include "timer_counter_drv.h"
+#else
+#include "rtc_timer.h"
+#endif
+
+/*
+ * 64-bit time from a 32-bit counter.
+ *
+ * TC source: tc_counter64 on the TC pair, which implements the scheme
+ * below in the TC driver. RTC source: the same scheme here, on the
+ * RTC's compare and overflow events.
+ *
+ * An interrupt fires twice per counter period: when COUNT reaches
+ * 0x80000000 and when it wraps to 0. It only increments tb_half, the
+ * number of half periods elapsed. A reader takes tb_half, then COUNT:
+ *
+ *   COUNT bit 31 == tb_half bit 0  → tb_half is current
+ *   otherwise                      → the counter already entered the
+ *                                    next half and its interrupt has
+ *                                    not run yet: use tb_half + 1
+ *
+ *   time = (tb_half / 2) << 32 | COUNT
+ *
+ * No flag is read and nothing is written, so readers never lock and
+ * stay correct when they preempt the timebase interrupt, as long as
+ * that interrupt is not held off for half a period (44 s at 48 MHz,
+ * 24 days at 1024 Hz).
+ */
+
+/* ================= MACROS ================= */
+#if TIMEBASE_SOURCE == TIMEBASE_SOURCE_TC
+#if (TIMEBASE_TC & 1u) != 0u
+#error "TIMEBASE_TC must be an even TC (32-bit pair master)"
+#endif
+
+#ifndef TIMEBASE_TC_IRQn
+#define TIMEBASE_TC_IRQn    ((IRQn_Type)(TC0_IRQn + TIMEBASE_TC))
+#endif
+#endif
+
+/* ================= STATE ================= */
+#if TIMEBASE_SOURCE != TIMEBASE_SOURCE_TC
+static volatile uint32_t tb_half = 0;
+#endif
+static uint32_t tb_hz = 0;
+
+/* ================= LOCAL HELPERS ================= */
+
+#if TIMEBASE_SOURCE != TIMEBASE_SOURCE_TC
+
+static inline uint32_t timebase_count(void)
+{
+    return RTC_Timer_GetCount();
+}
+
+static void timebase_half_event(void *ctx)
+{
+    (void)ctx;
+    tb_half++;
+}
+
+#endif
+
+/* ================= INITIALIZATION ================= */
+void timebase_init(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+#if TIMEBASE_SOURCE == TIMEBASE_SOURCE_TC
+    (void)tc_counter64_init(TIMEBASE_TC, TC_MODE_32BIT, TC_PRESCALER_DIV1);
+    irq_enable(TIMEBASE_TC_IRQn, IRQ_PRIO_TIMEBASE);
+
+    tb_hz = tc_get_clock_hz(TIMEBASE_TC);
+#else
+    RTC_Timer_InitFreeRunning();
+
+    /* The RTC may already be running: seed the half from COUNT */
+    tb_half = RTC_Timer_EnableWrapEvents(timebase_half_event, 0) >> 31;
+    tb_hz   = RTC_TIMER_FREE_HZ;
+#endif
+
+    /* DWT cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    __set_PRIMASK(primask);
+}
+
+uint32_t timebase_hz(void)
+{
+    return tb_hz;
+}
+
+/* ================= TIMESTAMP ================= */
+uint64_t timebase_now(void)
+{
+#if TIMEBASE_SOURCE == TIMEBASE_SOURCE_TC
+    return tc_counter64_read(TIMEBASE_TC);
+#else
+    uint32_t half = tb_half;
+    uint32_t lo   = timebase_count();
+
+    if ((lo >> 31) != (half & 1u))
+        half++;
+
+    return ((uint64_t)(half >> 1) << 32) | lo;
+#endif
+}
+
+uint64_t timebase_now_us(void)
+{
+    return timebase_ticks_to_us(timebase_now());
+}
+
+uint64_t timebase_now_ns(void)
+{
+    return timebase_ticks_to_ns(timebase_now());
+}
+
+/* ================= CONVERSIONS ================= */
+
+/*
+ * Whole seconds and remainder are scaled separately: the remainder is
+ * below tb_hz, so rem × 10^9 never overflows 64 bits.
+ */
+uint64_t timebase_ticks_to_us(uint64_t ticks)
+{
+    uint64_t sec = ticks / tb_hz;
+    uint64_t rem = ticks % tb_hz;
+
+    return sec * 1000000ULL + rem * 1000000ULL / tb_hz;
+}
+
+uint64_t timebase_ticks_to_ns(uint64_t ticks)
+{
+    uint64_t sec = ticks / tb_hz;
+    uint64_t rem = ticks % tb_hz;
+
+    return sec * 1000000000ULL + rem * 1000000000ULL / tb_hz;
+}
+
+uint64_t timebase_us_to_ticks(uint64_t us)
+{
+    uint64_t sec = us / 1000000ULL;
+    uint64_t rem = us % 1000000ULL;
+
+    return sec * tb_hz + (rem * tb_hz + 999999ULL) / 1000000ULL;
+}
+
+/* ================= TIMEOUTS ================= */
+uint64_t timebase_deadline_us(uint64_t us)
+{
+    return timebase_now() + timebase_us_to_ticks(us);
+}
+
+bool timebase_reached(uint64_t deadline)
+{
+    return timebase_now() >= deadline;
+}
+
+/* ================= CPU CYCLES ================= */
+uint32_t timebase_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+uint32_t timebase_cycles_to_ns(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000000000ULL / clock_cpu_hz());
+}
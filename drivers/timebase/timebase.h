@@ -0,0 +1,63 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= TIMEBASE CONFIG ================= */
+
+/*
+ * Counter behind the 64-bit timestamp:
+ *   TC  : TIMEBASE_TC / TIMEBASE_TC + 1 paired as one 32-bit counter
+ *         on GCLK1 (48 MHz, 20.8 ns resolution). Default.
+ *   RTC : free-running RTC at 1024 Hz, shared with the timer wheel;
+ *         keeps counting in standby.
+ */
+#define TIMEBASE_SOURCE_TC      0
+#define TIMEBASE_SOURCE_RTC     1
+
+#ifndef TIMEBASE_SOURCE
+#define TIMEBASE_SOURCE         TIMEBASE_SOURCE_TC
+#endif
+
+/* Even TC index, its odd partner becomes the 32-bit slave */
+#ifndef TIMEBASE_TC
+#define TIMEBASE_TC             0u
+#endif
+
+/* ================= TIMEBASE PUBLIC API ================= */
+
+/* Start the counter and its half-period interrupts */
+void timebase_init(void);
+
+/* Tick rate of timebase_now() */
+uint32_t timebase_hz(void);
+
+/*
+ * Monotonic 64-bit tick count. Lock-free: callable from any thread
+ * or interrupt, including ones that preempt the timebase interrupt.
+ */
+uint64_t timebase_now(void);
+
+uint64_t timebase_now_us(void);
+uint64_t timebase_now_ns(void);
+
+/* Conversions (exact to the tick, no overflow over the 64-bit range) */
+uint64_t timebase_ticks_to_us(uint64_t ticks);
+uint64_t timebase_ticks_to_ns(uint64_t ticks);
+uint64_t timebase_us_to_ticks(uint64_t us);     /* Rounded up */
+
+/* Timeouts */
+uint64_t timebase_deadline_us(uint64_t us);
+bool timebase_reached(uint64_t deadline);
+
+/* ================= CPU CYCLES (DWT) ================= */
+
+/*
+ * DWT->CYCCNT for short intervals (32-bit, wraps after 2^32 CPU
+ * cycles: ~35 s at 120 MHz). Enabled by timebase_init().
+ */
+uint32_t timebase_cycles(void);
+uint32_t timebase_cycles_to_ns(uint32_t cycles);
+
+#endif /* TIMEBASE_H */
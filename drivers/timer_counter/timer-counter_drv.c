@@ -1,11 +1,15 @@
 #include "pic32cx1025sg61128.h"
 #include "timer_counter_drv.h"
+#include "clock_mgr.h"
+#include "irq_mgr.h"
+#include "isr_prof.h"
+#include "scheduler.h"
 
 /* ================= TC BASE TABLE ================= */
-#define TC_MAX 8
-#define TC_CHANNELS 2
+#define TC_CHANNELS 6   /* INTFLAG bits: OVF, ERR, -, -, MC0, MC1 */
 
-static tc_registers_t *const tc_table[] =
+/* Shared with the inline width-specific accessors of the header */
+tc_registers_t *const tc_table[TC_MAX] =
 {
     TC0_REGS, TC1_REGS, TC2_REGS, TC3_REGS,
     TC4_REGS, TC5_REGS, TC6_REGS, TC7_REGS
@@ -13,6 +17,7 @@ static tc_registers_t *const tc_table[] =
 
 /* ================= CALLBACK STORAGE ================= */
 static void (*tc_callbacks[TC_MAX][TC_CHANNELS])(void) = {0};
+static uint8_t tc_deferred[TC_MAX] = {0};  /* Per-channel: run from the scheduler */
 
 /* =========================================================
  * TC Clock Configuration Tables (Datasheet Accurate)
@@ -53,18 +58,64 @@ static const uint8_t tc_gclk_id[] =
     39  /* TC7 */
 };
 
+/* TCs holding a reference on their (pair-shared) GCLK channel */
+static uint8_t tc_clocked = 0;
+
+/* Counter width set by tc_init(): picks the COUNT8/16/32 register view */
+static tc_mode_t tc_mode[TC_MAX] = {0};
+
+/* Extended counters: half periods elapsed per TC, see tc_counter64_read() */
+static volatile uint32_t tc_half[TC_MAX] = {0};
+static uint8_t tc_extended = 0;
+
+/* ISR profiler: TCs timing their OVF latency, CPU cycles per tick (Q8) */
+static uint8_t tc_latency_mask = 0;
+static uint32_t tc_latency_q8[TC_MAX] = {0};
+
+static const uint16_t tc_prescaler_div[] =
+{
+    1, 2, 4, 8, 16, 64, 256, 1024   /* tc_prescaler_t order */
+};
+
 /* ================= CLOCK ENABLE ================= */
 static void tc_clock_enable(uint8_t tc_index)
 {
     // Enable APB clock for this TC
     *tc_apb_mask_reg[tc_index] |= tc_apb_mask_bit[tc_index];
 
-    // Enable GCLK for this TC
-    GCLK_REGS->GCLK_PCHCTRL[tc_gclk_id[tc_index]] =
-        GCLK_PCHCTRL_GEN_GCLK0 | GCLK_PCHCTRL_CHEN_Msk;
+    // Enable GCLK for this TC (channel shared by the pair, refcounted)
+    if (!(tc_clocked & (1u << tc_index)))
+    {
+        (void)clock_periph_enable(tc_gclk_id[tc_index], TC_GCLK_GEN);
+        tc_clocked |= (uint8_t)(1u << tc_index);
+    }
+}
+
+/* ================= WIDTH DISPATCH ================= */
+/*
+ * For callers that only know the width at run time (tc_init() stored
+ * it). Only COUNT, PER, CCx and their buffers move between the
+ * COUNT8/16/32 views; the control and flag registers below them are
+ * shared, so everything else goes through COUNT16.
+ */
+static void tc_write_cc(uint8_t tc_index, uint8_t channel, uint32_t value)
+{
+    switch (tc_mode[tc_index])
+    {
+        case TC_MODE_8BIT:  tc8_set_compare(tc_index, channel, (uint8_t)value);   break;
+        case TC_MODE_32BIT: tc32_set_compare(tc_index, channel, value);           break;
+        default:            tc16_set_compare(tc_index, channel, (uint16_t)value); break;
+    }
+}
 
-    // Wait until clock is ready
-    while (!(GCLK_REGS->GCLK_PCHCTRL[tc_gclk_id[tc_index]] & GCLK_PCHCTRL_CHEN_Msk));
+static uint32_t tc_read_cc(uint8_t tc_index, uint8_t channel)
+{
+    switch (tc_mode[tc_index])
+    {
+        case TC_MODE_8BIT:  return tc8_get_capture(tc_index, channel);
+        case TC_MODE_32BIT: return tc32_get_capture(tc_index, channel);
+        default:            return tc16_get_capture(tc_index, channel);
+    }
 }
 
 /* ================= INITIALIZATION ================= */
@@ -88,19 +139,72 @@ void tc_init(uint8_t tc_index,
 
     /* Set mode & prescaler */
     tc->COUNT16.TC_CTRLA = TC_CTRLA_MODE(mode) | TC_CTRLA_PRESCALER(prescaler);
+    tc_mode[tc_index] = mode;
 
     /* Waveform generation */
     tc->COUNT16.TC_WAVE = waveform;
     while (tc->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_ENABLE_Msk);
 
     /* Compare value */
-    tc->COUNT16.TC_CC[0] = compare_value;
-    while (tc->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_CC0_Msk);
+    tc_write_cc(tc_index, 0, compare_value);
 
     /* Clear interrupts */
     tc->COUNT16.TC_INTFLAG = TC_INTFLAG_Msk;
 }
 
+void tc_deinit(uint8_t tc_index)
+{
+    tc_registers_t *tc = tc_table[tc_index];
+
+    if (!(tc_clocked & (1u << tc_index)))
+        return;
+
+    tc->COUNT16.TC_INTENCLR = TC_INTENCLR_Msk;
+    tc->COUNT16.TC_CTRLA |= TC_CTRLA_SWRST_Msk;
+    while (tc->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_SWRST_Msk);
+
+    // GCLK channel stops once the other TC of the pair is done too
+    clock_periph_disable(tc_gclk_id[tc_index]);
+    tc_clocked &= (uint8_t)~(1u << tc_index);
+
+    *tc_apb_mask_reg[tc_index] &= ~tc_apb_mask_bit[tc_index];
+}
+
+uint32_t tc_get_clock_hz(uint8_t tc_index)
+{
+    return clock_periph_hz(tc_gclk_id[tc_index]);
+}
+
+/* Smallest prescaler whose counter range spans 1 / min_hz: finest ticks */
+uint32_t tc_init_for_rate(uint8_t tc_index,
+                          tc_mode_t mode,
+                          tc_waveform_t waveform,
+                          uint32_t min_hz)
+{
+    uint64_t range = (mode == TC_MODE_8BIT)  ? 0x100u :
+                     (mode == TC_MODE_32BIT) ? 0x100000000ull : 0x10000u;
+
+    if (min_hz == 0u)
+        return 0;
+
+    /* Clocks the TC so its input frequency is known */
+    tc_clock_enable(tc_index);
+    uint32_t clk = tc_get_clock_hz(tc_index);
+
+    for (uint8_t p = 0; p < sizeof tc_prescaler_div / sizeof tc_prescaler_div[0]; p++)
+    {
+        uint32_t in = clk / tc_prescaler_div[p];
+
+        if (in / min_hz < range)
+        {
+            tc_init(tc_index, mode, (tc_prescaler_t)p, waveform, 0);
+            return in;
+        }
+    }
+
+    return 0;
+}
+
 /* ================= CONTROL ================= */
 void tc_start(uint8_t tc_index)
 {
@@ -119,9 +223,7 @@ void tc_stop(uint8_t tc_index)
 /* ================= COMPARE ================= */
 void tc_set_compare(uint8_t tc_index, uint32_t value)
 {
-    tc_registers_t *tc = tc_table[tc_index];
-    tc->COUNT16.TC_CC[0] = value;
-    while (tc->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_CC0_Msk);
+    tc_write_cc(tc_index, 0, value);
 }
 
 bool tc_compare_match(uint8_t tc_index)
@@ -135,19 +237,206 @@ bool tc_compare_match(uint8_t tc_index)
     return false;
 }
 
-/* ================= READ COUNTER ================= */
-uint16_t tc_get_count(uint8_t tc_index)
+bool tc_overflow(uint8_t tc_index)
 {
     tc_registers_t *tc = tc_table[tc_index];
-    return tc->COUNT16.TC_COUNT; // Current counter value
+    if(tc->COUNT16.TC_INTFLAG & TC_INTFLAG_OVF_Msk)
+    {
+        tc->COUNT16.TC_INTFLAG = TC_INTFLAG_OVF_Msk;
+        return true;
+    }
+    return false;
+}
+
+/* ================= BUFFERED UPDATES ================= */
+/*
+ * CCBUFx / PERBUF are plain APB registers: no write synchronization.
+ * The core copies them to CCx / PER on the next update condition
+ * (overflow, underflow or retrigger) unless CTRLB.LUPD is set. So a
+ * buffered write never waits, and a value only ever takes effect at a
+ * period boundary: no glitch from a compare moved mid-period.
+ */
+void tc_set_compare_buffered(uint8_t tc_index, uint8_t channel, uint32_t value)
+{
+    switch (tc_mode[tc_index])
+    {
+        case TC_MODE_8BIT:  tc8_set_compare_buffered(tc_index, channel, (uint8_t)value);   break;
+        case TC_MODE_32BIT: tc32_set_compare_buffered(tc_index, channel, value);           break;
+        default:            tc16_set_compare_buffered(tc_index, channel, (uint16_t)value); break;
+    }
+}
+
+void tc_set_period_buffered(uint8_t tc_index, uint32_t value)
+{
+    /* 8-bit mode has PER; 16/32-bit MFRQ / MPWM use CC0 as the top */
+    if (tc_mode[tc_index] == TC_MODE_8BIT)
+        tc_table[tc_index]->COUNT8.TC_PERBUF = (uint8_t)value;
+    else
+        tc_set_compare_buffered(tc_index, 0, value);
+}
+
+/*
+ * CTRLB is write-synchronized. Its SYNCBUSY is only checked before the
+ * next CTRLB write, a few GCLK cycles after the previous one: the
+ * control loop in between (buffer writes) makes that wait empty.
+ */
+static void tc_ctrlb_write(tc_registers_t *tc, bool set, uint8_t bits)
+{
+    while (tc->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_CTRLB_Msk);
+
+    if (set)
+        tc->COUNT16.TC_CTRLBSET = bits;
+    else
+        tc->COUNT16.TC_CTRLBCLR = bits;
+}
+
+void tc_update_lock(uint8_t tc_mask)
+{
+    for (uint8_t i = 0; i < TC_MAX; i++)
+    {
+        if (tc_mask & (1u << i))
+            tc_ctrlb_write(tc_table[i], true, TC_CTRLBSET_LUPD_Msk);
+    }
+}
+
+static void tc_ctrlb_sync(uint8_t tc_mask)
+{
+    for (uint8_t i = 0; i < TC_MAX; i++)
+    {
+        if (tc_mask & (1u << i))
+            while (tc_table[i]->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_CTRLB_Msk);
+    }
+}
+
+/*
+ * Back to back: the TCs see the unlock within a few bus cycles. Only
+ * the plain CTRLBCLR stores run with PRIMASK set; the CTRLB syncs are
+ * waited for before and after, with interrupts enabled.
+ */
+void tc_update_unlock(uint8_t tc_mask)
+{
+    tc_ctrlb_sync(tc_mask);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t i = 0; i < TC_MAX; i++)
+    {
+        if (tc_mask & (1u << i))
+            tc_table[i]->COUNT16.TC_CTRLBCLR = TC_CTRLBCLR_LUPD_Msk;
+    }
+
+    __set_PRIMASK(primask);
+
+    tc_ctrlb_sync(tc_mask);
+}
+
+bool tc_update_pending(uint8_t tc_index)
+{
+    return (tc_table[tc_index]->COUNT16.TC_STATUS &
+            (TC_STATUS_PERBUFV_Msk | TC_STATUS_CCBUFV0_Msk | TC_STATUS_CCBUFV1_Msk)) != 0u;
+}
+
+/* ================= READ COUNTER ================= */
+uint32_t tc_get_count(uint8_t tc_index)
+{
+    switch (tc_mode[tc_index])
+    {
+        case TC_MODE_8BIT:  return tc8_get_count(tc_index);
+        case TC_MODE_32BIT: return tc32_get_count(tc_index);
+        default:            return tc16_get_count(tc_index);
+    }
+}
+
+/* ================= 64-BIT COUNTER ================= */
+/*
+ * Same scheme as the timebase: CC0 sits at half the counter range, and
+ * MC0 and OVF each bump tc_half, the half periods elapsed. A reader
+ * takes tc_half, then COUNT:
+ *
+ *   COUNT top bit == tc_half bit 0  → tc_half is current
+ *   otherwise                       → the counter entered the next half
+ *                                     and its interrupt has not run yet
+ *
+ *   value = (tc_half / 2) << width | COUNT
+ *
+ * No flag is read or cleared by readers, so they never race the
+ * interrupt. Correct as long as the interrupt is not held off for
+ * half a counter period (2^31 ticks in 32-bit mode: 44 s at 48 MHz).
+ */
+static uint8_t tc_width_bits(uint8_t tc_index)
+{
+    switch (tc_mode[tc_index])
+    {
+        case TC_MODE_8BIT:  return 8u;
+        case TC_MODE_32BIT: return 32u;
+        default:            return 16u;
+    }
+}
+
+bool tc_counter64_init(uint8_t tc_index, tc_mode_t mode, tc_prescaler_t prescaler)
+{
+    if (tc_index >= TC_MAX || (mode == TC_MODE_32BIT && (tc_index & 1u)))
+        return false;
+
+    /* 32-bit: the odd partner is clocked and slaved to the master */
+    if (mode == TC_MODE_32BIT)
+        tc_init(tc_index + 1u, TC_MODE_16BIT, prescaler, TC_WAVE_NFRQ, 0);
+
+    tc_init(tc_index, mode, prescaler, TC_WAVE_NFRQ, 0);
+
+    /* NFRQ tops out at MAX in 16/32-bit; 8-bit counts to PER */
+    if (mode == TC_MODE_8BIT)
+    {
+        tc_table[tc_index]->COUNT8.TC_PER = 0xFFu;
+        while (tc_table[tc_index]->COUNT8.TC_SYNCBUSY & TC_SYNCBUSY_PER_Msk);
+    }
+
+    /* Half-range compare: MC0 marks the second half */
+    tc_write_cc(tc_index, 0, 1u << (tc_width_bits(tc_index) - 1u));
+
+    tc_half[tc_index] = 0;
+    tc_extended |= (uint8_t)(1u << tc_index);
+    tc_clear_interrupt(tc_index, TC_INTFLAG_OVF_Msk | TC_INTFLAG_MC0_Msk);
+    tc_enable_interrupt(tc_index, TC_INTENSET_OVF_Msk | TC_INTENSET_MC0_Msk);
+
+    NVIC_ClearPendingIRQ((IRQn_Type)(TC0_IRQn + tc_index));
+    irq_enable((IRQn_Type)(TC0_IRQn + tc_index), IRQ_PRIO_TC);
+
+    tc_start(tc_index);
+    return true;
+}
+
+uint64_t tc_counter64_read(uint8_t tc_index)
+{
+    uint8_t  bits  = tc_width_bits(tc_index);
+    uint32_t half  = tc_half[tc_index];
+    uint32_t count = tc_get_count(tc_index);
+
+    if (((count >> (bits - 1u)) & 1u) != (half & 1u))
+        half++;
+
+    return ((uint64_t)(half >> 1) << bits) | count;
+}
+
+void tc_counter64_deinit(uint8_t tc_index)
+{
+    if (!(tc_extended & (1u << tc_index)))
+        return;
+
+    irq_disable((IRQn_Type)(TC0_IRQn + tc_index));
+    tc_extended &= (uint8_t)~(1u << tc_index);
+
+    if (tc_mode[tc_index] == TC_MODE_32BIT)
+        tc_deinit(tc_index + 1u);
+
+    tc_deinit(tc_index);
 }
 
 /* ================= PWM ================= */
 void tc_pwm_set_duty(uint8_t tc_index, uint32_t duty)
 {
-    tc_registers_t *tc = tc_table[tc_index];
-    tc->COUNT16.TC_CC[1] = duty;
-    while (tc->COUNT16.TC_SYNCBUSY & TC_SYNCBUSY_CC1_Msk);
+    tc_write_cc(tc_index, 1, duty);
 }
 
 /* ================= CAPTURE ================= */
@@ -173,13 +462,13 @@ void tc_capture_enable(uint8_t tc_index, uint8_t channel, tc_capture_mode_t mode
             break;
 
         case TC_CAPTURE_PPWP:
-            tc->COUNT16.TC_EVCTRL |= TC_EVCTRL_EVACT_PPW;
+            tc->COUNT16.TC_EVCTRL |= TC_EVCTRL_TCEI_Msk | TC_EVCTRL_EVACT_PPW;
             if (invert)
                 tc->COUNT16.TC_EVCTRL |= TC_EVCTRL_TCINV_Msk;
             break;
 
         case TC_CAPTURE_PWP:
-            tc->COUNT16.TC_EVCTRL |= TC_EVCTRL_EVACT_PW;
+            tc->COUNT16.TC_EVCTRL |= TC_EVCTRL_TCEI_Msk | TC_EVCTRL_EVACT_PW;
             if (invert)
                 tc->COUNT16.TC_EVCTRL |= TC_EVCTRL_TCINV_Msk;
             break;
@@ -191,15 +480,54 @@ void tc_capture_enable(uint8_t tc_index, uint8_t channel, tc_capture_mode_t mode
     tc->COUNT16.TC_INTFLAG = TC_INTFLAG_MC0_Msk << channel;
 }
 
-uint16_t tc_capture_read(uint8_t tc_index, uint8_t channel)
+uint32_t tc_capture_read(uint8_t tc_index, uint8_t channel)
 {
     tc_registers_t *tc = tc_table[tc_index];
     while (!(tc->COUNT16.TC_INTFLAG & (TC_INTFLAG_MC0_Msk << channel)));
-    uint16_t val = tc->COUNT16.TC_CC[channel];
+    uint32_t val = tc_read_cc(tc_index, channel);
     tc->COUNT16.TC_INTFLAG = (TC_INTFLAG_MC0_Msk << channel);
     return val;
 }
 
+volatile void *tc_capture_register(uint8_t tc_index, uint8_t channel)
+{
+    switch (tc_mode[tc_index])
+    {
+        case TC_MODE_8BIT:  return &tc_table[tc_index]->COUNT8.TC_CC[channel];
+        case TC_MODE_32BIT: return &tc_table[tc_index]->COUNT32.TC_CC[channel];
+        default:            return &tc_table[tc_index]->COUNT16.TC_CC[channel];
+    }
+}
+
+/* ================= EVENTS ================= */
+void tc_set_event_action(uint8_t tc_index, tc_event_action_t action, bool invert)
+{
+    tc_registers_t *tc = tc_table[tc_index];
+    uint16_t evctrl = tc->COUNT16.TC_EVCTRL &
+                      (uint16_t)~(TC_EVCTRL_EVACT_Msk | TC_EVCTRL_TCEI_Msk | TC_EVCTRL_TCINV_Msk);
+
+    if (action != TC_EVACT_OFF)
+    {
+        evctrl |= TC_EVCTRL_TCEI_Msk | TC_EVCTRL_EVACT(action);
+        if (invert)
+            evctrl |= TC_EVCTRL_TCINV_Msk;
+    }
+
+    tc->COUNT16.TC_EVCTRL = evctrl;
+}
+
+void tc_event_output_enable(uint8_t tc_index, uint16_t outputs, bool enable)
+{
+    tc_registers_t *tc = tc_table[tc_index];
+
+    outputs &= (TC_EVOUT_OVF | TC_EVOUT_MC0 | TC_EVOUT_MC1);
+
+    if (enable)
+        tc->COUNT16.TC_EVCTRL |= outputs;
+    else
+        tc->COUNT16.TC_EVCTRL &= (uint16_t)~outputs;
+}
+
 /* ================= INTERRUPTS ================= */
 void tc_enable_interrupt(uint8_t tc_index, uint32_t flags)
 {
@@ -225,23 +553,106 @@ void tc_register_callback(uint8_t tc_index, uint8_t channel, void (*callback)(vo
     if(tc_index < TC_MAX && channel < TC_CHANNELS)
     {
         tc_callbacks[tc_index][channel] = callback;
+        tc_deferred[tc_index] &= ~(1u << channel);
+        tc_enable_interrupt(tc_index, 1 << channel);
+        irq_enable((IRQn_Type)(TC0_IRQn + tc_index), IRQ_PRIO_TC);
+    }
+}
+
+void tc_register_callback_deferred(uint8_t tc_index, uint8_t channel, void (*callback)(void))
+{
+    if(tc_index < TC_MAX && channel < TC_CHANNELS)
+    {
+        tc_callbacks[tc_index][channel] = callback;
+        tc_deferred[tc_index] |= (1u << channel);
         tc_enable_interrupt(tc_index, 1 << channel);
+        irq_enable((IRQn_Type)(TC0_IRQn + tc_index), IRQ_PRIO_TC);
     }
 }
 
+/* Runs in the scheduler's defer task, arg = callback slot */
+static void tc_deferred_trampoline(void *arg)
+{
+    void (*callback)(void) = *(void (*const *)(void))arg;
+
+    if(callback)
+        callback();
+}
+
+/* ================= ISR PROFILING ================= */
+void tc_profile_latency(uint8_t tc_index, bool enable)
+{
+    if (tc_index >= TC_MAX)
+        return;
+
+    if (!enable)
+    {
+        tc_latency_mask &= (uint8_t)~(1u << tc_index);
+        return;
+    }
+
+    uint32_t presc   = (tc_table[tc_index]->COUNT16.TC_CTRLA & TC_CTRLA_PRESCALER_Msk) >> TC_CTRLA_PRESCALER_Pos;
+    uint32_t tick_hz = tc_get_clock_hz(tc_index) / tc_prescaler_div[presc];
+
+    if (tick_hz == 0u)
+        return;
+
+    tc_latency_q8[tc_index] = (uint32_t)(((uint64_t)clock_cpu_hz() << 8) / tick_hz);
+    tc_latency_mask |= (uint8_t)(1u << tc_index);
+}
+
 /* ================= COMMON ISR HANDLER ================= */
 void TCx_Handler(uint8_t tc_index)
 {
+    ISR_PROF_ENTER(prof);
+
     tc_registers_t *tc = tc_table[tc_index];
+
+    /* Only enabled sources: polled flags (tc_compare_match) stay set */
+    uint8_t pending = tc->COUNT16.TC_INTFLAG & tc->COUNT16.TC_INTENSET;
+
+#if ISR_PROF_ENABLE
+    uint32_t latency = ISR_PROF_NO_LATENCY;
+
+    if ((tc_latency_mask & (1u << tc_index)) && (pending & TC_INTFLAG_OVF_Msk))
+        latency = (uint32_t)(((uint64_t)tc_get_count(tc_index) * tc_latency_q8[tc_index]) >> 8);
+#endif
+
+    /*
+     * Extended counter: MC0 / OVF are half periods. Their flags are
+     * cleared here once; a second clear below could drop a wrap that
+     * landed in between. Callbacks on them still run.
+     */
+    uint8_t cleared = 0;
+
+    if (tc_extended & (1u << tc_index))
+    {
+        cleared = pending & (TC_INTFLAG_OVF_Msk | TC_INTFLAG_MC0_Msk);
+
+        if (cleared)
+        {
+            tc->COUNT16.TC_INTFLAG = cleared;
+            tc_half[tc_index] += (cleared == (TC_INTFLAG_OVF_Msk | TC_INTFLAG_MC0_Msk)) ? 2u : 1u;
+        }
+    }
+
     for(uint8_t ch = 0; ch < TC_CHANNELS; ch++)
     {
-        if(tc->COUNT16.TC_INTFLAG & (1 << ch))
+        if(pending & (1 << ch))
         {
-            tc->COUNT16.TC_INTFLAG = (1 << ch); // clear flag
-            if(tc_callbacks[tc_index][ch])
+            if(!(cleared & (1u << ch)))
+                tc->COUNT16.TC_INTFLAG = (1 << ch); // clear flag
+            if(!tc_callbacks[tc_index][ch])
+                continue;
+
+            if(tc_deferred[tc_index] & (1u << ch))
+                (void)sched_defer(tc_deferred_trampoline, &tc_callbacks[tc_index][ch]);
+            else
                 tc_callbacks[tc_index][ch]();   // call user callback
         }
     }
+
+    ISR_PROF_EXIT(prof, ISR_PROF_ID_TC(tc_index), latency);
 }
 
 /* ================= MAPPING ISR HANDLERS ================= */
@@ -3,6 +3,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <xc.h>
+
+#define TC_MAX          8u
+
+/* Generator feeding the TC cores (CLOCK_GEN_PERIPH, 48 MHz) */
+#ifndef TC_GCLK_GEN
+#define TC_GCLK_GEN     1u
+#endif
 
 /* ================= TC MODE ================= */
 typedef enum
@@ -44,6 +52,25 @@ typedef enum
     TC_CAPTURE_PWP,    // Pulse width single edge
 } tc_capture_mode_t;
 
+/* ================= EVENT ACTIONS ================= */
+/* EVCTRL.EVACT: what an incoming EVSYS event does to the TC */
+typedef enum
+{
+    TC_EVACT_OFF       = 0,
+    TC_EVACT_RETRIGGER = 1,     /* Restart the counter                  */
+    TC_EVACT_COUNT     = 2,     /* Count events instead of clock ticks  */
+    TC_EVACT_START     = 3,     /* Start on event                       */
+    TC_EVACT_STAMP     = 4,     /* Time stamp into CC0                  */
+    TC_EVACT_PPW       = 5,     /* Period → CC0, pulse width → CC1      */
+    TC_EVACT_PWP       = 6,     /* Period → CC1, pulse width → CC0      */
+    TC_EVACT_PW        = 7      /* Pulse width → CC0                    */
+} tc_event_action_t;
+
+/* tc_event_output_enable() outputs (EVCTRL bit positions) */
+#define TC_EVOUT_OVF    (1u << 8)
+#define TC_EVOUT_MC0    (1u << 12)
+#define TC_EVOUT_MC1    (1u << 13)
+
 /* ================= COUNTER CONFIG ================= */
 typedef enum {
     TC_DIR_UP = 0,
@@ -62,20 +89,90 @@ void tc_init(uint8_t tc_index,
              tc_waveform_t waveform,
              uint32_t compare_value);
 
+/* Reset the TC and drop its clock references */
+void tc_deinit(uint8_t tc_index);
+
+/* Counter input frequency before the prescaler (0 if not initialized) */
+uint32_t tc_get_clock_hz(uint8_t tc_index);
+
+/*
+ * tc_init() at the smallest prescaler whose counter range still spans
+ * one period of min_hz: the finest ticks that time (or, with MFRQ,
+ * generate) min_hz without a wrap. CC0 starts at 0. Returns the tick
+ * rate, 0 if min_hz is 0 or too slow even at DIV1024.
+ */
+uint32_t tc_init_for_rate(uint8_t tc_index,
+                          tc_mode_t mode,
+                          tc_waveform_t waveform,
+                          uint32_t min_hz);
+
 void tc_start(uint8_t tc_index);
 void tc_stop(uint8_t tc_index);
 
-/* Compare & Counter */
+/* Compare & Counter (width from tc_init(), dispatched at run time) */
 void tc_set_compare(uint8_t tc_index, uint32_t value);
 bool tc_compare_match(uint8_t tc_index);
-uint16_t tc_get_count(uint8_t tc_index);  // Read current counter value
+bool tc_overflow(uint8_t tc_index);      // OVF seen since the last call (polled)
+uint32_t tc_get_count(uint8_t tc_index);  // Read current counter value
+
+/* ================= 64-BIT COUNTER ================= */
+/*
+ * Free-running counter extended to 64 bits in software: MC0 at half
+ * the range and OVF each count a half period, so a 32-bit TC (even
+ * index, odd partner slaved) costs two interrupts per 2^32 ticks
+ * instead of two per 2^16. CC0 belongs to the extension. Starts
+ * counting from 0; 64 bits in 32-bit mode, 48 / 40 bits below. The
+ * interrupt must be served within half a counter period (2^31 ticks
+ * in 32-bit mode, only 128 in 8-bit mode). The TC timebase runs on it.
+ */
+bool tc_counter64_init(uint8_t tc_index, tc_mode_t mode, tc_prescaler_t prescaler);
+uint64_t tc_counter64_read(uint8_t tc_index);     /* Any context, lock-free */
+void tc_counter64_deinit(uint8_t tc_index);
 
 /* ================= PWM ================= */
 void tc_pwm_set_duty(uint8_t tc_index, uint32_t duty);
 
+/* ================= BUFFERED UPDATES ================= */
+#define TC_MASK(n)      ((uint8_t)(1u << (n)))
+
+/*
+ * Write CCBUFx / PERBUF: applied at the next update event (overflow /
+ * underflow), never mid-period. No SYNCBUSY wait. For a set of values
+ * that must change together, even across TCs:
+ *
+ *   tc_update_lock(TC_MASK(2) | TC_MASK(3));
+ *   tc_set_compare_buffered(2, 1, a);
+ *   tc_set_compare_buffered(3, 0, b);
+ *   tc_update_unlock(TC_MASK(2) | TC_MASK(3));
+ *
+ * Locked TCs keep their old values at update events. TCs started
+ * together with equal periods take the whole set at the same
+ * boundary, unless the unlock itself straddles it (a window of a few
+ * bus cycles).
+ */
+void tc_set_compare_buffered(uint8_t tc_index, uint8_t channel, uint32_t value);
+void tc_set_period_buffered(uint8_t tc_index, uint32_t value);   /* PERBUF / CCBUF0 */
+void tc_update_lock(uint8_t tc_mask);
+void tc_update_unlock(uint8_t tc_mask);
+
+/* Buffered values not yet applied */
+bool tc_update_pending(uint8_t tc_index);
+
 /* ================= CAPTURE ================= */
 void tc_capture_enable(uint8_t tc_index, uint8_t channel, tc_capture_mode_t mode, bool invert);
-uint16_t tc_capture_read(uint8_t tc_index, uint8_t channel);
+uint32_t tc_capture_read(uint8_t tc_index, uint8_t channel);
+
+/* Address of CCx in the TC's width, e.g. as a DMA source for captures */
+volatile void *tc_capture_register(uint8_t tc_index, uint8_t channel);
+
+/* ================= EVENTS ================= */
+/*
+ * EVCTRL is enable-protected: call both after tc_init() and before
+ * tc_start(). Route the event with the EVSYS driver
+ * (EVSYS_GEN_TC_OVF / EVSYS_GEN_TC_MC, EVSYS_USER_TC).
+ */
+void tc_set_event_action(uint8_t tc_index, tc_event_action_t action, bool invert);
+void tc_event_output_enable(uint8_t tc_index, uint16_t outputs, bool enable);
 
 /* ================= INTERRUPTS ================= */
 void tc_enable_interrupt(uint8_t tc_index, uint32_t flags);
@@ -83,8 +180,75 @@ void tc_disable_interrupt(uint8_t tc_index, uint32_t flags);
 void tc_clear_interrupt(uint8_t tc_index, uint32_t flags);
 
 /* ================= CALLBACKS ================= */
+/* channel = INTFLAG bit position */
+#define TC_INT_OVF      0u
+#define TC_INT_ERR      1u
+#define TC_INT_MC0      4u
+#define TC_INT_MC1      5u
+
 void tc_register_callback(uint8_t tc_index, uint8_t channel, void (*callback)(void));
 
+/*
+ * Same, but the ISR only clears the flag and hands the callback to
+ * sched_defer(): it runs later in thread mode from the scheduler.
+ * Events arriving while the defer queue is full are dropped (counted
+ * in the defer task's stats).
+ */
+void tc_register_callback_deferred(uint8_t tc_index, uint8_t channel, void (*callback)(void));
+
+/*
+ * ISR profiler latency for this TC's overflow interrupts: COUNT read on
+ * entry is the time since the overflow (up-counting NFRQ / MFRQ
+ * restart at 0). Costs a READSYNC per interrupt, so off by default.
+ * Call after tc_init() and again after a CPU clock change.
+ */
+void tc_profile_latency(uint8_t tc_index, bool enable);
+
+/* ================= WIDTH-SPECIFIC ACCESS ================= */
+/*
+ * tc8_ / tc16_ / tc32_ accessors go straight to one register view:
+ * no mode lookup, no branch, inlined. Use them when the width is
+ * fixed at build time; TC_CALL() picks the family from a width macro:
+ *
+ *   #define MOTOR_TC_WIDTH 32
+ *   uint32_t t = TC_CALL(MOTOR_TC_WIDTH, get_count)(2);   // tc32_get_count(2)
+ *
+ * get_count issues READSYNC and waits for it (a few GCLK cycles);
+ * set_compare waits for the CCx write sync; set_compare_buffered and
+ * get_capture never wait.
+ */
+extern tc_registers_t *const tc_table[TC_MAX];
+
+#define TC_CALL(width, fn)      TC_CALL_(width, fn)
+#define TC_CALL_(width, fn)     tc##width##_##fn
+
+#define TC_DEFINE_ACCESSORS(width, view, type)                                      \
+static inline type tc##width##_get_count(uint8_t tc_index)                          \
+{                                                                                   \
+    tc_registers_t *tc = tc_table[tc_index];                                        \
+    tc->view.TC_CTRLBSET = TC_CTRLBSET_CMD_READSYNC;                                \
+    while (tc->view.TC_SYNCBUSY & TC_SYNCBUSY_CTRLB_Msk);                           \
+    return tc->view.TC_COUNT;                                                       \
+}                                                                                   \
+static inline void tc##width##_set_compare(uint8_t tc_index, uint8_t channel, type value) \
+{                                                                                   \
+    tc_registers_t *tc = tc_table[tc_index];                                        \
+    tc->view.TC_CC[channel] = value;                                                \
+    while (tc->view.TC_SYNCBUSY & (TC_SYNCBUSY_CC0_Msk << channel));                \
+}                                                                                   \
+static inline void tc##width##_set_compare_buffered(uint8_t tc_index, uint8_t channel, type value) \
+{                                                                                   \
+    tc_table[tc_index]->view.TC_CCBUF[channel] = value;                             \
+}                                                                                   \
+static inline type tc##width##_get_capture(uint8_t tc_index, uint8_t channel)       \
+{                                                                                   \
+    return tc_table[tc_index]->view.TC_CC[channel];                                 \
+}
+
+TC_DEFINE_ACCESSORS(8,  COUNT8,  uint8_t)
+TC_DEFINE_ACCESSORS(16, COUNT16, uint16_t)
+TC_DEFINE_ACCESSORS(32, COUNT32, uint32_t)
+
 /* ================= COUNTER CONTROL ================= */
 void tc_set_oneshot(uint8_t tc_index, bool enable);
 void tc_set_downcount(uint8_t tc_index, bool enable);
@@ -0,0 +1,424 @@
+#include "timer_wheel.h"
+
+/*
+ * Hierarchical timing wheel.
+ *
+ * Level 0 has one slot per tick for the next 64 ticks. Level n slots
+ * each span 64^n ticks. A timer is filed by its distance from the
+ * wheel time; when the level-0 index wraps, the current slot of the
+ * next level is emptied and its timers are re-filed one level lower
+ * ("cascade"), so every timer reaches level 0 just before it expires.
+ *
+ * Slots are singly linked lists with a back pointer to the link that
+ * points at each timer, which makes insert and cancel O(1). A 64-bit
+ * occupancy mask per level finds the next non-empty slot without
+ * scanning, so time can jump straight from one event to the next
+ * (e.g. after a long sleep) and the tick source is only armed for the
+ * earliest expiry or cascade.
+ */
+
+/* ================= CRITICAL SECTION ================= */
+/* Override both for host builds driven by a simulated clock */
+#ifndef TIMER_WHEEL_LOCK
+#include "irq_mgr.h"
+#define TIMER_WHEEL_LOCK(state)     do { (state) = irq_lock(); } while (0)
+#define TIMER_WHEEL_UNLOCK(state)   irq_unlock(state)
+#endif
+
+/* ================= MACROS ================= */
+#define WHEEL_MASK          (TIMER_WHEEL_SLOTS - 1u)
+#define WHEEL_RANGE         (1ul << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))
+#define WHEEL_NO_LEVEL      0xFFu       /* Timer sits in the expired batch */
+
+/* ================= LOCAL HELPERS ================= */
+
+static uint32_t wheel_ctz64(uint64_t v)
+{
+    uint32_t lo = (uint32_t)v;
+
+    return lo ? (uint32_t)__builtin_ctz(lo)
+              : 32u + (uint32_t)__builtin_ctz((uint32_t)(v >> 32));
+}
+
+static void wheel_list_add(wheel_timer_t **head, wheel_timer_t *t)
+{
+    t->next = *head;
+    if (t->next)
+        t->next->pprev = &t->next;
+
+    *head    = t;
+    t->pprev = head;
+}
+
+static void wheel_unlink(timer_wheel_t *w, wheel_timer_t *t)
+{
+    *t->pprev = t->next;
+    if (t->next)
+        t->next->pprev = t->pprev;
+
+    if (t->level != WHEEL_NO_LEVEL && !w->slots[t->level][t->slot])
+        w->occupied[t->level] &= ~(1ull << t->slot);
+
+    t->next  = 0;
+    t->pprev = 0;
+}
+
+/*
+ * File a timer by its distance from the wheel time. Expired or
+ * immediate timers go to the current level-0 slot.
+ */
+static void wheel_link(timer_wheel_t *w, wheel_timer_t *t)
+{
+    uint32_t delta   = t->expires - w->time;
+    uint32_t expires = t->expires;
+    uint8_t  level   = 0;
+
+    if ((int32_t)delta < 0)
+    {
+        expires = w->time;
+    }
+    else
+    {
+        while (level < TIMER_WHEEL_LEVELS - 1u &&
+               delta >= (1ul << (TIMER_WHEEL_SLOT_BITS * (level + 1u))))
+            level++;
+
+        /* Beyond the wheel: park in the furthest top-level slot */
+        if (delta >= WHEEL_RANGE)
+            expires = w->time + (uint32_t)(WHEEL_RANGE - 1u);
+    }
+
+    t->level = level;
+    t->slot  = (uint8_t)((expires >> (TIMER_WHEEL_SLOT_BITS * level)) & WHEEL_MASK);
+
+    wheel_list_add(&w->slots[level][t->slot], t);
+    w->occupied[level] |= 1ull << t->slot;
+}
+
+/*
+ * Distance from the wheel time to the next tick with work: a level-0
+ * slot to run or a higher-level slot to cascade.
+ */
+static bool wheel_next_delta(timer_wheel_t *w, uint32_t *delta)
+{
+    bool found = false;
+    uint32_t best = 0;
+
+    for (uint32_t level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        uint64_t mask = w->occupied[level];
+
+        if (!mask)
+            continue;
+
+        uint32_t shift = TIMER_WHEEL_SLOT_BITS * level;
+        uint32_t cur   = (w->time >> shift) & WHEEL_MASK;
+
+        /* A higher-level slot cascades on the tick that starts it */
+        uint32_t first = (level == 0u || (w->time & ((1ul << shift) - 1u)) == 0u) ? 0u : 1u;
+        uint32_t start = (cur + first) & WHEEL_MASK;
+        uint64_t rot   = start ? ((mask >> start) | (mask << (64u - start))) : mask;
+        uint32_t ahead = first + wheel_ctz64(rot);
+
+        uint32_t event = (level == 0u) ? w->time + ahead
+                                       : ((w->time >> shift) + ahead) << shift;
+        uint32_t d = event - w->time;
+
+        if (!found || d < best)
+        {
+            best  = d;
+            found = true;
+        }
+    }
+
+    *delta = best;
+    return found;
+}
+
+/* Process the tick at w->time: cascade, then move level 0 to the batch */
+static void wheel_tick(timer_wheel_t *w)
+{
+    uint32_t idx = w->time & WHEEL_MASK;
+    wheel_timer_t *t;
+
+    if (idx == 0u)
+    {
+        for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+        {
+            uint32_t slot = (w->time >> (TIMER_WHEEL_SLOT_BITS * level)) & WHEEL_MASK;
+
+            while ((t = w->slots[level][slot]) != 0)
+            {
+                wheel_unlink(w, t);
+                wheel_link(w, t);
+                w->stats.cascaded++;
+            }
+
+            if (slot != 0u)
+                break;
+        }
+    }
+
+    while ((t = w->slots[0][idx]) != 0)
+    {
+        wheel_unlink(w, t);
+        t->level = WHEEL_NO_LEVEL;
+        wheel_list_add(&w->batch, t);
+    }
+
+    w->time++;
+}
+
+static void wheel_advance(timer_wheel_t *w, uint32_t now)
+{
+    uint32_t delta;
+
+    while ((int32_t)(now - w->time) >= 0)
+    {
+        /* Jump over empty ticks */
+        if (!wheel_next_delta(w, &delta) || (int32_t)(now - (w->time + delta)) < 0)
+        {
+            w->time = now + 1u;
+            break;
+        }
+
+        w->time += delta;
+        wheel_tick(w);
+    }
+}
+
+static void wheel_rearm(timer_wheel_t *w)
+{
+    uint32_t delta;
+    uint32_t deadline;
+
+    if (w->batch)
+    {
+        /* Timers waiting in the batch are due: a passed deadline fires at once */
+        deadline = w->time - 1u;
+    }
+    else if (wheel_next_delta(w, &delta))
+    {
+        deadline = w->time + delta;
+    }
+    else
+    {
+        if (w->clock.disarm)
+            w->clock.disarm(w->clock.ctx);
+        w->is_armed = false;
+        return;
+    }
+
+    if (w->is_armed && w->armed == deadline)
+        return;
+
+    w->armed    = deadline;
+    w->is_armed = true;
+
+    if (w->clock.arm)
+        w->clock.arm(w->armed, w->clock.ctx);
+}
+
+/* ================= INITIALIZATION ================= */
+void timer_wheel_init(timer_wheel_t *wheel, const timer_wheel_clock_t *clock)
+{
+    wheel->clock      = *clock;
+    wheel->time       = clock->now(clock->ctx);
+    wheel->is_armed   = false;
+    wheel->in_process = false;
+    wheel->batch      = 0;
+
+    for (uint32_t level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        wheel->occupied[level] = 0;
+        for (uint32_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+            wheel->slots[level][slot] = 0;
+    }
+
+    wheel->stats.active    = 0;
+    wheel->stats.expired   = 0;
+    wheel->stats.cascaded  = 0;
+    wheel->stats.max_batch = 0;
+}
+
+void wheel_timer_init(wheel_timer_t *timer, wheel_timer_callback_t callback, void *ctx)
+{
+    timer->next     = 0;
+    timer->pprev    = 0;
+    timer->expires  = 0;
+    timer->period   = 0;
+    timer->callback = callback;
+    timer->ctx      = ctx;
+    timer->level    = WHEEL_NO_LEVEL;
+    timer->slot     = 0;
+}
+
+bool wheel_timer_active(const wheel_timer_t *timer)
+{
+    return timer->pprev != 0;
+}
+
+/* ================= START / CANCEL ================= */
+void timer_wheel_start(timer_wheel_t *wheel, wheel_timer_t *timer,
+                       uint32_t delay, uint32_t period)
+{
+    uint32_t state;
+    uint32_t now = wheel->clock.now(wheel->clock.ctx);
+
+    TIMER_WHEEL_LOCK(state);
+
+    if (timer->pprev)
+        wheel_unlink(wheel, timer);
+    else
+        wheel->stats.active++;
+
+    /* Idle wheel: skip the ticks nobody waited for */
+    if (wheel->stats.active == 1u && !wheel->in_process &&
+        (int32_t)(now - wheel->time) > 0)
+        wheel->time = now;
+
+    timer->expires = now + delay;
+    timer->period  = period;
+
+    /*
+     * Due on a tick that has already been processed (delay 0 right
+     * after a process() in the same tick): straight to the batch, the
+     * next process() runs it without waiting for another tick. From a
+     * callback it is filed in the next tick instead, so a timer that
+     * restarts itself with delay 0 cannot keep the batch loop going.
+     */
+    if (!wheel->in_process && (int32_t)(timer->expires - wheel->time) < 0)
+    {
+        timer->level = WHEEL_NO_LEVEL;
+        wheel_list_add(&wheel->batch, timer);
+    }
+    else
+    {
+        wheel_link(wheel, timer);
+    }
+
+    if (!wheel->in_process)
+        wheel_rearm(wheel);
+
+    TIMER_WHEEL_UNLOCK(state);
+}
+
+bool timer_wheel_cancel(timer_wheel_t *wheel, wheel_timer_t *timer)
+{
+    uint32_t state;
+    bool was_active = false;
+
+    TIMER_WHEEL_LOCK(state);
+
+    if (timer->pprev)
+    {
+        wheel_unlink(wheel, timer);
+        timer->level = WHEEL_NO_LEVEL;
+        wheel->stats.active--;
+        was_active = true;
+
+        if (!wheel->in_process)
+            wheel_rearm(wheel);
+    }
+
+    TIMER_WHEEL_UNLOCK(state);
+    return was_active;
+}
+
+/* ================= EXPIRY ================= */
+
+/*
+ * Expired timers are first collected into wheel->batch under the lock,
+ * then their callbacks run one after another with interrupts enabled.
+ * A callback may start or cancel any timer, including ones still
+ * waiting in the batch. The tick source is re-armed once at the end.
+ */
+uint32_t timer_wheel_process(timer_wheel_t *wheel)
+{
+    uint32_t state;
+    uint32_t ran = 0;
+    wheel_timer_t *t;
+
+    TIMER_WHEEL_LOCK(state);
+
+    /* Nested call (ISR during a polled run): the outer run re-arms */
+    if (wheel->in_process)
+    {
+        TIMER_WHEEL_UNLOCK(state);
+        return 0;
+    }
+
+    wheel->in_process = true;
+    wheel->is_armed   = false;      /* Consumed by this call */
+
+    wheel_advance(wheel, wheel->clock.now(wheel->clock.ctx));
+
+    while ((t = wheel->batch) != 0)
+    {
+        wheel_unlink(wheel, t);
+
+        /* Periodic: re-file before the callback so it may cancel itself */
+        if (t->period)
+        {
+            t->expires += t->period;
+            wheel_link(wheel, t);
+        }
+        else
+        {
+            wheel->stats.active--;
+        }
+
+        TIMER_WHEEL_UNLOCK(state);
+
+        if (t->callback)
+            t->callback(t, t->ctx);
+        ran++;
+
+        TIMER_WHEEL_LOCK(state);
+    }
+
+    wheel->stats.expired += ran;
+    if (ran > wheel->stats.max_batch)
+        wheel->stats.max_batch = ran;
+
+    wheel->in_process = false;
+    wheel_rearm(wheel);
+
+    TIMER_WHEEL_UNLOCK(state);
+    return ran;
+}
+
+bool timer_wheel_next_event(timer_wheel_t *wheel, uint32_t *ticks)
+{
+    uint32_t state;
+    uint32_t delta;
+    bool found;
+
+    TIMER_WHEEL_LOCK(state);
+
+    if (wheel->batch)
+    {
+        TIMER_WHEEL_UNLOCK(state);
+        *ticks = 0;
+        return true;
+    }
+
+    found = wheel_next_delta(wheel, &delta);
+    if (found)
+    {
+        uint32_t left = wheel->time + delta - wheel->clock.now(wheel->clock.ctx);
+        *ticks = ((int32_t)left < 0) ? 0u : left;
+    }
+
+    TIMER_WHEEL_UNLOCK(state);
+    return found;
+}
+
+void timer_wheel_get_stats(timer_wheel_t *wheel, timer_wheel_stats_t *stats)
+{
+    uint32_t state;
+
+    TIMER_WHEEL_LOCK(state);
+    *stats = wheel->stats;
+    TIMER_WHEEL_UNLOCK(state);
+}
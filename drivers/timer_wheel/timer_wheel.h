@@ -0,0 +1,120 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= WHEEL CONFIG ================= */
+
+/*
+ * TIMER_WHEEL_LEVELS (1..5) levels of 64 slots. Level n slots are
+ * 64^n ticks wide, so 4 levels cover 2^24 ticks (~4.5 h at 1024 Hz).
+ * Longer delays are parked in the last level and re-filed when it
+ * cascades.
+ */
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS      4u
+#endif
+
+#define TIMER_WHEEL_SLOT_BITS   6u
+#define TIMER_WHEEL_SLOTS       (1u << TIMER_WHEEL_SLOT_BITS)
+
+/* ================= TYPES ================= */
+
+struct wheel_timer;
+typedef void (*wheel_timer_callback_t)(struct wheel_timer *timer, void *ctx);
+
+/*
+ * Caller-owned timer. Members are driver private; the struct must stay
+ * valid while the timer is running.
+ */
+typedef struct wheel_timer
+{
+    struct wheel_timer     *next;
+    struct wheel_timer    **pprev;      /* Link that points at us, 0 = idle */
+    uint32_t                expires;    /* Absolute tick */
+    uint32_t                period;     /* 0 = one-shot */
+    wheel_timer_callback_t  callback;
+    void                   *ctx;
+    uint8_t                 level;      /* Slot position for O(1) cancel */
+    uint8_t                 slot;
+} wheel_timer_t;
+
+/*
+ * Tick source. now() returns a free-running 32-bit tick counter,
+ * arm() asks for timer_wheel_process() to be called at (or soon after)
+ * the absolute tick given, disarm() cancels that request.
+ * Hardware: timer_wheel_rtc_init(). Simulation: any counter variable.
+ */
+typedef struct
+{
+    uint32_t (*now)(void *ctx);
+    void     (*arm)(uint32_t deadline, void *ctx);
+    void     (*disarm)(void *ctx);
+    void     *ctx;
+} timer_wheel_clock_t;
+
+typedef struct
+{
+    uint32_t active;            /* Timers currently queued            */
+    uint32_t expired;           /* Callbacks run since init           */
+    uint32_t cascaded;          /* Timers moved down a level          */
+    uint32_t max_batch;         /* Largest batch run by one process() */
+} timer_wheel_stats_t;
+
+typedef struct
+{
+    timer_wheel_clock_t  clock;
+    uint32_t             time;          /* Next tick to be processed */
+    uint32_t             armed;         /* Deadline handed to clock.arm */
+    bool                 is_armed;
+    bool                 in_process;
+    uint64_t             occupied[TIMER_WHEEL_LEVELS];
+    wheel_timer_t       *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    wheel_timer_t       *batch;         /* Expired, callbacks pending */
+    timer_wheel_stats_t  stats;
+} timer_wheel_t;
+
+/* ================= TIMER WHEEL PUBLIC API ================= */
+
+void timer_wheel_init(timer_wheel_t *wheel, const timer_wheel_clock_t *clock);
+
+void wheel_timer_init(wheel_timer_t *timer, wheel_timer_callback_t callback, void *ctx);
+bool wheel_timer_active(const wheel_timer_t *timer);
+
+/*
+ * Queue timer to fire delay ticks from now, then every period ticks
+ * (0 = once). Restarts a running timer. O(1), ISR safe.
+ */
+void timer_wheel_start(timer_wheel_t *wheel, wheel_timer_t *timer,
+                       uint32_t delay, uint32_t period);
+
+/* Remove a queued timer. O(1), ISR safe; false if it was not queued */
+bool timer_wheel_cancel(timer_wheel_t *wheel, wheel_timer_t *timer);
+
+/*
+ * Advance to clock.now(), run all expired callbacks as one batch and
+ * re-arm the clock for the next deadline. Called by the tick source
+ * (RTC compare interrupt) or polled from the main loop.
+ *
+ * @return Number of callbacks run
+ */
+uint32_t timer_wheel_process(timer_wheel_t *wheel);
+
+/* Ticks until the next wheel event, false if no timer is queued */
+bool timer_wheel_next_event(timer_wheel_t *wheel, uint32_t *ticks);
+
+void timer_wheel_get_stats(timer_wheel_t *wheel, timer_wheel_stats_t *stats);
+
+/* ================= RTC TICK SOURCE ================= */
+
+/*
+ * Free-running RTC at RTC_TIMER_FREE_HZ, COMP0 moved to the earliest
+ * deadline, timer_wheel_process() run from the RTC interrupt.
+ */
+#define TIMER_WHEEL_RTC_HZ      1024u
+#define TIMER_WHEEL_MS(ms)      ((uint32_t)(((uint64_t)(ms) * TIMER_WHEEL_RTC_HZ + 999u) / 1000u))
+
+void timer_wheel_rtc_init(timer_wheel_t *wheel);
+
+#endif /* TIMER_WHEEL_H */
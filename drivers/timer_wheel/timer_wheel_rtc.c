@@ -0,0 +1,50 @@
+#include "timer_wheel.h"
+#include "rtc_timer.h"
+
+/*
+ * RTC tick source: COUNT runs free at RTC_TIMER_FREE_HZ and is never
+ * reset, COMP0 follows the earliest wheel deadline and its interrupt
+ * processes the wheel.
+ */
+
+#if TIMER_WHEEL_RTC_HZ != RTC_TIMER_FREE_HZ
+#error "TIMER_WHEEL_RTC_HZ must match RTC_TIMER_FREE_HZ"
+#endif
+
+static uint32_t wheel_rtc_now(void *ctx)
+{
+    (void)ctx;
+    return RTC_Timer_GetCount();
+}
+
+static void wheel_rtc_arm(uint32_t deadline, void *ctx)
+{
+    (void)ctx;
+    RTC_Timer_ArmCompare(deadline);
+}
+
+static void wheel_rtc_disarm(void *ctx)
+{
+    (void)ctx;
+    RTC_Timer_DisarmCompare();
+}
+
+static void wheel_rtc_isr(void *ctx)
+{
+    (void)timer_wheel_process((timer_wheel_t *)ctx);
+}
+
+void timer_wheel_rtc_init(timer_wheel_t *wheel)
+{
+    static const timer_wheel_clock_t rtc_clock =
+    {
+        .now    = wheel_rtc_now,
+        .arm    = wheel_rtc_arm,
+        .disarm = wheel_rtc_disarm,
+        .ctx    = 0
+    };
+
+    RTC_Timer_InitFreeRunning();
+    timer_wheel_init(wheel, &rtc_clock);
+    RTC_Timer_RegisterCallback(wheel_rtc_isr, wheel);
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "dmac_drv.h"
+#include "evsys_drv.h"
+#include "eic_drv.h"
+#include "gpio_wave.h"
+#include "capture_stream.h"
+
+/*
+ * 100 kHz frequency / duty / jitter measurement.
+ *
+ * gpio_wave loops a 100 kHz, 25 % duty square wave on PA05 (one DMA
+ * beat per 2.5 µs sample). A jumper feeds it back into PA04, where the
+ * capture stream stores every cycle into a ring, again by DMA. Once a
+ * second the main loop reads a window of the latest cycles and prints
+ * its statistics: 100 000 cycles/s measured, the CPU only runs
+ * capture_stats_compute().
+ */
+#define SIG_OUT_PIN     5u          /* PA05, test signal out  */
+#define CAP_PIN         4u          /* PA04, capture input    */
+
+#define SIG_TC          4u
+#define CAP_TC          3u
+
+#define RING_LEN        4096u
+#define WINDOW          1024u
+
+static const uint8_t sig_levels[4] =
+{
+    1u << SIG_OUT_PIN, 0, 0, 0
+};
+
+static gpio_wave_t sig_wave;
+static capture_stream_t cap;
+static uint32_t ring[RING_LEN];
+static uint32_t window[WINDOW];
+
+static void delay_ms(uint32_t ms)
+{
+    for (volatile uint32_t i = 0; i < ms * 12000u; i++);
+}
+
+int main(void)
+{
+    char line[112];
+    capture_stats_t st;
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    dmac_init();
+    evsys_init();
+
+    const gpio_wave_config_t sig_cfg =
+    {
+        .tc_index     = SIG_TC,
+        .port         = GPIO_PORT_A,
+        .dst          = GPIO_WAVE_DST_OUT,
+        .beat         = DMAC_BEAT_BYTE,
+        .lane         = 0,
+        .pin_mask     = 1u << SIG_OUT_PIN,
+        .sample_hz    = 400000UL,
+        .dma_priority = 2
+    };
+
+    const capture_stream_config_t cap_cfg =
+    {
+        .tc_index     = CAP_TC,
+        .port         = GPIO_PORT_A,
+        .pin          = CAP_PIN,
+        .line         = EIC_LINE_FOR_PIN(CAP_PIN),
+        .invert       = false,
+        .min_hz       = 1000u,
+        .dma_priority = 3
+    };
+
+    gpio_wave_init(&sig_wave, &sig_cfg);
+
+    if (!capture_stream_init(&cap, &cap_cfg, ring, RING_LEN))
+    {
+        SERCOM7_USART_WriteString("capture stream init failed\r\n");
+        while (1);
+    }
+
+    capture_stream_start(&cap);
+    gpio_wave_start(&sig_wave, sig_levels, sizeof sig_levels, true);
+
+    snprintf(line, sizeof line, "\r\ncapture stream: tick %lu Hz, ring %u, window %u\r\n",
+             (unsigned long)capture_stream_tick_hz(&cap), RING_LEN, WINDOW);
+    SERCOM7_USART_WriteString(line);
+
+    while (1)
+    {
+        delay_ms(1000);
+
+        /* Keep only the newest window; the rest counts as read */
+        uint32_t avail = capture_stream_available(&cap);
+        if (avail > WINDOW)
+        {
+            uint32_t skip[64];
+            for (uint32_t n = avail - WINDOW; n; )
+                n -= capture_stream_read(&cap, skip, n < 64u ? n : 64u);
+        }
+
+        uint32_t n = capture_stream_read(&cap, window, WINDOW);
+        capture_stats_compute(window, n, capture_stream_tick_hz(&cap), &st);
+
+        snprintf(line, sizeof line,
+                 "n %lu  f %lu.%03lu Hz  duty %lu ppm  period %lu..%lu  rms %lu ns  pp %lu ns  ovr %lu\r\n",
+                 (unsigned long)st.count,
+                 (unsigned long)(st.freq_mhz / 1000u), (unsigned long)(st.freq_mhz % 1000u),
+                 (unsigned long)st.duty_ppm,
+                 (unsigned long)st.period_min, (unsigned long)st.period_max,
+                 (unsigned long)st.jitter_rms_ns, (unsigned long)st.jitter_pp_ns,
+                 (unsigned long)capture_stream_overruns(&cap));
+        SERCOM7_USART_WriteString(line);
+    }
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "clock_mgr.h"
+#include "sercom7_usart.h"
+#include "timer_counter_drv.h"
+
+/*
+ * Runtime CPU scaling with the clock manager.
+ *
+ * The CPU steps through STEPS[] while SERCOM7 and TC0 keep running
+ * from GCLK1 (48 MHz): the console baud rate and the TC0 time base
+ * do not move. Each step counts loop iterations during a fixed
+ * WINDOW_TICKS of TC0, so the count scales with the CPU clock only.
+ */
+#define WINDOW_TICKS    4688u       /* ~100 ms at 48 MHz / 1024 */
+#define SERCOM7_GCLK_ID 37u         /* SERCOM7_GCLK_ID_CORE */
+
+static const uint32_t STEPS[] =
+{
+    120000000UL, 96000000UL, 48000000UL, 12000000UL, 1000000UL
+};
+
+static uint32_t busy_loop_window(void)
+{
+    uint32_t loops = 0;
+    uint16_t start = tc_get_count(0);
+
+    while ((uint16_t)(tc_get_count(0) - start) < WINDOW_TICKS)
+        loops++;
+
+    return loops;
+}
+
+int main(void)
+{
+    char line[96];
+
+    clock_init();
+    SERCOM7_USART_Init(115200);
+
+    /* Free running 16-bit TC0 as wall clock */
+    tc_init(0, TC_MODE_16BIT, TC_PRESCALER_DIV1024, TC_WAVE_NFRQ, 0);
+    tc_start(0);
+
+    SERCOM7_USART_WriteString("\r\nclock scaling\r\n");
+
+    while (1)
+    {
+        for (uint32_t i = 0; i < sizeof STEPS / sizeof STEPS[0]; i++)
+        {
+            /* Let the last line leave the shift register first */
+            while (!(SERCOM7_REGS->USART_INT.SERCOM_INTFLAG & SERCOM_USART_INT_INTFLAG_TXC_Msk));
+
+            if (!clock_set_cpu_hz(STEPS[i]))
+                continue;
+
+            uint32_t loops = busy_loop_window();
+
+            snprintf(line, sizeof line,
+                     "cpu %9lu Hz  sercom7 %8lu Hz  tc0 %8lu Hz  loops/100ms %7lu\r\n",
+                     (unsigned long)clock_cpu_hz(),
+                     (unsigned long)clock_periph_hz(SERCOM7_GCLK_ID),
+                     (unsigned long)tc_get_clock_hz(0),
+                     (unsigned long)loops);
+            SERCOM7_USART_WriteString(line);
+        }
+    }
+}
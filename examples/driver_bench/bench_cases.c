@@ -0,0 +1,154 @@
+#include "bench_cases.h"
+#include "gpio_drv.h"
+#include "timebase.h"
+#include "timer_counter_drv.h"
+#include "dmac_drv.h"
+#include "evsys_drv.h"
+#include "irq_mgr.h"
+#if BENCH_USART
+#include "sercom7_usart.h"
+#endif
+#if BENCH_I2C
+#include "i2c_drv.h"
+#endif
+
+/*
+ * One case per driver entry point, named after it. Nothing here
+ * touches the console: main.c and the host runner choose the output.
+ */
+
+/* ================= CASES ================= */
+static void b_gpio_write_toggle(void *ctx)
+{
+    (void)ctx;
+    gpio_write_toggle(BENCH_PROBE_PORT, BENCH_PROBE_PIN);
+}
+
+static void b_gpio_read_pin(void *ctx)
+{
+    (void)ctx;
+    (void)gpio_read_pin(BENCH_PROBE_PORT, BENCH_PROBE_PIN);
+}
+
+static void b_gpio_port_toggle(void *ctx)
+{
+    (void)ctx;
+    gpio_port_toggle(BENCH_PROBE_PORT, GPIO_PIN_MASK(BENCH_PROBE_PIN));
+}
+
+#if BENCH_USART
+static void b_usart_write_byte(void *ctx)
+{
+    (void)ctx;
+    SERCOM7_USART_WriteByte(0);
+}
+#endif
+
+static void b_tc_set_compare(void *ctx)
+{
+    (void)ctx;
+    tc_set_compare(BENCH_TC, 1000u);
+}
+
+static void b_tc_set_compare_buffered(void *ctx)
+{
+    (void)ctx;
+    tc_set_compare_buffered(BENCH_TC, 1u, 500u);
+}
+
+static void b_tc_get_count(void *ctx)
+{
+    (void)ctx;
+    (void)tc_get_count(BENCH_TC);
+}
+
+static void b_tc16_get_count(void *ctx)
+{
+    (void)ctx;
+    (void)tc16_get_count(BENCH_TC);
+}
+
+static void b_timebase_now(void *ctx)
+{
+    (void)ctx;
+    (void)timebase_now();
+}
+
+static void b_irq_lock_unlock(void *ctx)
+{
+    (void)ctx;
+    irq_unlock(irq_lock());
+}
+
+static void b_dmac_alloc_free(void *ctx)
+{
+    (void)ctx;
+    int8_t ch = dmac_channel_alloc();
+
+    if (ch >= 0)
+        dmac_channel_free((uint8_t)ch);
+}
+
+static void b_evsys_alloc_free(void *ctx)
+{
+    (void)ctx;
+    int8_t ch = evsys_channel_alloc(false);
+
+    if (ch >= 0)
+        evsys_channel_free((uint8_t)ch);
+}
+
+#if BENCH_I2C
+static void b_i2c_start(void *ctx)
+{
+    (void)ctx;
+    (void)i2c_start(BENCH_I2C_ADDR, false);
+}
+
+static void b_i2c_write(void *ctx)
+{
+    (void)ctx;
+    (void)i2c_write(0);
+}
+
+static void b_i2c_stop(void *ctx)
+{
+    (void)ctx;
+    i2c_stop();
+}
+#endif
+
+const bench_case_t bench_cases[] =
+{
+    { .name = "gpio_write_toggle",       .fn = b_gpio_write_toggle },
+    { .name = "gpio_read_pin",           .fn = b_gpio_read_pin },
+    { .name = "gpio_port_toggle",        .fn = b_gpio_port_toggle },
+#if BENCH_USART
+    { .name = "SERCOM7_USART_WriteByte", .fn = b_usart_write_byte, .runs = 64u },
+#endif
+    { .name = "tc_set_compare",          .fn = b_tc_set_compare },
+    { .name = "tc_set_compare_buffered", .fn = b_tc_set_compare_buffered },
+    { .name = "tc_get_count",            .fn = b_tc_get_count },
+    { .name = "tc16_get_count",          .fn = b_tc16_get_count },
+    { .name = "timebase_now",            .fn = b_timebase_now },
+    { .name = "irq_lock_unlock",         .fn = b_irq_lock_unlock },
+    { .name = "dmac_alloc_free",         .fn = b_dmac_alloc_free },
+    { .name = "evsys_alloc_free",        .fn = b_evsys_alloc_free },
+#if BENCH_I2C
+    /* Byte time on the bus: i2c_write() waits for the ACK */
+    { .name = "i2c_write", .fn = b_i2c_write,
+      .setup = b_i2c_start, .teardown = b_i2c_stop, .runs = 32u },
+#endif
+};
+
+const uint32_t bench_case_count = sizeof bench_cases / sizeof bench_cases[0];
+
+/* ================= SETUP ================= */
+void bench_cases_init(void)
+{
+    gpio_configure_pin(BENCH_PROBE_PORT, BENCH_PROBE_PIN, GPIO_DIR_OUTPUT);
+
+    /* Free-running 16-bit counter: register writes wait on SYNCBUSY */
+    tc_init(BENCH_TC, TC_MODE_16BIT, TC_PRESCALER_DIV1, TC_WAVE_MFRQ, 0xFFFFu);
+    tc_start(BENCH_TC);
+}
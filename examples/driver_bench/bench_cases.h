@@ -0,0 +1,42 @@
+#ifndef BENCH_CASES_H
+#define BENCH_CASES_H
+
+#include <stdint.h>
+#include "bench.h"
+
+/*
+ * Case list of the driver bench, shared by the target build (main.c)
+ * and the host build against the register sim (tests/bench_host.c).
+ */
+
+/* ================= CASES CONFIG ================= */
+#define BENCH_PROBE_PORT    GPIO_PORT_A
+#define BENCH_PROBE_PIN     14          /* PA14 */
+
+#define BENCH_TC            2u
+
+/* SERCOM7 console byte: needs SERCOM7_USART_Init() */
+#ifndef BENCH_USART
+#define BENCH_USART         1
+#endif
+
+/* Needs i2c_init() and a device acknowledging BENCH_I2C_ADDR */
+#ifndef BENCH_I2C
+#define BENCH_I2C           1
+#endif
+
+#ifndef BENCH_I2C_ADDR
+#define BENCH_I2C_ADDR      0x50u       /* 24Cxx EEPROM */
+#endif
+
+/* ================= CASES API ================= */
+extern const bench_case_t bench_cases[];
+extern const uint32_t     bench_case_count;
+
+/*
+ * Probe pin and free-running BENCH_TC. timebase, dmac and evsys (and
+ * USART / I²C when enabled) are initialized by the caller.
+ */
+void bench_cases_init(void);
+
+#endif /* BENCH_CASES_H */
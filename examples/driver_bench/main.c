@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+#include "dmac_drv.h"
+#include "evsys_drv.h"
+#include "irq_mgr.h"
+#include "i2c_drv.h"
+#include "bench.h"
+#include "bench_cases.h"
+
+/*
+ * Cycle cost of single driver calls, SYNCBUSY and flag waits included.
+ *
+ * Every case in bench_cases.c is one driver entry point, called
+ * BENCH_RUNS times with interrupts masked. The suite prints one key=value line per
+ * call every few seconds; capture the console to a file and diff two
+ * builds to spot a regression.
+ *
+ * The I²C case needs a device acknowledging BENCH_I2C_ADDR; build
+ * with -DBENCH_I2C=0 without one. The USART case sends NUL bytes,
+ * which terminals do not display.
+ */
+int main(void)
+{
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    irq_init();
+    timebase_init();
+    dmac_init();
+    evsys_init();
+#if BENCH_I2C
+    (void)i2c_init();
+#endif
+
+    bench_cases_init();
+    bench_init();
+
+    while (1)
+    {
+        SERCOM7_USART_WriteString("\r\n");
+        bench_run_suite(bench_cases, bench_case_count, SERCOM7_USART_WriteString);
+
+        uint64_t next = timebase_deadline_us(5000000);
+        while (!timebase_reached(next));
+    }
+}
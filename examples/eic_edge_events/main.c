@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "gpio_drv.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "eic_drv.h"
+
+/*
+ * EIC edge events.
+ *
+ * - BUTTON (debounced, falling edge) toggles LED1 from its callback
+ * - PULSE (both edges, majority filter) only queues timestamped
+ *   events; the first event of a burst posts to the "edges" task,
+ *   which drains the queue in batches and prints the number of edges,
+ *   the shortest high/low time and the queue drops
+ *
+ * Feed PULSE from a signal generator to see the batching: one task
+ * run handles many edges.
+ */
+#define LED1_PORT       GPIO_PORT_C
+#define LED1_PIN        21          /* PC21 */
+
+#define BUTTON_PORT     GPIO_PORT_B
+#define BUTTON_PIN      31          /* PB31, active low */
+
+#define PULSE_PORT      GPIO_PORT_A
+#define PULSE_PIN       4           /* PA04 */
+
+#define PULSE_LINE      EIC_LINE_FOR_PIN(PULSE_PIN)
+
+#define EV_EDGES        1u
+
+static eic_event_t edge_queue[64];
+static sched_task_t edge_task;
+static sched_slot_t edge_slots[4];
+
+static void button_cb(uint8_t line, bool level, void *ctx)
+{
+    (void)line;
+    (void)level;
+    (void)ctx;
+    gpio_write_toggle(LED1_PORT, LED1_PIN);
+}
+
+/* ISR: queue went non-empty */
+static void edges_notify(void *ctx)
+{
+    (void)ctx;
+    (void)sched_post(&edge_task, EV_EDGES, 0);
+}
+
+static void edge_handler(const sched_event_t *event, void *ctx)
+{
+    static uint64_t last_ts = 0;
+    eic_event_t batch[16];
+    uint32_t n, edges = 0, batches = 0;
+    uint64_t min_high = UINT64_MAX, min_low = UINT64_MAX;
+    char line[112];
+    (void)event;
+    (void)ctx;
+
+    /* Drain until empty: the next burst notifies again */
+    while ((n = eic_queue_read(batch, 16)) != 0u)
+    {
+        batches++;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint64_t dt = batch[i].timestamp - last_ts;
+
+            /* Level after the edge: the time before it was the other level */
+            if (batch[i].level && dt < min_low)
+                min_low = dt;
+            else if (!batch[i].level && dt < min_high)
+                min_high = dt;
+
+            last_ts = batch[i].timestamp;
+        }
+
+        edges += n;
+    }
+
+    snprintf(line, sizeof line,
+             "edges %4lu in %lu reads  min high %lu ns  min low %lu ns  drop %lu\r\n",
+             (unsigned long)edges, (unsigned long)batches,
+             (unsigned long)(min_high == UINT64_MAX ? 0 : timebase_ticks_to_ns(min_high)),
+             (unsigned long)(min_low == UINT64_MAX ? 0 : timebase_ticks_to_ns(min_low)),
+             (unsigned long)eic_queue_dropped());
+    SERCOM7_USART_WriteString(line);
+}
+
+int main(void)
+{
+    SERCOM7_USART_Init(115200);
+    gpio_configure_pin(LED1_PORT, LED1_PIN, GPIO_DIR_OUTPUT);
+
+    timebase_init();
+    sched_init();
+    sched_task_create(&edge_task, "edges", 5, edge_handler, 0, edge_slots, 4);
+
+    eic_init();
+    eic_set_debounce_us(20000);
+    eic_queue_init(edge_queue, 64, edges_notify, 0);
+
+    eic_attach(BUTTON_PORT, BUTTON_PIN, EIC_LINE_FOR_PIN(BUTTON_PIN),
+               EIC_SENSE_FALL, EIC_FLAG_DEBOUNCE | EIC_FLAG_PULLUP,
+               button_cb, 0);
+
+    eic_attach(PULSE_PORT, PULSE_PIN, PULSE_LINE,
+               EIC_SENSE_BOTH, EIC_FLAG_FILTER | EIC_FLAG_QUEUE,
+               0, 0);
+
+    SERCOM7_USART_WriteString("\r\neic edge events\r\n");
+
+    sched_run();
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "dmac_drv.h"
+#include "eic_drv.h"
+#include "evsys_drv.h"
+#include "timer_counter_drv.h"
+#include "gpio_wave.h"
+
+/*
+ * Capture pipeline with no CPU in the loop.
+ *
+ *   PA05 (gpio_wave test signal) ── jumper ──► PA04 / EXTINT4
+ *        │ EIC, sense HIGH, event output, no interrupt
+ *        ▼ EVSYS channel, asynchronous path (level passes through)
+ *   TC3 PPW capture: rising edge → period in CC0,
+ *                    falling edge → pulse width in CC1
+ *        │ MC1 DMA trigger
+ *        ▼
+ *   DMAC: one word beat reads CC0 + CC1 together into a ring
+ *
+ * The main loop only looks at the ring once per second: every edge
+ * pair is measured and stored while the CPU does nothing.
+ */
+#define SIG_OUT_PIN     5u          /* PA05, test signal out  */
+#define CAP_PIN         4u          /* PA04, capture input    */
+#define CAP_LINE        EIC_LINE_FOR_PIN(CAP_PIN)
+
+#define CAP_TC          3u
+#define SIG_TC          4u
+
+#define RING_LEN        256u
+
+/* 10 kHz, 30 % duty from 100 kHz samples */
+static const uint8_t sig_levels[10] =
+{
+    1u << SIG_OUT_PIN, 1u << SIG_OUT_PIN, 1u << SIG_OUT_PIN, 0, 0, 0, 0, 0, 0, 0
+};
+
+static gpio_wave_t sig_wave;
+static volatile uint32_t ring[RING_LEN];    /* CC1 << 16 | CC0 */
+
+static void delay_ms(uint32_t ms)
+{
+    for (volatile uint32_t i = 0; i < ms * 12000u; i++);
+}
+
+int main(void)
+{
+    char line[96];
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    dmac_init();
+    evsys_init();
+    eic_init();
+
+    /* Test signal: byte samples to lane 0 of PORTA OUT */
+    const gpio_wave_config_t sig_cfg =
+    {
+        .tc_index     = SIG_TC,
+        .port         = GPIO_PORT_A,
+        .dst          = GPIO_WAVE_DST_OUT,
+        .beat         = DMAC_BEAT_BYTE,
+        .lane         = 0,
+        .pin_mask     = 1u << SIG_OUT_PIN,
+        .sample_hz    = 100000UL,
+        .dma_priority = 1
+    };
+    gpio_wave_init(&sig_wave, &sig_cfg);
+
+    /* EXTINT4 → event only: sense HIGH keeps the level on the event line */
+    eic_attach(GPIO_PORT_A, CAP_PIN, CAP_LINE, EIC_SENSE_HIGH, 0, 0, 0);
+    eic_disable_line(CAP_LINE);
+    eic_event_output_enable(CAP_LINE, true);
+
+    /* TC3: 48 MHz / 16 = 3 MHz ticks, PPW capture on CC0 / CC1 */
+    tc_init(CAP_TC, TC_MODE_16BIT, TC_PRESCALER_DIV16, TC_WAVE_NFRQ, 0);
+    tc_capture_enable(CAP_TC, 0, TC_CAPTURE_PPWP, false);
+    tc_capture_enable(CAP_TC, 1, TC_CAPTURE_PPWP, false);
+
+    int8_t ev = evsys_route(EVSYS_GEN_EIC_EXTINT(CAP_LINE), EVSYS_USER_TC(CAP_TC),
+                            EVSYS_PATH_ASYNC, EVSYS_EDGE_NONE);
+
+    /* CC0 and CC1 are adjacent: one word beat per captured cycle */
+    int8_t dma = dmac_channel_alloc();
+    dmac_desc_t *desc = dmac_channel_descriptor((uint8_t)dma);
+
+    dmac_channel_setup((uint8_t)dma, DMAC_TRIG_TC_MC(CAP_TC, 1), DMAC_TRIGACT_BURST, 3);
+    dmac_descriptor_fill(desc, &TC3_REGS->COUNT16.TC_CC[0], ring, RING_LEN,
+                         DMAC_BEAT_WORD, DMAC_DESC_DSTINC, desc);
+    dmac_channel_enable((uint8_t)dma);
+
+    tc_start(CAP_TC);
+    gpio_wave_start(&sig_wave, sig_levels, sizeof sig_levels, true);
+
+    uint32_t tick_hz = tc_get_clock_hz(CAP_TC) / 16u;
+
+    snprintf(line, sizeof line, "\r\nevsys capture: event ch %d, dma ch %d, tc %lu Hz\r\n",
+             ev, dma, (unsigned long)tick_hz);
+    SERCOM7_USART_WriteString(line);
+
+    while (1)
+    {
+        delay_ms(1000);
+
+        /* Last slot written: the ring index trails the remaining count */
+        uint32_t head  = RING_LEN - dmac_channel_remaining((uint8_t)dma);
+        uint32_t last  = ring[(head + RING_LEN - 1u) % RING_LEN];
+        uint32_t per   = last & 0xFFFFu;
+        uint32_t width = last >> 16;
+
+        snprintf(line, sizeof line, "period %lu  width %lu  freq %lu Hz  duty %lu %%\r\n",
+                 (unsigned long)per, (unsigned long)width,
+                 (unsigned long)(per ? tick_hz / per : 0),
+                 (unsigned long)(per ? width * 100u / per : 0));
+        SERCOM7_USART_WriteString(line);
+    }
+}
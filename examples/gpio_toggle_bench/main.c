@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "gpio_drv.h"
+#include "timebase.h"
+
+/*
+ * GPIO toggle-rate benchmark.
+ *
+ * At 120 MHz the probe pin is toggled ITERATIONS times through each
+ * access path and the DWT cycle count per write is printed, together
+ * with the resulting output frequency (two writes per period). The
+ * last case writes an 8-bit counting pattern to a parallel bus.
+ * Watch PROBE / BUS on a scope to confirm the printed rates.
+ */
+#define PROBE_PORT      GPIO_PORT_A
+#define PROBE_PIN       14          /* PA14 */
+#define PROBE_MASK      GPIO_PIN_MASK(PROBE_PIN)
+
+#define BUS_PORT        GPIO_PORT_B
+#define BUS_FIRST_PIN   8           /* PB08..PB15 */
+
+#define ITERATIONS      4096u       /* Multiple of 8 */
+
+static gpio_bus_t bus;
+
+typedef uint32_t (*bench_fn_t)(void);
+
+/* Single-pin API: call + pin check + write */
+static uint32_t bench_pin_api(void)
+{
+    uint32_t c0 = timebase_cycles();
+
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+        gpio_write_toggle(PROBE_PORT, PROBE_PIN);
+
+    return timebase_cycles() - c0;
+}
+
+/* Direct APB register write, unrolled */
+static uint32_t bench_apb(void)
+{
+    volatile uint32_t *outtgl = &PORT_REGS->GROUP[PROBE_PORT].PORT_OUTTGL;
+    uint32_t c0 = timebase_cycles();
+
+    for (uint32_t i = 0; i < ITERATIONS; i += 8u)
+    {
+        *outtgl = PROBE_MASK; *outtgl = PROBE_MASK;
+        *outtgl = PROBE_MASK; *outtgl = PROBE_MASK;
+        *outtgl = PROBE_MASK; *outtgl = PROBE_MASK;
+        *outtgl = PROBE_MASK; *outtgl = PROBE_MASK;
+    }
+
+    return timebase_cycles() - c0;
+}
+
+/* Port-wide API over IOBUS, unrolled */
+static uint32_t bench_iobus(void)
+{
+    uint32_t c0 = timebase_cycles();
+
+    for (uint32_t i = 0; i < ITERATIONS; i += 8u)
+    {
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+        gpio_port_toggle(PROBE_PORT, PROBE_MASK);
+    }
+
+    return timebase_cycles() - c0;
+}
+
+/* 8-bit bus, masked set + clear per write */
+static uint32_t bench_bus(void)
+{
+    uint32_t c0 = timebase_cycles();
+
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+        gpio_bus_write(&bus, i);
+
+    return timebase_cycles() - c0;
+}
+
+static void report(const char *name, bench_fn_t fn)
+{
+    char line[96];
+
+    /* No interrupts inside the measured window */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t cycles = fn();
+    __set_PRIMASK(primask);
+
+    /* Cycles per write ×100, toggle frequency = cpu / (2 × cycles) */
+    uint32_t cpw100 = (uint32_t)((uint64_t)cycles * 100u / ITERATIONS);
+    uint32_t khz    = (uint32_t)((uint64_t)clock_cpu_hz() * ITERATIONS / 2u / cycles / 1000u);
+
+    snprintf(line, sizeof line, "%-10s %3lu.%02lu cyc/write  %6lu kHz\r\n",
+             name,
+             (unsigned long)(cpw100 / 100u), (unsigned long)(cpw100 % 100u),
+             (unsigned long)khz);
+    SERCOM7_USART_WriteString(line);
+}
+
+int main(void)
+{
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+
+    SERCOM7_USART_Init(115200);
+    timebase_init();
+
+    gpio_port_configure(PROBE_PORT, PROBE_MASK, GPIO_DIR_OUTPUT);
+    gpio_bus_init(&bus, BUS_PORT, BUS_FIRST_PIN, 8, GPIO_DIR_OUTPUT);
+
+    SERCOM7_USART_WriteString("\r\ngpio toggle bench @ 120 MHz\r\n");
+
+    while (1)
+    {
+        report("pin api", bench_pin_api);
+        report("apb", bench_apb);
+        report("iobus", bench_iobus);
+        report("bus8", bench_bus);
+
+        SERCOM7_USART_WriteString("\r\n");
+        for (volatile uint32_t d = 0; d < 20000000u; d++);
+    }
+}
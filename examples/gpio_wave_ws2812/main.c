@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <string.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "dmac_drv.h"
+#include "gpio_wave.h"
+
+/*
+ * DMA-driven GPIO waveforms.
+ *
+ * 1. WS2812: STRIPS LED strips on PB00..PB07 driven in parallel.
+ *    Each data bit is three 417 ns slots at 2.4 MHz:
+ *        slot 0: all strip pins high
+ *        slot 1: high only for strips sending a 1
+ *        slot 2: low
+ *    (0 → 417 ns high, 1 → 833 ns high, 1.25 µs per bit). Samples are
+ *    bytes written to lane 0 of PORTB OUT, so PB08..PB31 are untouched.
+ *
+ * 2. Quadrature test signal: PA20 / PA21, 250 kHz, looped forever
+ *    through OUTTGL from a 4-entry toggle table.
+ *
+ * While both run the CPU renders the next frame, busy in a loop that
+ * would wreck any bit-banged timing.
+ */
+#define STRIPS          8u
+#define LEDS            60u
+#define RESET_SLOTS     144u        /* > 50 µs low at 2.4 MHz */
+
+#define WS_TC           2u
+#define QUAD_TC         4u
+
+#define QUAD_A          20u         /* PA20 */
+#define QUAD_B          21u         /* PA21 */
+
+static uint8_t ws_buf[LEDS * 24u * 3u + RESET_SLOTS];
+static uint8_t frame[STRIPS][LEDS][3];      /* G, R, B */
+
+static uint32_t quad_buf[4];
+
+static gpio_wave_t ws_wave;
+static gpio_wave_t quad_wave;
+
+static volatile uint32_t frames_sent = 0;
+
+static void ws_done(gpio_wave_t *wave, void *ctx)
+{
+    (void)wave;
+    (void)ctx;
+    frames_sent++;
+}
+
+/* Interleave the strips: one sample carries one bit of every strip */
+static void ws_encode(void)
+{
+    uint8_t *s = ws_buf;
+    uint8_t all = (uint8_t)((1u << STRIPS) - 1u);
+
+    for (uint32_t led = 0; led < LEDS; led++)
+    {
+        for (uint32_t byte = 0; byte < 3u; byte++)
+        {
+            for (int32_t bit = 7; bit >= 0; bit--)
+            {
+                uint8_t data = 0;
+
+                for (uint32_t strip = 0; strip < STRIPS; strip++)
+                    data |= (uint8_t)(((frame[strip][led][byte] >> bit) & 1u) << strip);
+
+                *s++ = all;
+                *s++ = data;
+                *s++ = 0;
+            }
+        }
+    }
+
+    memset(s, 0, RESET_SLOTS);
+}
+
+/* Triangle 0..127..0 over one hue turn, quarter brightness */
+static uint8_t tri(uint8_t h)
+{
+    return (uint8_t)((h < 128u ? h : 255u - h) >> 2);
+}
+
+/* Moving rainbow, different phase per strip */
+static void render(uint32_t t)
+{
+    for (uint32_t strip = 0; strip < STRIPS; strip++)
+    {
+        for (uint32_t led = 0; led < LEDS; led++)
+        {
+            uint8_t h = (uint8_t)(led * 4u + t + strip * 32u);
+
+            frame[strip][led][0] = tri(h);
+            frame[strip][led][1] = tri((uint8_t)(h + 85u));
+            frame[strip][led][2] = tri((uint8_t)(h + 170u));
+        }
+    }
+}
+
+int main(void)
+{
+    char line[80];
+    uint32_t t = 0;
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    dmac_init();
+
+    const gpio_wave_config_t ws_cfg =
+    {
+        .tc_index     = WS_TC,
+        .port         = GPIO_PORT_B,
+        .dst          = GPIO_WAVE_DST_OUT,
+        .beat         = DMAC_BEAT_BYTE,
+        .lane         = 0,
+        .pin_mask     = (1u << STRIPS) - 1u,
+        .sample_hz    = 2400000UL,
+        .dma_priority = 3
+    };
+
+    const gpio_wave_config_t quad_cfg =
+    {
+        .tc_index     = QUAD_TC,
+        .port         = GPIO_PORT_A,
+        .dst          = GPIO_WAVE_DST_OUTTGL,
+        .beat         = DMAC_BEAT_WORD,
+        .lane         = 0,
+        .pin_mask     = (1u << QUAD_A) | (1u << QUAD_B),
+        .sample_hz    = 1000000UL,  /* 4 steps per cycle: 250 kHz */
+        .dma_priority = 2
+    };
+
+    gpio_wave_init(&ws_wave, &ws_cfg);
+    gpio_wave_set_callback(&ws_wave, ws_done, 0);
+
+    gpio_wave_init(&quad_wave, &quad_cfg);
+
+    /* A/B Gray sequence 00 → 01 → 11 → 10, encoded as toggles */
+    quad_buf[0] = (1u << QUAD_A);
+    quad_buf[1] = (1u << QUAD_A) | (1u << QUAD_B);
+    quad_buf[2] = (1u << QUAD_B);
+    quad_buf[3] = 0;
+    gpio_wave_encode_toggle(quad_buf, 4, 0, quad_cfg.pin_mask);
+    gpio_port_clear(GPIO_PORT_A, quad_cfg.pin_mask);
+    gpio_wave_start(&quad_wave, quad_buf, 4, true);
+
+    snprintf(line, sizeof line, "\r\ngpio wave: ws2812 %lu Hz, quad %lu Hz\r\n",
+             (unsigned long)ws_wave.sample_hz, (unsigned long)quad_wave.sample_hz);
+    SERCOM7_USART_WriteString(line);
+
+    while (1)
+    {
+        render(t++);
+
+        while (gpio_wave_busy(&ws_wave));
+        ws_encode();
+        gpio_wave_start(&ws_wave, ws_buf, sizeof ws_buf, false);
+
+        if ((t & 63u) == 0u)
+        {
+            snprintf(line, sizeof line, "frames %lu\r\n", (unsigned long)frames_sent);
+            SERCOM7_USART_WriteString(line);
+        }
+    }
+}
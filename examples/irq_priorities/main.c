@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+#include "dmac_drv.h"
+#include "timer_counter_drv.h"
+#include "irq_mgr.h"
+
+/*
+ * Control interrupt above the driver critical sections.
+ *
+ * TC2 fires at 10 kHz as a stand-in control loop, promoted to
+ * IRQ_PRIO_CONTROL. On entry it reads its own counter, which restarted
+ * at the compare match: the count is the entry latency in 48 MHz
+ * ticks. Meanwhile the main loop keeps the DMA driver allocating and
+ * freeing channels, each in an irq_lock() section.
+ *
+ * Once a second it prints the worst control latency and the longest
+ * window irq_lock() kept the driver interrupts masked. The latency
+ * does not grow with the driver sections; set CTRL_PRIO to
+ * IRQ_PRIO_TC and it does.
+ */
+#define CTRL_TC         2u
+#define CTRL_HZ         10000u
+
+#ifndef CTRL_PRIO
+#define CTRL_PRIO       IRQ_PRIO_CONTROL
+#endif
+
+static volatile uint32_t ctrl_latency_max;
+static volatile uint32_t ctrl_runs;
+
+static void control_isr(void)
+{
+    uint32_t latency = tc16_get_count(CTRL_TC);
+
+    if (latency > ctrl_latency_max)
+        ctrl_latency_max = latency;
+
+    ctrl_runs++;
+}
+
+int main(void)
+{
+    char line[112];
+    irq_mask_stats_t st;
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    irq_init();
+    timebase_init();
+    dmac_init();
+
+    tc_init(CTRL_TC, TC_MODE_16BIT, TC_PRESCALER_DIV1, TC_WAVE_MFRQ, 0);
+    uint32_t tick_hz = tc_get_clock_hz(CTRL_TC);
+    tc_init(CTRL_TC, TC_MODE_16BIT, TC_PRESCALER_DIV1, TC_WAVE_MFRQ, tick_hz / CTRL_HZ - 1u);
+
+    /* Registered at IRQ_PRIO_TC, then promoted */
+    tc_register_callback(CTRL_TC, TC_INT_MC0, control_isr);
+    irq_enable((IRQn_Type)(TC0_IRQn + CTRL_TC), CTRL_PRIO);
+    tc_start(CTRL_TC);
+
+    snprintf(line, sizeof line, "\r\nirq: control at %u, lock ceiling %u, drivers down to %u\r\n",
+             (unsigned)CTRL_PRIO, (unsigned)IRQ_LOCK_CEILING, (unsigned)IRQ_PRIO_SERCOM);
+    SERCOM7_USART_WriteString(line);
+
+    uint64_t next = timebase_deadline_us(1000000);
+
+    while (1)
+    {
+        /* Driver load: allocation sections */
+        int8_t ch = dmac_channel_alloc();
+        if (ch >= 0)
+            dmac_channel_free((uint8_t)ch);
+
+        if (!timebase_reached(next))
+            continue;
+        next += timebase_us_to_ticks(1000000);
+
+        irq_get_mask_stats(&st);
+        irq_reset_mask_stats();
+
+        uint32_t cpu_mhz = clock_cpu_hz() / 1000000u;
+
+        snprintf(line, sizeof line,
+                 "ctrl %lu runs, latency max %lu ns | masked %lu x, max %lu ns at 0x%08lx\r\n",
+                 (unsigned long)ctrl_runs,
+                 (unsigned long)(ctrl_latency_max * 1000u / (tick_hz / 1000000u)),
+                 (unsigned long)st.count,
+                 (unsigned long)(st.max_cycles * 1000u / cpu_mhz),
+                 (unsigned long)st.max_site);
+        SERCOM7_USART_WriteString(line);
+
+        ctrl_runs        = 0;
+        ctrl_latency_max = 0;
+    }
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+#include "evsys_drv.h"
+#include "eic_drv.h"
+#include "qdec_drv.h"
+
+/*
+ * Incremental encoder: position, speed and index.
+ *
+ * A / B go to the PDEC (PC16 / PC17, X4 decoding). A is also jumpered
+ * to PA04, whose rising edges TC2 times for the T method: at low speed
+ * the estimate comes from the edge period instead of the 0 or 1 count
+ * seen per millisecond. The index pulse on PC18 re-zeroes the position
+ * once, on the first pulse after start.
+ *
+ * qdec_update() runs every millisecond; every 100 ms the position,
+ * speed, method in use and index data are printed.
+ */
+#define ENC_A_PIN       16u         /* PC16, PDEC QDI0        */
+#define ENC_B_PIN       17u         /* PC17, PDEC QDI1        */
+#define ENC_Z_PIN       18u         /* PC18, index, EXTINT2   */
+#define ENC_A_TIME_PIN  4u          /* PA04, A jumper, EXTINT4 */
+
+#define PERIOD_TC       2u
+#define ENC_CPR         4096u       /* 1024 lines, X4         */
+
+static qdec_t enc;
+
+static const char *const method_name[] = { "none", "M", "T", "stall" };
+
+int main(void)
+{
+    char line[112];
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    timebase_init();
+    evsys_init();
+
+    const qdec_config_t cfg =
+    {
+        .backend        = QDEC_BACKEND_PDEC,
+        .port           = GPIO_PORT_C,
+        .pin_a          = ENC_A_PIN,
+        .pin_b          = ENC_B_PIN,
+        .swap           = false,
+        .filter         = 4,
+        .period_tc      = PERIOD_TC,
+        .period_port    = GPIO_PORT_A,
+        .period_pin     = ENC_A_TIME_PIN,
+        .period_line    = EIC_LINE_FOR_PIN(ENC_A_TIME_PIN),
+        .min_edge_hz    = 10u,
+        .index_port     = GPIO_PORT_C,
+        .index_pin      = ENC_Z_PIN,
+        .index_line     = EIC_LINE_FOR_PIN(ENC_Z_PIN),
+        .counts_per_rev = ENC_CPR
+    };
+
+    if (!qdec_init(&enc, &cfg))
+    {
+        SERCOM7_USART_WriteString("qdec init failed\r\n");
+        while (1);
+    }
+
+    qdec_home_on_index(&enc);
+
+    SERCOM7_USART_WriteString("\r\nqdec: PDEC X4, T method on TC2, index homing\r\n");
+
+    uint64_t next_update = timebase_deadline_us(1000);
+    uint32_t ticks = 0;
+
+    while (1)
+    {
+        if (!timebase_reached(next_update))
+            continue;
+        next_update += timebase_us_to_ticks(1000);
+
+        qdec_update(&enc);
+
+        if (++ticks < 100u)
+            continue;
+        ticks = 0;
+
+        int64_t mcps = qdec_velocity_mcps(&enc);
+        int32_t rpm  = qdec_rpm_x10(&enc);
+        char    sign = mcps < 0 ? '-' : ' ';
+
+        if (mcps < 0)
+        {
+            mcps = -mcps;
+            rpm  = -rpm;
+        }
+
+        snprintf(line, sizeof line,
+                 "pos %6ld  %c%lu.%03lu cps  %c%lu.%lu rpm  %-5s  idx %lu @ %ld%s\r\n",
+                 (long)qdec_position(&enc),
+                 sign, (unsigned long)(mcps / 1000), (unsigned long)(mcps % 1000),
+                 sign, (unsigned long)(rpm / 10), (unsigned long)(rpm % 10),
+                 method_name[qdec_velocity_method(&enc)],
+                 (unsigned long)qdec_index_count(&enc),
+                 (long)qdec_index_position(&enc),
+                 qdec_error(&enc) ? "  QERR" : "");
+        SERCOM7_USART_WriteString(line);
+    }
+}
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "gpio_drv.h"
+#include "timer_counter_drv.h"
+#include "scheduler.h"
+
+/*
+ * Run-to-completion scheduler demo.
+ *
+ * - SysTick at 2 kHz posts a sample event to the "filter" task
+ * - TC2 overflows at 1 kHz; its callback is deferred, so it runs from
+ *   the scheduler's defer task and only counts milliseconds
+ * - Every 1000 ms the tick callback posts to the "report" task, which
+ *   prints per-task statistics and the CPU load, then resets them
+ *
+ * All work happens in thread mode; the interrupts only enqueue.
+ */
+#define LED1_PORT       GPIO_PORT_C
+#define LED1_PIN        21          /* PC21 */
+
+#define SYSTICK_HZ      2000u
+#define TICK_TC         2u
+
+#define PRIO_FILTER     10u
+#define PRIO_REPORT     1u
+
+#define EV_SAMPLE       1u
+#define EV_REPORT       2u
+
+static sched_task_t filter_task;
+static sched_task_t report_task;
+static sched_slot_t filter_queue[16];
+static sched_slot_t report_queue[4];
+
+static uint32_t filter_avg = 0;
+static uint32_t ms_count = 0;
+
+void SysTick_Handler(void)
+{
+    (void)sched_post(&filter_task, EV_SAMPLE, (void *)DWT->CYCCNT);
+}
+
+/* Deferred TC callback: thread mode, defer task priority */
+static void tick_cb(void)
+{
+    if (++ms_count % 1000u == 0u)
+    {
+        gpio_write_toggle(LED1_PORT, LED1_PIN);
+        (void)sched_post(&report_task, EV_REPORT, 0);
+    }
+}
+
+/* Exponential moving average of the sample's low bits */
+static void filter_handler(const sched_event_t *event, void *ctx)
+{
+    uint32_t sample = (uint32_t)event->data & 0xFFFFu;
+    (void)ctx;
+
+    filter_avg = filter_avg - (filter_avg >> 4) + (sample >> 4);
+}
+
+static void report_handler(const sched_event_t *event, void *ctx)
+{
+    char line[112];
+    sched_task_stats_t st;
+    sched_stats_t total;
+    (void)event;
+    (void)ctx;
+
+    sched_get_stats(&total);
+    uint64_t all = total.cycles_busy + total.cycles_idle;
+    uint32_t load = all ? (uint32_t)(total.cycles_busy * 1000u / all) : 0u;
+
+    snprintf(line, sizeof line, "\r\n%lu ms  load %lu.%lu %%  avg %lu\r\n",
+             (unsigned long)ms_count,
+             (unsigned long)(load / 10u), (unsigned long)(load % 10u),
+             (unsigned long)filter_avg);
+    SERCOM7_USART_WriteString(line);
+
+    for (sched_task_t *t = sched_task_next(0); t; t = sched_task_next(t))
+    {
+        sched_task_get_stats(t, &st);
+
+        snprintf(line, sizeof line,
+                 "  %-7s p%-2u runs %6lu  mean %5lu  max %6lu cyc  hw %2lu  drop %lu\r\n",
+                 t->name, (unsigned)t->priority,
+                 (unsigned long)st.runs,
+                 (unsigned long)(st.runs ? st.cycles_total / st.runs : 0u),
+                 (unsigned long)st.cycles_max,
+                 (unsigned long)st.queue_high_water,
+                 (unsigned long)st.dropped);
+        SERCOM7_USART_WriteString(line);
+
+        /* This handler's own run is added after it returns */
+        sched_task_reset_stats(t);
+    }
+}
+
+int main(void)
+{
+    SERCOM7_USART_Init(115200);
+    gpio_configure_pin(LED1_PORT, LED1_PIN, GPIO_DIR_OUTPUT);
+
+    sched_init();
+    sched_task_create(&filter_task, "filter", PRIO_FILTER, filter_handler, 0,
+                      filter_queue, sizeof filter_queue / sizeof filter_queue[0]);
+    sched_task_create(&report_task, "report", PRIO_REPORT, report_handler, 0,
+                      report_queue, sizeof report_queue / sizeof report_queue[0]);
+
+    /* 48 MHz / 64 / 750 = 1 kHz */
+    tc_init(TICK_TC, TC_MODE_16BIT, TC_PRESCALER_DIV64, TC_WAVE_MFRQ, 749);
+    tc_register_callback_deferred(TICK_TC, TC_INT_OVF, tick_cb);
+    NVIC_EnableIRQ(TC2_IRQn);
+    tc_start(TICK_TC);
+
+    (void)SysTick_Config(clock_cpu_hz() / SYSTICK_HZ);
+
+    SERCOM7_USART_WriteString("\r\nscheduler demo\r\n");
+
+    sched_run();
+}
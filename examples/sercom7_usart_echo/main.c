@@ -1,10 +1,17 @@
 #include "sercom7_usart.h"
 
+/* Set to 1 to echo through the interrupt-driven ring buffers */
+#define USE_INTERRUPT_MODE  0
+
 int main(void)
 {
     /* Initialize SERCOM7 USART at 115200 baud */
     SERCOM7_USART_Init(115200);
 
+#if USE_INTERRUPT_MODE
+    SERCOM7_USART_SetMode(SERCOM7_USART_MODE_INTERRUPT);
+#endif
+
     /* Send startup message */
     SERCOM7_USART_WriteString("SERCOM7 USART Initialized\r\n");
 
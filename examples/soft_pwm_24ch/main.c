@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "soft_pwm.h"
+
+/*
+ * 24-channel software PWM.
+ *
+ * PB00..PB15 and PC00..PC07 dim 24 LEDs at 500 Hz with 256 steps from
+ * one TC. A wave of brightness runs across the channels; every 10 ms
+ * all staged duties are published with soft_pwm_update() and switch
+ * together at the next period boundary. Once a second the interrupt
+ * cost per PWM period is printed.
+ */
+#define PWM_TC          3u
+#define PWM_HZ          500u
+#define PWM_STEPS       256u
+
+#define CHANNELS        24u
+
+/* Square law: roughly linear perceived brightness */
+static uint16_t gamma8(uint8_t x)
+{
+    return (uint16_t)(((uint32_t)x * x + 255u) >> 8);
+}
+
+int main(void)
+{
+    char line[112];
+    uint32_t frame = 0;
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+
+    if (!soft_pwm_init(PWM_TC, PWM_HZ, PWM_STEPS))
+    {
+        SERCOM7_USART_WriteString("soft_pwm_init failed\r\n");
+        while (1);
+    }
+
+    for (uint8_t i = 0; i < 16u; i++)
+        soft_pwm_add_channel(GPIO_PORT_B, i);
+    for (uint8_t i = 0; i < 8u; i++)
+        soft_pwm_add_channel(GPIO_PORT_C, i);
+
+    soft_pwm_start();
+
+    snprintf(line, sizeof line, "\r\nsoft pwm: %u ch, %lu Hz, %u steps\r\n",
+             (unsigned)CHANNELS, (unsigned long)soft_pwm_get_freq_hz(), (unsigned)PWM_STEPS);
+    SERCOM7_USART_WriteString(line);
+
+    /* SysTick as a 10 ms frame clock, polled */
+    SysTick->LOAD = clock_cpu_hz() / 100u - 1u;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    while (1)
+    {
+        while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk));
+        frame++;
+
+        for (uint8_t ch = 0; ch < CHANNELS; ch++)
+        {
+            uint8_t phase = (uint8_t)(frame * 3u + ch * 10u);
+            uint8_t tri   = (uint8_t)(phase < 128u ? phase * 2u : (255u - phase) * 2u);
+
+            soft_pwm_set_duty(ch, gamma8(tri));
+        }
+        soft_pwm_update();
+
+        if (frame % 100u == 0u)
+        {
+            soft_pwm_stats_t st;
+            soft_pwm_get_stats(&st);
+
+            uint32_t load = st.period_cycles ? st.isr_cycles_last * 1000u / st.period_cycles : 0u;
+
+            snprintf(line, sizeof line,
+                     "periods %6lu  isr/period %2lu  cyc %5lu (max %5lu)  load %lu.%lu %%  updates %lu\r\n",
+                     (unsigned long)st.periods,
+                     (unsigned long)st.isr_count_last,
+                     (unsigned long)st.isr_cycles_last,
+                     (unsigned long)st.isr_cycles_max,
+                     (unsigned long)(load / 10u), (unsigned long)(load % 10u),
+                     (unsigned long)st.updates);
+            SERCOM7_USART_WriteString(line);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "dmac_drv.h"
+#include "spi_drv.h"
+
+/*
+ * SERCOM4 SPI loopback: wire PB12 (MOSI) to PB15 (MISO).
+ * Two logical devices share CS PB14 to exercise the per-device
+ * mode / SCK switch inside the transaction queue.
+ */
+#define LOOP_LEN        1024u
+#define CPU_HZ          48000000UL
+
+static const sercom_pin_t spi_pins[] =
+{
+    { SERCOM_PORTB, 12, SERCOM_MUX_C, false },  // PAD0 MOSI
+    { SERCOM_PORTB, 13, SERCOM_MUX_C, false },  // PAD1 SCK
+    { SERCOM_PORTB, 15, SERCOM_MUX_C, false }   // PAD3 MISO
+};
+
+static spi_master_t spi;
+static spi_device_t dev_fast;
+static spi_device_t dev_slow;
+
+static uint8_t tx_buf[LOOP_LEN];
+static uint8_t rx_fast[LOOP_LEN];
+static uint8_t rx_slow[LOOP_LEN];
+
+static bool check(const uint8_t *rx)
+{
+    for (uint32_t i = 0; i < LOOP_LEN; i++)
+    {
+        if (rx[i] != tx_buf[i])
+            return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    char line[96];
+
+    SERCOM7_USART_Init(115200);
+    dmac_init();
+
+    spi_config_t cfg =
+    {
+        .sercom = 4, .pins = spi_pins, .pin_count = 3,
+        .dopo = 0,          // MOSI PAD0, SCK PAD1
+        .dipo = 3           // MISO PAD3
+    };
+    spi_master_init(&spi, &cfg);
+
+    spi_device_init(&spi, &dev_fast, GPIO_PORT1, 14, 24000000UL, SPI_MODE0, false);
+    spi_device_init(&spi, &dev_slow, GPIO_PORT1, 14, 1000000UL,  SPI_MODE3, false);
+
+    for (uint32_t i = 0; i < LOOP_LEN; i++)
+        tx_buf[i] = (uint8_t)(i * 7u + 1u);
+
+    /* SysTick as free-running 24-bit cycle counter */
+    SysTick->LOAD = 0xFFFFFFu;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    while (1)
+    {
+        spi_xfer_t x_fast = { .dev = &dev_fast, .tx_buf = tx_buf, .rx_buf = rx_fast, .len = LOOP_LEN };
+        spi_xfer_t x_slow = { .dev = &dev_slow, .tx_buf = tx_buf, .rx_buf = rx_slow, .len = LOOP_LEN };
+
+        /* Back-to-back: the device switch happens in the DMA ISR */
+        uint32_t t0 = SysTick->VAL;
+        spi_submit(&spi, &x_fast);
+        spi_submit(&spi, &x_slow);
+        while (x_fast.status == SPI_STATUS_PENDING);
+        uint32_t cycles = (t0 - SysTick->VAL) & 0xFFFFFFu;
+        while (spi_busy(&spi));
+
+        uint32_t kbps = (uint32_t)((uint64_t)LOOP_LEN * 8u * (CPU_HZ / 1000u) / cycles);
+
+        snprintf(line, sizeof line, "SCK %lu Hz: %lu kbit/s %s | SCK %lu Hz: %s\r\n",
+                 (unsigned long)dev_fast.sck_hz, (unsigned long)kbps,
+                 check(rx_fast) ? "OK" : "FAIL",
+                 (unsigned long)dev_slow.sck_hz,
+                 check(rx_slow) ? "OK" : "FAIL");
+        SERCOM7_USART_WriteString(line);
+
+        for (volatile uint32_t d = 0; d < 4000000u; d++);
+    }
+}
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+#include "timer_counter_drv.h"
+
+/*
+ * Three-phase PWM with buffered, synchronized duty updates.
+ *
+ * TC2, TC3 and TC4 run 20 kHz match-PWM (CC0 = period, CC1 = duty on
+ * WO1). A 1 kHz control loop computes three sine-shaped duties and
+ * commits them as one set: lock, three CCBUF1 writes, unlock. All
+ * three outputs change at the same period boundary and no write waits
+ * for SYNCBUSY.
+ *
+ * For comparison the same three updates are timed once with
+ * tc_pwm_set_duty(), which writes CC1 and spins on SYNCBUSY.
+ */
+#define PWM_HZ          20000u
+#define PHASES          3u
+
+#define PMUX_E          4u          /* TC waveform outputs */
+
+static const uint8_t phase_tc[PHASES]  = { 2, 3, 4 };
+static const uint8_t phase_pin[PHASES] = { 13, 15, 23 };   /* PA13, PA15, PA23: TCn WO1 */
+
+/* Quarter sine, 0..1000, 16 steps */
+static const uint16_t sine_q[17] =
+{
+    0, 98, 195, 290, 383, 471, 556, 634, 707, 773, 831, 882, 924, 957, 981, 995, 1000
+};
+
+static void pin_mux_tc(uint8_t pin)
+{
+    port_group_registers_t *group = &PORT_REGS->GROUP[0];
+
+    if (pin & 1u)
+        group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0x0Fu) | (uint8_t)(PMUX_E << 4);
+    else
+        group->PORT_PMUX[pin >> 1] = (group->PORT_PMUX[pin >> 1] & 0xF0u) | (uint8_t)PMUX_E;
+
+    group->PORT_PINCFG[pin] = PORT_PINCFG_PMUXEN_Msk;
+}
+
+/* Sine of a 64-step angle, scaled to 0..1000 around 500 */
+static uint32_t sine_duty(uint32_t angle)
+{
+    uint32_t q = angle & 15u;
+    int32_t  s;
+
+    switch ((angle >> 4) & 3u)
+    {
+        case 0:  s =  (int32_t)sine_q[q];       break;
+        case 1:  s =  (int32_t)sine_q[16u - q]; break;
+        case 2:  s = -(int32_t)sine_q[q];       break;
+        default: s = -(int32_t)sine_q[16u - q]; break;
+    }
+
+    return (uint32_t)(500 + s / 2);
+}
+
+int main(void)
+{
+    char line[96];
+    uint8_t mask = 0;
+    uint32_t period, angle = 0, loops = 0;
+    uint32_t buffered_max = 0, direct;
+
+    clock_init();
+    (void)clock_set_cpu_hz(120000000UL);
+    SERCOM7_USART_Init(115200);
+    timebase_init();
+
+    for (uint8_t p = 0; p < PHASES; p++)
+    {
+        tc_init(phase_tc[p], TC_MODE_16BIT, TC_PRESCALER_DIV1, TC_WAVE_MPWM, 0);
+        period = tc_get_clock_hz(phase_tc[p]) / PWM_HZ - 1u;
+
+        tc_set_compare(phase_tc[p], period);
+        tc_pwm_set_duty(phase_tc[p], period / 2u);
+        pin_mux_tc(phase_pin[p]);
+
+        mask |= TC_MASK(phase_tc[p]);
+    }
+
+    /* Back to back: equal periods, boundaries a few cycles apart */
+    for (uint8_t p = 0; p < PHASES; p++)
+        tc_start(phase_tc[p]);
+
+    /* Reference: the blocking path */
+    uint32_t t0 = timebase_cycles();
+    for (uint8_t p = 0; p < PHASES; p++)
+        tc_pwm_set_duty(phase_tc[p], period / 2u);
+    direct = timebase_cycles() - t0;
+
+    snprintf(line, sizeof line, "\r\ntc pwm sync: %u Hz, period %lu ticks\r\n",
+             PWM_HZ, (unsigned long)period);
+    SERCOM7_USART_WriteString(line);
+
+    uint64_t next = timebase_deadline_us(1000);
+
+    while (1)
+    {
+        while (!timebase_reached(next));
+        next += timebase_us_to_ticks(1000);
+
+        /* One set: all three phases change at the same boundary */
+        t0 = timebase_cycles();
+        tc_update_lock(mask);
+        for (uint8_t p = 0; p < PHASES; p++)
+        {
+            uint32_t duty = sine_duty(angle + p * 64u / PHASES);
+            tc_set_compare_buffered(phase_tc[p], 1, duty * period / 1000u);
+        }
+        tc_update_unlock(mask);
+        uint32_t cycles = timebase_cycles() - t0;
+
+        if (cycles > buffered_max)
+            buffered_max = cycles;
+
+        angle = (angle + 1u) & 63u;
+
+        if (++loops == 1000u)
+        {
+            snprintf(line, sizeof line, "update set: buffered max %lu cycles, direct %lu cycles\r\n",
+                     (unsigned long)buffered_max, (unsigned long)direct);
+            SERCOM7_USART_WriteString(line);
+            loops = 0;
+            buffered_max = 0;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "clock_mgr.h"
+#include "timebase.h"
+
+/*
+ * Timebase stress test.
+ *
+ * The main loop and a 10 kHz SysTick interrupt read timebase_now()
+ * back to back and flag any value lower than the previous one seen
+ * by the same context. Each second the read counts, the violations
+ * and the cost of one read (DWT cycles) are printed.
+ */
+#define SYSTICK_HZ      10000u
+
+static volatile uint32_t isr_reads = 0;
+static volatile uint32_t isr_backwards = 0;
+static uint64_t isr_last = 0;
+
+void SysTick_Handler(void)
+{
+    uint64_t now = timebase_now();
+
+    if (now < isr_last)
+        isr_backwards++;
+
+    isr_last = now;
+    isr_reads++;
+}
+
+int main(void)
+{
+    char line[112];
+    uint32_t main_reads = 0;
+    uint32_t main_backwards = 0;
+    uint64_t last = 0;
+
+    SERCOM7_USART_Init(115200);
+    timebase_init();
+
+    (void)SysTick_Config(clock_cpu_hz() / SYSTICK_HZ);
+
+    SERCOM7_USART_WriteString("\r\ntimebase monotonic\r\n");
+
+    uint64_t next_report = timebase_now() + timebase_hz();
+
+    while (1)
+    {
+        uint64_t now = timebase_now();
+
+        if (now < last)
+            main_backwards++;
+
+        last = now;
+        main_reads++;
+
+        if (now >= next_report)
+        {
+            uint32_t c0 = timebase_cycles();
+            (void)timebase_now();
+            uint32_t cost = timebase_cycles() - c0;
+
+            snprintf(line, sizeof line,
+                     "t %10lu us  main %8lu/%lu  isr %6lu/%lu  read %lu cyc (%lu ns)\r\n",
+                     (unsigned long)timebase_ticks_to_us(now),
+                     (unsigned long)main_reads, (unsigned long)main_backwards,
+                     (unsigned long)isr_reads, (unsigned long)isr_backwards,
+                     (unsigned long)cost,
+                     (unsigned long)timebase_cycles_to_ns(cost));
+            SERCOM7_USART_WriteString(line);
+
+            main_reads = 0;
+            next_report += timebase_hz();
+        }
+    }
+}
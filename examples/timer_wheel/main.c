@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "sercom7_usart.h"
+#include "gpio_drv.h"
+#include "timer_wheel.h"
+
+/*
+ * Timer wheel on the RTC.
+ *
+ * LED1 blinks from a periodic timer, LOAD_TIMERS periodic timers with
+ * spread-out periods keep the wheel busy, one one-shot timer is
+ * restarted from its own callback with a growing delay, and a 1 s
+ * timer hands the statistics to the main loop. Between interrupts the
+ * CPU sleeps; the RTC compare is only armed for the earliest deadline.
+ */
+#define LED1_PORT       GPIO_PORT_C
+#define LED1_PIN        21          /* PC21 */
+
+#define LOAD_TIMERS     2000u
+
+static timer_wheel_t wheel;
+
+static wheel_timer_t led_timer;
+static wheel_timer_t report_timer;
+static wheel_timer_t backoff_timer;
+static wheel_timer_t load_timers[LOAD_TIMERS];
+
+static volatile uint32_t load_hits = 0;
+static volatile uint32_t backoff_delay = 1;
+static volatile bool report_due = false;
+
+static void led_cb(wheel_timer_t *timer, void *ctx)
+{
+    (void)timer;
+    (void)ctx;
+    gpio_write_toggle(LED1_PORT, LED1_PIN);
+}
+
+static void report_cb(wheel_timer_t *timer, void *ctx)
+{
+    (void)timer;
+    (void)ctx;
+    report_due = true;
+}
+
+static void load_cb(wheel_timer_t *timer, void *ctx)
+{
+    (void)timer;
+    (void)ctx;
+    load_hits++;
+}
+
+/* One-shot, re-armed with a doubling delay up to ~64 s */
+static void backoff_cb(wheel_timer_t *timer, void *ctx)
+{
+    (void)ctx;
+
+    if (backoff_delay < TIMER_WHEEL_MS(64000))
+        backoff_delay *= 2u;
+
+    timer_wheel_start(&wheel, timer, backoff_delay, 0);
+}
+
+int main(void)
+{
+    char line[96];
+
+    SERCOM7_USART_Init(115200);
+    gpio_configure_pin(LED1_PORT, LED1_PIN, GPIO_DIR_OUTPUT);
+
+    timer_wheel_rtc_init(&wheel);
+
+    wheel_timer_init(&led_timer, led_cb, 0);
+    timer_wheel_start(&wheel, &led_timer, TIMER_WHEEL_MS(250), TIMER_WHEEL_MS(250));
+
+    wheel_timer_init(&report_timer, report_cb, 0);
+    timer_wheel_start(&wheel, &report_timer, TIMER_WHEEL_MS(1000), TIMER_WHEEL_MS(1000));
+
+    wheel_timer_init(&backoff_timer, backoff_cb, 0);
+    timer_wheel_start(&wheel, &backoff_timer, backoff_delay, 0);
+
+    /* Periods 10 ms .. ~20 s, phases spread over the first second */
+    for (uint32_t i = 0; i < LOAD_TIMERS; i++)
+    {
+        wheel_timer_init(&load_timers[i], load_cb, 0);
+        timer_wheel_start(&wheel, &load_timers[i],
+                          TIMER_WHEEL_MS(i % 1000u) + 1u,
+                          TIMER_WHEEL_MS(10u + 10u * i));
+    }
+
+    SERCOM7_USART_WriteString("\r\ntimer wheel\r\n");
+
+    while (1)
+    {
+        if (report_due)
+        {
+            timer_wheel_stats_t st;
+            uint32_t next = 0;
+
+            report_due = false;
+            timer_wheel_get_stats(&wheel, &st);
+            (void)timer_wheel_next_event(&wheel, &next);
+
+            snprintf(line, sizeof line,
+                     "active %4lu  expired %8lu  cascaded %7lu  max batch %3lu  load %7lu  next %lu\r\n",
+                     (unsigned long)st.active,
+                     (unsigned long)st.expired,
+                     (unsigned long)st.cascaded,
+                     (unsigned long)st.max_batch,
+                     (unsigned long)load_hits,
+                     (unsigned long)next);
+            SERCOM7_USART_WriteString(line);
+        }
+
+        __WFI();
+    }
+}
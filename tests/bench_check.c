@@ -0,0 +1,154 @@
+/*
+ * Compare a bench_host run against the checked-in baseline.
+ *
+ *   bench_check <baseline> <run> [tolerance %]
+ *
+ * Reads the counter= line and the bench=<name> lines of both files and
+ * holds the p50 of every baseline case against the run. A case fails
+ * when it is more than tolerance % (default 5) and more than
+ * BENCH_CHECK_SLACK instructions above its baseline, or when it is
+ * missing from the run. Cases faster than their baseline by more than
+ * the tolerance are reported, not failed: refresh the baseline with
+ * make bench-baseline to keep the gain.
+ *
+ * Exits non-zero on a regression, and when either file was not
+ * counted in instructions (counter=tsc): cycles do not repeat between
+ * runs and are not checked.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Absolute allowance, for cases of a few instructions */
+#define BENCH_CHECK_SLACK       4u
+
+#define MAX_CASES               64u
+#define NAME_LEN                48u
+
+typedef struct
+{
+    char     name[NAME_LEN];
+    uint32_t p50;
+} bench_line_t;
+
+typedef struct
+{
+    char         counter[16];
+    bench_line_t cases[MAX_CASES];
+    uint32_t     count;
+} bench_file_t;
+
+static bool bench_load(const char *path, bench_file_t *f)
+{
+    FILE *fp = fopen(path, "r");
+    char line[256];
+
+    if (!fp)
+    {
+        fprintf(stderr, "bench_check: cannot open %s\n", path);
+        return false;
+    }
+
+    memset(f, 0, sizeof(*f));
+    while (fgets(line, sizeof(line), fp))
+    {
+        bench_line_t *c;
+        const char *p50;
+
+        if (sscanf(line, "bench counter=%15s", f->counter) == 1)
+            continue;
+        if (strncmp(line, "bench=", 6) != 0 || f->count == MAX_CASES)
+            continue;
+
+        c = &f->cases[f->count];
+        p50 = strstr(line, " p50=");
+        if (sscanf(line + 6, "%47s", c->name) == 1 && p50 &&
+            sscanf(p50 + 5, "%u", &c->p50) == 1)
+            f->count++;
+    }
+
+    fclose(fp);
+    return true;
+}
+
+static const bench_line_t *bench_find(const bench_file_t *f, const char *name)
+{
+    for (uint32_t i = 0; i < f->count; i++)
+    {
+        if (strcmp(f->cases[i].name, name) == 0)
+            return &f->cases[i];
+    }
+    return NULL;
+}
+
+static bool bench_counted(const char *path, const bench_file_t *f)
+{
+    if (strcmp(f->counter, "perf") == 0 || strcmp(f->counter, "ptrace") == 0)
+        return true;
+
+    fprintf(stderr, "bench_check: %s: counter=%s is not an instruction count\n",
+            path, f->counter[0] ? f->counter : "?");
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    static bench_file_t base, run;
+    uint32_t tol = 5u;
+    uint32_t failed = 0;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: bench_check <baseline> <run> [tolerance %%]\n");
+        return 2;
+    }
+    if (argc > 3)
+        tol = (uint32_t)strtoul(argv[3], NULL, 10);
+
+    if (!bench_load(argv[1], &base) || !bench_load(argv[2], &run))
+        return 2;
+    if (!bench_counted(argv[1], &base) || !bench_counted(argv[2], &run))
+        return 2;
+
+    for (uint32_t i = 0; i < base.count; i++)
+    {
+        const bench_line_t *b = &base.cases[i];
+        const bench_line_t *r = bench_find(&run, b->name);
+        uint64_t limit = (uint64_t)b->p50 * (100u + tol) / 100u;
+        const char *verdict = "ok";
+
+        if (limit < (uint64_t)b->p50 + BENCH_CHECK_SLACK)
+            limit = (uint64_t)b->p50 + BENCH_CHECK_SLACK;
+
+        if (!r)
+        {
+            printf("%-28s base=%-6u run=-      MISSING\n", b->name, b->p50);
+            failed++;
+            continue;
+        }
+
+        if (r->p50 > limit)
+        {
+            verdict = "REGRESSION";
+            failed++;
+        }
+        else if ((uint64_t)r->p50 * (100u + tol) < (uint64_t)b->p50 * 100u)
+        {
+            verdict = "faster";
+        }
+
+        printf("%-28s base=%-6u run=%-6u %+6.1f%% %s\n", b->name, b->p50, r->p50,
+               b->p50 ? 100.0 * ((double)r->p50 - b->p50) / b->p50 : 0.0, verdict);
+    }
+
+    for (uint32_t i = 0; i < run.count; i++)
+    {
+        if (!bench_find(&base, run.cases[i].name))
+            printf("%-28s not in the baseline\n", run.cases[i].name);
+    }
+
+    printf("bench_check: %u of %u cases over +%u%%\n", failed, base.count, tol);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Driver bench on the host register sim.
+ *
+ * Runs the case list of examples/driver_bench against the drivers
+ * built on host/. The Makefile points BENCH_CYCLES() at sim_insns():
+ * a sample is the host instructions the call retires, the same on
+ * every run, so bench_check can hold it against bench_baseline.txt.
+ * They are not target timings. Without an instruction counter the
+ * samples fall back to host cycles (counter=tsc). The USART and I²C
+ * cases need their peripheral and are left out.
+ *
+ *   make -C tests bench-check
+ *
+ * Output is a counter= line, then the bench's key=value lines, with
+ * plain \n line ends.
+ */
+#include <stdio.h>
+#include "pic32cx1025sg61128.h"
+#include "clock_mgr.h"
+#include "scheduler.h"
+#include "irq_mgr.h"
+#include "timebase.h"
+#include "dmac_drv.h"
+#include "evsys_drv.h"
+#include "bench.h"
+#include "bench_cases.h"
+
+#define GEN_HZ          48000000u
+
+/* ================= STUBS ================= */
+bool clock_periph_enable(uint8_t pch, uint8_t gen)  { (void)pch; (void)gen; return true; }
+void clock_periph_disable(uint8_t pch)              { (void)pch; }
+uint32_t clock_periph_hz(uint8_t pch)               { (void)pch; return GEN_HZ; }
+uint32_t clock_cpu_hz(void)                         { return sim_cycles_hz(); }
+
+/* TC callbacks run in the ISR: nothing is deferred */
+bool sched_defer(void (*fn)(void *arg), void *arg)  { (void)fn; (void)arg; return false; }
+
+/* ================= OUTPUT ================= */
+static void bench_write(const char *str)
+{
+    for (; *str; str++)
+    {
+        if (*str != '\r')
+            putchar(*str);
+    }
+}
+
+int main(void)
+{
+    /* First: the ptrace source forks here */
+    const char *counter = sim_insns_init();
+
+    sim_reset();
+    irq_init();
+    timebase_init();
+    dmac_init();
+    evsys_init();
+
+    bench_cases_init();
+    bench_init();
+
+    printf("bench counter=%s\n", counter);
+
+    bench_run_suite(bench_cases, bench_case_count, bench_write);
+    return 0;
+}
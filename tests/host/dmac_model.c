@@ -0,0 +1,319 @@
+#include <string.h>
+#include "pic32cx1025sg61128.h"
+#include "dmac_drv.h"
+#include "dmac_model.h"
+
+/*
+ * The model keeps the hardware's view of each channel (interrupt
+ * flags and enables, the descriptor being executed) and reconciles it
+ * with the register block on every entry:
+ *
+ *   CHINTFLAG   a value other than the one the model left there is a
+ *               write-1-to-clear by the driver
+ *   CHINTENSET  bits written are added to the enable mask, then
+ *   CHINTENCLR  bits written are removed from it; both are left
+ *               reading the mask / 0
+ *   CHCTRLA     ENABLE cleared by the driver aborts the channel
+ *
+ * Flags cleared by the handler itself are dropped after the call.
+ */
+
+void DMAC_0_Handler(void);
+void DMAC_1_Handler(void);
+void DMAC_2_Handler(void);
+void DMAC_3_Handler(void);
+void DMAC_4_Handler(void);
+
+/* ================= STATE ================= */
+typedef struct
+{
+    bool        running;        /* Descriptor fetched, channel on a transfer */
+    bool        hold;
+    dmac_desc_t desc;           /* Descriptor being executed */
+    uint16_t    left;           /* Beats left in its block */
+    uint8_t     flags;          /* CHINTFLAG */
+    uint8_t     inten;          /* CHINTENSET / CHINTENCLR */
+    uint32_t    blocks;
+} dmac_model_ch_t;
+
+static dmac_model_ch_t model_ch[DMAC_CH_MAX];
+
+/* ================= LOCAL HELPERS ================= */
+static dmac_desc_t *model_desc_at(uint32_t addr)
+{
+    return (dmac_desc_t *)(uintptr_t)addr;
+}
+
+/* Reconcile the register block with the model after driver code ran */
+static void model_sync(uint8_t ch)
+{
+    dmac_model_ch_t *c = &model_ch[ch];
+    volatile dmac_channel_registers_t *r = &DMAC_REGS->CHANNEL[ch];
+
+    if (r->DMAC_CHINTFLAG != c->flags)
+        c->flags &= (uint8_t)~r->DMAC_CHINTFLAG;
+    r->DMAC_CHINTFLAG = c->flags;
+
+    c->inten = (uint8_t)((c->inten | r->DMAC_CHINTENSET) & ~r->DMAC_CHINTENCLR);
+    r->DMAC_CHINTENSET = c->inten;
+    r->DMAC_CHINTENCLR = 0;
+
+    if (!(r->DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk))
+        c->running = false;
+}
+
+static void model_raise(uint8_t ch, uint8_t flag)
+{
+    model_ch[ch].flags |= flag;
+    DMAC_REGS->CHANNEL[ch].DMAC_CHINTFLAG = model_ch[ch].flags;
+}
+
+static void model_stop(uint8_t ch)
+{
+    model_ch[ch].running = false;
+    DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA &= ~DMAC_CHCTRLA_ENABLE_Msk;
+}
+
+/* Fetch a descriptor; an invalid one is a transfer error */
+static bool model_load(uint8_t ch, uint32_t addr)
+{
+    dmac_model_ch_t *c = &model_ch[ch];
+
+    memcpy(&c->desc, (const void *)model_desc_at(addr), sizeof c->desc);
+
+    if (!(c->desc.btctrl & DMAC_BTCTRL_VALID_Msk))
+    {
+        model_raise(ch, DMAC_CHINTFLAG_TERR_Msk);
+        model_stop(ch);
+        return false;
+    }
+
+    c->left    = c->desc.btcnt;
+    c->running = true;
+    return true;
+}
+
+static void model_writeback(uint8_t ch)
+{
+    dmac_model_ch_t *c = &model_ch[ch];
+    dmac_desc_t *wrb = model_desc_at(DMAC_REGS->DMAC_WRBADDR) + ch;
+
+    if (c->hold && c->running)
+    {
+        DMAC_REGS->DMAC_ACTIVE = DMAC_ACTIVE_ABUSY_Msk
+                               | ((uint32_t)ch << DMAC_ACTIVE_ID_Pos)
+                               | ((uint32_t)c->left << DMAC_ACTIVE_BTCNT_Pos);
+        return;
+    }
+
+    if (((DMAC_REGS->DMAC_ACTIVE & DMAC_ACTIVE_ID_Msk) >> DMAC_ACTIVE_ID_Pos) == ch)
+        DMAC_REGS->DMAC_ACTIVE = 0;
+
+    wrb->btctrl   = c->desc.btctrl;
+    wrb->btcnt    = c->running ? c->left : 0u;
+    wrb->srcaddr  = c->desc.srcaddr;
+    wrb->dstaddr  = c->desc.dstaddr;
+    wrb->descaddr = c->desc.descaddr;
+}
+
+static void model_beat(uint8_t ch)
+{
+    dmac_model_ch_t *c = &model_ch[ch];
+    uint32_t btctrl = c->desc.btctrl;
+    uint32_t size   = 1u << ((btctrl & DMAC_BTCTRL_BEATSIZE_Msk) >> DMAC_BTCTRL_BEATSIZE_Pos);
+    uint32_t offset = (uint32_t)(c->desc.btcnt - c->left) * size;
+    uint32_t span   = (uint32_t)c->desc.btcnt * size;
+    uint32_t src    = c->desc.srcaddr;
+    uint32_t dst    = c->desc.dstaddr;
+
+    /* Incrementing addresses are END addresses in the descriptor */
+    if (btctrl & DMAC_BTCTRL_SRCINC_Msk)
+        src = src - span + offset;
+    if (btctrl & DMAC_BTCTRL_DSTINC_Msk)
+        dst = dst - span + offset;
+
+    memcpy((void *)(uintptr_t)dst, (const void *)(uintptr_t)src, size);
+    c->left--;
+}
+
+/* Block finished: interrupt, then the next descriptor or the end */
+static bool model_block_done(uint8_t ch)
+{
+    dmac_model_ch_t *c = &model_ch[ch];
+    uint32_t act = c->desc.btctrl & DMAC_BTCTRL_BLOCKACT_Msk;
+
+    c->blocks++;
+
+    if (act == DMAC_BTCTRL_BLOCKACT_INT || act == DMAC_BTCTRL_BLOCKACT_BOTH)
+        model_raise(ch, DMAC_CHINTFLAG_TCMPL_Msk);
+
+    if (c->desc.descaddr)
+        return model_load(ch, c->desc.descaddr);
+
+    model_stop(ch);
+    return false;
+}
+
+/* One trigger action of an enabled channel */
+static uint32_t model_action(uint8_t ch)
+{
+    dmac_model_ch_t *c = &model_ch[ch];
+    uint32_t ctrla   = DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA;
+    uint32_t trigact = (ctrla & DMAC_CHCTRLA_TRIGACT_Msk) >> DMAC_CHCTRLA_TRIGACT_Pos;
+    uint32_t burst   = ((ctrla & DMAC_CHCTRLA_BURSTLEN_Msk) >> DMAC_CHCTRLA_BURSTLEN_Pos) + 1u;
+    uint32_t moved   = 0;
+
+    if (!(DMAC_REGS->DMAC_CTRL & DMAC_CTRL_DMAENABLE_Msk) ||
+        !(ctrla & DMAC_CHCTRLA_ENABLE_Msk))
+        return 0;
+
+    if (!c->running)
+    {
+        if (!model_load(ch, DMAC_REGS->DMAC_BASEADDR + 16u * ch))
+            return 0;
+    }
+
+    for (;;)
+    {
+        model_beat(ch);
+        moved++;
+
+        if (c->left == 0u)
+        {
+            /* A burst or block never spans two blocks */
+            if (!model_block_done(ch) || trigact != DMAC_TRIGACT_TRANSACTION)
+                break;
+        }
+        else if (trigact == DMAC_TRIGACT_BURST && (moved % burst) == 0u)
+        {
+            break;
+        }
+    }
+
+    model_writeback(ch);
+    return moved;
+}
+
+static IRQn_Type model_irqn(uint8_t ch)
+{
+    return (ch < 4u) ? (IRQn_Type)(DMAC_0_IRQn + ch) : DMAC_4_IRQn;
+}
+
+/* ================= MODEL API ================= */
+void dmac_model_reset(void)
+{
+    memset(model_ch, 0, sizeof model_ch);
+}
+
+uint32_t dmac_model_trigger(uint8_t trigsrc)
+{
+    uint32_t moved = 0;
+
+    for (uint8_t ch = 0; ch < DMAC_CH_MAX; ch++)
+    {
+        uint32_t ctrla = DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA;
+
+        model_sync(ch);
+
+        if ((ctrla & DMAC_CHCTRLA_TRIGSRC_Msk) >> DMAC_CHCTRLA_TRIGSRC_Pos == trigsrc &&
+            trigsrc != DMAC_TRIG_DISABLE)
+            moved += model_action(ch);
+    }
+
+    dmac_model_irq();
+    return moved;
+}
+
+uint32_t dmac_model_swtrig(void)
+{
+    uint32_t pending = DMAC_REGS->DMAC_SWTRIGCTRL;
+    uint32_t moved = 0;
+
+    DMAC_REGS->DMAC_SWTRIGCTRL = 0;
+
+    for (uint8_t ch = 0; ch < DMAC_CH_MAX; ch++)
+    {
+        model_sync(ch);
+
+        if (pending & (1u << ch))
+            moved += model_action(ch);
+    }
+
+    dmac_model_irq();
+    return moved;
+}
+
+void dmac_model_irq(void)
+{
+    static void (*const handlers[5])(void) =
+    {
+        DMAC_0_Handler, DMAC_1_Handler, DMAC_2_Handler, DMAC_3_Handler, DMAC_4_Handler
+    };
+    uint8_t raised[DMAC_CH_MAX];
+    uint32_t status = 0;
+
+    for (uint8_t ch = 0; ch < DMAC_CH_MAX; ch++)
+    {
+        model_sync(ch);
+        raised[ch] = model_ch[ch].flags & model_ch[ch].inten;
+        if (raised[ch])
+            status |= 1u << ch;
+    }
+
+    while (status)
+    {
+        uint8_t ch = (uint8_t)__builtin_ctz(status);
+        IRQn_Type irq = model_irqn(ch);
+        uint32_t served = 0;
+
+        /* Every pending channel on this vector is served by one call */
+        for (uint8_t i = ch; i < DMAC_CH_MAX; i++)
+        {
+            if ((status & (1u << i)) && model_irqn(i) == irq)
+                served |= 1u << i;
+        }
+        status &= ~served;
+
+        if (!sim_irq_deliverable(irq))
+        {
+            NVIC_SetPendingIRQ(irq);
+            continue;
+        }
+
+        DMAC_REGS->DMAC_INTSTATUS = served;
+        sim_irq_call(irq, handlers[irq - DMAC_0_IRQn]);
+        DMAC_REGS->DMAC_INTSTATUS = 0;
+
+        for (uint8_t i = 0; i < DMAC_CH_MAX; i++)
+        {
+            if (served & (1u << i))
+            {
+                model_ch[i].flags &= (uint8_t)~raised[i];
+                DMAC_REGS->CHANNEL[i].DMAC_CHINTFLAG = model_ch[i].flags;
+            }
+        }
+    }
+}
+
+void dmac_model_hold(uint8_t ch, bool hold)
+{
+    model_ch[ch].hold = hold;
+    model_writeback(ch);
+}
+
+void dmac_model_bus_error(uint8_t ch)
+{
+    model_sync(ch);
+    if (!(DMAC_REGS->CHANNEL[ch].DMAC_CHCTRLA & DMAC_CHCTRLA_ENABLE_Msk))
+        return;
+
+    model_raise(ch, DMAC_CHINTFLAG_TERR_Msk);
+    model_stop(ch);
+    model_writeback(ch);
+    dmac_model_irq();
+}
+
+uint32_t dmac_model_blocks(uint8_t ch)
+{
+    return model_ch[ch].blocks;
+}
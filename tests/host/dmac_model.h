@@ -0,0 +1,54 @@
+#ifndef DMAC_MODEL_H
+#define DMAC_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * DMAC model for the host register sim.
+ *
+ * Runs the channels dmac_drv.c programs: fetches the first descriptor
+ * from BASEADDR when CHCTRLA.ENABLE is seen, moves beats per trigger
+ * action, follows DESCADDR, writes the channel state back to WRBADDR
+ * when the channel leaves the bus, raises CHINTFLAG and calls the
+ * DMAC_n_Handler of the channel when the interrupt is deliverable.
+ *
+ * Not modelled: priorities and arbitration between channels, STEPSEL
+ * / STEPSIZE, event inputs and outputs, CRC, BLOCKACT SUSPEND.
+ */
+
+/* ================= MODEL API ================= */
+
+/* Forget all channel state; call after sim_reset() */
+void dmac_model_reset(void);
+
+/*
+ * Peripheral trigger: one trigger action (beat, block or transaction
+ * per CHCTRLA.TRIGACT and BURSTLEN) on every enabled channel whose
+ * TRIGSRC is trigsrc, then dmac_model_irq(). Returns beats moved.
+ */
+uint32_t dmac_model_trigger(uint8_t trigsrc);
+
+/* Consume the SWTRIGCTRL bits: one trigger action per channel set */
+uint32_t dmac_model_swtrig(void);
+
+/* Call the handlers of channels with an enabled flag pending */
+void dmac_model_irq(void);
+
+/*
+ * Keep ch on the bus between trigger actions: ACTIVE shows its live
+ * beat count and its write-back is not updated until released.
+ */
+void dmac_model_hold(uint8_t ch, bool hold);
+
+/*
+ * Bus error on ch (descriptor fetch or beat): TERR, channel disabled,
+ * write-back updated, then dmac_model_irq(). Ignored unless ch is
+ * enabled.
+ */
+void dmac_model_bus_error(uint8_t ch);
+
+/* Block transfers completed by ch since reset */
+uint32_t dmac_model_blocks(uint8_t ch);
+
+#endif /* DMAC_MODEL_H */
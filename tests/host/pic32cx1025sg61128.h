@@ -0,0 +1,706 @@
+#ifndef HOST_PIC32CX1025SG61128_H
+#define HOST_PIC32CX1025SG61128_H
+
+/*
+ * Register-sim device header for host builds.
+ *
+ * Same names, layouts and bit positions as the DFP header, for the
+ * modules the host tests compile. Every peripheral is a struct in RAM
+ * (sim.c), so a driver built against this header stores exactly the
+ * values it would store on the target; the models in this directory
+ * read them back and play the part of the hardware when a test steps
+ * them.
+ *
+ * A store to RAM cannot be trapped, which sets three rules:
+ *   - SYNCBUSY registers read 0: synchronisation is instant
+ *   - SWRST bits a driver polls in the register it wrote are 0 here:
+ *     the reset write clears the register and the poll falls through
+ *   - set / clear and write-1-to-clear registers keep the last value
+ *     written until a model interprets them
+ *
+ * The drivers keep addresses in 32-bit registers and descriptors.
+ * Host binaries are linked -no-pie and keep DMA buffers in static
+ * storage, so every such address fits.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define __I     volatile        /* Writable: models drive status registers */
+#define __O     volatile
+#define __IO    volatile
+
+/* ================= INTERRUPT NUMBERS ================= */
+#define __NVIC_PRIO_BITS    3
+
+typedef enum IRQn
+{
+    NonMaskableInt_IRQn     = -14,
+    HardFault_IRQn          = -13,
+    SVCall_IRQn             = -5,
+    PendSV_IRQn             = -2,
+    SysTick_IRQn            = -1,
+
+    RTC_IRQn                = 11,
+    DMAC_0_IRQn             = 31,
+    DMAC_1_IRQn             = 32,
+    DMAC_2_IRQn             = 33,
+    DMAC_3_IRQn             = 34,
+    DMAC_4_IRQn             = 35,
+    EVSYS_0_IRQn            = 36,
+    EVSYS_1_IRQn            = 37,
+    EVSYS_2_IRQn            = 38,
+    EVSYS_3_IRQn            = 39,
+    EVSYS_4_IRQn            = 40,
+    SERCOM0_0_IRQn          = 46,
+    SERCOM1_0_IRQn          = 50,
+    SERCOM2_0_IRQn          = 54,
+    SERCOM3_0_IRQn          = 58,
+    SERCOM4_0_IRQn          = 62,
+    SERCOM5_0_IRQn          = 66,
+    SERCOM6_0_IRQn          = 70,
+    SERCOM7_0_IRQn          = 74,
+    TC0_IRQn                = 107,
+    TC1_IRQn                = 108,
+    TC2_IRQn                = 109,
+    TC3_IRQn                = 110,
+    TC4_IRQn                = 111,
+    TC5_IRQn                = 112,
+    TC6_IRQn                = 113,
+    TC7_IRQn                = 114,
+
+    PERIPH_MAX_IRQn         = 136
+} IRQn_Type;
+
+/* ================= CORE STATE ================= */
+/*
+ * PRIMASK, BASEPRI and the NVIC as plain variables. Models ask
+ * sim_irq_deliverable() before calling a handler and set ipsr around
+ * the call.
+ */
+typedef struct
+{
+    uint32_t primask;
+    uint32_t basepri;
+    uint32_t ipsr;
+    uint32_t enabled[8];
+    uint32_t pending[8];
+    uint8_t  priority[256];
+} sim_core_t;
+
+extern sim_core_t sim_core;
+
+/* ================= CMSIS INTRINSICS ================= */
+static inline void __disable_irq(void)          { sim_core.primask = 1u; }
+static inline void __enable_irq(void)           { sim_core.primask = 0u; }
+static inline uint32_t __get_PRIMASK(void)      { return sim_core.primask; }
+static inline void __set_PRIMASK(uint32_t v)    { sim_core.primask = v & 1u; }
+static inline uint32_t __get_BASEPRI(void)      { return sim_core.basepri; }
+static inline void __set_BASEPRI(uint32_t v)    { sim_core.basepri = v & 0xFFu; }
+static inline uint32_t __get_IPSR(void)         { return sim_core.ipsr; }
+
+static inline void __set_BASEPRI_MAX(uint32_t v)
+{
+    v &= 0xFFu;
+    if (v != 0u && (sim_core.basepri == 0u || v < sim_core.basepri))
+        sim_core.basepri = v;
+}
+
+static inline void __DSB(void)  { __asm__ volatile ("" ::: "memory"); }
+static inline void __DMB(void)  { __asm__ volatile ("" ::: "memory"); }
+static inline void __ISB(void)  { __asm__ volatile ("" ::: "memory"); }
+static inline void __WFI(void)  { }
+static inline void __NOP(void)  { }
+
+/* Single-threaded host: the exclusive pair always succeeds */
+static inline uint32_t __LDREXW(volatile uint32_t *addr)            { return *addr; }
+static inline uint32_t __STREXW(uint32_t v, volatile uint32_t *addr) { *addr = v; return 0u; }
+static inline void __CLREX(void) { }
+
+static inline uint32_t __CLZ(uint32_t v)  { return v ? (uint32_t)__builtin_clz(v) : 32u; }
+static inline uint32_t __RBIT(uint32_t v)
+{
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < 32u; i++, v >>= 1)
+        r = (r << 1) | (v & 1u);
+    return r;
+}
+
+/* ================= NVIC ================= */
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    if ((int32_t)irq >= 0)
+        sim_core.enabled[irq >> 5] |= 1u << (irq & 31);
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    if ((int32_t)irq >= 0)
+        sim_core.enabled[irq >> 5] &= ~(1u << (irq & 31));
+}
+
+static inline uint32_t NVIC_GetEnableIRQ(IRQn_Type irq)
+{
+    return ((int32_t)irq >= 0) ? (sim_core.enabled[irq >> 5] >> (irq & 31)) & 1u : 0u;
+}
+
+static inline void NVIC_SetPendingIRQ(IRQn_Type irq)
+{
+    if ((int32_t)irq >= 0)
+        sim_core.pending[irq >> 5] |= 1u << (irq & 31);
+}
+
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+    if ((int32_t)irq >= 0)
+        sim_core.pending[irq >> 5] &= ~(1u << (irq & 31));
+}
+
+static inline uint32_t NVIC_GetPendingIRQ(IRQn_Type irq)
+{
+    return ((int32_t)irq >= 0) ? (sim_core.pending[irq >> 5] >> (irq & 31)) & 1u : 0u;
+}
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+    sim_core.priority[(uint8_t)irq] = (uint8_t)(priority << (8u - __NVIC_PRIO_BITS));
+}
+
+static inline uint32_t NVIC_GetPriority(IRQn_Type irq)
+{
+    return (uint32_t)sim_core.priority[(uint8_t)irq] >> (8u - __NVIC_PRIO_BITS);
+}
+
+/* ================= DWT / CoreDebug ================= */
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DHCSR;
+    __O  uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (0x1u << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk      (0x1u << 24)
+
+extern DWT_Type       sim_dwt;
+extern CoreDebug_Type sim_coredebug;
+
+/*
+ * CYCCNT counts host time: once TRCENA and CYCCNTENA are set, every
+ * access through DWT reloads it from sim_cycles(). A value written to
+ * it is lost on the next access.
+ */
+DWT_Type *sim_dwt_now(void);
+
+#define DWT             (sim_dwt_now())
+#define CoreDebug       (&sim_coredebug)
+
+/* ================= MCLK ================= */
+typedef struct
+{
+    __I  uint8_t  Reserved1[0x01];
+    __IO uint8_t  MCLK_INTENCLR;
+    __IO uint8_t  MCLK_INTENSET;
+    __IO uint8_t  MCLK_INTFLAG;
+    __I  uint8_t  MCLK_HSDIV;
+    __IO uint8_t  MCLK_CPUDIV;
+    __I  uint8_t  Reserved2[0x0A];
+    __IO uint32_t MCLK_AHBMASK;
+    __IO uint32_t MCLK_APBAMASK;
+    __IO uint32_t MCLK_APBBMASK;
+    __IO uint32_t MCLK_APBCMASK;
+    __IO uint32_t MCLK_APBDMASK;
+} mclk_registers_t;
+
+#define MCLK_AHBMASK_DMAC_Msk           (0x1u << 9)
+#define MCLK_APBAMASK_SERCOM0_Msk       (0x1u << 12)
+#define MCLK_APBAMASK_SERCOM1_Msk       (0x1u << 13)
+#define MCLK_APBAMASK_TC0_Msk           (0x1u << 14)
+#define MCLK_APBAMASK_TC1_Msk           (0x1u << 15)
+#define MCLK_APBBMASK_EVSYS_Msk         (0x1u << 7)
+#define MCLK_APBBMASK_SERCOM2_Msk       (0x1u << 9)
+#define MCLK_APBBMASK_SERCOM3_Msk       (0x1u << 10)
+#define MCLK_APBBMASK_TC2_Msk           (0x1u << 13)
+#define MCLK_APBBMASK_TC3_Msk           (0x1u << 14)
+#define MCLK_APBCMASK_TC4_Msk           (0x1u << 5)
+#define MCLK_APBCMASK_TC5_Msk           (0x1u << 6)
+#define MCLK_APBDMASK_SERCOM4_Msk       (0x1u << 0)
+#define MCLK_APBDMASK_SERCOM5_Msk       (0x1u << 1)
+#define MCLK_APBDMASK_SERCOM6_Msk       (0x1u << 2)
+#define MCLK_APBDMASK_SERCOM7_Msk       (0x1u << 3)
+#define MCLK_APBDMASK_TC6_Msk           (0x1u << 4)
+#define MCLK_APBDMASK_TC7_Msk           (0x1u << 5)
+
+/* ================= DMAC ================= */
+typedef struct
+{
+    __IO uint32_t DMAC_CHCTRLA;
+    __IO uint8_t  DMAC_CHCTRLB;
+    __IO uint8_t  DMAC_CHPRILVL;
+    __IO uint8_t  DMAC_CHEVCTRL;
+    __I  uint8_t  Reserved1[0x05];
+    __IO uint8_t  DMAC_CHINTENCLR;
+    __IO uint8_t  DMAC_CHINTENSET;
+    __IO uint8_t  DMAC_CHINTFLAG;
+    __I  uint8_t  DMAC_CHSTATUS;
+} dmac_channel_registers_t;
+
+typedef struct
+{
+    __IO uint16_t DMAC_CTRL;
+    __IO uint16_t DMAC_CRCCTRL;
+    __IO uint32_t DMAC_CRCDATAIN;
+    __IO uint32_t DMAC_CRCCHKSUM;
+    __IO uint8_t  DMAC_CRCSTATUS;
+    __IO uint8_t  DMAC_DBGCTRL;
+    __I  uint8_t  Reserved1[0x02];
+    __IO uint32_t DMAC_SWTRIGCTRL;
+    __IO uint32_t DMAC_PRICTRL0;
+    __I  uint8_t  Reserved2[0x08];
+    __IO uint16_t DMAC_INTPEND;
+    __I  uint8_t  Reserved3[0x02];
+    __I  uint32_t DMAC_INTSTATUS;
+    __I  uint32_t DMAC_BUSYCH;
+    __I  uint32_t DMAC_PENDCH;
+    __I  uint32_t DMAC_ACTIVE;
+    __IO uint32_t DMAC_BASEADDR;
+    __IO uint32_t DMAC_WRBADDR;
+    __I  uint8_t  Reserved4[0x0C];
+    dmac_channel_registers_t CHANNEL[32];
+} dmac_registers_t;
+
+#define DMAC_CTRL_SWRST_Msk             (0x0u)          /* Sim: instant reset */
+#define DMAC_CTRL_DMAENABLE_Msk         (0x1u << 1)
+#define DMAC_CTRL_LVLEN0_Msk            (0x1u << 8)
+#define DMAC_CTRL_LVLEN1_Msk            (0x1u << 9)
+#define DMAC_CTRL_LVLEN2_Msk            (0x1u << 10)
+#define DMAC_CTRL_LVLEN3_Msk            (0x1u << 11)
+
+#define DMAC_CHCTRLA_SWRST_Msk          (0x0u)          /* Sim: instant reset */
+#define DMAC_CHCTRLA_ENABLE_Msk         (0x1u << 1)
+#define DMAC_CHCTRLA_TRIGSRC_Pos        8u
+#define DMAC_CHCTRLA_TRIGSRC_Msk        (0x7Fu << DMAC_CHCTRLA_TRIGSRC_Pos)
+#define DMAC_CHCTRLA_TRIGSRC(value)     (DMAC_CHCTRLA_TRIGSRC_Msk & ((uint32_t)(value) << DMAC_CHCTRLA_TRIGSRC_Pos))
+#define DMAC_CHCTRLA_TRIGACT_Pos        20u
+#define DMAC_CHCTRLA_TRIGACT_Msk        (0x3u << DMAC_CHCTRLA_TRIGACT_Pos)
+#define DMAC_CHCTRLA_TRIGACT(value)     (DMAC_CHCTRLA_TRIGACT_Msk & ((uint32_t)(value) << DMAC_CHCTRLA_TRIGACT_Pos))
+#define DMAC_CHCTRLA_BURSTLEN_Pos       24u
+#define DMAC_CHCTRLA_BURSTLEN_Msk       (0xFu << DMAC_CHCTRLA_BURSTLEN_Pos)
+#define DMAC_CHCTRLA_BURSTLEN_SINGLE    (0x0u << DMAC_CHCTRLA_BURSTLEN_Pos)
+
+#define DMAC_CHEVCTRL_EVACT_Pos         0u
+#define DMAC_CHEVCTRL_EVACT_Msk         (0x7u << DMAC_CHEVCTRL_EVACT_Pos)
+#define DMAC_CHEVCTRL_EVACT(value)      (DMAC_CHEVCTRL_EVACT_Msk & ((uint32_t)(value) << DMAC_CHEVCTRL_EVACT_Pos))
+#define DMAC_CHEVCTRL_EVIE_Msk          (0x1u << 6)
+
+#define DMAC_CHINTENCLR_TERR_Msk        (0x1u << 0)
+#define DMAC_CHINTENCLR_TCMPL_Msk       (0x1u << 1)
+#define DMAC_CHINTENCLR_SUSP_Msk        (0x1u << 2)
+#define DMAC_CHINTENSET_TERR_Msk        (0x1u << 0)
+#define DMAC_CHINTENSET_TCMPL_Msk       (0x1u << 1)
+#define DMAC_CHINTENSET_SUSP_Msk        (0x1u << 2)
+#define DMAC_CHINTFLAG_TERR_Msk         (0x1u << 0)
+#define DMAC_CHINTFLAG_TCMPL_Msk        (0x1u << 1)
+#define DMAC_CHINTFLAG_SUSP_Msk         (0x1u << 2)
+
+#define DMAC_BTCTRL_VALID_Msk           (0x1u << 0)
+#define DMAC_BTCTRL_BLOCKACT_Pos        3u
+#define DMAC_BTCTRL_BLOCKACT_Msk        (0x3u << DMAC_BTCTRL_BLOCKACT_Pos)
+#define DMAC_BTCTRL_BLOCKACT_NOACT      (0x0u << DMAC_BTCTRL_BLOCKACT_Pos)
+#define DMAC_BTCTRL_BLOCKACT_INT        (0x1u << DMAC_BTCTRL_BLOCKACT_Pos)
+#define DMAC_BTCTRL_BLOCKACT_SUSPEND    (0x2u << DMAC_BTCTRL_BLOCKACT_Pos)
+#define DMAC_BTCTRL_BLOCKACT_BOTH       (0x3u << DMAC_BTCTRL_BLOCKACT_Pos)
+#define DMAC_BTCTRL_BEATSIZE_Pos        8u
+#define DMAC_BTCTRL_BEATSIZE_Msk        (0x3u << DMAC_BTCTRL_BEATSIZE_Pos)
+#define DMAC_BTCTRL_BEATSIZE(value)     (DMAC_BTCTRL_BEATSIZE_Msk & ((uint32_t)(value) << DMAC_BTCTRL_BEATSIZE_Pos))
+#define DMAC_BTCTRL_SRCINC_Msk          (0x1u << 10)
+#define DMAC_BTCTRL_DSTINC_Msk          (0x1u << 11)
+
+#define DMAC_ACTIVE_ID_Pos              8u
+#define DMAC_ACTIVE_ID_Msk              (0x1Fu << DMAC_ACTIVE_ID_Pos)
+#define DMAC_ACTIVE_ABUSY_Msk           (0x1u << 15)
+#define DMAC_ACTIVE_BTCNT_Pos           16u
+#define DMAC_ACTIVE_BTCNT_Msk           (0xFFFFu << DMAC_ACTIVE_BTCNT_Pos)
+
+/* ================= PORT ================= */
+typedef struct
+{
+    __IO uint32_t PORT_DIR;
+    __IO uint32_t PORT_DIRCLR;
+    __IO uint32_t PORT_DIRSET;
+    __IO uint32_t PORT_DIRTGL;
+    __IO uint32_t PORT_OUT;
+    __IO uint32_t PORT_OUTCLR;
+    __IO uint32_t PORT_OUTSET;
+    __IO uint32_t PORT_OUTTGL;
+    __I  uint32_t PORT_IN;
+    __IO uint32_t PORT_CTRL;
+    __O  uint32_t PORT_WRCONFIG;
+    __IO uint32_t PORT_EVCTRL;
+    __IO uint8_t  PORT_PMUX[16];
+    __IO uint8_t  PORT_PINCFG[32];
+    __I  uint8_t  Reserved1[0x20];
+} port_group_registers_t;
+
+typedef struct
+{
+    port_group_registers_t GROUP[4];
+} port_registers_t;
+
+#define PORT_PINCFG_PMUXEN_Msk          (0x1u << 0)
+#define PORT_PINCFG_INEN_Msk            (0x1u << 1)
+#define PORT_PINCFG_PULLEN_Msk          (0x1u << 2)
+
+#define PORT_WRCONFIG_PINMASK_Pos       0u
+#define PORT_WRCONFIG_PINMASK_Msk       (0xFFFFu << PORT_WRCONFIG_PINMASK_Pos)
+#define PORT_WRCONFIG_PINMASK(value)    (PORT_WRCONFIG_PINMASK_Msk & ((uint32_t)(value) << PORT_WRCONFIG_PINMASK_Pos))
+#define PORT_WRCONFIG_PMUXEN_Msk        (0x1u << 16)
+#define PORT_WRCONFIG_INEN_Msk          (0x1u << 17)
+#define PORT_WRCONFIG_PULLEN_Msk        (0x1u << 18)
+#define PORT_WRCONFIG_WRPMUX_Msk        (0x1u << 28)
+#define PORT_WRCONFIG_WRPINCFG_Msk      (0x1u << 30)
+#define PORT_WRCONFIG_HWSEL_Msk         (0x1u << 31)
+
+/* ================= EVSYS ================= */
+typedef struct
+{
+    __IO uint32_t EVSYS_CHANNEL;
+    __IO uint8_t  EVSYS_CHINTENCLR;
+    __IO uint8_t  EVSYS_CHINTENSET;
+    __IO uint8_t  EVSYS_CHINTFLAG;
+    __I  uint8_t  EVSYS_CHSTATUS;
+} evsys_channel_registers_t;
+
+typedef struct
+{
+    __IO uint8_t  EVSYS_CTRLA;
+    __I  uint8_t  Reserved1[0x03];
+    __O  uint32_t EVSYS_SWEVT;
+    __IO uint8_t  EVSYS_PRICTRL;
+    __I  uint8_t  Reserved2[0x07];
+    __IO uint16_t EVSYS_INTPEND;
+    __I  uint8_t  Reserved3[0x02];
+    __I  uint32_t EVSYS_INTSTATUS;
+    __I  uint32_t EVSYS_BUSYCH;
+    __I  uint32_t EVSYS_READYUSR;
+    evsys_channel_registers_t CHANNEL[32];
+    __IO uint8_t  EVSYS_USER[67];
+} evsys_registers_t;
+
+#define EVSYS_CTRLA_SWRST_Msk           (0x0u)          /* Sim: instant reset */
+
+#define EVSYS_CHANNEL_EVGEN_Pos         0u
+#define EVSYS_CHANNEL_EVGEN_Msk         (0x7Fu << EVSYS_CHANNEL_EVGEN_Pos)
+#define EVSYS_CHANNEL_EVGEN(value)      (EVSYS_CHANNEL_EVGEN_Msk & ((uint32_t)(value) << EVSYS_CHANNEL_EVGEN_Pos))
+#define EVSYS_CHANNEL_PATH_Pos          8u
+#define EVSYS_CHANNEL_PATH_Msk          (0x3u << EVSYS_CHANNEL_PATH_Pos)
+#define EVSYS_CHANNEL_PATH(value)       (EVSYS_CHANNEL_PATH_Msk & ((uint32_t)(value) << EVSYS_CHANNEL_PATH_Pos))
+#define EVSYS_CHANNEL_EDGSEL_Pos        10u
+#define EVSYS_CHANNEL_EDGSEL_Msk        (0x3u << EVSYS_CHANNEL_EDGSEL_Pos)
+#define EVSYS_CHANNEL_EDGSEL(value)     (EVSYS_CHANNEL_EDGSEL_Msk & ((uint32_t)(value) << EVSYS_CHANNEL_EDGSEL_Pos))
+#define EVSYS_CHANNEL_ONDEMAND_Msk      (0x1u << 15)
+
+#define EVSYS_CHINTENCLR_OVR_Msk        (0x1u << 0)
+#define EVSYS_CHINTENCLR_EVD_Msk        (0x1u << 1)
+#define EVSYS_CHINTENCLR_Msk            (0x3u)
+
+#define EVSYS_CHSTATUS_RDYUSR_Msk       (0x1u << 0)
+#define EVSYS_CHSTATUS_BUSYCH_Msk       (0x1u << 1)
+
+#define EVSYS_USER_CHANNEL_Pos          0u
+#define EVSYS_USER_CHANNEL_Msk          (0x3Fu << EVSYS_USER_CHANNEL_Pos)
+#define EVSYS_USER_CHANNEL(value)       (EVSYS_USER_CHANNEL_Msk & ((uint32_t)(value) << EVSYS_USER_CHANNEL_Pos))
+
+/* ================= SERCOM ================= */
+typedef struct
+{
+    __IO uint32_t SERCOM_CTRLA;
+    __IO uint32_t SERCOM_CTRLB;
+    __IO uint32_t SERCOM_CTRLC;
+    __IO uint16_t SERCOM_BAUD;
+    __IO uint8_t  SERCOM_RXPL;
+    __I  uint8_t  Reserved1[0x05];
+    __IO uint8_t  SERCOM_INTENCLR;
+    __I  uint8_t  Reserved2[0x01];
+    __IO uint8_t  SERCOM_INTENSET;
+    __I  uint8_t  Reserved3[0x01];
+    __IO uint8_t  SERCOM_INTFLAG;
+    __I  uint8_t  Reserved4[0x01];
+    __IO uint16_t SERCOM_STATUS;
+    __I  uint32_t SERCOM_SYNCBUSY;
+    __I  uint8_t  SERCOM_RXERRCNT;
+    __I  uint8_t  Reserved5[0x01];
+    __IO uint16_t SERCOM_LENGTH;
+    __I  uint8_t  Reserved6[0x04];
+    __IO uint32_t SERCOM_DATA;
+    __I  uint8_t  Reserved7[0x04];
+    __IO uint8_t  SERCOM_DBGCTRL;
+} sercom_usart_int_registers_t;
+
+typedef struct
+{
+    __IO uint32_t SERCOM_CTRLA;
+    __IO uint32_t SERCOM_CTRLB;
+    __IO uint32_t SERCOM_CTRLC;
+    __IO uint8_t  SERCOM_BAUD;
+    __I  uint8_t  Reserved1[0x07];
+    __IO uint8_t  SERCOM_INTENCLR;
+    __I  uint8_t  Reserved2[0x01];
+    __IO uint8_t  SERCOM_INTENSET;
+    __I  uint8_t  Reserved3[0x01];
+    __IO uint8_t  SERCOM_INTFLAG;
+    __I  uint8_t  Reserved4[0x01];
+    __IO uint16_t SERCOM_STATUS;
+    __I  uint32_t SERCOM_SYNCBUSY;
+    __I  uint8_t  Reserved5[0x02];
+    __IO uint16_t SERCOM_LENGTH;
+    __IO uint32_t SERCOM_ADDR;
+    __IO uint32_t SERCOM_DATA;
+    __I  uint8_t  Reserved6[0x04];
+    __IO uint8_t  SERCOM_DBGCTRL;
+} sercom_spim_registers_t;
+
+typedef union
+{
+    sercom_usart_int_registers_t USART_INT;
+    sercom_spim_registers_t      SPIM;
+} sercom_registers_t;
+
+#define SERCOM_USART_INT_CTRLA_SWRST_Msk        (0x1u << 0)
+#define SERCOM_USART_INT_CTRLA_ENABLE_Msk       (0x1u << 1)
+#define SERCOM_USART_INT_SYNCBUSY_SWRST_Msk     (0x1u << 0)
+#define SERCOM_USART_INT_SYNCBUSY_ENABLE_Msk    (0x1u << 1)
+
+#define SERCOM_SPIM_CTRLA_SWRST_Msk             (0x1u << 0)
+#define SERCOM_SPIM_CTRLA_ENABLE_Msk            (0x1u << 1)
+#define SERCOM_SPIM_CTRLA_MODE_Pos              2u
+#define SERCOM_SPIM_CTRLA_MODE_Msk              (0x7u << SERCOM_SPIM_CTRLA_MODE_Pos)
+#define SERCOM_SPIM_CTRLA_MODE_SPI_MASTER       (0x3u << SERCOM_SPIM_CTRLA_MODE_Pos)
+#define SERCOM_SPIM_CTRLA_DOPO_Pos              16u
+#define SERCOM_SPIM_CTRLA_DOPO_Msk              (0x3u << SERCOM_SPIM_CTRLA_DOPO_Pos)
+#define SERCOM_SPIM_CTRLA_DOPO(value)           (SERCOM_SPIM_CTRLA_DOPO_Msk & ((uint32_t)(value) << SERCOM_SPIM_CTRLA_DOPO_Pos))
+#define SERCOM_SPIM_CTRLA_DIPO_Pos              20u
+#define SERCOM_SPIM_CTRLA_DIPO_Msk              (0x3u << SERCOM_SPIM_CTRLA_DIPO_Pos)
+#define SERCOM_SPIM_CTRLA_DIPO(value)           (SERCOM_SPIM_CTRLA_DIPO_Msk & ((uint32_t)(value) << SERCOM_SPIM_CTRLA_DIPO_Pos))
+#define SERCOM_SPIM_CTRLA_CPHA_Msk              (0x1u << 28)
+#define SERCOM_SPIM_CTRLA_CPOL_Msk              (0x1u << 29)
+#define SERCOM_SPIM_CTRLA_DORD_Msk              (0x1u << 30)
+
+#define SERCOM_SPIM_CTRLB_CHSIZE_Pos            0u
+#define SERCOM_SPIM_CTRLB_CHSIZE_Msk            (0x7u << SERCOM_SPIM_CTRLB_CHSIZE_Pos)
+#define SERCOM_SPIM_CTRLB_CHSIZE(value)         (SERCOM_SPIM_CTRLB_CHSIZE_Msk & ((uint32_t)(value) << SERCOM_SPIM_CTRLB_CHSIZE_Pos))
+#define SERCOM_SPIM_CTRLB_MSSEN_Msk             (0x1u << 13)
+#define SERCOM_SPIM_CTRLB_RXEN_Msk              (0x1u << 17)
+
+#define SERCOM_SPIM_INTFLAG_DRE_Msk             (0x1u << 0)
+#define SERCOM_SPIM_INTFLAG_TXC_Msk             (0x1u << 1)
+#define SERCOM_SPIM_INTFLAG_RXC_Msk             (0x1u << 2)
+
+#define SERCOM_SPIM_STATUS_BUFOVF_Msk           (0x1u << 2)
+
+#define SERCOM_SPIM_SYNCBUSY_SWRST_Msk          (0x1u << 0)
+#define SERCOM_SPIM_SYNCBUSY_ENABLE_Msk         (0x1u << 1)
+#define SERCOM_SPIM_SYNCBUSY_CTRLB_Msk          (0x1u << 2)
+
+/* ================= TC ================= */
+typedef struct
+{
+    __IO uint32_t TC_CTRLA;
+    __IO uint8_t  TC_CTRLBCLR;
+    __IO uint8_t  TC_CTRLBSET;
+    __IO uint16_t TC_EVCTRL;
+    __IO uint8_t  TC_INTENCLR;
+    __IO uint8_t  TC_INTENSET;
+    __IO uint8_t  TC_INTFLAG;
+    __IO uint8_t  TC_STATUS;
+    __IO uint8_t  TC_WAVE;
+    __IO uint8_t  TC_DRVCTRL;
+    __I  uint8_t  Reserved1[0x01];
+    __IO uint8_t  TC_DBGCTRL;
+    __I  uint32_t TC_SYNCBUSY;
+    __IO uint8_t  TC_COUNT;
+    __I  uint8_t  Reserved2[0x06];
+    __IO uint8_t  TC_PER;
+    __IO uint8_t  TC_CC[2];
+    __I  uint8_t  Reserved3[0x11];
+    __IO uint8_t  TC_PERBUF;
+    __IO uint8_t  TC_CCBUF[2];
+} tc_count8_registers_t;
+
+typedef struct
+{
+    __IO uint32_t TC_CTRLA;
+    __IO uint8_t  TC_CTRLBCLR;
+    __IO uint8_t  TC_CTRLBSET;
+    __IO uint16_t TC_EVCTRL;
+    __IO uint8_t  TC_INTENCLR;
+    __IO uint8_t  TC_INTENSET;
+    __IO uint8_t  TC_INTFLAG;
+    __IO uint8_t  TC_STATUS;
+    __IO uint8_t  TC_WAVE;
+    __IO uint8_t  TC_DRVCTRL;
+    __I  uint8_t  Reserved1[0x01];
+    __IO uint8_t  TC_DBGCTRL;
+    __I  uint32_t TC_SYNCBUSY;
+    __IO uint16_t TC_COUNT;
+    __I  uint8_t  Reserved2[0x06];
+    __IO uint16_t TC_CC[2];
+    __I  uint8_t  Reserved3[0x10];
+    __IO uint16_t TC_CCBUF[2];
+} tc_count16_registers_t;
+
+typedef struct
+{
+    __IO uint32_t TC_CTRLA;
+    __IO uint8_t  TC_CTRLBCLR;
+    __IO uint8_t  TC_CTRLBSET;
+    __IO uint16_t TC_EVCTRL;
+    __IO uint8_t  TC_INTENCLR;
+    __IO uint8_t  TC_INTENSET;
+    __IO uint8_t  TC_INTFLAG;
+    __IO uint8_t  TC_STATUS;
+    __IO uint8_t  TC_WAVE;
+    __IO uint8_t  TC_DRVCTRL;
+    __I  uint8_t  Reserved1[0x01];
+    __IO uint8_t  TC_DBGCTRL;
+    __I  uint32_t TC_SYNCBUSY;
+    __IO uint32_t TC_COUNT;
+    __I  uint8_t  Reserved2[0x04];
+    __IO uint32_t TC_CC[2];
+    __I  uint8_t  Reserved3[0x0C];
+    __IO uint32_t TC_CCBUF[2];
+} tc_count32_registers_t;
+
+typedef union
+{
+    tc_count8_registers_t  COUNT8;
+    tc_count16_registers_t COUNT16;
+    tc_count32_registers_t COUNT32;
+} tc_registers_t;
+
+#define TC_CTRLA_SWRST_Msk              (0x1u << 0)
+#define TC_CTRLA_ENABLE_Msk             (0x1u << 1)
+#define TC_CTRLA_MODE_Pos               2u
+#define TC_CTRLA_MODE_Msk               (0x3u << TC_CTRLA_MODE_Pos)
+#define TC_CTRLA_MODE(value)            (TC_CTRLA_MODE_Msk & ((uint32_t)(value) << TC_CTRLA_MODE_Pos))
+#define TC_CTRLA_PRESCALER_Pos          8u
+#define TC_CTRLA_PRESCALER_Msk          (0x7u << TC_CTRLA_PRESCALER_Pos)
+#define TC_CTRLA_PRESCALER(value)       (TC_CTRLA_PRESCALER_Msk & ((uint32_t)(value) << TC_CTRLA_PRESCALER_Pos))
+#define TC_CTRLA_CAPTEN0_Pos            16u
+#define TC_CTRLA_COPEN0_Pos             20u
+
+#define TC_CTRLBCLR_DIR_Msk             (0x1u << 0)
+#define TC_CTRLBCLR_LUPD_Msk            (0x1u << 1)
+#define TC_CTRLBSET_DIR_Msk             (0x1u << 0)
+#define TC_CTRLBSET_LUPD_Msk            (0x1u << 1)
+#define TC_CTRLBSET_ONESHOT_Msk         (0x1u << 2)
+#define TC_CTRLBSET_CMD_Pos             5u
+#define TC_CTRLBSET_CMD_Msk             (0x7u << TC_CTRLBSET_CMD_Pos)
+#define TC_CTRLBSET_CMD_READSYNC        (0x4u << TC_CTRLBSET_CMD_Pos)
+
+#define TC_EVCTRL_EVACT_Pos             0u
+#define TC_EVCTRL_EVACT_Msk             (0x7u << TC_EVCTRL_EVACT_Pos)
+#define TC_EVCTRL_EVACT(value)          (TC_EVCTRL_EVACT_Msk & ((uint32_t)(value) << TC_EVCTRL_EVACT_Pos))
+#define TC_EVCTRL_EVACT_PPW             (0x5u << TC_EVCTRL_EVACT_Pos)
+#define TC_EVCTRL_EVACT_PWP             (0x6u << TC_EVCTRL_EVACT_Pos)
+#define TC_EVCTRL_EVACT_PW              (0x7u << TC_EVCTRL_EVACT_Pos)
+#define TC_EVCTRL_TCINV_Msk             (0x1u << 4)
+#define TC_EVCTRL_TCEI_Msk              (0x1u << 5)
+
+#define TC_INTENCLR_Msk                 (0x33u)
+#define TC_INTENSET_OVF_Msk             (0x1u << 0)
+#define TC_INTENSET_MC0_Msk             (0x1u << 4)
+#define TC_INTFLAG_OVF_Msk              (0x1u << 0)
+#define TC_INTFLAG_ERR_Msk              (0x1u << 1)
+#define TC_INTFLAG_MC0_Msk              (0x1u << 4)
+#define TC_INTFLAG_MC1_Msk              (0x1u << 5)
+#define TC_INTFLAG_Msk                  (0x33u)
+
+#define TC_STATUS_PERBUFV_Msk           (0x1u << 3)
+#define TC_STATUS_CCBUFV0_Msk           (0x1u << 4)
+#define TC_STATUS_CCBUFV1_Msk           (0x1u << 5)
+
+#define TC_DRVCTRL_INVEN0_Pos           0u
+
+#define TC_SYNCBUSY_SWRST_Msk           (0x1u << 0)
+#define TC_SYNCBUSY_ENABLE_Msk          (0x1u << 1)
+#define TC_SYNCBUSY_CTRLB_Msk           (0x1u << 2)
+#define TC_SYNCBUSY_STATUS_Msk          (0x1u << 3)
+#define TC_SYNCBUSY_COUNT_Msk           (0x1u << 4)
+#define TC_SYNCBUSY_PER_Msk             (0x1u << 5)
+#define TC_SYNCBUSY_CC0_Msk             (0x1u << 6)
+#define TC_SYNCBUSY_CC1_Msk             (0x1u << 7)
+
+/* ================= INSTANCES ================= */
+extern mclk_registers_t sim_mclk;
+extern dmac_registers_t sim_dmac;
+extern port_registers_t sim_port;
+extern evsys_registers_t sim_evsys;
+extern tc_registers_t   sim_tc[8];
+extern sercom_registers_t sim_sercom[8];
+
+#define MCLK_REGS       (&sim_mclk)
+#define DMAC_REGS       (&sim_dmac)
+#define PORT_REGS       (&sim_port)
+#define EVSYS_REGS      (&sim_evsys)
+#define TC0_REGS        (&sim_tc[0])
+#define TC1_REGS        (&sim_tc[1])
+#define TC2_REGS        (&sim_tc[2])
+#define TC3_REGS        (&sim_tc[3])
+#define TC4_REGS        (&sim_tc[4])
+#define TC5_REGS        (&sim_tc[5])
+#define TC6_REGS        (&sim_tc[6])
+#define TC7_REGS        (&sim_tc[7])
+#define SERCOM0_REGS    (&sim_sercom[0])
+#define SERCOM1_REGS    (&sim_sercom[1])
+#define SERCOM2_REGS    (&sim_sercom[2])
+#define SERCOM3_REGS    (&sim_sercom[3])
+#define SERCOM4_REGS    (&sim_sercom[4])
+#define SERCOM5_REGS    (&sim_sercom[5])
+#define SERCOM6_REGS    (&sim_sercom[6])
+#define SERCOM7_REGS    (&sim_sercom[7])
+
+/* ================= SIM CONTROL ================= */
+
+/* Free-running host counter behind CYCCNT: TSC on x86, else ns */
+uint64_t sim_cycles(void);
+
+/* Rate of sim_cycles(), measured on the first call */
+uint32_t sim_cycles_hz(void);
+
+/* Zero every register block and the core state, preset ready flags */
+void sim_reset(void);
+
+/* Enabled in the NVIC and not masked by PRIMASK / BASEPRI */
+bool sim_irq_deliverable(IRQn_Type irq);
+
+/* Call handler as the ISR of irq: IPSR set for the duration */
+void sim_irq_call(IRQn_Type irq, void (*handler)(void));
+
+/*
+ * Apply the DIR / OUT set, clear and toggle registers of every PORT
+ * group and clear them; IN follows OUT on output pins. Between two
+ * calls the order is set, clear, toggle: a driver that releases a pin
+ * and drives it again in one go ends with it driven.
+ */
+void sim_port_update(void);
+
+/*
+ * Instruction counter for the bench (host/sim_insns.c): user-mode
+ * instructions retired, from perf, else a ptrace single-step tracer
+ * (x86-64), else sim_cycles(). sim_insns_init() picks the source and
+ * must run first in main(): the ptrace source forks there. Both
+ * return "perf", "ptrace" or "tsc".
+ */
+const char *sim_insns_init(void);
+const char *sim_insns_source(void);
+uint32_t sim_insns(void);
+
+#endif /* HOST_PIC32CX1025SG61128_H */
@@ -0,0 +1,115 @@
+#include <string.h>
+#include <time.h>
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Register blocks and core state of the host register sim.
+ * Plain globals: in the low 4 GB of a -no-pie binary, so the 32-bit
+ * addresses the drivers store (descriptors, DATA registers) are valid.
+ */
+
+/* ================= INSTANCES ================= */
+sim_core_t       sim_core;
+DWT_Type         sim_dwt;
+CoreDebug_Type   sim_coredebug;
+
+mclk_registers_t sim_mclk;
+dmac_registers_t sim_dmac;
+port_registers_t sim_port;
+evsys_registers_t sim_evsys;
+tc_registers_t   sim_tc[8];
+sercom_registers_t sim_sercom[8];
+
+/* ================= CYCLE COUNTER ================= */
+static uint64_t sim_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t sim_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return sim_ns();
+#endif
+}
+
+uint32_t sim_cycles_hz(void)
+{
+    static uint32_t hz;
+
+    if (hz == 0u)
+    {
+        uint64_t t0 = sim_ns();
+        uint64_t c0 = sim_cycles();
+        uint64_t t1;
+
+        while ((t1 = sim_ns()) - t0 < 20000000u);
+        hz = (uint32_t)((sim_cycles() - c0) * 1000000000u / (t1 - t0));
+    }
+
+    return hz;
+}
+
+DWT_Type *sim_dwt_now(void)
+{
+    if ((sim_coredebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) &&
+        (sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk))
+        sim_dwt.CYCCNT = (uint32_t)sim_cycles();
+
+    return &sim_dwt;
+}
+
+/* ================= CONTROL ================= */
+void sim_reset(void)
+{
+    memset(&sim_core, 0, sizeof sim_core);
+    memset(&sim_dwt, 0, sizeof sim_dwt);
+    memset(&sim_coredebug, 0, sizeof sim_coredebug);
+
+    memset((void *)&sim_mclk, 0, sizeof sim_mclk);
+    memset((void *)&sim_dmac, 0, sizeof sim_dmac);
+    memset((void *)&sim_port, 0, sizeof sim_port);
+    memset((void *)&sim_evsys, 0, sizeof sim_evsys);
+    memset((void *)sim_tc, 0, sizeof sim_tc);
+    memset((void *)sim_sercom, 0, sizeof sim_sercom);
+}
+
+bool sim_irq_deliverable(IRQn_Type irq)
+{
+    uint32_t prio = sim_core.priority[(uint8_t)irq];
+
+    if ((int32_t)irq < 0 || !NVIC_GetEnableIRQ(irq) || sim_core.primask)
+        return false;
+
+    return sim_core.basepri == 0u || prio < sim_core.basepri;
+}
+
+void sim_irq_call(IRQn_Type irq, void (*handler)(void))
+{
+    uint32_t ipsr = sim_core.ipsr;
+
+    sim_core.ipsr = (uint32_t)irq + 16u;
+    NVIC_ClearPendingIRQ(irq);
+    handler();
+    sim_core.ipsr = ipsr;
+}
+
+void sim_port_update(void)
+{
+    for (uint32_t g = 0; g < 4u; g++)
+    {
+        port_group_registers_t *r = &sim_port.GROUP[g];
+
+        r->PORT_DIR = ((r->PORT_DIR | r->PORT_DIRSET) & ~r->PORT_DIRCLR) ^ r->PORT_DIRTGL;
+        r->PORT_OUT = ((r->PORT_OUT | r->PORT_OUTSET) & ~r->PORT_OUTCLR) ^ r->PORT_OUTTGL;
+        r->PORT_DIRSET = r->PORT_DIRCLR = r->PORT_DIRTGL = 0;
+        r->PORT_OUTSET = r->PORT_OUTCLR = r->PORT_OUTTGL = 0;
+
+        r->PORT_IN = (r->PORT_IN & ~r->PORT_DIR) | (r->PORT_OUT & r->PORT_DIR);
+    }
+}
@@ -0,0 +1,218 @@
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ptrace.h>
+#include <sys/user.h>
+#endif
+#include "pic32cx1025sg61128.h"
+
+/*
+ * Instruction counter of the host register sim, for the bench.
+ *
+ * Counts the user-mode instructions this process retires, so a bench
+ * case reads the same on every run and every machine with the same
+ * compiler. Sources, first one that works:
+ *
+ * perf   : PERF_COUNT_HW_INSTRUCTIONS, read() on every sim_insns().
+ * ptrace : x86-64. The process forks; the parent single-steps the
+ *          child between two sim_insns() calls and stores the steps
+ *          in insn_count before the second call returns. Runs as
+ *          plain code outside a window, so the slowdown is confined
+ *          to the measured calls (for VMs and containers without a
+ *          PMU or with perf_event_paranoid too high).
+ * tsc    : sim_cycles(). Not an instruction count; sim_insns_source()
+ *          says so and bench_check refuses to compare it.
+ */
+
+typedef enum
+{
+    INSN_NONE = 0,
+    INSN_PERF,
+    INSN_PTRACE,
+    INSN_TSC
+} insn_src_t;
+
+static insn_src_t insn_src;
+static int insn_fd = -1;
+static volatile uint64_t insn_count;      /* ptrace: written by the tracer */
+
+/* ================= PERF ================= */
+static bool insn_perf_open(void)
+{
+#if defined(__linux__) && defined(SYS_perf_event_open)
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    insn_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return insn_fd >= 0;
+#else
+    return false;
+#endif
+}
+
+static uint64_t insn_perf_read(void)
+{
+    uint64_t n = 0;
+
+    if (read(insn_fd, &n, sizeof(n)) != (ssize_t)sizeof(n))
+        return 0;
+    return n;
+}
+
+/* ================= PTRACE ================= */
+#if defined(__linux__) && defined(__x86_64__)
+
+/* The window marker: the tracer looks for a trap just past this int3 */
+void sim_insns_mark(void);
+__asm__(".text\n"
+        ".globl sim_insns_mark\n"
+        ".type sim_insns_mark, @function\n"
+        "sim_insns_mark:\n"
+        "    int3\n"
+        "    ret\n"
+        ".size sim_insns_mark, .-sim_insns_mark\n");
+
+static void insn_tracer(pid_t child)
+{
+    const uintptr_t mark = (uintptr_t)sim_insns_mark + 1u;   /* past int3 */
+    uint64_t count = 0;
+    bool stepping = false;
+    int status;
+
+    for (;;)
+    {
+        int sig = 0;
+
+        if (waitpid(child, &status, 0) < 0)
+            _exit(1);
+        if (WIFEXITED(status))
+            _exit(WEXITSTATUS(status));
+        if (WIFSIGNALED(status))
+            _exit(128 + WTERMSIG(status));
+        if (!WIFSTOPPED(status))
+            continue;
+
+        if (WSTOPSIG(status) == SIGTRAP)
+        {
+            struct user_regs_struct regs;
+
+            ptrace(PTRACE_GETREGS, child, NULL, &regs);
+            if (stepping)
+                count++;
+            if ((uintptr_t)regs.rip == mark)
+            {
+                ptrace(PTRACE_POKEDATA, child, (void *)&insn_count, (void *)(uintptr_t)count);
+                stepping = !stepping;
+            }
+        }
+        else if (WSTOPSIG(status) != SIGSTOP)
+        {
+            sig = WSTOPSIG(status);
+        }
+
+        ptrace(stepping ? PTRACE_SINGLESTEP : PTRACE_CONT, child, NULL, (void *)(uintptr_t)sig);
+    }
+}
+
+static bool insn_ptrace_start(void)
+{
+    int fd[2];
+    pid_t child;
+    char ok = 0;
+
+    if (pipe(fd) != 0)
+        return false;
+
+    child = fork();
+    if (child < 0)
+        return false;
+
+    if (child == 0)
+    {
+        /* Traced side: tell the parent whether TRACEME took, then stop */
+        ok = (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == 0);
+        (void)!write(fd[1], &ok, 1);
+        close(fd[0]);
+        close(fd[1]);
+        if (ok)
+            raise(SIGSTOP);
+        return ok;
+    }
+
+    close(fd[1]);
+    if (read(fd[0], &ok, 1) != 1)
+        ok = 0;
+    close(fd[0]);
+
+    if (!ok)
+    {
+        /* The child falls back on its own: wait for it, nothing to trace */
+        int status = 0;
+
+        if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status))
+            _exit(1);
+        _exit(WEXITSTATUS(status));
+    }
+
+    insn_tracer(child);
+    return false;
+}
+#endif
+
+/* ================= API ================= */
+const char *sim_insns_init(void)
+{
+    if (insn_src == INSN_NONE)
+    {
+        if (insn_perf_open())
+            insn_src = INSN_PERF;
+#if defined(__linux__) && defined(__x86_64__)
+        else if (insn_ptrace_start())
+            insn_src = INSN_PTRACE;
+#endif
+        else
+            insn_src = INSN_TSC;
+    }
+
+    return sim_insns_source();
+}
+
+const char *sim_insns_source(void)
+{
+    switch (insn_src)
+    {
+        case INSN_PERF:   return "perf";
+        case INSN_PTRACE: return "ptrace";
+        case INSN_TSC:    return "tsc";
+        default:          return "none";
+    }
+}
+
+uint32_t sim_insns(void)
+{
+    switch (insn_src)
+    {
+        case INSN_PERF:
+            return (uint32_t)insn_perf_read();
+#if defined(__linux__) && defined(__x86_64__)
+        case INSN_PTRACE:
+            sim_insns_mark();
+            return (uint32_t)insn_count;
+#endif
+        default:
+            return (uint32_t)sim_cycles();
+    }
+}
@@ -0,0 +1,167 @@
+#include <string.h>
+#include "pic32cx1025sg61128.h"
+#include "dmac_drv.h"
+#include "dmac_model.h"
+#include "spi_model.h"
+
+/*
+ * Chip selects are plain PORT pins, so a release and a new select can
+ * both happen between two bytes (end of one transaction, start of the
+ * next, in the same DMAC interrupt). OUTSET is checked for the pin
+ * before sim_port_update() folds the writes into OUT: a set in between
+ * ends the frame even if the pin is low again.
+ */
+
+#define SPI_MODEL_DEVICES   4u
+
+/* ================= STATE ================= */
+typedef struct
+{
+    uint8_t             sercom;
+    uint8_t             port;
+    uint32_t            mask;
+    spi_model_device_t  device;
+    void               *ctx;
+    bool                selected;
+    bool                first;
+} spi_model_dev_t;
+
+static spi_model_dev_t model_dev[SPI_MODEL_DEVICES];
+static uint8_t         model_dev_count;
+static uint32_t        model_stray;
+static uint32_t        model_overflows;
+
+/* ================= LOCAL HELPERS ================= */
+static uint8_t model_rev8(uint8_t v)
+{
+    return (uint8_t)(__RBIT(v) >> 24);
+}
+
+/* Follow the chip selects through the PORT writes since the last byte */
+static void model_cs_update(void)
+{
+    for (uint8_t i = 0; i < model_dev_count; i++)
+    {
+        if (PORT_REGS->GROUP[model_dev[i].port].PORT_OUTSET & model_dev[i].mask)
+            model_dev[i].selected = false;
+    }
+
+    sim_port_update();
+
+    for (uint8_t i = 0; i < model_dev_count; i++)
+    {
+        spi_model_dev_t *d = &model_dev[i];
+        port_group_registers_t *g = &PORT_REGS->GROUP[d->port];
+        bool low = (g->PORT_DIR & d->mask) && !(g->PORT_OUT & d->mask);
+
+        if (low && !d->selected)
+            d->first = true;
+        d->selected = low;
+    }
+}
+
+/* One byte on the wire: MOSI in, MISO of the one selected device out */
+static uint8_t model_exchange(uint8_t sercom, uint8_t mosi)
+{
+    spi_model_dev_t *sel = 0;
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < model_dev_count; i++)
+    {
+        if (model_dev[i].sercom == sercom && model_dev[i].selected)
+        {
+            sel = &model_dev[i];
+            n++;
+        }
+    }
+
+    if (n != 1u)
+    {
+        model_stray++;
+        return 0xFFu;
+    }
+
+    bool first = sel->first;
+    sel->first = false;
+
+    return sel->device ? sel->device(sel->ctx, mosi, first) : mosi;
+}
+
+/* ================= MODEL API ================= */
+void spi_model_reset(void)
+{
+    memset(model_dev, 0, sizeof model_dev);
+    model_dev_count = 0;
+    model_stray     = 0;
+    model_overflows = 0;
+}
+
+void spi_model_attach(uint8_t sercom, uint8_t port, uint8_t pin,
+                      spi_model_device_t device, void *ctx)
+{
+    if (model_dev_count >= SPI_MODEL_DEVICES)
+        return;
+
+    model_dev[model_dev_count++] = (spi_model_dev_t)
+    {
+        .sercom = sercom,
+        .port   = port,
+        .mask   = 1u << pin,
+        .device = device,
+        .ctx    = ctx,
+    };
+}
+
+uint32_t spi_model_run(uint8_t sercom)
+{
+    sercom_spim_registers_t *r = &sim_sercom[sercom].SPIM;
+    uint32_t bytes = 0;
+
+    for (;;)
+    {
+        model_cs_update();
+
+        if (!(r->SERCOM_CTRLA & SERCOM_SPIM_CTRLA_ENABLE_Msk) ||
+            (r->SERCOM_CTRLA & SERCOM_SPIM_CTRLA_MODE_Msk) != SERCOM_SPIM_CTRLA_MODE_SPI_MASTER)
+            break;
+
+        /* DRE is set whenever the shift register is idle */
+        r->SERCOM_INTFLAG |= SERCOM_SPIM_INTFLAG_DRE_Msk;
+        if (dmac_model_trigger(DMAC_TRIG_SERCOM_TX(sercom)) == 0u)
+            break;
+
+        bool    lsb  = (r->SERCOM_CTRLA & SERCOM_SPIM_CTRLA_DORD_Msk) != 0u;
+        uint8_t data = (uint8_t)r->SERCOM_DATA;
+        uint8_t miso = model_exchange(sercom, lsb ? model_rev8(data) : data);
+
+        bytes++;
+        r->SERCOM_INTFLAG |= SERCOM_SPIM_INTFLAG_TXC_Msk;
+
+        if (!(r->SERCOM_CTRLB & SERCOM_SPIM_CTRLB_RXEN_Msk))
+            continue;
+
+        if (r->SERCOM_INTFLAG & SERCOM_SPIM_INTFLAG_RXC_Msk)
+        {
+            r->SERCOM_STATUS |= SERCOM_SPIM_STATUS_BUFOVF_Msk;
+            model_overflows++;
+        }
+
+        /* The RX channel reads DATA, which clears RXC */
+        r->SERCOM_DATA = lsb ? model_rev8(miso) : miso;
+        r->SERCOM_INTFLAG |= SERCOM_SPIM_INTFLAG_RXC_Msk;
+        if (dmac_model_trigger(DMAC_TRIG_SERCOM_RX(sercom)) != 0u)
+            r->SERCOM_INTFLAG &= (uint8_t)~SERCOM_SPIM_INTFLAG_RXC_Msk;
+    }
+
+    return bytes;
+}
+
+uint32_t spi_model_stray(void)
+{
+    return model_stray;
+}
+
+uint32_t spi_model_overflows(void)
+{
+    return model_overflows;
+}
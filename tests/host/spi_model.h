@@ -0,0 +1,47 @@
+#ifndef SPI_MODEL_H
+#define SPI_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * SERCOM SPI host model for the host register sim.
+ *
+ * Clocks the bytes the DMAC model feeds into SERCOM_DATA: every byte
+ * is one SERCOMn TX trigger, the byte on MOSI goes to the device whose
+ * chip select (a PORT pin) is low, its answer on MISO lands in DATA
+ * with RXC set and fires the SERCOMn RX trigger. Devices see the bits
+ * in wire order, so CTRLA.DORD is visible to them.
+ *
+ * Not modelled: SCK timing, the two-byte TX buffer (TX never runs
+ * ahead of RX), hardware slave select (MSSEN), 9-bit characters.
+ */
+
+/*
+ * Device behind a chip select: gets the MOSI byte, returns the MISO
+ * byte. first is true on the first byte after CS went low.
+ */
+typedef uint8_t (*spi_model_device_t)(void *ctx, uint8_t mosi, bool first);
+
+/* ================= MODEL API ================= */
+
+/* Detach every device and clear the counters; call after sim_reset() */
+void spi_model_reset(void);
+
+/*
+ * Put a device on SERCOMn, selected by PORT group port, pin low.
+ * device NULL is a loopback: MISO wired to MOSI.
+ */
+void spi_model_attach(uint8_t sercom, uint8_t port, uint8_t pin,
+                      spi_model_device_t device, void *ctx);
+
+/* Clock bytes until the TX channel stops feeding DATA; returns bytes */
+uint32_t spi_model_run(uint8_t sercom);
+
+/* Bytes clocked with no device, or more than one, selected */
+uint32_t spi_model_stray(void);
+
+/* Bytes received while the previous one was still unread (BUFOVF) */
+uint32_t spi_model_overflows(void);
+
+#endif /* SPI_MODEL_H */
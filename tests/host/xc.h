@@ -0,0 +1,7 @@
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+/* Host stand-in for the XC32 umbrella header */
+#include "pic32cx1025sg61128.h"
+
+#endif /* HOST_XC_H */
@@ -0,0 +1,74 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Minimal host test harness. Each test binary is one file of
+ * static void test_xxx(void) cases run from main() with TEST_RUN();
+ * TEST_EXIT() prints the summary and returns the exit status.
+ *
+ *     static void test_something(void)
+ *     {
+ *         TEST_EQ(2u, 1u + 1u);
+ *     }
+ *
+ *     int main(void)
+ *     {
+ *         TEST_RUN(test_something);
+ *         return TEST_EXIT();
+ *     }
+ */
+
+/* ================= STATE ================= */
+static unsigned test_checks;
+static unsigned test_failed;
+static const char *test_current;
+
+/* ================= CHECKS ================= */
+#define TEST_CHECK(cond, fmt, ...)                                          \
+    do {                                                                    \
+        test_checks++;                                                      \
+        if (!(cond))                                                        \
+        {                                                                   \
+            test_failed++;                                                  \
+            printf("FAIL %s (%s:%d): " fmt "\n",                            \
+                   test_current, __FILE__, __LINE__, __VA_ARGS__);          \
+        }                                                                   \
+    } while (0)
+
+#define TEST_ASSERT(cond)   TEST_CHECK((cond), "%s", #cond)
+
+/* Integers of any width, compared as 64-bit signed */
+#define TEST_EQ(expected, actual)                                           \
+    do {                                                                    \
+        long long test_e_ = (long long)(expected);                          \
+        long long test_a_ = (long long)(actual);                            \
+        TEST_CHECK(test_e_ == test_a_, "%s == %s: expected %lld, got %lld", \
+                   #expected, #actual, test_e_, test_a_);                   \
+    } while (0)
+
+/* |actual - expected| <= tol */
+#define TEST_NEAR(expected, actual, tol)                                    \
+    do {                                                                    \
+        long long test_e_ = (long long)(expected);                          \
+        long long test_a_ = (long long)(actual);                            \
+        long long test_d_ = test_a_ - test_e_;                              \
+        TEST_CHECK(test_d_ <= (long long)(tol) && -test_d_ <= (long long)(tol), \
+                   "%s ~ %s: expected %lld +/- %lld, got %lld",              \
+                   #expected, #actual, test_e_, (long long)(tol), test_a_); \
+    } while (0)
+
+/* ================= RUNNER ================= */
+#define TEST_RUN(fn)                                                        \
+    do {                                                                    \
+        test_current = #fn;                                                 \
+        fn();                                                               \
+    } while (0)
+
+#define TEST_EXIT()                                                         \
+    (printf("%s: %u checks, %u failed\n", __FILE__, test_checks, test_failed), \
+     test_failed ? 1 : 0)
+
+#endif /* TEST_H */
@@ -0,0 +1,419 @@
+/*
+ * Capture window statistics and the capture stream ring.
+ *
+ * capture_stats_compute() is fed synthetic windows with known answers.
+ * The stream part runs capture_stream.c on the register sim: a test
+ * "edge" loads CC0 / CC1 of the TC and fires its MC1 DMA trigger, and
+ * the DMAC model moves the word into the ring exactly as the
+ * descriptor says. TC, EIC and EVSYS are stubbed below; only their
+ * registers matter to the stream.
+ */
+#include "test.h"
+#include "pic32cx1025sg61128.h"
+#include "capture_stats.h"
+#include "capture_stream.h"
+#include "timer_counter_drv.h"
+#include "eic_drv.h"
+#include "evsys_drv.h"
+#include "dmac_drv.h"
+#include "dmac_model.h"
+
+#define STREAM_TC       3u
+#define STREAM_TC_HZ    48000000u
+#define RING_LEN        16u
+
+/* ================= STUBS ================= */
+uint32_t tc_init_for_rate(uint8_t tc_index, tc_mode_t mode, tc_waveform_t waveform, uint32_t min_hz)
+{
+    (void)tc_index; (void)mode; (void)waveform;
+    return (min_hz != 0u && STREAM_TC_HZ / min_hz < 65536u) ? STREAM_TC_HZ : 0u;
+}
+
+void tc_deinit(uint8_t tc_index)                { (void)tc_index; }
+void tc_start(uint8_t tc_index)                 { (void)tc_index; }
+void tc_stop(uint8_t tc_index)                  { (void)tc_index; }
+
+void tc_capture_enable(uint8_t tc_index, uint8_t channel, tc_capture_mode_t mode, bool invert)
+{
+    (void)tc_index; (void)channel; (void)mode; (void)invert;
+}
+
+volatile void *tc_capture_register(uint8_t tc_index, uint8_t channel)
+{
+    return &sim_tc[tc_index].COUNT16.TC_CC[channel];
+}
+
+bool eic_attach(gpio_port_id_t port, uint8_t pin, uint8_t line, eic_sense_t sense,
+                uint32_t flags, eic_callback_t callback, void *ctx)
+{
+    (void)port; (void)pin; (void)line; (void)sense; (void)flags; (void)callback; (void)ctx;
+    return true;
+}
+
+void eic_detach(uint8_t line)                           { (void)line; }
+void eic_disable_line(uint8_t line)                     { (void)line; }
+void eic_event_output_enable(uint8_t line, bool enable) { (void)line; (void)enable; }
+
+int8_t evsys_route(uint8_t generator, uint8_t user, evsys_path_t path, evsys_edge_t edge)
+{
+    (void)generator; (void)user; (void)path; (void)edge;
+    return 0;
+}
+
+void evsys_channel_free(uint8_t ch)                     { (void)ch; }
+
+/* ================= WINDOW STATISTICS ================= */
+static uint32_t window[65536];
+
+static void fill(uint32_t n, uint32_t period, uint32_t width)
+{
+    for (uint32_t i = 0; i < n; i++)
+        window[i] = CAPTURE_SAMPLE(period, width);
+}
+
+/* 1 kHz, 25 % at 48 MHz: exact figures, no jitter */
+static void test_stats_steady(void)
+{
+    capture_stats_t st;
+
+    fill(100, 48000, 12000);
+    capture_stats_compute(window, 100, 48000000u, &st);
+
+    TEST_EQ(100, st.count);
+    TEST_EQ(0, st.invalid);
+    TEST_EQ(48000, st.period_min);
+    TEST_EQ(48000, st.period_max);
+    TEST_EQ(48000, st.period_mean);
+    TEST_EQ(12000, st.width_mean);
+    TEST_EQ(1000000, st.freq_mhz);
+    TEST_EQ(250000, st.duty_ppm);
+    TEST_EQ(0, st.jitter_rms_ns);
+    TEST_EQ(0, st.jitter_pp_ns);
+}
+
+/* ±1 tick around 1000 at 1 MHz: RMS 1 µs, peak-to-peak 2 µs */
+static void test_stats_alternating(void)
+{
+    capture_stats_t st;
+
+    for (uint32_t i = 0; i < 100u; i++)
+        window[i] = CAPTURE_SAMPLE((i & 1u) ? 1001u : 999u, 500u);
+    capture_stats_compute(window, 100, 1000000u, &st);
+
+    TEST_EQ(999, st.period_min);
+    TEST_EQ(1001, st.period_max);
+    TEST_EQ(1000, st.period_mean);
+    TEST_EQ(1000000, st.freq_mhz);
+    TEST_EQ(500000, st.duty_ppm);
+    TEST_EQ(1000, st.jitter_rms_ns);
+    TEST_EQ(2000, st.jitter_pp_ns);
+}
+
+/* One long period in four: 0.43 tick RMS, not rounded away */
+static void test_stats_sub_tick_jitter(void)
+{
+    capture_stats_t st;
+
+    for (uint32_t i = 0; i < 100u; i++)
+        window[i] = CAPTURE_SAMPLE((i % 4u) == 3u ? 1001u : 1000u, 100u);
+    capture_stats_compute(window, 100, 1000000u, &st);
+
+    TEST_EQ(1000, st.period_mean);
+    TEST_NEAR(433, st.jitter_rms_ns, 5);
+    TEST_EQ(1000, st.jitter_pp_ns);
+}
+
+/* Duty is Σ width / Σ period, not the mean of per-cycle ratios */
+static void test_stats_duty_weighted(void)
+{
+    capture_stats_t st;
+
+    window[0] = CAPTURE_SAMPLE(1000, 900);
+    window[1] = CAPTURE_SAMPLE(3000, 300);
+    capture_stats_compute(window, 2, 1000000u, &st);
+
+    TEST_EQ(300, st.width_min);
+    TEST_EQ(900, st.width_max);
+    TEST_EQ(600, st.width_mean);
+    TEST_EQ(300000, st.duty_ppm);
+    TEST_EQ(500000, st.freq_mhz);
+}
+
+/* Period 0 (no edge) and width > period (torn capture) are skipped */
+static void test_stats_invalid_samples(void)
+{
+    capture_stats_t st;
+
+    window[0] = CAPTURE_SAMPLE(1000, 200);
+    window[1] = CAPTURE_SAMPLE(0, 0);
+    window[2] = CAPTURE_SAMPLE(100, 150);
+    window[3] = CAPTURE_SAMPLE(1000, 300);
+    capture_stats_compute(window, 4, 1000000u, &st);
+
+    TEST_EQ(2, st.count);
+    TEST_EQ(2, st.invalid);
+    TEST_EQ(200, st.width_min);
+    TEST_EQ(300, st.width_max);
+    TEST_EQ(250, st.width_mean);
+    TEST_EQ(250000, st.duty_ppm);
+    TEST_EQ(0, st.jitter_rms_ns);
+
+    /* Nothing valid: every figure 0 */
+    capture_stats_compute(&window[1], 2, 1000000u, &st);
+    TEST_EQ(0, st.count);
+    TEST_EQ(2, st.invalid);
+    TEST_EQ(0, st.period_min);
+    TEST_EQ(0, st.width_min);
+    TEST_EQ(0, st.freq_mhz);
+
+    capture_stats_compute(window, 0, 1000000u, &st);
+    TEST_EQ(0, st.count);
+    TEST_EQ(0, st.invalid);
+}
+
+/* Unknown tick rate: tick figures only */
+static void test_stats_no_tick_rate(void)
+{
+    capture_stats_t st;
+
+    fill(10, 2000, 500);
+    capture_stats_compute(window, 10, 0, &st);
+
+    TEST_EQ(2000, st.period_mean);
+    TEST_EQ(250000, st.duty_ppm);
+    TEST_EQ(0, st.freq_mhz);
+    TEST_EQ(0, st.jitter_rms_ns);
+    TEST_EQ(0, st.jitter_pp_ns);
+}
+
+/* Full 16-bit range over the largest window: no sum overflows */
+static void test_stats_full_range(void)
+{
+    capture_stats_t st;
+
+    fill(65535, 65535, 65535);
+    capture_stats_compute(window, 65535, 120000000u, &st);
+
+    TEST_EQ(65535, st.count);
+    TEST_EQ(65535, st.period_mean);
+    TEST_EQ(1000000, st.duty_ppm);
+    TEST_EQ(1831083, st.freq_mhz);      /* 120 MHz / 65535, mHz */
+    TEST_EQ(0, st.jitter_rms_ns);
+
+    /* Worst deviation: 1 and 65535 alternating */
+    for (uint32_t i = 0; i < 65534u; i++)
+        window[i] = CAPTURE_SAMPLE((i & 1u) ? 65535u : 1u, 0u);
+    capture_stats_compute(window, 65534, 1000000u, &st);
+
+    TEST_EQ(32768, st.period_mean);
+    TEST_EQ(32767000, st.jitter_rms_ns);
+    TEST_EQ(65534000, st.jitter_pp_ns);
+}
+
+static void test_ticks_to_ns(void)
+{
+    TEST_EQ(21, capture_ticks_to_ns(1, 48000000u));
+    TEST_EQ(333333333, capture_ticks_to_ns(1, 3));
+    TEST_EQ(1365333333, capture_ticks_to_ns(65536, 48000));
+    TEST_EQ(0, capture_ticks_to_ns(100, 0));
+}
+
+/* ================= STREAM RING ================= */
+static capture_stream_t cs;
+static uint32_t ring[RING_LEN];
+static uint32_t out[64];
+static uint16_t next_period;
+
+static const capture_stream_config_t stream_cfg =
+{
+    .tc_index     = STREAM_TC,
+    .port         = GPIO_PORT_A,
+    .pin          = 4,
+    .line         = 4,
+    .min_hz       = 1000,
+    .dma_priority = 1,
+};
+
+/* One input cycle: PPW capture into CC0 / CC1, MC1 triggers the DMA */
+static void edge(uint16_t period, uint16_t width)
+{
+    sim_tc[STREAM_TC].COUNT16.TC_CC[0] = period;
+    sim_tc[STREAM_TC].COUNT16.TC_CC[1] = width;
+    (void)dmac_model_trigger(DMAC_TRIG_TC_MC(STREAM_TC, 1));
+}
+
+/* Cycles with consecutive periods, so order and gaps are visible */
+static void edges(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        edge(next_period, 10);
+        next_period++;
+    }
+}
+
+static void stream_open(void)
+{
+    sim_reset();
+    dmac_model_reset();
+    dmac_init();
+
+    TEST_ASSERT(capture_stream_init(&cs, &stream_cfg, ring, RING_LEN));
+    TEST_EQ(STREAM_TC_HZ, capture_stream_tick_hz(&cs));
+
+    capture_stream_start(&cs);
+    next_period = 1000;
+}
+
+/* Samples read must be the consecutive periods from first on */
+static void expect_run(uint32_t n, uint32_t first)
+{
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (CAPTURE_PERIOD(out[i]) != first + i || CAPTURE_WIDTH(out[i]) != 10u)
+            bad++;
+    }
+
+    TEST_EQ(0, bad);
+}
+
+/* The first sample (tc_start() to the first edge) is dropped */
+static void test_stream_first_sample(void)
+{
+    stream_open();
+
+    TEST_EQ(0, capture_stream_available(&cs));
+    edges(10);
+    TEST_EQ(9, capture_stream_available(&cs));
+
+    TEST_EQ(9, capture_stream_read(&cs, out, 64));
+    expect_run(9, 1001);
+    TEST_EQ(0, capture_stream_available(&cs));
+
+    capture_stream_deinit(&cs);
+}
+
+/* Reads in small pieces across many ring wraps stay in order */
+static void test_stream_wraps_in_order(void)
+{
+    uint32_t expected = 1001;
+
+    stream_open();
+    edges(1);
+
+    for (uint32_t round = 0; round < 20u; round++)
+    {
+        edges(7);
+        TEST_EQ(7, capture_stream_available(&cs));
+
+        uint32_t n = capture_stream_read(&cs, out, 4);
+        n += capture_stream_read(&cs, &out[n], 64);
+        TEST_EQ(7, n);
+        expect_run(7, expected);
+        expected += 7u;
+    }
+
+    TEST_EQ(0, capture_stream_overruns(&cs));
+    TEST_EQ((20u * 7u + 1u) / RING_LEN, cs.wraps);
+
+    capture_stream_deinit(&cs);
+}
+
+/*
+ * The ring wraps while the DMAC interrupt is held off: the total seen
+ * by the reader goes backwards and is corrected once. The late
+ * interrupt must not count the same pass again.
+ */
+static void test_stream_wrap_before_interrupt(void)
+{
+    stream_open();
+    edges(10);
+    TEST_EQ(9, capture_stream_read(&cs, out, 64));
+
+    __disable_irq();
+    edges(12);                          /* Slots 10..15, 0..5 */
+    TEST_EQ(0, cs.wraps);
+    TEST_EQ(12, capture_stream_available(&cs));
+    TEST_EQ(12, capture_stream_read(&cs, out, 64));
+    expect_run(12, 1010);
+
+    __enable_irq();
+    dmac_model_irq();
+    TEST_EQ(1, cs.wraps);
+    TEST_EQ(0, capture_stream_available(&cs));
+
+    edges(3);
+    TEST_EQ(3, capture_stream_read(&cs, out, 64));
+    expect_run(3, 1022);
+    TEST_EQ(0, capture_stream_overruns(&cs));
+
+    capture_stream_deinit(&cs);
+}
+
+/* Lapped reader: the newest len - 1 samples survive, the rest count */
+static void test_stream_overrun(void)
+{
+    stream_open();
+    edges(40);
+
+    TEST_EQ(39, capture_stream_available(&cs));
+    TEST_EQ(RING_LEN - 1u, capture_stream_read(&cs, out, 64));
+    expect_run(RING_LEN - 1u, 1000u + 40u - (RING_LEN - 1u));
+    TEST_EQ(39u - (RING_LEN - 1u), capture_stream_overruns(&cs));
+
+    edges(2);
+    TEST_EQ(2, capture_stream_read(&cs, out, 64));
+    expect_run(2, 1040);
+
+    capture_stream_flush(&cs);
+    edges(5);
+    capture_stream_flush(&cs);
+    TEST_EQ(0, capture_stream_available(&cs));
+
+    capture_stream_deinit(&cs);
+}
+
+/* Ring → window → statistics, the way the example uses it */
+static void test_stream_window_stats(void)
+{
+    capture_stats_t st;
+
+    stream_open();
+
+    /* 1 kHz at 48 MHz with ±2 ticks of jitter, 50 % duty */
+    for (uint32_t i = 0; i < 13u; i++)
+        edge((i & 1u) ? 48002u : 47998u, 24000u);
+
+    uint32_t n = capture_stream_read(&cs, out, 64);
+    TEST_EQ(12, n);
+
+    capture_stats_compute(out, n, capture_stream_tick_hz(&cs), &st);
+    TEST_EQ(12, st.count);
+    TEST_EQ(48000, st.period_mean);
+    TEST_EQ(1000000, st.freq_mhz);
+    TEST_EQ(500000, st.duty_ppm);
+    TEST_EQ(42, st.jitter_rms_ns);      /* 2 ticks of 20.8 ns */
+    TEST_EQ(83, st.jitter_pp_ns);
+
+    capture_stream_deinit(&cs);
+}
+
+int main(void)
+{
+    TEST_RUN(test_stats_steady);
+    TEST_RUN(test_stats_alternating);
+    TEST_RUN(test_stats_sub_tick_jitter);
+    TEST_RUN(test_stats_duty_weighted);
+    TEST_RUN(test_stats_invalid_samples);
+    TEST_RUN(test_stats_no_tick_rate);
+    TEST_RUN(test_stats_full_range);
+    TEST_RUN(test_ticks_to_ns);
+    TEST_RUN(test_stream_first_sample);
+    TEST_RUN(test_stream_wraps_in_order);
+    TEST_RUN(test_stream_wrap_before_interrupt);
+    TEST_RUN(test_stream_overrun);
+    TEST_RUN(test_stream_window_stats);
+    return TEST_EXIT();
+}
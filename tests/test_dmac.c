@@ -0,0 +1,398 @@
+/*
+ * dmac_drv.c on the host register sim.
+ *
+ * The DMAC model executes what the driver programmed: descriptor
+ * chains, write-back, completion and error interrupts through the
+ * DMAC_n handlers, and the ACTIVE / write-back split read by
+ * dmac_channel_remaining().
+ */
+#include <string.h>
+#include "test.h"
+#include "pic32cx1025sg61128.h"
+#include "dmac_drv.h"
+#include "irq_mgr.h"
+#include "dmac_model.h"
+
+/* A peripheral data register stand-in with its own trigger source */
+#define TRIG_PERIPH     DMAC_TRIG_SERCOM_TX(3)
+
+/* ================= FIXTURE ================= */
+typedef struct
+{
+    uint32_t complete;
+    uint32_t error;
+    uint32_t suspended;
+    uint8_t  ch;
+    uint16_t remaining;         /* dmac_channel_remaining() in the callback */
+} dma_log_t;
+
+static dma_log_t log_;
+
+static void on_dma(uint8_t ch, dmac_xfer_status_t status, void *ctx)
+{
+    dma_log_t *log = ctx;
+
+    log->ch = ch;
+    log->remaining = dmac_channel_remaining(ch);
+
+    if (status == DMAC_XFER_COMPLETE)
+        log->complete++;
+    else if (status == DMAC_XFER_ERROR)
+        log->error++;
+    else
+        log->suspended++;
+}
+
+static int8_t dma_setup(uint8_t trigsrc, dmac_trigact_t trigact)
+{
+    int8_t ch = dmac_channel_alloc();
+
+    if (ch < 0)
+        return ch;
+
+    log_ = (dma_log_t){0};
+    dmac_channel_setup((uint8_t)ch, trigsrc, trigact, 0);
+    dmac_channel_register_callback((uint8_t)ch, on_dma, &log_);
+    return ch;
+}
+
+static void fixture_reset(void)
+{
+    sim_reset();
+    dmac_model_reset();
+    dmac_init();
+}
+
+/* Static storage: the driver keeps 32-bit addresses */
+static uint8_t  src8[64];
+static uint8_t  dst8[64];
+static uint32_t src32[16];
+static uint32_t dst32[16];
+static uint16_t src16[8];
+static uint16_t dst16[8];
+static volatile uint32_t periph_data;
+static dmac_desc_t chain[3];
+
+static void fill_pattern(void)
+{
+    for (uint32_t i = 0; i < sizeof src8; i++)
+        src8[i] = (uint8_t)(0xA0u + i);
+    for (uint32_t i = 0; i < 16u; i++)
+        src32[i] = 0x11110000u * (i + 1u) + i;
+    for (uint32_t i = 0; i < 8u; i++)
+        src16[i] = (uint16_t)(0xBEEFu - i);
+
+    memset(dst8, 0, sizeof dst8);
+    memset(dst32, 0, sizeof dst32);
+    memset(dst16, 0, sizeof dst16);
+    periph_data = 0;
+}
+
+/* ================= TESTS ================= */
+
+/* Memory to memory, one software trigger runs the whole transaction */
+static void test_single_block_swtrig(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(DMAC_TRIG_DISABLE, DMAC_TRIGACT_TRANSACTION);
+    TEST_ASSERT(ch >= 0);
+
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)ch), src8, dst8, 40,
+                         DMAC_BEAT_BYTE, DMAC_DESC_SRCINC | DMAC_DESC_DSTINC | DMAC_DESC_INT, 0);
+    dmac_channel_enable((uint8_t)ch);
+
+    TEST_EQ(40, dmac_channel_remaining((uint8_t)ch));
+    TEST_ASSERT(dmac_channel_busy((uint8_t)ch));
+
+    dmac_channel_trigger((uint8_t)ch);
+    TEST_EQ(40, dmac_model_swtrig());
+
+    TEST_EQ(1, log_.complete);
+    TEST_EQ(0, log_.error);
+    TEST_EQ(ch, log_.ch);
+    TEST_EQ(0, memcmp(src8, dst8, 40));
+    TEST_EQ(0, dst8[40]);
+    TEST_EQ(0, dmac_channel_remaining((uint8_t)ch));
+    TEST_ASSERT(!dmac_channel_busy((uint8_t)ch));
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/*
+ * Three linked descriptors of different beat sizes. Only the last one
+ * interrupts: one callback for the chain, all data moved.
+ */
+static void test_chain_one_interrupt(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(DMAC_TRIG_DISABLE, DMAC_TRIGACT_TRANSACTION);
+    dmac_desc_t *first = dmac_channel_descriptor((uint8_t)ch);
+
+    dmac_descriptor_fill(first, src8, dst8, 7, DMAC_BEAT_BYTE,
+                         DMAC_DESC_SRCINC | DMAC_DESC_DSTINC, &chain[0]);
+    dmac_descriptor_fill(&chain[0], src16, dst16, 8, DMAC_BEAT_HWORD,
+                         DMAC_DESC_SRCINC | DMAC_DESC_DSTINC, &chain[1]);
+    dmac_descriptor_fill(&chain[1], src32, dst32, 16, DMAC_BEAT_WORD,
+                         DMAC_DESC_SRCINC | DMAC_DESC_DSTINC | DMAC_DESC_INT, 0);
+
+    dmac_channel_enable((uint8_t)ch);
+    dmac_channel_trigger((uint8_t)ch);
+    TEST_EQ(31, dmac_model_swtrig());
+
+    TEST_EQ(3, dmac_model_blocks((uint8_t)ch));
+    TEST_EQ(1, log_.complete);
+    TEST_EQ(0, memcmp(src8, dst8, 7));
+    TEST_EQ(0, memcmp(src16, dst16, sizeof src16));
+    TEST_EQ(0, memcmp(src32, dst32, sizeof src32));
+    TEST_ASSERT(!dmac_channel_busy((uint8_t)ch));
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/*
+ * Peripheral-paced chain, one beat per trigger: remaining() follows
+ * the write-back through each block, each block interrupts.
+ */
+static void test_chain_burst_remaining(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(TRIG_PERIPH, DMAC_TRIGACT_BURST);
+    dmac_desc_t *first = dmac_channel_descriptor((uint8_t)ch);
+
+    dmac_descriptor_fill(first, src8, &periph_data, 5, DMAC_BEAT_BYTE,
+                         DMAC_DESC_SRCINC | DMAC_DESC_INT, &chain[0]);
+    dmac_descriptor_fill(&chain[0], &src8[5], &periph_data, 3, DMAC_BEAT_BYTE,
+                         DMAC_DESC_SRCINC | DMAC_DESC_INT, 0);
+    dmac_channel_enable((uint8_t)ch);
+
+    for (uint32_t i = 0; i < 4u; i++)
+    {
+        TEST_EQ(1, dmac_model_trigger(TRIG_PERIPH));
+        TEST_EQ(src8[i], periph_data);
+    }
+    TEST_EQ(1, dmac_channel_remaining((uint8_t)ch));
+    TEST_EQ(0, log_.complete);
+
+    /* Block 1 done: the write-back holds the next block */
+    TEST_EQ(1, dmac_model_trigger(TRIG_PERIPH));
+    TEST_EQ(1, log_.complete);
+    TEST_EQ(3, log_.remaining);
+    TEST_EQ(3, dmac_channel_remaining((uint8_t)ch));
+
+    /* Other trigger sources leave it alone */
+    TEST_EQ(0, dmac_model_trigger(DMAC_TRIG_SERCOM_RX(3)));
+    TEST_EQ(3, dmac_channel_remaining((uint8_t)ch));
+
+    for (uint32_t i = 5; i < 8u; i++)
+    {
+        TEST_EQ(1, dmac_model_trigger(TRIG_PERIPH));
+        TEST_EQ(src8[i], periph_data);
+    }
+    TEST_EQ(2, log_.complete);
+    TEST_EQ(0, dmac_channel_remaining((uint8_t)ch));
+    TEST_ASSERT(!dmac_channel_busy((uint8_t)ch));
+
+    /* Transaction over: triggers are ignored */
+    TEST_EQ(0, dmac_model_trigger(TRIG_PERIPH));
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/*
+ * The channel on the bus is read from ACTIVE; its write-back is stale
+ * until it is re-arbitrated. Other channels still use write-back.
+ */
+static void test_remaining_active_channel(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(TRIG_PERIPH, DMAC_TRIGACT_BURST);
+    int8_t other = dma_setup(DMAC_TRIG_SERCOM_RX(3), DMAC_TRIGACT_BURST);
+
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)ch), src8, &periph_data, 10,
+                         DMAC_BEAT_BYTE, DMAC_DESC_SRCINC, 0);
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)other), &periph_data, dst8, 6,
+                         DMAC_BEAT_BYTE, DMAC_DESC_DSTINC, 0);
+    dmac_channel_enable((uint8_t)ch);
+    dmac_channel_enable((uint8_t)other);
+
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    TEST_EQ(8, dmac_channel_remaining((uint8_t)ch));
+
+    dmac_model_hold((uint8_t)ch, true);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+
+    TEST_ASSERT(DMAC_REGS->DMAC_ACTIVE & DMAC_ACTIVE_ABUSY_Msk);
+    TEST_EQ(10, dmac_channel_descriptor((uint8_t)ch)->btcnt);      /* Descriptor untouched */
+    TEST_EQ(5, dmac_channel_remaining((uint8_t)ch));
+    TEST_EQ(6, dmac_channel_remaining((uint8_t)other));
+
+    dmac_model_hold((uint8_t)ch, false);
+    TEST_EQ(0, DMAC_REGS->DMAC_ACTIVE);
+    TEST_EQ(5, dmac_channel_remaining((uint8_t)ch));
+
+    dmac_channel_free((uint8_t)ch);
+    dmac_channel_free((uint8_t)other);
+}
+
+/* A descriptor that loops on itself: a ring, one interrupt per pass */
+static void test_circular_ring(void)
+{
+    fixture_reset();
+
+    int8_t ch = dma_setup(TRIG_PERIPH, DMAC_TRIGACT_BURST);
+    dmac_desc_t *desc = dmac_channel_descriptor((uint8_t)ch);
+
+    memset(dst32, 0, sizeof dst32);
+    dmac_descriptor_fill(desc, &periph_data, dst32, 8, DMAC_BEAT_WORD,
+                         DMAC_DESC_DSTINC | DMAC_DESC_INT, desc);
+    dmac_channel_enable((uint8_t)ch);
+
+    for (uint32_t i = 0; i < 20u; i++)
+    {
+        periph_data = 1000u + i;
+        TEST_EQ(1, dmac_model_trigger(TRIG_PERIPH));
+    }
+
+    TEST_EQ(2, log_.complete);
+    TEST_EQ(4, dmac_channel_remaining((uint8_t)ch));
+    TEST_ASSERT(dmac_channel_busy((uint8_t)ch));
+    TEST_EQ(1016, dst32[0]);
+    TEST_EQ(1019, dst32[3]);
+    TEST_EQ(1012, dst32[4]);    /* Second pass, not yet overwritten */
+    TEST_EQ(1015, dst32[7]);
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/* Invalid next descriptor: error callback, channel stopped */
+static void test_invalid_descriptor_error(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(DMAC_TRIG_DISABLE, DMAC_TRIGACT_TRANSACTION);
+
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)ch), src8, dst8, 4,
+                         DMAC_BEAT_BYTE, DMAC_DESC_SRCINC | DMAC_DESC_DSTINC, &chain[2]);
+    chain[2] = (dmac_desc_t){0};
+
+    dmac_channel_enable((uint8_t)ch);
+    dmac_channel_trigger((uint8_t)ch);
+    TEST_EQ(4, dmac_model_swtrig());
+
+    TEST_EQ(1, log_.error);
+    TEST_EQ(0, log_.complete);
+    TEST_ASSERT(!dmac_channel_busy((uint8_t)ch));
+    TEST_EQ(0, memcmp(src8, dst8, 4));
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/* Completion under irq_lock() waits for the unlock */
+static void test_completion_masked_by_lock(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(DMAC_TRIG_DISABLE, DMAC_TRIGACT_TRANSACTION);
+
+    dmac_descriptor_fill(dmac_channel_descriptor((uint8_t)ch), src8, dst8, 8,
+                         DMAC_BEAT_BYTE, DMAC_DESC_SRCINC | DMAC_DESC_DSTINC | DMAC_DESC_INT, 0);
+    dmac_channel_enable((uint8_t)ch);
+
+    uint32_t basepri = irq_lock();
+    dmac_channel_trigger((uint8_t)ch);
+    (void)dmac_model_swtrig();
+
+    TEST_EQ(0, log_.complete);
+    TEST_ASSERT(NVIC_GetPendingIRQ(ch < 4 ? (IRQn_Type)(DMAC_0_IRQn + ch) : DMAC_4_IRQn));
+
+    irq_unlock(basepri);
+    dmac_model_irq();
+    TEST_EQ(1, log_.complete);
+
+    /* Served once: the flag was cleared by the handler */
+    dmac_model_irq();
+    TEST_EQ(1, log_.complete);
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/* Disabling a channel mid-transfer stops it; re-enable restarts */
+static void test_disable_and_restart(void)
+{
+    fixture_reset();
+    fill_pattern();
+
+    int8_t ch = dma_setup(TRIG_PERIPH, DMAC_TRIGACT_BURST);
+    dmac_desc_t *desc = dmac_channel_descriptor((uint8_t)ch);
+
+    dmac_descriptor_fill(desc, src8, &periph_data, 6, DMAC_BEAT_BYTE,
+                         DMAC_DESC_SRCINC | DMAC_DESC_INT, 0);
+    dmac_channel_enable((uint8_t)ch);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+
+    dmac_channel_disable((uint8_t)ch);
+    TEST_EQ(0, dmac_model_trigger(TRIG_PERIPH));
+    TEST_EQ(0, log_.complete);
+
+    dmac_descriptor_fill(desc, &src8[10], &periph_data, 2, DMAC_BEAT_BYTE,
+                         DMAC_DESC_SRCINC | DMAC_DESC_INT, 0);
+    dmac_channel_enable((uint8_t)ch);
+    TEST_EQ(2, dmac_channel_remaining((uint8_t)ch));
+
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    TEST_EQ(src8[10], periph_data);
+    (void)dmac_model_trigger(TRIG_PERIPH);
+    TEST_EQ(src8[11], periph_data);
+    TEST_EQ(1, log_.complete);
+
+    dmac_channel_free((uint8_t)ch);
+}
+
+/* Every channel can be allocated once, and again after a free */
+static void test_alloc_exhaustion(void)
+{
+    int8_t got[DMAC_CH_MAX];
+
+    fixture_reset();
+
+    for (uint32_t i = 0; i < DMAC_CH_MAX; i++)
+        got[i] = dmac_channel_alloc();
+
+    TEST_EQ(0, got[0]);
+    TEST_EQ(DMAC_CH_MAX - 1u, got[DMAC_CH_MAX - 1u]);
+    TEST_EQ(-1, dmac_channel_alloc());
+
+    dmac_channel_free(5);
+    TEST_EQ(5, dmac_channel_alloc());
+
+    for (uint32_t i = 0; i < DMAC_CH_MAX; i++)
+        dmac_channel_free((uint8_t)got[i]);
+}
+
+int main(void)
+{
+    TEST_RUN(test_single_block_swtrig);
+    TEST_RUN(test_chain_one_interrupt);
+    TEST_RUN(test_chain_burst_remaining);
+    TEST_RUN(test_remaining_active_channel);
+    TEST_RUN(test_circular_ring);
+    TEST_RUN(test_invalid_descriptor_error);
+    TEST_RUN(test_completion_masked_by_lock);
+    TEST_RUN(test_disable_and_restart);
+    TEST_RUN(test_alloc_exhaustion);
+    return TEST_EXIT();
+}
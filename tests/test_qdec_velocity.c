@@ -0,0 +1,355 @@
+/*
+ * M / T velocity estimator against a simulated encoder.
+ *
+ * The shaft is a position in counts moving at a set speed. Each 1 ms
+ * update gets the counts it crossed, and the period between the last
+ * two channel A edges (every counts_per_period counts) as a 16-bit
+ * capture TC would deliver it: in ticks, or QDEC_VEL_WRAPPED when the
+ * TC overflowed before the edge (qdec_update() reads OVF).
+ */
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+#include "qdec_velocity.h"
+
+#define CPP         4u              /* X4 decoding: 4 counts per A cycle */
+#define TICK_HZ     1000000u        /* Capture TC: 1 MHz, wraps at 65.5 ms */
+#define MIN_COUNTS  8u
+#define DT_US       1000u
+
+/* ================= ENCODER SIM ================= */
+typedef struct
+{
+    double pos;             /* Counts */
+    double t_us;
+    double edge_us;         /* Last channel A edge */
+    bool   edge_seen;
+} shaft_t;
+
+static void shaft_init(shaft_t *s)
+{
+    *s = (shaft_t){ .pos = 0.37 };  /* Off the count boundaries */
+}
+
+/* Move at cps for dt_us; counts crossed and the last capture */
+static void shaft_step_dt(shaft_t *s, double cps, uint32_t dt_us, int32_t *counts, uint32_t *period)
+{
+    double p0 = s->pos;
+    double p1 = p0 + cps * dt_us / 1e6;
+
+    *counts = (int32_t)(floor(p1) - floor(p0));
+    *period = 0;
+
+    /* Edges at multiples of CPP, in the order the shaft meets them */
+    double lo = fmin(p0, p1), hi = fmax(p0, p1);
+    double first = ceil(lo / CPP) * CPP;
+    double last  = floor(hi / CPP) * CPP;
+
+    for (double k = first; cps != 0.0 && k <= last; k += CPP)
+    {
+        double edge = (cps > 0.0) ? k : (last - (k - first));
+        double t    = s->t_us + (edge - p0) / cps * 1e6;
+
+        if (s->edge_seen)
+        {
+            uint64_t ticks = (uint64_t)llround((t - s->edge_us) * TICK_HZ / 1e6);
+            *period = (ticks > 0xFFFFu) ? QDEC_VEL_WRAPPED : (uint32_t)ticks;
+        }
+
+        s->edge_us   = t;
+        s->edge_seen = true;
+    }
+
+    s->pos   = p1;
+    s->t_us += dt_us;
+}
+
+static void shaft_step(shaft_t *s, double cps, int32_t *counts, uint32_t *period)
+{
+    shaft_step_dt(s, cps, DT_US, counts, period);
+}
+
+static int64_t step(qdec_velocity_t *v, shaft_t *s, double cps)
+{
+    int32_t  counts;
+    uint32_t period;
+
+    shaft_step(s, cps, &counts, &period);
+    return qdec_velocity_update(v, counts, DT_US, period);
+}
+
+/* |estimate - true| in millicounts per second */
+static double err_mcps(int64_t mcps, double cps)
+{
+    return fabs((double)mcps - cps * 1000.0);
+}
+
+/* ================= TESTS ================= */
+
+/* 200 counts/s: 0 or 1 count per update, T gives the exact speed */
+static void test_low_speed_t(void)
+{
+    qdec_velocity_t v;
+    shaft_t s;
+    uint32_t not_t = 0, bad = 0;
+
+    qdec_velocity_init(&v, CPP, TICK_HZ, MIN_COUNTS);
+    shaft_init(&s);
+    TEST_EQ(65536, v.wrap_us);
+
+    for (uint32_t i = 0; i < 500u; i++)
+    {
+        int64_t mcps = step(&v, &s, 200.0);
+
+        if (i < 50u)
+            continue;                       /* Two captures first */
+        if (v.method != QDEC_VEL_T)
+            not_t++;
+        if (err_mcps(mcps, 200.0) > 200.0 * 1000.0 * 0.001)
+            bad++;
+    }
+
+    TEST_EQ(0, not_t);
+    TEST_EQ(0, bad);
+    TEST_EQ(200000, v.mcps);
+    TEST_EQ(20000, v.period);
+}
+
+/*
+ * Speed plateaus across the crossover: below MIN_COUNTS per update
+ * the estimate comes from T and stays within 1 %, also at 5.5 counts
+ * per update where M would swing ±9 %; from MIN_COUNTS on it is M.
+ */
+static void test_t_to_m_crossover(void)
+{
+    static const struct { double cps; qdec_vel_method_t method; } plateau[] =
+    {
+        {   150.0, QDEC_VEL_T },
+        {  1000.0, QDEC_VEL_T },
+        {  5500.0, QDEC_VEL_T },
+        {  7000.0, QDEC_VEL_T },
+        {  9000.0, QDEC_VEL_M },
+        { 20000.0, QDEC_VEL_M },
+        {  5500.0, QDEC_VEL_T },            /* And back */
+    };
+    qdec_velocity_t v;
+    shaft_t s;
+
+    qdec_velocity_init(&v, CPP, TICK_HZ, MIN_COUNTS);
+    shaft_init(&s);
+
+    for (uint32_t p = 0; p < sizeof plateau / sizeof plateau[0]; p++)
+    {
+        double   cps = plateau[p].cps;
+        uint32_t wrong_method = 0;
+        double   worst = 0.0;
+
+        for (uint32_t i = 0; i < 300u; i++)
+        {
+            int64_t mcps = step(&v, &s, cps);
+
+            if (i < 200u)
+                continue;                   /* Settle */
+            if (v.method != plateau[p].method)
+                wrong_method++;
+            if (err_mcps(mcps, cps) > worst)
+                worst = err_mcps(mcps, cps);
+        }
+
+        TEST_CHECK(wrong_method == 0, "%.0f counts/s: method %d", cps, v.method);
+        if (plateau[p].method == QDEC_VEL_T)
+            TEST_CHECK(worst <= cps * 10.0, "%.0f counts/s: T off by %.0f mcps", cps, worst);
+        else
+            TEST_CHECK(worst <= 1e6, "%.0f counts/s: M off by %.0f mcps", cps, worst);
+    }
+}
+
+/*
+ * Forward, instant reversal, backward: the sign follows the first
+ * backward count, the magnitude is back within 1 % after two edges.
+ */
+static void test_direction_reversal(void)
+{
+    qdec_velocity_t v;
+    shaft_t s;
+    uint32_t positive_after = 0, bad = 0;
+    int32_t back_at = -1;
+
+    qdec_velocity_init(&v, CPP, TICK_HZ, MIN_COUNTS);
+    shaft_init(&s);
+
+    for (uint32_t i = 0; i < 300u; i++)
+        (void)step(&v, &s, 300.0);
+    TEST_EQ(QDEC_VEL_T, v.method);
+    TEST_NEAR(300000, v.mcps, 300);
+
+    for (int32_t i = 0; i < 300; i++)
+    {
+        int32_t  counts;
+        uint32_t period;
+
+        shaft_step(&s, -300.0, &counts, &period);
+        int64_t mcps = qdec_velocity_update(&v, counts, DT_US, period);
+
+        if (counts < 0 && back_at < 0)
+            back_at = i;
+        if (back_at >= 0 && mcps > 0)
+            positive_after++;
+        if (i >= 30 && err_mcps(mcps, -300.0) > 300.0)
+            bad++;
+    }
+
+    TEST_ASSERT(back_at >= 0 && back_at < 5);
+    TEST_EQ(0, positive_after);
+    TEST_EQ(0, bad);
+    TEST_EQ(-1, v.dir);
+    TEST_EQ(-30, qdec_velocity_rpm_x10(v.mcps, 6000));      /* -3 rpm */
+}
+
+/* Shaft stops: T is bounded by 1 count / time since the last count */
+static void test_stop_decays(void)
+{
+    qdec_velocity_t v;
+    shaft_t s;
+    uint32_t rising = 0;
+
+    qdec_velocity_init(&v, CPP, TICK_HZ, MIN_COUNTS);
+    shaft_init(&s);
+
+    for (uint32_t i = 0; i < 300u; i++)
+        (void)step(&v, &s, -300.0);
+
+    int64_t prev = v.mcps;
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        int64_t mcps = step(&v, &s, 0.0);
+
+        if (llabs(mcps) > llabs(prev))
+            rising++;
+        prev = mcps;
+    }
+
+    TEST_EQ(0, rising);
+    TEST_EQ(QDEC_VEL_STALL, v.method);
+    TEST_ASSERT(v.mcps <= 0);
+    TEST_ASSERT(llabs(v.mcps) <= 1000000000LL / (int64_t)v.since_edge_us);
+    TEST_ASSERT(llabs(v.mcps) <= 1000);         /* Still for ≥ 1 s */
+}
+
+/*
+ * 40 counts/s: 100 ms between A edges, beyond the 16-bit TC range.
+ * The truncated captures are dropped and M is used; T returns once
+ * the edges are close again.
+ */
+static void test_wrapped_capture_dropped(void)
+{
+    qdec_velocity_t v;
+    shaft_t s;
+    uint32_t used_t = 0;
+
+    qdec_velocity_init(&v, CPP, TICK_HZ, MIN_COUNTS);
+    shaft_init(&s);
+
+    for (uint32_t i = 0; i < 1000u; i++)
+    {
+        (void)step(&v, &s, 40.0);
+        if (v.method == QDEC_VEL_T || v.method == QDEC_VEL_STALL)
+            used_t++;
+    }
+
+    TEST_EQ(0, used_t);
+    TEST_EQ(0, v.period);
+
+    for (uint32_t i = 0; i < 100u; i++)
+        (void)step(&v, &s, 200.0);
+
+    TEST_EQ(QDEC_VEL_T, v.method);
+    TEST_EQ(200000, v.mcps);
+}
+
+/*
+ * 57 counts/s: 70 ms between A edges, just past the TC range, with
+ * updates late by up to 9 ms. A late update after edge k and a timely
+ * one after edge k + 1 are less than the range apart, yet the capture
+ * wrapped: only the TC's OVF tells, and no truncated period is used.
+ */
+static void test_wrapped_capture_jittered_polls(void)
+{
+    qdec_velocity_t v;
+    shaft_t s;
+    uint32_t rng = 12345u, short_gap = 0, captures = 0, used = 0;
+    double last_seen_us = -1.0;
+
+    qdec_velocity_init(&v, CPP, TICK_HZ, MIN_COUNTS);
+    shaft_init(&s);
+
+    for (uint32_t i = 0; i < 3000u; i++)
+    {
+        int32_t  counts;
+        uint32_t period;
+
+        rng = rng * 1103515245u + 12345u;
+        uint32_t dt_us = DT_US + ((rng >> 16) % 9u) * 1000u;
+
+        shaft_step_dt(&s, 4.0 / 0.070, dt_us, &counts, &period);
+        (void)qdec_velocity_update(&v, counts, dt_us, period);
+
+        if (period)
+        {
+            captures++;
+            if (last_seen_us >= 0.0 && s.t_us - last_seen_us < v.wrap_us)
+                short_gap++;
+            last_seen_us = s.t_us;
+        }
+        if (v.period != 0u || v.method == QDEC_VEL_T || v.method == QDEC_VEL_STALL)
+            used++;
+    }
+
+    TEST_ASSERT(captures > 100u);
+    TEST_ASSERT(short_gap > 0u);        /* The case update timing gets wrong */
+    TEST_EQ(0, used);
+}
+
+/* No capture TC: M only, NONE until the first count */
+static void test_m_only(void)
+{
+    qdec_velocity_t v;
+
+    qdec_velocity_init(&v, CPP, 0, 0);
+    TEST_EQ(1, v.min_counts);
+    TEST_EQ(0, v.wrap_us);
+
+    TEST_EQ(0, qdec_velocity_update(&v, 0, DT_US, 0));
+    TEST_EQ(QDEC_VEL_NONE, v.method);
+
+    TEST_EQ(-3000000, qdec_velocity_update(&v, -3, DT_US, 1234));
+    TEST_EQ(QDEC_VEL_M, v.method);
+
+    TEST_EQ(0, qdec_velocity_update(&v, 0, DT_US, 0));
+    TEST_EQ(QDEC_VEL_M, v.method);
+
+    /* dt 0: previous estimate kept */
+    (void)qdec_velocity_update(&v, 5, DT_US, 0);
+    TEST_EQ(5000000, qdec_velocity_update(&v, 2, 0, 0));
+}
+
+static void test_rpm_x10(void)
+{
+    TEST_EQ(600, qdec_velocity_rpm_x10(4000000, 4000));        /* 1 rev/s */
+    TEST_EQ(-600, qdec_velocity_rpm_x10(-4000000, 4000));
+    TEST_EQ(1, qdec_velocity_rpm_x10(6667, 4000));
+    TEST_EQ(0, qdec_velocity_rpm_x10(4000000, 0));
+}
+
+int main(void)
+{
+    TEST_RUN(test_low_speed_t);
+    TEST_RUN(test_t_to_m_crossover);
+    TEST_RUN(test_direction_reversal);
+    TEST_RUN(test_stop_decays);
+    TEST_RUN(test_wrapped_capture_dropped);
+    TEST_RUN(test_wrapped_capture_jittered_polls);
+    TEST_RUN(test_m_only);
+    TEST_RUN(test_rpm_x10);
+    return TEST_EXIT();
+}
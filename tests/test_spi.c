@@ -0,0 +1,421 @@
+/*
+ * SPI host driver on the register sim.
+ *
+ * spi_drv.c, sercom_core.c, gpio_drv.c and dmac_drv.c run unchanged;
+ * the DMAC model moves the bytes and the SPI model clocks them to the
+ * device whose chip select is low. The clock manager is stubbed below:
+ * the SERCOM generator runs at 48 MHz.
+ */
+#include <string.h>
+#include "test.h"
+#include "pic32cx1025sg61128.h"
+#include "spi_drv.h"
+#include "clock_mgr.h"
+#include "dmac_model.h"
+#include "spi_model.h"
+
+#define SPI_SERCOM      2u
+#define GEN_HZ          48000000u
+
+/* ================= STUBS ================= */
+bool clock_periph_enable(uint8_t pch, uint8_t gen)  { (void)pch; (void)gen; return true; }
+void clock_periph_disable(uint8_t pch)              { (void)pch; }
+uint32_t clock_periph_hz(uint8_t pch)               { (void)pch; return GEN_HZ; }
+uint32_t clock_gen_hz(uint8_t gen)                  { (void)gen; return GEN_HZ; }
+
+/* ================= DEVICES ================= */
+/* Records what it is sent and answers the inverted byte */
+typedef struct
+{
+    uint8_t  rx[256];
+    uint32_t bytes;
+    uint32_t frames;
+    uint32_t frame_len[8];
+    uint32_t ctrla;             /* SERCOM state seen on the last byte */
+    uint8_t  baud;
+} chip_t;
+
+static uint8_t chip_byte(void *ctx, uint8_t mosi, bool first)
+{
+    chip_t *c = ctx;
+
+    if (first)
+        c->frames++;
+    if (c->frames && c->frames <= 8u)
+        c->frame_len[c->frames - 1u]++;
+    if (c->bytes < sizeof c->rx)
+        c->rx[c->bytes] = mosi;
+    c->bytes++;
+
+    c->ctrla = sim_sercom[SPI_SERCOM].SPIM.SERCOM_CTRLA;
+    c->baud  = sim_sercom[SPI_SERCOM].SPIM.SERCOM_BAUD;
+
+    return (uint8_t)~mosi;
+}
+
+/* ================= FIXTURE ================= */
+static const sercom_pin_t spi_pins[] =
+{
+    { SERCOM_PORTA, 12, SERCOM_MUX_C, false },     /* PAD0 MOSI */
+    { SERCOM_PORTA, 13, SERCOM_MUX_C, false },     /* PAD1 SCK  */
+    { SERCOM_PORTA, 15, SERCOM_MUX_C, false },     /* PAD3 MISO */
+};
+
+static const spi_config_t spi_cfg =
+{
+    .sercom    = SPI_SERCOM,
+    .pins      = spi_pins,
+    .pin_count = 3,
+    .dopo      = 0,
+    .dipo      = 3,
+};
+
+static spi_master_t bus;
+static spi_device_t dev_a, dev_b;
+static chip_t       chip_a, chip_b;
+
+static uint8_t  tx[256], rx[256], rx2[256];
+static uint32_t done_order[8];
+static uint32_t done_count;
+
+static void xfer_done(spi_xfer_t *xfer, void *ctx)
+{
+    (void)xfer;
+    if (done_count < 8u)
+        done_order[done_count] = (uint32_t)(uintptr_t)ctx;
+    done_count++;
+}
+
+static void bus_open(void)
+{
+    sim_reset();
+    dmac_model_reset();
+    spi_model_reset();
+    dmac_init();
+
+    memset(&chip_a, 0, sizeof chip_a);
+    memset(&chip_b, 0, sizeof chip_b);
+    memset(rx, 0, sizeof rx);
+    memset(rx2, 0, sizeof rx2);
+    for (uint32_t i = 0; i < sizeof tx; i++)
+        tx[i] = (uint8_t)(i * 7u + 1u);
+    done_count = 0;
+
+    TEST_ASSERT(spi_master_init(&bus, &spi_cfg));
+}
+
+static void bus_close(void)
+{
+    TEST_EQ(0, spi_model_stray());
+    TEST_EQ(0, spi_model_overflows());
+
+    dmac_channel_free((uint8_t)bus.dma_tx_ch);
+    dmac_channel_free((uint8_t)bus.dma_rx_ch);
+    sercom_core_release(SPI_SERCOM);
+}
+
+static bool cs_high(gpio_port_id_t port, uint8_t pin)
+{
+    sim_port_update();
+    return (PORT_REGS->GROUP[port].PORT_OUT >> pin) & 1u;
+}
+
+/* ================= TESTS ================= */
+
+/* MOSI wired to MISO: every byte comes back, CS framed around it */
+static void test_loopback(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 1000000u, SPI_MODE0, false);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_B, 14, 0, 0);
+
+    TEST_EQ(23, dev_a.baud);
+    TEST_EQ(1000000, dev_a.sck_hz);
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+    TEST_ASSERT(PORT_REGS->GROUP[0].PORT_PINCFG[15] & PORT_PINCFG_PMUXEN_Msk);
+    TEST_EQ(SERCOM_MUX_C, PORT_REGS->GROUP[0].PORT_PMUX[7] >> 4);
+
+    spi_xfer_t x = { .dev = &dev_a, .tx_buf = tx, .rx_buf = rx, .len = 200,
+                     .callback = xfer_done, .ctx = (void *)1 };
+
+    TEST_ASSERT(spi_submit(&bus, &x));
+    TEST_ASSERT(spi_busy(&bus));
+    TEST_ASSERT(!cs_high(GPIO_PORT_B, 14));
+
+    TEST_EQ(200, spi_model_run(SPI_SERCOM));
+    TEST_EQ(SPI_STATUS_OK, x.status);
+    TEST_EQ(1, done_count);
+    TEST_ASSERT(!spi_busy(&bus));
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+    TEST_ASSERT(memcmp(tx, rx, 200) == 0);
+    TEST_EQ(0, rx[200]);
+
+    /* SERCOM left as the device wants it */
+    uint32_t ctrla = sim_sercom[SPI_SERCOM].SPIM.SERCOM_CTRLA;
+    TEST_EQ(SERCOM_SPIM_CTRLA_MODE_SPI_MASTER, ctrla & SERCOM_SPIM_CTRLA_MODE_Msk);
+    TEST_EQ(SERCOM_SPIM_CTRLA_DIPO(3), ctrla & SERCOM_SPIM_CTRLA_DIPO_Msk);
+    TEST_EQ(23, sim_sercom[SPI_SERCOM].SPIM.SERCOM_BAUD);
+
+    bus_close();
+}
+
+/* No tx_buf: dummy bytes out; no rx_buf: nothing written */
+static void test_dummy_buffers(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 24000000u, SPI_MODE0, false);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_B, 14, chip_byte, &chip_a);
+
+    spi_xfer_t rd = { .dev = &dev_a, .rx_buf = rx, .len = 16 };
+    spi_xfer_t wr = { .dev = &dev_a, .tx_buf = tx, .len = 16 };
+
+    TEST_ASSERT(spi_submit(&bus, &rd));
+    TEST_ASSERT(spi_submit(&bus, &wr));
+    TEST_EQ(32, spi_model_run(SPI_SERCOM));
+
+    TEST_EQ(SPI_STATUS_OK, rd.status);
+    TEST_EQ(SPI_STATUS_OK, wr.status);
+    TEST_EQ(0, dev_a.baud);
+    TEST_EQ(2, chip_a.frames);
+
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < 16u; i++)
+    {
+        if (chip_a.rx[i] != SPI_DUMMY_BYTE || rx[i] != (uint8_t)~SPI_DUMMY_BYTE)
+            bad++;
+        if (chip_a.rx[16u + i] != tx[i])
+            bad++;
+    }
+    TEST_EQ(0, bad);
+    TEST_EQ(0, rx[16]);
+
+    bus_close();
+}
+
+/*
+ * Three queued transactions over two devices: each one reaches its
+ * device with that device's mode and BAUD, in submit order, without
+ * the application restarting anything.
+ */
+static void test_queue_two_devices(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 12000000u, SPI_MODE0, false);
+    spi_device_init(&bus, &dev_b, GPIO_PORT_C, 3, 4000000u, SPI_MODE3, true);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_B, 14, chip_byte, &chip_a);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_C, 3, chip_byte, &chip_b);
+
+    spi_xfer_t x1 = { .dev = &dev_a, .tx_buf = tx,      .rx_buf = rx,       .len = 10,
+                      .callback = xfer_done, .ctx = (void *)1 };
+    spi_xfer_t x2 = { .dev = &dev_b, .tx_buf = tx + 10, .rx_buf = rx2,      .len = 5,
+                      .callback = xfer_done, .ctx = (void *)2 };
+    spi_xfer_t x3 = { .dev = &dev_a, .tx_buf = tx + 20, .rx_buf = rx + 10,  .len = 7,
+                      .callback = xfer_done, .ctx = (void *)3 };
+
+    TEST_ASSERT(spi_submit(&bus, &x1));
+    TEST_ASSERT(spi_submit(&bus, &x2));
+    TEST_ASSERT(spi_submit(&bus, &x3));
+    TEST_ASSERT(!spi_submit(&bus, &x2));        /* Still queued */
+
+    TEST_EQ(22, spi_model_run(SPI_SERCOM));
+    TEST_EQ(3, done_count);
+    TEST_EQ(1, done_order[0]);
+    TEST_EQ(2, done_order[1]);
+    TEST_EQ(3, done_order[2]);
+
+    /* Device A: two frames, mode 0, BAUD for 12 MHz */
+    TEST_EQ(2, chip_a.frames);
+    TEST_EQ(10, chip_a.frame_len[0]);
+    TEST_EQ(7, chip_a.frame_len[1]);
+    TEST_ASSERT(memcmp(chip_a.rx, tx, 10) == 0);
+    TEST_ASSERT(memcmp(chip_a.rx + 10, tx + 20, 7) == 0);
+    TEST_EQ(1, chip_a.baud);
+    TEST_EQ(0, chip_a.ctrla & (SERCOM_SPIM_CTRLA_CPOL_Msk | SERCOM_SPIM_CTRLA_CPHA_Msk |
+                               SERCOM_SPIM_CTRLA_DORD_Msk));
+
+    /* Device B: mode 3, LSB first, so it sees every byte bit-reversed */
+    TEST_EQ(1, chip_b.frames);
+    TEST_EQ(5, chip_b.bytes);
+    TEST_EQ(5, chip_b.baud);
+    TEST_EQ(SERCOM_SPIM_CTRLA_CPOL_Msk | SERCOM_SPIM_CTRLA_CPHA_Msk | SERCOM_SPIM_CTRLA_DORD_Msk,
+            chip_b.ctrla & (SERCOM_SPIM_CTRLA_CPOL_Msk | SERCOM_SPIM_CTRLA_CPHA_Msk |
+                            SERCOM_SPIM_CTRLA_DORD_Msk));
+
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < 5u; i++)
+    {
+        uint8_t wire  = (uint8_t)(__RBIT(tx[10u + i]) >> 24);
+        uint8_t reply = (uint8_t)~tx[10u + i];
+        if (chip_b.rx[i] != wire || rx2[i] != reply)
+            bad++;
+    }
+    for (uint32_t i = 0; i < 17u; i++)
+    {
+        uint8_t reply = (uint8_t)~(i < 10u ? tx[i] : tx[10u + i]);
+        if (rx[i] != reply)
+            bad++;
+    }
+    TEST_EQ(0, bad);
+
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+    TEST_ASSERT(cs_high(GPIO_PORT_C, 3));
+
+    bus_close();
+}
+
+/* KEEP_CS joins transactions to the same device into one frame only */
+static void test_keep_cs(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 24000000u, SPI_MODE0, false);
+    spi_device_init(&bus, &dev_b, GPIO_PORT_C, 3, 24000000u, SPI_MODE0, false);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_B, 14, chip_byte, &chip_a);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_C, 3, chip_byte, &chip_b);
+
+    /* Command + payload: one frame */
+    spi_xfer_t cmd  = { .dev = &dev_a, .tx_buf = tx, .len = 4, .flags = SPI_XFER_KEEP_CS };
+    spi_xfer_t data = { .dev = &dev_a, .rx_buf = rx, .len = 32 };
+    /* Same device, no KEEP_CS: CS released and taken again */
+    spi_xfer_t next = { .dev = &dev_a, .tx_buf = tx, .len = 2, .flags = SPI_XFER_KEEP_CS };
+    /* KEEP_CS but the next one is another device: released anyway */
+    spi_xfer_t other = { .dev = &dev_b, .tx_buf = tx, .len = 3 };
+
+    TEST_ASSERT(spi_submit(&bus, &cmd));
+    TEST_ASSERT(spi_submit(&bus, &data));
+    TEST_ASSERT(spi_submit(&bus, &next));
+    TEST_ASSERT(spi_submit(&bus, &other));
+    TEST_EQ(41, spi_model_run(SPI_SERCOM));
+
+    TEST_EQ(2, chip_a.frames);
+    TEST_EQ(36, chip_a.frame_len[0]);
+    TEST_EQ(2, chip_a.frame_len[1]);
+    TEST_EQ(1, chip_b.frames);
+    TEST_EQ(3, chip_b.frame_len[0]);
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+    TEST_ASSERT(cs_high(GPIO_PORT_C, 3));
+
+    /* KEEP_CS on the last transaction: nothing follows, CS released */
+    spi_xfer_t last = { .dev = &dev_a, .tx_buf = tx, .len = 1, .flags = SPI_XFER_KEEP_CS };
+    TEST_ASSERT(spi_submit(&bus, &last));
+    TEST_EQ(1, spi_model_run(SPI_SERCOM));
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+
+    bus_close();
+}
+
+/*
+ * Completion is the RX interrupt: held off by PRIMASK, the transaction
+ * stays PENDING with CS low and the next one waits for it.
+ */
+static void test_completion_masked(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 24000000u, SPI_MODE0, false);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_B, 14, 0, 0);
+
+    spi_xfer_t x1 = { .dev = &dev_a, .tx_buf = tx, .rx_buf = rx, .len = 8 };
+    spi_xfer_t x2 = { .dev = &dev_a, .tx_buf = tx + 8, .rx_buf = rx + 8, .len = 8 };
+
+    TEST_ASSERT(spi_submit(&bus, &x1));
+    TEST_ASSERT(spi_submit(&bus, &x2));
+
+    __disable_irq();
+    TEST_EQ(8, spi_model_run(SPI_SERCOM));
+    TEST_EQ(SPI_STATUS_PENDING, x1.status);
+    TEST_ASSERT(!cs_high(GPIO_PORT_B, 14));
+    TEST_EQ(0, spi_model_run(SPI_SERCOM));
+
+    __enable_irq();
+    dmac_model_irq();
+    TEST_EQ(SPI_STATUS_OK, x1.status);
+    TEST_EQ(SPI_STATUS_PENDING, x2.status);
+
+    TEST_EQ(8, spi_model_run(SPI_SERCOM));
+    TEST_EQ(SPI_STATUS_OK, x2.status);
+    TEST_ASSERT(memcmp(tx, rx, 16) == 0);
+
+    bus_close();
+}
+
+/*
+ * Bus error on the TX channel: RX is stopped, CS released and the
+ * transaction ends with DMA_ERROR instead of waiting for bytes that
+ * are never clocked. The queue goes on with the next one.
+ */
+static void test_tx_error(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 24000000u, SPI_MODE0, false);
+    spi_model_attach(SPI_SERCOM, GPIO_PORT_B, 14, chip_byte, &chip_a);
+
+    spi_xfer_t x1 = { .dev = &dev_a, .tx_buf = tx, .rx_buf = rx, .len = 16,
+                      .callback = xfer_done, .ctx = (void *)1 };
+    spi_xfer_t x2 = { .dev = &dev_a, .tx_buf = tx + 16, .rx_buf = rx2, .len = 8,
+                      .callback = xfer_done, .ctx = (void *)2 };
+
+    TEST_ASSERT(spi_submit(&bus, &x1));
+    TEST_ASSERT(spi_submit(&bus, &x2));
+    TEST_ASSERT(!cs_high(GPIO_PORT_B, 14));
+
+    dmac_model_bus_error((uint8_t)bus.dma_tx_ch);
+
+    TEST_EQ(SPI_STATUS_DMA_ERROR, x1.status);
+    TEST_EQ(1, done_count);
+    TEST_EQ(SPI_STATUS_PENDING, x2.status);
+
+    /* x1 never reaches the wire; x2 gets its own frame */
+    TEST_EQ(8, spi_model_run(SPI_SERCOM));
+    TEST_EQ(SPI_STATUS_OK, x2.status);
+    TEST_EQ(2, done_count);
+    TEST_EQ(2, done_order[1]);
+    TEST_EQ(1, chip_a.frames);
+    TEST_EQ(8, chip_a.bytes);
+    TEST_ASSERT(memcmp(chip_a.rx, tx + 16, 8) == 0);
+    TEST_EQ(0, rx[0]);
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+    TEST_ASSERT(!spi_busy(&bus));
+
+    /* Alone in the queue: the bus goes idle */
+    spi_xfer_t x3 = { .dev = &dev_a, .tx_buf = tx, .len = 4 };
+    TEST_ASSERT(spi_submit(&bus, &x3));
+    TEST_ASSERT(!cs_high(GPIO_PORT_B, 14));
+    dmac_model_bus_error((uint8_t)bus.dma_tx_ch);
+    TEST_EQ(SPI_STATUS_DMA_ERROR, x3.status);
+    TEST_ASSERT(!spi_busy(&bus));
+    TEST_ASSERT(cs_high(GPIO_PORT_B, 14));
+    TEST_EQ(0, spi_model_run(SPI_SERCOM));
+
+    bus_close();
+}
+
+static void test_submit_rejects(void)
+{
+    bus_open();
+    spi_device_init(&bus, &dev_a, GPIO_PORT_B, 14, 24000000u, SPI_MODE0, false);
+
+    spi_xfer_t empty   = { .dev = &dev_a, .tx_buf = tx, .len = 0 };
+    spi_xfer_t no_dev  = { .tx_buf = tx, .len = 4 };
+
+    TEST_ASSERT(!spi_submit(&bus, &empty));
+    TEST_ASSERT(!spi_submit(&bus, &no_dev));
+    TEST_ASSERT(!spi_submit(&bus, 0));
+    TEST_ASSERT(!spi_busy(&bus));
+
+    /* The SERCOM stays claimed until released */
+    spi_master_t again;
+    TEST_ASSERT(!spi_master_init(&again, &spi_cfg));
+
+    bus_close();
+}
+
+int main(void)
+{
+    TEST_RUN(test_loopback);
+    TEST_RUN(test_dummy_buffers);
+    TEST_RUN(test_queue_two_devices);
+    TEST_RUN(test_keep_cs);
+    TEST_RUN(test_completion_masked);
+    TEST_RUN(test_tx_error);
+    TEST_RUN(test_submit_rejects);
+    return TEST_EXIT();
+}
@@ -0,0 +1,426 @@
+/*
+ * Timer wheel against a simulated tick counter.
+ *
+ * timer_wheel.c is included directly with its critical section
+ * replaced by a nesting counter, so the tests can check that callbacks
+ * run outside the lock. The clock is a variable; arm() records the
+ * deadline the way the RTC compare would, and sim_run_to() plays the
+ * RTC interrupt: jump to each armed deadline, process, repeat.
+ */
+#include "test.h"
+
+static int wheel_lock_depth;
+
+#define TIMER_WHEEL_LOCK(state)     do { (state) = (uint32_t)wheel_lock_depth++; } while (0)
+#define TIMER_WHEEL_UNLOCK(state)   (wheel_lock_depth = (int)(state))
+
+#include "timer_wheel.c"
+
+/* ================= SIMULATED CLOCK ================= */
+static uint32_t sim_ticks;
+static uint32_t sim_deadline;
+static bool     sim_armed;
+static uint32_t sim_arm_calls;
+
+static uint32_t sim_now(void *ctx)
+{
+    (void)ctx;
+    return sim_ticks;
+}
+
+static void sim_arm(uint32_t deadline, void *ctx)
+{
+    (void)ctx;
+    sim_deadline = deadline;
+    sim_armed    = true;
+    sim_arm_calls++;
+}
+
+static void sim_disarm(void *ctx)
+{
+    (void)ctx;
+    sim_armed = false;
+}
+
+static const timer_wheel_clock_t sim_clock =
+{
+    .now    = sim_now,
+    .arm    = sim_arm,
+    .disarm = sim_disarm,
+};
+
+static timer_wheel_t wheel;
+
+static void sim_reset(uint32_t start)
+{
+    sim_ticks     = start;
+    sim_armed     = false;
+    sim_arm_calls = 0;
+    timer_wheel_init(&wheel, &sim_clock);
+}
+
+/* RTC compare: wait for each deadline up to end, process on it */
+static void sim_run_to(uint32_t end)
+{
+    while (sim_armed && (int32_t)(end - sim_deadline) >= 0)
+    {
+        if ((int32_t)(sim_deadline - sim_ticks) > 0)
+            sim_ticks = sim_deadline;
+        sim_armed = false;
+        (void)timer_wheel_process(&wheel);
+    }
+
+    sim_ticks = end;
+}
+
+/* ================= RECORDING CALLBACK ================= */
+#define FIRE_MAX    64u
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t at[FIRE_MAX];      /* sim_ticks of each call */
+    int      lock_depth;        /* Worst lock depth seen in the callback */
+} fire_log_t;
+
+static void on_fire(wheel_timer_t *t, void *ctx)
+{
+    fire_log_t *log = ctx;
+    (void)t;
+
+    if (log->count < FIRE_MAX)
+        log->at[log->count] = sim_ticks;
+    log->count++;
+
+    if (wheel_lock_depth > log->lock_depth)
+        log->lock_depth = wheel_lock_depth;
+}
+
+/* ================= TESTS ================= */
+
+/* One-shot fires on its tick, not one earlier, with the lock released */
+static void test_one_shot_exact(void)
+{
+    fire_log_t log = {0};
+    wheel_timer_t t;
+
+    sim_reset(1000);
+    wheel_timer_init(&t, on_fire, &log);
+    timer_wheel_start(&wheel, &t, 10, 0);
+
+    TEST_ASSERT(sim_armed);
+    TEST_EQ(1010, sim_deadline);
+
+    sim_ticks = 1009;
+    TEST_EQ(0, timer_wheel_process(&wheel));
+    TEST_EQ(0, log.count);
+
+    sim_ticks = 1010;
+    TEST_EQ(1, timer_wheel_process(&wheel));
+    TEST_EQ(1, log.count);
+    TEST_EQ(1010, log.at[0]);
+    TEST_EQ(0, log.lock_depth);
+    TEST_ASSERT(!wheel_timer_active(&t));
+    TEST_ASSERT(!sim_armed);
+}
+
+/*
+ * Delay 0 right after a process() in the same tick: that tick is
+ * already behind the wheel, yet the timer is due now. The next
+ * process() must run it without the clock moving.
+ */
+static void test_delay0_after_process(void)
+{
+    fire_log_t log = {0};
+    wheel_timer_t t;
+
+    sim_reset(500);
+    (void)timer_wheel_process(&wheel);
+
+    wheel_timer_init(&t, on_fire, &log);
+    timer_wheel_start(&wheel, &t, 0, 0);
+
+    /* Armed on a passed deadline: the tick source fires at once */
+    TEST_ASSERT(sim_armed);
+    TEST_ASSERT((int32_t)(sim_ticks - sim_deadline) >= 0);
+
+    uint32_t ticks = 99;
+    TEST_ASSERT(timer_wheel_next_event(&wheel, &ticks));
+    TEST_EQ(0, ticks);
+
+    TEST_EQ(1, timer_wheel_process(&wheel));
+    TEST_EQ(1, log.count);
+    TEST_EQ(500, log.at[0]);
+    TEST_ASSERT(!sim_armed);
+}
+
+/* A batched delay-0 timer can still be cancelled or restarted */
+static void test_delay0_cancel_restart(void)
+{
+    fire_log_t log = {0};
+    wheel_timer_t t;
+
+    sim_reset(77);
+    (void)timer_wheel_process(&wheel);
+
+    wheel_timer_init(&t, on_fire, &log);
+    timer_wheel_start(&wheel, &t, 0, 0);
+    TEST_ASSERT(timer_wheel_cancel(&wheel, &t));
+    TEST_ASSERT(!sim_armed);
+    TEST_EQ(0, timer_wheel_process(&wheel));
+
+    timer_wheel_start(&wheel, &t, 0, 0);
+    timer_wheel_start(&wheel, &t, 5, 0);
+    TEST_EQ(82, sim_deadline);
+    TEST_EQ(0, timer_wheel_process(&wheel));
+
+    sim_run_to(100);
+    TEST_EQ(1, log.count);
+    TEST_EQ(82, log.at[0]);
+}
+
+/* Delay 0 from a callback waits for the next tick: no livelock */
+static wheel_timer_t self_timer;
+static uint32_t self_runs;
+static uint32_t self_at[4];
+
+static void on_self_restart(wheel_timer_t *t, void *ctx)
+{
+    (void)ctx;
+
+    if (self_runs < 4u)
+        self_at[self_runs] = sim_ticks;
+    if (++self_runs < 4u)
+        timer_wheel_start(&wheel, t, 0, 0);
+}
+
+static void test_delay0_from_callback(void)
+{
+    sim_reset(10);
+    self_runs = 0;
+    wheel_timer_init(&self_timer, on_self_restart, 0);
+    timer_wheel_start(&wheel, &self_timer, 1, 0);
+
+    sim_ticks = 11;
+    TEST_EQ(1, timer_wheel_process(&wheel));
+    TEST_EQ(12, sim_deadline);
+
+    sim_run_to(20);
+    TEST_EQ(4, self_runs);
+    TEST_EQ(11, self_at[0]);
+    TEST_EQ(12, self_at[1]);
+    TEST_EQ(13, self_at[2]);
+    TEST_EQ(14, self_at[3]);
+}
+
+/* Periodic timers keep their phase: expiry += period, not now + period */
+static void test_periodic_no_drift(void)
+{
+    fire_log_t log = {0};
+    wheel_timer_t t;
+
+    sim_reset(0);
+    wheel_timer_init(&t, on_fire, &log);
+    timer_wheel_start(&wheel, &t, 7, 7);
+
+    /* Serviced late every time: 3 ticks after the deadline */
+    for (uint32_t i = 0; i < 20u; i++)
+    {
+        sim_ticks = sim_deadline + 3u;
+        sim_armed = false;
+        (void)timer_wheel_process(&wheel);
+    }
+
+    TEST_EQ(20, log.count);
+    for (uint32_t i = 0; i < 20u; i++)
+        TEST_EQ(7u * (i + 1u) + 3u, log.at[i]);
+    TEST_EQ(147, sim_deadline);
+}
+
+/* Delays across every level fire on their exact tick after cascading */
+static void test_cascade_exact(void)
+{
+    static const uint32_t delays[] = { 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300001 };
+    static fire_log_t logs[sizeof delays / sizeof delays[0]];
+    static wheel_timer_t timers[sizeof delays / sizeof delays[0]];
+    const uint32_t start = 0xFFFFF000u;     /* Crosses the 32-bit wrap */
+    const uint32_t n = sizeof delays / sizeof delays[0];
+
+    sim_reset(start);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        logs[i] = (fire_log_t){0};
+        wheel_timer_init(&timers[i], on_fire, &logs[i]);
+        timer_wheel_start(&wheel, &timers[i], delays[i], 0);
+    }
+
+    sim_run_to(start + 400000u);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        TEST_EQ(1, logs[i].count);
+        TEST_EQ(start + delays[i], logs[i].at[0]);
+    }
+
+    timer_wheel_stats_t stats;
+    timer_wheel_get_stats(&wheel, &stats);
+    TEST_EQ(0, stats.active);
+    TEST_EQ(n, stats.expired);
+    TEST_ASSERT(stats.cascaded > 0u);
+}
+
+/* A callback cancelling a timer still waiting in the same batch skips it */
+static wheel_timer_t pair[2];
+static uint32_t pair_runs;
+static uint32_t pair_cancelled;
+
+static void on_cancel_other(wheel_timer_t *t, void *ctx)
+{
+    (void)ctx;
+
+    pair_runs++;
+    if (timer_wheel_cancel(&wheel, &pair[t == &pair[0] ? 1 : 0]))
+        pair_cancelled++;
+}
+
+static void test_cancel_in_batch(void)
+{
+    sim_reset(200);
+    pair_runs      = 0;
+    pair_cancelled = 0;
+
+    /* Same tick: whichever runs first cancels the other */
+    wheel_timer_init(&pair[0], on_cancel_other, 0);
+    wheel_timer_init(&pair[1], on_cancel_other, 0);
+    timer_wheel_start(&wheel, &pair[0], 5, 0);
+    timer_wheel_start(&wheel, &pair[1], 5, 0);
+
+    sim_run_to(300);
+    TEST_EQ(1, pair_runs);
+    TEST_EQ(1, pair_cancelled);
+    TEST_ASSERT(!wheel_timer_active(&pair[0]));
+    TEST_ASSERT(!wheel_timer_active(&pair[1]));
+    TEST_ASSERT(!sim_armed);
+}
+
+/* next_event() counts from the current clock, not the wheel time */
+static void test_next_event(void)
+{
+    wheel_timer_t t;
+    uint32_t ticks;
+
+    sim_reset(4000);
+    TEST_ASSERT(!timer_wheel_next_event(&wheel, &ticks));
+
+    wheel_timer_init(&t, 0, 0);
+    timer_wheel_start(&wheel, &t, 50, 0);
+
+    sim_ticks = 4030;
+    TEST_ASSERT(timer_wheel_next_event(&wheel, &ticks));
+    TEST_EQ(20, ticks);
+
+    /* Beyond level 0 the next event is the cascade at 4096 */
+    timer_wheel_start(&wheel, &t, 100, 0);
+    TEST_ASSERT(timer_wheel_next_event(&wheel, &ticks));
+    TEST_EQ(66, ticks);
+
+    sim_ticks = 4200;
+    TEST_ASSERT(timer_wheel_next_event(&wheel, &ticks));
+    TEST_EQ(0, ticks);
+}
+
+/* Many random timers, restarts and cancels against a reference list */
+#define RAND_TIMERS     96u
+
+static wheel_timer_t rand_timers[RAND_TIMERS];
+static uint32_t      rand_due[RAND_TIMERS];
+static bool          rand_live[RAND_TIMERS];
+static uint32_t      rand_errors;
+static uint32_t      rand_fired;
+static uint32_t      rand_seed = 12345u;
+
+static uint32_t rand_next(void)
+{
+    rand_seed = rand_seed * 1103515245u + 12345u;
+    return rand_seed >> 8;
+}
+
+static uint32_t rand_delay(void)
+{
+    switch (rand_next() % 4u)
+    {
+    case 0:  return rand_next() % 64u;
+    case 1:  return rand_next() % 4096u;
+    case 2:  return rand_next() % 262144u;
+    default: return rand_next() % 2000000u;
+    }
+}
+
+static void on_rand(wheel_timer_t *t, void *ctx)
+{
+    uint32_t i = (uint32_t)(uintptr_t)ctx;
+    (void)t;
+
+    if (!rand_live[i] || rand_due[i] != sim_ticks)
+        rand_errors++;
+
+    rand_live[i] = false;
+    rand_fired++;
+}
+
+static void test_random_against_reference(void)
+{
+    sim_reset(0x7FFFFF00u);
+    rand_errors = 0;
+    rand_fired  = 0;
+
+    for (uint32_t i = 0; i < RAND_TIMERS; i++)
+    {
+        rand_live[i] = false;
+        wheel_timer_init(&rand_timers[i], on_rand, (void *)(uintptr_t)i);
+    }
+
+    for (uint32_t step = 0; step < 4000u; step++)
+    {
+        uint32_t i = rand_next() % RAND_TIMERS;
+
+        if (rand_live[i] && (rand_next() % 4u) == 0u)
+        {
+            TEST_ASSERT(timer_wheel_cancel(&wheel, &rand_timers[i]));
+            rand_live[i] = false;
+        }
+        else
+        {
+            uint32_t delay = rand_delay();
+
+            timer_wheel_start(&wheel, &rand_timers[i], delay, 0);
+            rand_due[i]  = sim_ticks + delay;
+            rand_live[i] = true;
+        }
+
+        sim_run_to(sim_ticks + rand_next() % 5000u);
+    }
+
+    sim_run_to(sim_ticks + 2100000u);
+
+    TEST_EQ(0, rand_errors);
+    TEST_ASSERT(rand_fired > 1000u);
+    for (uint32_t i = 0; i < RAND_TIMERS; i++)
+        TEST_ASSERT(!rand_live[i]);
+    TEST_ASSERT(!sim_armed);
+}
+
+int main(void)
+{
+    TEST_RUN(test_one_shot_exact);
+    TEST_RUN(test_delay0_after_process);
+    TEST_RUN(test_delay0_cancel_restart);
+    TEST_RUN(test_delay0_from_callback);
+    TEST_RUN(test_periodic_no_drift);
+    TEST_RUN(test_cascade_exact);
+    TEST_RUN(test_cancel_in_batch);
+    TEST_RUN(test_next_event);
+    TEST_RUN(test_random_against_reference);
+    return TEST_EXIT();
+}